@@ -0,0 +1,22 @@
+//
+//	body_halo_batch
+//
+#version 420
+#pragma debug(on)
+#pragma optimize(off)
+
+layout (binding=0) uniform sampler2D mapTexture;
+
+in Interpolators
+{
+	vec2 TexCoord;
+	vec3 TexColor;
+} interData;
+
+out vec3 FragColor;
+
+void main(void)
+{
+	// TexColor contient déjà cmag, comme dans body_halo
+	FragColor = interData.TexColor * texture(mapTexture, interData.TexCoord).rgb;
+}
@@ -0,0 +1,23 @@
+//
+//	body_halo_batch
+//
+#version 420
+#pragma debug(on)
+#pragma optimize(off)
+
+layout (location = 0) in vec2 Position;
+layout (location = 1) in float Radius;
+layout (location = 2) in vec3 Color;
+
+out vertexData
+{
+	float radius;
+	vec3 color;
+} vertexOut;
+
+void main(void)
+{
+	vertexOut.radius = Radius;
+	vertexOut.color = Color;
+	gl_Position = vec4(Position, 0.0, 1.0);
+}
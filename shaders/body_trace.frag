@@ -5,12 +5,12 @@
 #pragma debug(on)
 #pragma optimize(off)
 
-uniform vec3 Color;
- 
+in vec3 fragColor;
+
 out vec4 FragColor;
 
 void main(void)
 {
-	FragColor = vec4(Color, 1.0);
+	FragColor = vec4(fragColor, 1.0);
 }
 
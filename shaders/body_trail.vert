@@ -9,10 +9,13 @@
 //layout
 //~ layout (location=1)in vec3 color;
 layout (location=0) in vec3 position;
-layout (location=1) in float segment;
+layout (location=1) in float slot;
 
 uniform int nbPoints;
 uniform float fader;
+// emplacement du point le plus récent et taille de l'anneau de points
+uniform int head;
+uniform int capacity;
 
 out ValueFader
 {
@@ -22,5 +25,7 @@ out ValueFader
 void main()
 {
 	gl_Position = vec4(position,1.0);
+	// rang du point depuis le plus récent, à partir de 1
+	float segment = float((head - int(slot) + capacity) % capacity + 1);
 	valueFader.indice = (1.0-0.9*segment/nbPoints)*fader;
 }
@@ -6,7 +6,7 @@
 #pragma optimize(off)
 #pragma optionNV(fastprecision off)
 
-layout (location=0)in vec2 position;
+layout (location=0)in vec3 position;
 layout (location=1)in vec2 texCoord;
 
 //~ uniform mat4 MVP;
@@ -32,7 +32,7 @@ void main()
 {
 	//~ gl_Position = MVP2D * vec4(position,0.0,1.0);
 	TexCoord = texCoord;
-	gl_Position = vec4(position,0.0,1.0);
+	gl_Position = vec4(position,1.0);
 	//~ interData.TexCoord = texCoord;
 }
 
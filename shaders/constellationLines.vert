@@ -7,27 +7,13 @@
 #pragma optionNV(fastprecision off)
 
 //layout
-layout (location=0)in vec2 position;
-layout (location=2)in vec4 color;
+layout (location=0)in vec3 position;
+layout (location=2)in vec4 vertexColor;
 
-//externe
-//~ uniform mat4 MVP;
-
-layout (std140) uniform cam_block
-{
-	ivec4 viewport;
-	ivec4 viewport_center;
-	vec4 main_clipping_fov;
-	mat4 MVP2D;
-	float ambient;
-	float time;
-};
-
-out vec4 Color;
+out vec4 color;
 
 void main()
 {
-	Color = color;
-	gl_Position = MVP2D * vec4(position,0.0,1.0);
+	color = vertexColor;
+	gl_Position = vec4(position,1.0);
 }
-
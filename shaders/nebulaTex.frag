@@ -5,7 +5,7 @@
 #pragma optimize(off)
 
 uniform float fader;
-layout (binding=0) uniform sampler2D mapTexture;
+layout (binding=0) uniform sampler2DArray mapTexture;
 
 
 out vec4 FragColor;
@@ -13,14 +13,15 @@ out vec4 FragColor;
 
 in FInterpolators
 {
-	vec2 texCoord;
+	vec3 texCoord;
+	float luminance;
 } dataFrag;
 
 
 void main(void)
 {
 	vec4 tex_color = vec4(texture(mapTexture,dataFrag.texCoord)).rgba;
-	tex_color.a *= fader;
+	tex_color.a *= fader * dataFrag.luminance;
 	//~ if (fader>1.)
 		//~ FragColor = vec4(1.0, 0.0,0.0,1.0);
 	//~ else
@@ -5,15 +5,18 @@
 #pragma optimize(off)
 
 layout (location = 0) in vec3 Position;
-layout (location = 1) in vec2 TexCoord;
+layout (location = 1) in vec3 TexCoord;
+layout (location = 2) in float Luminance;
 
 out VInterpolators
 {
-	vec2 texCoord;
+	vec3 texCoord;
+	float luminance;
 } dataVertex;
 
 void main(void)
 {
 	gl_Position = vec4(Position,1.0);
 	dataVertex.texCoord = TexCoord;
+	dataVertex.luminance = Luminance;
 }
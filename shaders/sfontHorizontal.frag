@@ -7,9 +7,8 @@
 
 
 layout (binding=0)uniform sampler2D mapTexture;
-uniform vec3 Color;
-
 smooth in vec2 TexCoord;
+flat in vec3 Color;
  
 out vec4 FragColor;
 
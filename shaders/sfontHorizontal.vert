@@ -9,6 +9,7 @@
 
 layout (location=0)in vec2 position;
 layout (location=1)in vec2 texCoord;
+layout (location=2)in vec3 color;
 
 //~ uniform mat4 MVP;
 
@@ -24,10 +25,12 @@ layout (std140) uniform cam_block
 
 
 smooth out vec2 TexCoord;
+flat out vec3 Color;
 
 
 void main()
 {
 	gl_Position = MVP2D * vec4(position,0.0,1.0);
 	TexCoord = texCoord;
+	Color = color;
 }
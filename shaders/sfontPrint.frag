@@ -7,9 +7,8 @@
 
 
 layout (binding=0) uniform sampler2D mapTexture;
-uniform vec4 Color;
-
 smooth in vec2 TexCoord;
+flat in vec4 Color;
  
 out vec4 FragColor;
 
@@ -7,16 +7,18 @@
 #pragma optimize(off)
 #pragma optionNV(fastprecision off)
 
-layout (location=0)in vec2 position;
+// position already transformed by the MVP of each string
+layout (location=0)in vec4 position;
 layout (location=1)in vec2 texCoord;
-
-uniform mat4 MVP;
+layout (location=2)in vec4 color;
 
 smooth out vec2 TexCoord;
+flat out vec4 Color;
 
 
 void main()
 {
-	gl_Position = MVP * vec4(position,0.0,1.0);
+	gl_Position = position;
 	TexCoord = texCoord;
+	Color = color;
 }
@@ -0,0 +1,15 @@
+//
+//	skylineProj
+//
+#version 420
+#pragma debug(on)
+#pragma optimize(off)
+
+uniform vec4 Color;
+ 
+out vec4 FragColor;
+
+void main(void)
+{
+	FragColor = Color;
+}
@@ -0,0 +1,19 @@
+//
+// skylineProj
+//
+
+#version 420
+#pragma debug(on)
+#pragma optimize(off)
+#pragma optionNV(fastprecision off)
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in float Tick;
+
+out float tick;
+
+void main(void)
+{
+	gl_Position = vec4(Position,1.0);
+	tick = Tick;
+}
@@ -56,6 +56,8 @@
 #include "call_system.hpp"
 #include "event_manager.hpp"
 #include "event_handler.hpp"
+#include "texture_cache.hpp"
+#include "texture_streamer.hpp"
 #include "spacecrafter.hpp"
 
 EventManager* EventManager::instance = nullptr;
@@ -131,6 +133,8 @@ App::~App()
 	delete internalClock;
 	delete screenFader;
 	delete spaceDate;
+	s_texture::setStreamer(nullptr);
+	delete texStreamer;
 }
 
 void App::quit(void)
@@ -252,6 +256,7 @@ void App::init(void)
 
 	internalClock->setMaxFps(conf.getDouble ("video","maximum_fps"));
 	internalClock->setScriptFps(conf.getDouble ("video","script_fps"));
+	scriptMgr->setFrameBudget(conf.getDouble("main","script_frame_budget"));
 
 	string appLocaleName = conf.getStr("localization", "app_locale"); //, "system");
 	spaceDate->setTimeFormat(spaceDate->stringToSTimeFormat(conf.getStr("localization:time_display_format")));
@@ -341,6 +346,11 @@ void App::init(void)
 			mkfifo->init(mkfifo_file_in, buffer_in_size);
 		}
 		#endif
+		// les textures chargées à partir d'ici n'arrêtent plus le rendu
+		texStreamer = new TextureStreamer();
+		s_texture::setStreamer(texStreamer);
+
+		Log.write(TextureCache::getStats(), cLog::LOG_TYPE::L_INFO);
 		Log.write(CallSystem::getRamInfo());
 		Log.mark();
 		Log.write("End of loading SC");
@@ -400,6 +410,8 @@ void App::update(int delta_time)
 
 	// run command from a running script
 	scriptMgr->update(delta_time);
+	if (scriptMgr->getFrameCommands() > 0)
+		pd.addMeasure("ScriptMgr::update", scriptMgr->getFrameCpuTime(), scriptMgr->getFrameWallTime());
 	if (!scriptMgr->isPaused() || !scriptMgr->isFaster() )	media->audioUpdate(delta_time);
 
 	// run any incoming command from shared memory interface
@@ -413,6 +425,9 @@ void App::update(int delta_time)
 	media->playerUpdate();
 	media->faderUpdate(delta_time);
 
+	if (texStreamer)
+		texStreamer->update();
+
 	core->updateMode();
 	//~ switch(statePosition) {
 		//~ case IN_SOLARSYSTEM :
@@ -61,6 +61,7 @@ class ServerSocket;
 class ScreenFader;
 class EventManager;
 class EventHandler;
+class TextureStreamer;
 
 /**
 @author Fabien Chereau
@@ -286,6 +287,7 @@ private:
 	#endif
 	ServerSocket * tcp = nullptr;
 	Clock* internalClock = nullptr;				//! getion fine du frameRate
+	TextureStreamer* texStreamer = nullptr;		//! chargement des textures en arrière-plan après le démarrage
 
 	SpaceDate * spaceDate = nullptr;			    //Handles dates and conversions
 	EventManager *eventManager = nullptr;
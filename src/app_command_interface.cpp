@@ -47,6 +47,7 @@
 #include "call_system.hpp"
 #include "media.hpp"
 #include "ui.hpp"
+#include "script.hpp"
 
 using namespace std;
 
@@ -61,7 +62,8 @@ AppCommandInterface::AppCommandInterface(Core * core, CoreIO* _coreIO, App * app
 	swapIfCommand = false;
 	max_random = 1.0;
 	min_random = 0.0;
-	initialiseCommandsName();
+	if (m_commands.empty())
+		initialiseCommandsName();
 	initialiseFlagsName();
 }
 
@@ -158,8 +160,23 @@ void AppCommandInterface::initialiseFlagsName()
 }
 
 
+std::map<const std::string, AppCommandInterface::LC_COMMAND> AppCommandInterface::m_commands;
+
+int AppCommandInterface::getCommandId(const std::string &name)
+{
+	if (m_commands.empty())
+		initialiseCommandsName();
+
+	std::map<const std::string, LC_COMMAND>::const_iterator it = m_commands.find(name);
+	if (it == m_commands.end())
+		return -1;
+	return static_cast<int>(it->second);
+}
+
 void AppCommandInterface::initialiseCommandsName()
 {
+	m_commands["comment"] = LC_COMMAND::LC_COMMENT;
+	m_commands["uncomment"] = LC_COMMAND::LC_UNCOMMENT;
 	m_commands["add"] = LC_COMMAND::LC_ADD;
 	m_commands["audio"] = LC_COMMAND::LC_AUDIO;
 	m_commands["body_trace"] = LC_COMMAND::LC_BODY_TRACE;
@@ -250,46 +267,6 @@ bool AppCommandInterface::isFalse(const string &a)
 		return false;
 }
 
-int AppCommandInterface::parseCommand(const std::string &command_line, string &command, stringHash_t &arguments)
-{
-	istringstream commandstr( command_line );
-	string key, value, temp;
-	char nextc;
-
-	commandstr >> command;
-	transform(command.begin(), command.end(), command.begin(), ::tolower);
-
-	while (commandstr >> key >> value ) {
-		if (value[0] == '"') {
-			// pull in all text inside quotes
-			if (value[value.length()-1] == '"') {
-				// one word in quotes
-				value = value.substr(1, value.length() -2 );
-			} else {
-				// multiple words in quotes
-				value = value.substr(1, value.length() -1 );
-
-				while (1) {
-					nextc = commandstr.get();
-					if ( nextc == '"' || !commandstr.good()) break;
-					value.push_back( nextc );
-				}
-			}
-		}
-		transform(key.begin(), key.end(), key.begin(), ::tolower);
-		arguments[key] = value;
-	}
-
-	#ifdef PARSE_DEBUG
-	Log.write("Command: " + command + "Argument hash:", cLog::LOG_TYPE::L_DEBUG);
-	for ( stringHashIter_t iter = arguments.begin(); iter != arguments.end(); ++iter ) {
-		Log.write("\t" + iter->first + " : " + iter->second,, cLog::LOG_TYPE::L_DEBUG);
-	}
-	#endif
-	return 1;  // no error checking yet
-}
-
-
 int AppCommandInterface::executeCommand(const string &commandline )
 {
 	unsigned long int delay;
@@ -322,17 +299,21 @@ int AppCommandInterface::executeIcommand(const string &command, int arg)
 
 //! @brief called by script executors and transform a string to instruction
 int AppCommandInterface::executeCommand(const string &_commandline, unsigned long int &wait)
+{
+	return executeCommand(Token(_commandline, ""), wait);
+}
+
+//! @brief called by script executors with a line parsed when the script was loaded
+int AppCommandInterface::executeCommand(const Token &token, unsigned long int &wait)
 {
 	recordable = 1;  // true if command should be recorded (if recording)
 	debug_message.clear(); // initialise to empty
 	wait = 0;  // default, no wait between commands
-	commandline = _commandline;
-
-	command.clear(); // = ""; //vide l'ancienne valeur de args
-	args.clear(); //vide les anciennes valeurs de args //TODO A VERIFIER
+	commandline = token.getToken();
 
-	// on réécrit toute la ligne proprement sans majuscule minuscule
-	parseCommand(commandline, command, args);
+	// la ligne a été réécrite proprement sans majuscule minuscule au chargement
+	command = token.getCommand();
+	args = token.getArgs();
 
 	FilePath::fixScriptPath(stapp->scriptMgr->getScriptPath());
 
@@ -345,13 +326,15 @@ int AppCommandInterface::executeCommand(const string &_commandline, unsigned lon
 	//                                                 //
 	// application specific logic to run each command  //
 	//                                                 //
-	if (command =="comment")
+	LC_COMMAND commandId = static_cast<LC_COMMAND>(token.getCommandId());
+
+	if (commandId == LC_COMMAND::LC_COMMENT)
 		return commandComment();
 
-	if (command =="uncomment")
+	if (commandId == LC_COMMAND::LC_UNCOMMENT)
 		return commandUncomment();
 
-	if (command =="struct")
+	if (commandId == LC_COMMAND::LC_STRUCT)
 		return commandStruct();
 
 	if (swapCommand== true || swapIfCommand==true) {	 // on n'execute pas les commandes qui suivent
@@ -359,15 +342,14 @@ int AppCommandInterface::executeCommand(const string &_commandline, unsigned lon
 		return 1;
 	}
 
-	m_commands_it = m_commands.find(command);
-	if (m_commands_it == m_commands.end()) {
+	if (token.getCommandId() < 0) {
 		//~ cout <<"error command "<< command << endl;
 		debug_message = _("Unrecognized or malformed command name");
 		Log.write( debug_message,cLog::LOG_TYPE::L_DEBUG, cLog::cLog::LOG_FILE::SCRIPT );
 		return 0;
 	}
 
-	switch(m_commands_it->second) {
+	switch(commandId) {
 		case LC_COMMAND::LC_ADD : 	return commandAdd(); break;
 		case LC_COMMAND::LC_AUDIO : 	return commandAudio(); break;
 		case LC_COMMAND::LC_BODY_TRACE :	return commandBodyTrace();  break;
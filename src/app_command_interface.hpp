@@ -39,6 +39,7 @@ class CoreIO;
 class App;
 class ScriptMgr;
 class Media;
+class Token;
 
 class AppCommandInterface {
 
@@ -50,11 +51,16 @@ public:
 
 	int executeCommand(const std::string &commandline);
 	int executeCommand(const std::string &command, unsigned long int &wait);
+	//! exécute une ligne de script déjà analysée
+	int executeCommand(const Token &token, unsigned long int &wait);
 	int executeIcommand(const std::string &command, double arg);
 	int executeIcommand(const std::string &command, int arg);
 	bool setFlag(const std::string &name, const std::string &value, bool &newval);
 	std::string getErrorString();
 
+	//! identifiant de la commande name (en minuscules), négatif si elle n'existe pas
+	static int getCommandId(const std::string &name);
+
 protected:
 	//all different command
 	int commandAdd();
@@ -118,7 +124,7 @@ private:
 	stringHash_t args;
 
 	//liste de toutes les commandes
-	enum class LC_COMMAND : char {LC_ADD, LC_AUDIO, LC_BODY_TRACE, LC_BODY, LC_CAMERA, LC_CLEAR, LC_COLOR, LC_CONFIGURATION, LC_CONSTELLATION, LC_DATE, LC_DEFINE, LC_DESELECT,
+	enum class LC_COMMAND : char {LC_COMMENT, LC_UNCOMMENT, LC_ADD, LC_AUDIO, LC_BODY_TRACE, LC_BODY, LC_CAMERA, LC_CLEAR, LC_COLOR, LC_CONFIGURATION, LC_CONSTELLATION, LC_DATE, LC_DEFINE, LC_DESELECT,
 								  LC_DOMEMASTERS,
 	                              LC_DSO, LC_EXERNALC_MPLAYER, LC_EXTERNALC_VIEWER, LC_FLAG, LC_GET, LC_ILLUMINATE, LC_IMAGE, LC_LANDSCAPE, LC_LOOK, LC_MEDIA, LC_METEORS,
 	                              LC_MOVETO, LC_MOVETOCITY, LC_MULTIPLIER, LC_MULTIPLY, LC_PERSONAL, LC_PERSONEQ, LC_PLANET_SCALE, LC_POSITION, LC_PRINT, LC_RANDOM,
@@ -154,14 +160,13 @@ private:
 	bool isTrue(const std::string &a);
 
 	std::string debug_message;  //!< for 'executeCommand' error details
-	int parseCommand(const std::string &command_line, std::string &command, stringHash_t &arguments);
 	int executeCommandStatus();
 
 	double evalDouble(const std::string &var);
 	int evalInt (const std::string &var);//cyp
 	std::string evalString (const std::string &var);//cyp
 
-	void initialiseCommandsName();
+	static void initialiseCommandsName();
 	void initialiseFlagsName();
 
 
@@ -174,8 +179,7 @@ private:
 	std::map<const std::string, std::string> variables;
 	std::map<const std::string, std::string>::iterator var_it;
 	//map assurant la transcription entre le texte et la commande associée
-	std::map<const std::string, LC_COMMAND> m_commands;
-	std::map<const std::string, LC_COMMAND>::iterator m_commands_it;
+	static std::map<const std::string, LC_COMMAND> m_commands;
 	//map assurant la transcription entre le texte et le flag associé
 	std::map<const std::string, FLAG_NAMES> m_flags;
 	std::map<const std::string, FLAG_NAMES>::iterator m_flag_it;
@@ -255,6 +255,15 @@ const std::string AppSettings::getVR360Dir(void) const
 	#endif
 }
 
+const std::string AppSettings::getCacheDir(void) const
+{
+	#ifdef LINUX
+	return getUserDir() + REP_CACHE + "/";
+	#else
+	return getUserDir()  + REP_CACHE + "\\";
+	#endif
+}
+
 const std::string AppSettings::getFtpDir(void) const
 {
 	#ifdef LINUX
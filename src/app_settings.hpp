@@ -123,6 +123,9 @@ public:
 	//! Get the fullname of the directory containing the VR360 user
 	const std::string getVR360Dir(void) const;
 
+	//! Get the fullname of the directory containing the cached data (decoded textures)
+	const std::string getCacheDir(void) const;
+
 	//! Get the fullname of the directory containing the picture user
 	const std::string getPictureDir(void) const;
 
@@ -27,7 +27,10 @@
 //	the sky is computed with the Skylight class.
 
 #include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
 #include <string>
+#include <thread>
 #include "atmosphere.hpp"
 // #include "spacecrafter.hpp"
 #include "utility.hpp"
@@ -37,34 +40,47 @@
 #include "fmath.hpp"
 #include "space_date.hpp"
 #include "event_manager.hpp"
+#include "perf_debug.hpp"
+#include "frame_scheduler.hpp"
 
 
 #define SKY_RESOLUTION 48
 
 #define NB_LUM ((SKY_RESOLUTION+1) * (SKY_RESOLUTION+1))
 
+// in incremental mode, the colors are computed again when the sun, the moon or the moon phase
+// have moved by more than this angle in radian since the last computation
+#define SKY_ANGLE_THRESHOLD 2e-4
+// or when an eye adaptation luminance has changed by more than this ratio
+#define SKY_ADAPTATION_THRESHOLD 0.01
+
 
 
 using namespace std;
 
-Atmosphere::Atmosphere() : /*tab_sky(NULL),*/ world_adaptation_luminance(0.f), atm_intensity(0),
-	lightPollutionLuminance(0), cor_optoma(0)
+Atmosphere::Atmosphere(FrameScheduler *_scheduler) : /*tab_sky(NULL),*/ scheduler(_scheduler), world_adaptation_luminance(0.f),
+	atm_intensity(0), lightPollutionLuminance(0), cor_optoma(0)
 {
-	// Create the vector array used to store the sky color on the full field of view
-	tab_sky = new Vec3f*[SKY_RESOLUTION+1];
-	for (int k=0; k<SKY_RESOLUTION+1 ; k++) {
-		tab_sky[k] = new Vec3f[SKY_RESOLUTION+1];
-	}
+	// Create the arrays used to store the sky color on the full field of view
+	gridX.resize(NB_LUM);
+	gridY.resize(NB_LUM);
+	gridZ.resize(NB_LUM);
+	cosMoon.resize(NB_LUM);
+	cosSun.resize(NB_LUM);
+	colorR.resize(NB_LUM);
+	colorG.resize(NB_LUM);
+	colorB.resize(NB_LUM);
+	dataColor.resize(SKY_RESOLUTION*(SKY_RESOLUTION+1)*2*3);
+
+	// the thread calling computeColor computes its part too
+	nbParts = scheduler->getNbWorkers() + 1;
+
 	setFaderDuration(0.f);
 	createShader();
 }
 
 Atmosphere::~Atmosphere()
 {
-	for (int k=0; k<SKY_RESOLUTION+1 ; k++) {
-		if (tab_sky[k]) delete [] tab_sky[k];
-	}
-	if (tab_sky) delete [] tab_sky;
 	dataColor.clear();
 	dataPos.clear();
 	deleteShader();
@@ -84,6 +100,7 @@ void Atmosphere::initGridViewport(const Projector *prj)
 	stepY = (float)prj->getViewportHeight() / SKY_RESOLUTION;
 	viewport_left = (float)prj->getViewportPosX();
 	viewport_bottom = (float)prj->getViewportPosY();
+	gridChanged = true;
 }
 
 //initialise la grille des points pour le calcul de l'atmosphere
@@ -116,6 +133,10 @@ void Atmosphere::createShader()
 	glBindVertexArray(atmosphere.vao);
 	glBindBuffer (GL_ARRAY_BUFFER, atmosphere.pos);
 	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
+	// the colors are only uploaded when they change, with glBufferSubData
+	glBindBuffer (GL_ARRAY_BUFFER, atmosphere.color);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*dataColor.size(),NULL,GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,0,NULL);
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
@@ -138,17 +159,22 @@ void Atmosphere::computeColor(double JD, Vec3d sunPos, Vec3d moonPos, float moon
 {
 	float min_mw_lum = 0.13;
 
+	recomputed = false;
+
 	// no need to calculate if not visible
 	if (!fader.getInterstate()) {
 		atm_intensity = 0;
 		world_adaptation_luminance = 3.75f + lightPollutionLuminance;
 		milkyway_adaptation_luminance = min_mw_lum;  // brighter than without atm, since no drawing addition of atm brightness
+		computeWallTime = 0;
+		computeCpuTime = 0;
 		return;
 	} else {
 		atm_intensity = fader.getInterstate();
 	}
 
-	skylight_struct2 b2;
+	const std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	const unsigned long long cpuStart = PerformanceDebugger::threadCpuTime();
 
 	// these are for radii
 	double sun_angular_size = atan(696000./AU/sunPos.length());
@@ -190,73 +216,159 @@ void Atmosphere::computeColor(double JD, Vec3d sunPos, Vec3d moonPos, float moon
 	moon_pos[1] = moonPos[1];
 	moon_pos[2] = moonPos[2];
 
-	sky.setParamsv(sun_pos, 5.f, planetName);
-
-	skyb.setLoc(latitude * C_PI/180., altitude, temperature, relative_humidity);
-	skyb.setSunMoon(moon_pos[2], sun_pos[2], cor_optoma);
+	const float turbidity = 5.f;
 
 	// Calculate the date from the julian day.
 	ln_date date;
 	SpaceDate::JulianToDate(JD, &date);
 
-	skyb.setDate(date.years, date.months, moon_phase);
+	SkyState state;
+	state.sunPos = sunPos;
+	state.moonPos = moonPos;
+	state.moonPhase = moon_phase;
+	state.turbidity = turbidity;
+	state.worldAdaptation = eye->getWorldAdaptationLuminance();
+	state.displayAdaptation = eye->getDisplayAdaptationLuminance();
+	state.latitude = latitude;
+	state.altitude = altitude;
+	state.temperature = temperature;
+	state.relativeHumidity = relative_humidity;
+	state.year = date.years;
+	state.month = date.months;
+	state.optoma = cor_optoma;
+	state.planetName = planetName;
+	state.localToEye = prj->getMatLocalToEye();
+	state.fov = prj->getFov();
+
+	// the atmosphere intensity is applied when the colors are uploaded, so that
+	// a fade or an eclipse alone doesn't need a new computation of the grid
+	unsigned long long partsCpuTime = 0;
+	if (!flagIncremental || gridChanged || !isSameSky(state, lastState)) {
+		sky.setParamsv(sun_pos, turbidity, planetName);
+
+		skyb.setLoc(latitude * C_PI/180., altitude, temperature, relative_humidity);
+		skyb.setSunMoon(moon_pos[2], sun_pos[2], cor_optoma);
+		skyb.setDate(date.years, date.months, moon_phase);
+
+		// Compute the sky color for every point of the grid, by contiguous parts
+		std::vector<double> partSumLum(nbParts, 0.);
+		// the CPU time of this thread already counts the parts it computed itself
+		std::vector<unsigned long long> partCpuTime(nbParts, 0);
+		const std::thread::id caller = std::this_thread::get_id();
+		scheduler->parallelFor(nbParts, [&](size_t p) {
+			const int begin = NB_LUM*p/nbParts;
+			const int end = NB_LUM*(p+1)/nbParts;
+			const unsigned long long start = PerformanceDebugger::threadCpuTime();
+			partSumLum[p] = computeGridPart(begin, end, sun_pos, moon_pos, eye, prj);
+			if (std::this_thread::get_id() != caller)
+				partCpuTime[p] = PerformanceDebugger::threadCpuTime() - start;
+		});
+
+		// Variables used to compute the average sky luminance, summed in the order of the parts
+		double sum_lum = 0.;
+		for (unsigned int p=0; p<nbParts; p++) {
+			sum_lum += partSumLum[p];
+			partsCpuTime += partCpuTime[p];
+		}
+
+		lastSumLum = sum_lum;
+		lastState = state;
+		gridChanged = false;
+		recomputed = true;
+		colorChanged = true;
+	}
+
+	world_adaptation_luminance = 3.75f + lightPollutionLuminance + 3.5*lastSumLum/NB_LUM*atm_intensity;
+	milkyway_adaptation_luminance = min_mw_lum*(1-atm_intensity) + 30*lastSumLum/NB_LUM*atm_intensity;
 
+	computeCpuTime = PerformanceDebugger::threadCpuTime() - cpuStart + partsCpuTime;
+	computeWallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count();
+}
+
+double Atmosphere::computeGridPart(int begin, int end, const float* sun_pos, const float* moon_pos,
+                                   const ToneReproductor* eye, const Projector* prj)
+{
 	Vec3d point(1., 0., 0.);
 
-	// Variables used to compute the average sky luminance
-	double sum_lum = 0.;
+	for (int i=begin; i<end; i++) {
+		const int x = i / (SKY_RESOLUTION+1);
+		const int y = i % (SKY_RESOLUTION+1);
+		prj->unprojectLocal((double)viewport_left+x*stepX, (double)viewport_bottom+y*stepY,point);
+		point.normalize();
+
+		// The sky below the ground is the symetric of the one above :
+		// it looks nice and gives proper values for brightness estimation
+		gridX[i] = point[0];
+		gridY[i] = point[1];
+		gridZ[i] = fabs(point[2]);
+	}
 
-	// Compute the sky color for every point above the ground
-	for (int x=0; x<SKY_RESOLUTION+1; x++) {
-		for (int y=0; y<SKY_RESOLUTION+1; y++) {
-			prj->unprojectLocal((double)viewport_left+x*stepX, (double)viewport_bottom+y*stepY,point);
-			point.normalize();
-
-			if (point[2]<=0) {
-				point[2] = -point[2];
-				// The sky below the ground is the symetric of the one above :
-				// it looks nice and gives proper values for brightness estimation
-			}
-
-			b2.pos[0] = point[0];
-			b2.pos[1] = point[1];
-			b2.pos[2] = point[2];
-
-			// Use the Skylight model for the color
-			sky.get_xyY_Valuev(b2);
-
-			// Use the Skybright.cpp 's models for brightness which gives better results.
-			b2.color[2] = skyb.getLuminance(moon_pos[0]*b2.pos[0]+moon_pos[1]*b2.pos[1]+
-			                                 moon_pos[2]*b2.pos[2], sun_pos[0]*b2.pos[0]+sun_pos[1]*b2.pos[1]+
-			                                 sun_pos[2]*b2.pos[2], b2.pos[2],cor_optoma);
-
-			sum_lum+=b2.color[2];
-			eye->xyY_to_RGB(b2.color);
-			tab_sky[x][y].set(atm_intensity*b2.color[0],atm_intensity*b2.color[1],atm_intensity*b2.color[2]);
-		}
+	for (int i=begin; i<end; i++) {
+		cosMoon[i] = moon_pos[0]*gridX[i] + moon_pos[1]*gridY[i] + moon_pos[2]*gridZ[i];
+		cosSun[i] = sun_pos[0]*gridX[i] + sun_pos[1]*gridY[i] + sun_pos[2]*gridZ[i];
+	}
+
+	const int n = end - begin;
+	// Use the Skylight model for the color
+	sky.get_xyY_Valuesv(&gridX[begin], &gridY[begin], &gridZ[begin], &colorR[begin], &colorG[begin], &colorB[begin], n);
+	// Use the Skybright.cpp 's models for brightness which gives better results.
+	skyb.getLuminances(&cosMoon[begin], &cosSun[begin], &gridZ[begin], &colorB[begin], n, cor_optoma);
+
+	double sum_lum = 0.;
+	float color[3];
+	for (int i=begin; i<end; i++) {
+		sum_lum += colorB[i];
+		color[0] = colorR[i];
+		color[1] = colorG[i];
+		color[2] = colorB[i];
+		eye->xyY_to_RGB(color);
+		colorR[i] = color[0];
+		colorG[i] = color[1];
+		colorB[i] = color[2];
 	}
+	return sum_lum;
+}
 
-	world_adaptation_luminance = 3.75f + lightPollutionLuminance + 3.5*sum_lum/NB_LUM*atm_intensity;
-	milkyway_adaptation_luminance = min_mw_lum*(1-atm_intensity) + 30*sum_lum/NB_LUM*atm_intensity;
-	sum_lum = 0.f;
+bool Atmosphere::isSameSky(const SkyState &state, const SkyState &lastState)
+{
+	// the view moved : the grid points to other directions
+	if (state.fov != lastState.fov ||
+	        !std::equal(state.localToEye.r, state.localToEye.r+16, lastState.localToEye.r))
+		return false;
+
+	if (state.planetName != lastState.planetName || state.optoma != lastState.optoma ||
+	        state.year != lastState.year || state.month != lastState.month ||
+	        state.latitude != lastState.latitude || state.altitude != lastState.altitude ||
+	        state.temperature != lastState.temperature || state.relativeHumidity != lastState.relativeHumidity ||
+	        state.turbidity != lastState.turbidity)
+		return false;
+
+	const double cos_threshold = cos(SKY_ANGLE_THRESHOLD);
+	if (state.sunPos.dot(lastState.sunPos) < cos_threshold || state.moonPos.dot(lastState.moonPos) < cos_threshold ||
+	        fabs(state.moonPhase - lastState.moonPhase) > SKY_ANGLE_THRESHOLD)
+		return false;
+
+	if (fabs(state.worldAdaptation - lastState.worldAdaptation) > SKY_ADAPTATION_THRESHOLD*lastState.worldAdaptation ||
+	        fabs(state.displayAdaptation - lastState.displayAdaptation) > SKY_ADAPTATION_THRESHOLD*lastState.displayAdaptation)
+		return false;
+
+	return true;
 }
 
 
+
 void Atmosphere::fillOutDataColor()
 {
-	dataColor.clear();
+	int k = 0;
 	for (int y=0; y<SKY_RESOLUTION; y++) {
 		for (int x=0; x<SKY_RESOLUTION+1; x++) {
-			dataColor.push_back(tab_sky[x][y][0]);
-			dataColor.push_back(tab_sky[x][y][1]);
-			dataColor.push_back(tab_sky[x][y][2]);
-			//~ glColor3fv(tab_sky[x][y]);
-			//~ glVertexi((int)(viewport_left+x*stepX),(int)(view_bottom+y*stepY));
-			dataColor.push_back(tab_sky[x][y+1][0]);
-			dataColor.push_back(tab_sky[x][y+1][1]);
-			dataColor.push_back(tab_sky[x][y+1][2]);
-			//~ glColor3fv(tab_sky[x][y+1]);
-			//~ glVertexi((int)(viewport_left+x*stepX),(int)(view_bottom+(y+1)*stepY));
+			const int i = x*(SKY_RESOLUTION+1)+y;
+			dataColor[k++] = atm_intensity*colorR[i];
+			dataColor[k++] = atm_intensity*colorG[i];
+			dataColor[k++] = atm_intensity*colorB[i];
+			dataColor[k++] = atm_intensity*colorR[i+1];
+			dataColor[k++] = atm_intensity*colorG[i+1];
+			dataColor[k++] = atm_intensity*colorB[i+1];
 		}
 	}
 }
@@ -268,12 +380,15 @@ void Atmosphere::draw(const Projector* prj, const std::string &planetName)
 
 	StateGL::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
 
-	fillOutDataColor();
+	if (colorChanged || atm_intensity != uploadedIntensity) {
+		fillOutDataColor();
+		glBindBuffer (GL_ARRAY_BUFFER, atmosphere.color);
+		glBufferSubData(GL_ARRAY_BUFFER,0,sizeof(float)*dataColor.size(),dataColor.data());
+		colorChanged = false;
+		uploadedIntensity = atm_intensity;
+	}
 
 	glBindVertexArray(atmosphere.vao);
-	glBindBuffer (GL_ARRAY_BUFFER, atmosphere.color);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*dataColor.size(),dataColor.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,0,NULL);
 	StateGL::enable(GL_BLEND);
 
 	shaderAtmosphere->use();
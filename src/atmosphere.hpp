@@ -26,10 +26,15 @@
 //! @class Atmosphere
 //!	@brief Class which compute and display the daylight sky color using openGL
 //!	sky is computed with the Skylight class.
+//!
+//!	The colors of the grid vertices are stored as separate arrays (structure of arrays)
+//!	and computed by parts on the threads of the FrameScheduler. In incremental mode, the colors are only
+//!	computed again when the sky has changed enough since their last computation.
 
 #ifndef _ATMOSTPHERE_H_
 #define _ATMOSTPHERE_H_
 
+#include <string>
 #include <vector>
 #include "skylight.hpp"
 #include "vecmath.hpp"
@@ -42,10 +47,12 @@
 class Projector;
 class Navigator;
 class ToneReproductor;
+class FrameScheduler;
 
 class Atmosphere {
 public:
-	Atmosphere();
+	//! \param scheduler fournit les threads du calcul des couleurs
+	Atmosphere(FrameScheduler *scheduler);
 	virtual ~Atmosphere();
 	Atmosphere(Atmosphere const &) = delete;
 	Atmosphere& operator = (Atmosphere const &) = delete;
@@ -122,6 +129,31 @@ public:
 		return lightPollutionLuminance;
 	}
 
+	//! Define whether the colors are only computed again when the sky has changed enough
+	void setFlagIncremental(bool b) {
+		flagIncremental = b;
+	}
+
+	//! Get whether the colors are only computed again when the sky has changed enough
+	bool getFlagIncremental() const {
+		return flagIncremental;
+	}
+
+	//! tells you if the last computeColor computed the colors of the grid again
+	bool getFlagRecomputed() const {
+		return recomputed;
+	}
+
+	//! wall time of the last computeColor in microseconds
+	unsigned long long getComputeWallTime() const {
+		return computeWallTime;
+	}
+
+	//! CPU time of the last computeColor in microseconds, summed over all the threads
+	unsigned long long getComputeCpuTime() const {
+		return computeCpuTime;
+	}
+
 	//! construit la grille d'affichage des points pour les shaders
 	void initGridPos();
 
@@ -129,6 +161,33 @@ public:
 	void initGridViewport(const Projector *prj);
 
 private:
+	//! parameters the colors of the grid depend on
+	struct SkyState {
+		Vec3d sunPos;
+		Vec3d moonPos;
+		float moonPhase;
+		float turbidity;
+		float worldAdaptation;
+		float displayAdaptation;
+		float latitude;
+		float altitude;
+		float temperature;
+		float relativeHumidity;
+		int year;
+		int month;
+		int optoma;
+		std::string planetName;
+		Mat4f localToEye;
+		double fov;
+	};
+
+	//! tells if the colors computed for lastState can be kept for state
+	static bool isSameSky(const SkyState &state, const SkyState &lastState);
+
+	//! compute the colors of the grid vertices [begin,end[ and return the sum of their luminances
+	double computeGridPart(int begin, int end, const float* sun_pos, const float* moon_pos,
+	                       const ToneReproductor* eye, const Projector* prj);
+
 	//! initialise les paramètres du shader
 	void createShader();
 	//! remplir les couleurs du conteneur
@@ -137,7 +196,26 @@ private:
 
 	Skylight sky;
 	Skybright skyb;
-	Vec3f ** tab_sky=nullptr;	//!< For Atmosphere calculation
+
+	// direction of each grid vertex in local coordinates, index x*(SKY_RESOLUTION+1)+y
+	std::vector<float> gridX, gridY, gridZ;
+	// cosine of the angular distance from each vertex to the moon and to the sun
+	std::vector<float> cosMoon, cosSun;
+	// color of each vertex : xyY, then RGB once converted by the eye
+	std::vector<float> colorR, colorG, colorB;
+
+	FrameScheduler *scheduler = nullptr;
+	unsigned int nbParts = 1;
+
+	bool flagIncremental = true;
+	bool gridChanged = true;	//!< the grid must be computed again whatever the sky
+	SkyState lastState;			//!< sky of the last computation of the colors
+	double lastSumLum = 0.;		//!< sum of the luminances of the last computation
+	bool recomputed = false;
+	unsigned long long computeWallTime = 0;
+	unsigned long long computeCpuTime = 0;
+	bool colorChanged = true;	//!< the color buffer must be uploaded again
+	float uploadedIntensity = -1.f;
 
 	float world_adaptation_luminance;
 	float milkyway_adaptation_luminance;
@@ -43,6 +43,7 @@
 #include "hints.hpp"
 #include "axis.hpp"
 #include "halo.hpp"
+#include "halo_batch.hpp"
 #include "orbit_plot.hpp"
 // #include "atmosphere_ext.hpp"
 #include "s_font.hpp"
@@ -462,6 +463,8 @@ void Body::createShader()
 
 	Halo::createShader();
 
+	HaloBatch::createShader();
+
 	Hints::createShader();
 
 	Axis::createShader();
@@ -485,6 +488,8 @@ void Body::deleteShader()
 
 	Halo::deleteShader();
 
+	HaloBatch::deleteShader();
+
 	Hints::deleteShader();
 
 	Axis::deleteShader();
@@ -780,8 +785,6 @@ void Body::compute_position(const double date)
 	//~ else {
 */
 
-		OsculatingFunctionType *oscFunc = orbit->getOsculatingFunction();
-
 		if(orbitPlot != nullptr && flags.flag_orbit==true){
 			orbitPlot->init();
 			orbitPlot->computeOrbit(date);
@@ -791,10 +794,7 @@ void Body::compute_position(const double date)
 		delta = fabs(delta);
 
 		if(delta >= deltaJD ) {
-			if(oscFunc) 
-				(*oscFunc)(date,date,ecliptic_pos);
-			else 
-				orbit->positionAtTimevInVSOP87Coordinates(date,date,ecliptic_pos);
+			orbit->positionAtTimevInVSOP87Coordinates(date,date,ecliptic_pos);
 
 			lastJD = date;
 		}
@@ -1339,6 +1339,32 @@ void Body::drawAtmExt(const Projector* prj, const Navigator* nav, const Observer
 	// atmExt->unuse();
 }
 
+bool Body::computeDrawPoint(const Projector* prj, const Navigator* nav)
+{
+	// même seuil que isVisibleOnScreen : en dessous, drawBody n'est pas appelé
+	float size = getOnScreenSize(prj, nav);
+	if (size > POINT_SIZE_LIMIT)
+		return false;
+
+	screen_sz = size;
+	// la position héliocentrique suffit, sans la chaîne des matrices de computeDraw
+	isVisible = prj->projectCustom(get_heliocentric_ecliptic_pos(), screenPos, nav->getHelioToEyeMat())
+	            && prj->checkInMask(screenPos, (int)(screen_sz/2));
+	ang_dist = 300.f*atan(get_ecliptic_pos().length()/getEarthEquPos(nav).length())/prj->getFov();
+	return true;
+}
+
+void Body::addToBatch(const Navigator* nav, const Projector* prj, const Observer* observatory, const ToneReproductor* eye, bool drawHomePlanet, HaloBatch &batch)
+{
+	if (skipDrawingThisBody(observatory, drawHomePlanet))
+		return;
+
+	handleVisibilityFader(observatory, prj, nav);
+
+	if (isVisible && flags.flag_halo)
+		halo->addToBatch(nav, prj, eye, batch);
+}
+
 bool Body::skipDrawingThisBody(const Observer* observatory, bool drawHomePlanet)
 {
 	//~ if(hidden)
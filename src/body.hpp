@@ -54,6 +54,7 @@ class Axis;
 class Orbit2D;
 class Orbit3D;
 class Halo;
+class HaloBatch;
 class s_font;
 class Translator;
 class ToneReproductor;
@@ -189,6 +190,21 @@ public:
 	// Return the squared distance in pixels between the current and the  previous position this Body was drawn at.
 	virtual bool drawGL(Projector* prj, const Navigator* nav, const Observer* observatory, const ToneReproductor* eye, bool depthTest, bool drawHomePlanet, bool selected);
 
+	// vrai si le corps n'a rien d'autre que son halo à dessiner quand il est trop petit à l'écran
+	virtual bool canBeBatched() const {
+		return false;
+	}
+
+	// version allégée de computeDraw pour un corps réduit à un point : seule sa position à l'écran est calculée.
+	// Renvoie faux sans rien calculer si le corps dépasse POINT_SIZE_LIMIT pixels
+	bool computeDrawPoint(const Projector* prj, const Navigator* nav);
+
+	// ajoute au lot le halo d'un corps préparé par computeDrawPoint
+	void addToBatch(const Navigator* nav, const Projector* prj, const Observer* observatory, const ToneReproductor* eye, bool drawHomePlanet, HaloBatch &batch);
+
+	//! taille à l'écran en pixels jusqu'à laquelle un corps est dessiné par son seul halo
+	static constexpr float POINT_SIZE_LIMIT = 1.f;
+
 	// Set the orbital elements
 	void set_rotation_elements(float _period, float _offset, double _epoch, float _obliquity, float _ascendingNode, float _precessionRate, double _sidereal_period, float _axial_tilt);
 
@@ -77,6 +77,8 @@ Body(parent,
 Artificial::~Artificial()
 {
 	if (obj3D) delete obj3D;
+	if (orbitPlot) delete orbitPlot;
+	orbitPlot = nullptr;
 }
 
 void Artificial::selectShader ()
@@ -27,6 +27,7 @@
 #include "trail.hpp"
 #include "axis.hpp"
 #include "orbit_2d.hpp"
+#include "orbit_plot.hpp"
 #include "hints.hpp"
 #include "halo.hpp"
 #include "projector.hpp"
@@ -145,6 +146,11 @@ void SmallBody::drawGL(Projector* prj, const Navigator* nav, const Observer* obs
 	StateGL::disable(GL_DEPTH_TEST);
 }*/
 
+bool SmallBody::canBeBatched() const
+{
+	return satellites.empty() && !orbitPlot->isVisible() && !hints->isVisible() && (trail == nullptr || !trail->isVisible());
+}
+
 void SmallBody::drawBody(const Projector* prj, const Navigator * nav, const Mat4d& mat, float screen_sz)
 {
 	//~ AutoPerfDebug apd(&pd, "SmallBody::drawBody$"); //Debug
@@ -49,6 +49,9 @@ public:
 
 	virtual void selectShader ();
 
+	// ni orbite, ni traînée, ni nom, ni satellite à dessiner
+	virtual bool canBeBatched() const override;
+
 protected :
 	virtual void drawBody(const Projector* prj, const Navigator * nav, const Mat4d& mat, float screen_sz);
 };
@@ -42,6 +42,7 @@ BodyTrace::BodyTrace()
 {
 	for(int i= 0; i<NB_MAX_LIST; i++) {
 		bodyData[i].size=0;
+		bodyData[i].uploaded=0;
 		bodyData[i].old_punt[0]=0.0;
 		bodyData[i].old_punt[1]=0.0;
 		bodyData[i].color= Vec3f(1.f,0.f,0.f);
@@ -85,11 +86,6 @@ BodyTrace::BodyTrace()
 	//~ bodyData[6].color[1]=1.;
 	//~ bodyData[6].color[2]=0.4;
 
-	bodyData[7].color= Vec3f(0.4f, 1.0f, 0.6f);
-	//~ bodyData[7].color[0]=0.4;
-	//~ bodyData[7].color[1]=1.;
-	//~ bodyData[7].color[2]=0.6;
-
 	is_tracing=true;
 	currentUsedList=0;
 
@@ -116,16 +112,25 @@ void BodyTrace::createShader()
 {
 	shaderTrace = new shaderProgram();
 	shaderTrace->init("body_trace.vert","body_trace.geom","body_trace.frag");
-	shaderTrace->setUniformLocation("Color");
-	shaderTrace->setUniformLocation("Mat");
+	uniformMat = shaderTrace->setUniformLocation("Mat");
 
 	glGenVertexArrays(1,&trace.vao);
 	glBindVertexArray(trace.vao);
 
-	glGenBuffers(1,&trace.color);
+	// allocated once for all the lists, the points are then appended with glBufferSubData
 	glGenBuffers(1,&trace.pos);
+	glBindBuffer(GL_ARRAY_BUFFER,trace.pos);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*NB_MAX_LIST*MAX_POINTS, nullptr, GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glGenBuffers(1,&trace.color);
+	glBindBuffer(GL_ARRAY_BUFFER,trace.color);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*NB_MAX_LIST*MAX_POINTS, nullptr, GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,0,NULL);
+
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
+	glBindVertexArray(0);
 }
 
 void BodyTrace::deleteShader()
@@ -148,44 +153,50 @@ void BodyTrace::draw(const Projector *prj,const Navigator *nav)
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	shaderTrace->use();
-
-	for(int l=0; l<currentUsedList+1; l++) {
-
-		if (bodyData[l].size>2 && !bodyData[l].hide) {
-
-			for (int i=0; i < bodyData[l].size; i=i+1) {
+	glBindVertexArray(trace.vao);
 
-				//~ if ((prj->projectLocal(bodyData[l].punts[i], pt1)) && (prj->projectLocal(bodyData[l].punts[i+1], pt2)) ) {
-					vecVertex.push_back( bodyData[l].punts[i][0] );
-					vecVertex.push_back( bodyData[l].punts[i][1] );
-					vecVertex.push_back( bodyData[l].punts[i][2] );
-					//~ vecVertex.push_back( pt1[1] );
-					//~ vecVertex.push_back( pt2[0] );
-					//~ vecVertex.push_back( pt2[1] );
-				//~ }
-			}
+	GLint first[NB_MAX_LIST];
+	GLsizei count[NB_MAX_LIST];
+	int nbLists = 0;
 
-			//tracé en direct de la courbe de ci dessus
-			if( vecVertex.size() >=6 ) { // il faut au moins deux points pour le tracé
+	for(int l=0; l<currentUsedList+1; l++) {
+		BodyList &list = bodyData[l];
 
-				shaderTrace->setUniform("Color", bodyData[l].color );
-				shaderTrace->setUniform("Mat", prj->getMatLocalToEye() );
+		// only the points recorded since the last frame are sent
+		if (list.uploaded < list.size) {
+			const int offset = l*MAX_POINTS + list.uploaded;
+			const int nbNew = list.size - list.uploaded;
 
-				glBindVertexArray(trace.vao);
-				glBindBuffer(GL_ARRAY_BUFFER,trace.pos);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(float)*vecVertex.size(), vecVertex.data(), GL_DYNAMIC_DRAW);
-				glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+			glBindBuffer(GL_ARRAY_BUFFER,trace.pos);
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(float)*3*offset, sizeof(float)*3*nbNew, list.punts + list.uploaded);
 
-				glDrawArrays(GL_LINE_STRIP, 0, vecVertex.size()/3);
+			vecColor.clear();
+			for (int i=0; i < nbNew; i++) {
+				vecColor.push_back(list.color[0]);
+				vecColor.push_back(list.color[1]);
+				vecColor.push_back(list.color[2]);
 			}
+			glBindBuffer(GL_ARRAY_BUFFER,trace.color);
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(float)*3*offset, sizeof(float)*vecColor.size(), vecColor.data());
 
-			//suppression du contenu des data
-			vecVertex.clear();
+			list.uploaded = list.size;
+		}
 
+		if (list.size>2 && !list.hide) {
+			first[nbLists] = l*MAX_POINTS;
+			count[nbLists] = list.size;
+			nbLists++;
 		}
 	}
-	shaderTrace->unuse();
+
+	//tracé en direct de toutes les courbes en un seul appel
+	if (nbLists > 0) {
+		shaderTrace->use();
+		shaderTrace->setUniform(uniformMat, prj->getMatLocalToEye() );
+		glMultiDrawArrays(GL_LINE_STRIP, first, count, nbLists);
+		shaderTrace->unuse();
+	}
+	glBindVertexArray(0);
 }
 
 void BodyTrace::addData(const Navigator *nav, double alt, double az)
@@ -203,7 +214,7 @@ void BodyTrace::addData(const Navigator *nav, double alt, double az)
 		if (bodyData[currentUsedList].size==(MAX_POINTS-1)) return;
 		bodyData[currentUsedList].old_punt[0]=alt;
 		bodyData[currentUsedList].old_punt[1]=az;
-		bodyData[currentUsedList].size+=1;
 		Utility::spheToRect(-(az+C_PI),alt,bodyData[currentUsedList].punts[bodyData[currentUsedList].size]);
+		bodyData[currentUsedList].size+=1;
 	}
 }
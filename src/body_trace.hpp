@@ -45,6 +45,7 @@ public:
 	struct BodyList {
 		Vec3f color;
 		int size;
+		int uploaded;	// number of points already in the vertex buffer
 		Vec3f punts[MAX_POINTS];
 		Vec2f old_punt;
 		bool hide;
@@ -59,6 +60,8 @@ public:
 
 	void setColor(const Vec3f& c, int numberlist) {
 		bodyData[numberlist].color = c;
+		// the color is stored with each vertex: upload the whole list again
+		bodyData[numberlist].uploaded = 0;
 	}
 
 	const Vec3f& getColor( int numberlist) {
@@ -107,8 +110,10 @@ public:
 
 	void clear() {
 		currentUsedList=0;
-		for(int i= 0; i<NB_MAX_LIST; i++)
+		for(int i= 0; i<NB_MAX_LIST; i++) {
 			bodyData[i].size=0;
+			bodyData[i].uploaded=0;
+		}
 	}
 
 
@@ -124,10 +129,12 @@ protected :
 	void createShader();
 	void deleteShader();
 
-	std::vector<float> vecVertex;
+	std::vector<float> vecColor;
 
 	//shader for meteor's displaying
 	shaderProgram *shaderTrace;
+	UniformHandle uniformMat;
+	// all the lists share the same buffers, list l uses the vertices from l*MAX_POINTS
 	DataGL trace;
 };
 
@@ -132,6 +132,7 @@ void Cardinals::draw(const Projector* prj, double latitude, bool gravityON) cons
 		pos.set(0.685f, -0.715f, 0.13f);
 		if (prj->projectLocal(pos,xy)) prj->printGravity180(font, xy[0], xy[1], d[3], Color, 1.0, -shift, -shift);
 	}
+	font->flush();
 }
 
 
@@ -35,7 +35,10 @@ static void checkMainSettings(InitParser &user_conf)
 	mainSettings["flag_masterput"]="false";
 	mainSettings["flag_navigation"]="false";
 	mainSettings["flag_optoma"]="false";
+	mainSettings["flag_texture_cache"]="true";
 	mainSettings["script_debug"]="false";
+	mainSettings["script_frame_budget"]="4";
+	mainSettings["texture_cache_size"]="1024";
 	mainSettings["cpu_info"]="false";
 
 	for (std::map<std::string,std::string>::iterator it=mainSettings.begin(); it!=mainSettings.end(); ++it) {
@@ -313,6 +316,7 @@ static void checkViewingSettings(InitParser &user_conf)
 	std::map<std::string,std::string> viewingSettings;
 	viewingSettings["nebula_picto_size"] = "6";
 	viewingSettings["atmosphere_fade_duration"] = "2";
+	viewingSettings["flag_atmosphere_incremental"] = "true";
 	viewingSettings["flag_constellation_drawing"] = "false";
 	viewingSettings["flag_constellation_name"] = "false";
 	viewingSettings["flag_constellation_boundaries"] = "false";
@@ -418,6 +422,7 @@ static void checkAstroSettings(InitParser &user_conf)
 	astroSettings["max_mag_nebula_name"]="99";
 	astroSettings["flag_object_trails"]="false";
 	astroSettings["flag_light_travel_time"]="true";
+	astroSettings["flag_ephemeris_cache"]="true";
 	astroSettings["planet_size_marginal_limit"]="0";
 	astroSettings["star_size_limit"]="9";
 	astroSettings["meteor_rate"]="10";
@@ -48,14 +48,6 @@ Constellation::~Constellation()
 
 	if (art_tex) delete art_tex;
 	art_tex = nullptr;
-
-	while(!vecPos.empty()) {
-		vecPos.pop_back();
-	}
-
-	while(!vecTex.empty()) {
-		vecTex.pop_back();
-	}
 }
 
 //! Read Constellation data record and grab cartesian positions of stars
@@ -106,32 +98,18 @@ bool Constellation::read(const std::string& record, HipStarMgr * _VouteCeleste)
 }
 
 
-//! Draw the lines for the Constellation using the coords of the stars
+//! Append the segments of the Constellation to the static buffer of the lines
 //! (optimized for use thru the class ConstellationMgr only)
-void Constellation::drawLines(const Projector* prj, std::vector<float> &vLinesPos, std::vector<float> &vLinesColor)
+void Constellation::buildLines(std::vector<float> &pos)
 {
-	if (!line_fader.getInterstate()) return;
-
-	Vec3d star1;
-	Vec3d star2;
-
-	for (unsigned int i=0; i<nb_segments; ++i) {
-		if (prj->projectJ2000LineCheck( asterism[2*i]->getObsJ2000Pos(0),star1, asterism[2*i+1]->getObsJ2000Pos(0),star2)) {
-
-			vLinesPos.push_back(star1[0]);
-			vLinesPos.push_back(star1[1]);
-			vLinesColor.push_back(lineColor[0]);
-			vLinesColor.push_back(lineColor[1]);
-			vLinesColor.push_back(lineColor[2]);
-			vLinesColor.push_back(line_fader.getInterstate());
-			vLinesPos.push_back(star2[0]);
-			vLinesPos.push_back(star2[1]);
-			vLinesColor.push_back(lineColor[0]);
-			vLinesColor.push_back(lineColor[1]);
-			vLinesColor.push_back(lineColor[2]);
-			vLinesColor.push_back(line_fader.getInterstate());
-		}
+	linesFirst = pos.size()/3;
+	linesCount = 2*nb_segments;
+	for (unsigned int i=0; i<2*nb_segments; ++i) {
+		const Vec3d star = asterism[i]->getObsJ2000Pos(0);
+		pos.insert(pos.end(), {(float)star[0], (float)star[1], (float)star[2]});
 	}
+	// force the color to be written again
+	linesState = Vec4f(-1.f, -1.f, -1.f, -1.f);
 }
 
 
@@ -143,136 +121,30 @@ void Constellation::drawName(s_font *constfont, const Projector* prj) const
 	prj->printGravity180(constfont, XYname[0], XYname[1], nameI18, Color, 1, -constfont->getStrLen(nameI18)/2);
 }
 
-//! Draw the art texture, optimized function to be called thru a constellation manager only
-void Constellation::drawArt(const Projector* prj, const Navigator* nav, shaderProgram* &shaderArt, const DataGL &constellation)
+//! Append the art quads to the static buffer of the art, as lines adjacency
+//! (optimized for use thru the class ConstellationMgr only)
+void Constellation::buildArt(std::vector<float> &pos, std::vector<float> &tex)
 {
-	float intensity = art_fader.getInterstate();
-
-	vecPos.clear();
-	vecTex.clear();
-
-	if (art_tex && intensity) {
-		int tailleTab = 9;
-		// bool tabB[tailleTab];
-		std::vector<bool> tabB (tailleTab, false);
-
-		// Vec3d tabV[tailleTab];
-		std::vector<Vec3d> tabV (tailleTab, v3dNull);
-		bool onScreen = false;
-
-		for (int i = 0; i < tailleTab; i++) {
-			if( (tabB[i] = prj->projectJ2000Check(art_vertex[i],tabV[i]) || (nav->getPrecEquVision().dot(art_vertex[i])>0.9)) )
-				onScreen = true;
-		}
-
-		if(onScreen) {
-
-			if ((tabB[0] || tabB[1] || tabB[2] || tabB[3]) && (tabV[0][2]<1 && tabV[1][2]<1 && tabV[2][2]<1 && tabV[3][2]<1)) {
-
-				vecTex.push_back(0.5);
-				vecTex.push_back(0);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0);
-				vecTex.push_back(0);
-				vecTex.push_back(0);
-				vecTex.push_back(0.5);
-
-				vecPos.push_back(tabV[1][0]);
-				vecPos.push_back(tabV[1][1]);
-				vecPos.push_back(tabV[2][0]);
-				vecPos.push_back(tabV[2][1]);
-				vecPos.push_back(tabV[0][0]);
-				vecPos.push_back(tabV[0][1]);
-				vecPos.push_back(tabV[3][0]);
-				vecPos.push_back(tabV[3][1]);
-			}
-
-			if ((tabB[1] || tabB[4] || tabB[5] || tabB[2]) && (tabV[1][2]<1 && tabV[4][2]<1 && tabV[5][2]<1 && tabV[2][2]<1)) {
-
-				vecTex.push_back(1);
-				vecTex.push_back(0);
-				vecTex.push_back(1);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-
-				vecPos.push_back(tabV[4][0]);
-				vecPos.push_back(tabV[4][1]);
-				vecPos.push_back(tabV[5][0]);
-				vecPos.push_back(tabV[5][1]);
-				vecPos.push_back(tabV[1][0]);
-				vecPos.push_back(tabV[1][1]);
-				vecPos.push_back(tabV[2][0]);
-				vecPos.push_back(tabV[2][1]);
-			}
-
-			if ((tabB[2] || tabB[5] || tabB[6] || tabB[7]) && (tabV[2][2]<1 && tabV[5][2]<1 && tabV[6][2]<1 && tabV[7][2]<1)) {
-
-				vecTex.push_back(1);
-				vecTex.push_back(0.5);
-				vecTex.push_back(1);
-				vecTex.push_back(1);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-				vecTex.push_back(1);
-
-				vecPos.push_back(tabV[5][0]);
-				vecPos.push_back(tabV[5][1]);
-				vecPos.push_back(tabV[6][0]);
-				vecPos.push_back(tabV[6][1]);
-				vecPos.push_back(tabV[2][0]);
-				vecPos.push_back(tabV[2][1]);
-				vecPos.push_back(tabV[7][0]);
-				vecPos.push_back(tabV[7][1]);
-
-			}
-			if ((tabB[3] || tabB[2] || tabB[7] || tabB[8]) && (tabV[3][2]<1 && tabV[2][2]<1 && tabV[7][2]<1 && tabV[8][2]<1)) {
-
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0.5);
-				vecTex.push_back(1);
-				vecTex.push_back(0);
-				vecTex.push_back(0.5);
-				vecTex.push_back(0);
-				vecTex.push_back(1);
-
-				vecPos.push_back(tabV[2][0]);
-				vecPos.push_back(tabV[2][1]);
-				vecPos.push_back(tabV[7][0]);
-				vecPos.push_back(tabV[7][1]);
-				vecPos.push_back(tabV[3][0]);
-				vecPos.push_back(tabV[3][1]);
-				vecPos.push_back(tabV[8][0]);
-				vecPos.push_back(tabV[8][1]);
-			}
-		}
-	}
-
-
-	if (vecPos.size()==0)
+	// the texture is cut in 4 quads, each one given by 4 of the 9 art vertices
+	static const int quadVertex[16] = { 1, 2, 0, 3,  4, 5, 1, 2,  5, 6, 2, 7,  2, 7, 3, 8 };
+	static const float quadTex[32] = {
+		0.5, 0,  0.5, 0.5,  0, 0,  0, 0.5,
+		1, 0,  1, 0.5,  0.5, 0,  0.5, 0.5,
+		1, 0.5,  1, 1,  0.5, 0.5,  0.5, 1,
+		0.5, 0.5,  0.5, 1,  0, 0.5,  0, 1
+	};
+
+	artFirst = pos.size()/3;
+	artCount = 0;
+	if (!art_tex || art_tex->getID() == 0)
 		return;
 
-	glBindVertexArray(constellation.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,constellation.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecPos.size(),vecPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glBindBuffer(GL_ARRAY_BUFFER,constellation.tex);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTex.size(),vecTex.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glBindTexture(GL_TEXTURE_2D, art_tex->getID());
-
-	shaderArt->setUniform("Intensity", intensity);
-	shaderArt->setUniform("Color", artColor);
-
-	glDrawArrays(GL_LINES_ADJACENCY, 0, vecPos.size()/2);
+	for (int i = 0; i < 16; i++) {
+		const Vec3d &v = art_vertex[quadVertex[i]];
+		pos.insert(pos.end(), {(float)v[0], (float)v[1], (float)v[2]});
+		tex.insert(tex.end(), {quadTex[2*i], quadTex[2*i+1]});
+	}
+	artCount = 16;
 }
 
 const Constellation* Constellation::isStarIn(const Object &s) const
@@ -295,34 +167,23 @@ void Constellation::update(int delta_time)
 	boundary_fader.update(delta_time);
 }
 
-//! Draw the Constellation lines
-void Constellation::drawBoundary(const Projector* prj, std::vector<float> &vBoundariesPos, std::vector<float> &vBoundariesIntensity)
+//! Append the boundary segments of the Constellation to the static buffer of the boundaries
+//! isolated : all the boundaries around the constellation, otherwise only the ones it owns
+void Constellation::buildBoundaries(std::vector<float> &pos, bool isolated)
 {
-	if (!boundary_fader.getInterstate()) return;
-
-	unsigned int i, j, size;
-	Vec3d pt1, pt2;
-	std::vector<Vec3f> *points;
-
-	if (singleSelected) size = isolatedBoundarySegments.size();
-	else size = sharedBoundarySegments.size();
-
-	for (i=0; i<size; i++) {
-		if (singleSelected) points = isolatedBoundarySegments[i];
-		else points = sharedBoundarySegments[i];
-
-		for (j=0; j<points->size()-1; j++) {
-			if (prj->projectJ2000LineCheck(points->at(j),pt1,points->at(j+1),pt2)) {
-
-				vBoundariesPos.push_back(pt1[0]);
-				vBoundariesPos.push_back(pt1[1]);
-				vBoundariesIntensity.push_back(boundary_fader.getInterstate());
-				vBoundariesPos.push_back(pt2[0]);
-				vBoundariesPos.push_back(pt2[1]);
-				vBoundariesIntensity.push_back(boundary_fader.getInterstate());
-			}
+	const std::vector<std::vector<Vec3f> *> &segments = isolated ? isolatedBoundarySegments : sharedBoundarySegments;
+
+	boundaryFirst[isolated] = pos.size()/3;
+	for (const std::vector<Vec3f> *points : segments) {
+		for (unsigned int j=0; j+1<points->size(); j++) {
+			const Vec3f &pt1 = points->at(j);
+			const Vec3f &pt2 = points->at(j+1);
+			pos.insert(pos.end(), {pt1[0], pt1[1], pt1[2], pt2[0], pt2[1], pt2[2]});
 		}
 	}
+	boundaryCount[isolated] = pos.size()/3 - boundaryFirst[isolated];
+	// force the intensity to be written again
+	boundaryState = -1.f;
 }
 
 ObjectBaseP Constellation::getBrightestStarInConstellation(void) const
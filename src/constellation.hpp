@@ -96,9 +96,13 @@ public:
 	}
 
 	void drawName(s_font * constfont,const  Projector* prj) const;
-	void drawBoundary(const Projector* prj, std::vector<float> &vBoundariesPos, std::vector<float> &vBoundariesIntensity);
-	void drawLines(const Projector* prj, std::vector<float> &vLinesPos, std::vector<float> &vLinesColor);
-	void drawArt(const Projector* prj, const Navigator* nav, shaderProgram* &shaderArt, const DataGL &constellation);
+
+	//! Append the J2000 positions of the segment ends to pos and remember their range
+	void buildLines(std::vector<float> &pos);
+	//! Append the boundary segments, shared or isolated, to pos and remember their range
+	void buildBoundaries(std::vector<float> &pos, bool isolated);
+	//! Append the 4 quads of the art texture to pos and tex and remember their range
+	void buildArt(std::vector<float> &pos, std::vector<float> &tex);
 
 	void update(int delta_time);
 
@@ -169,8 +173,14 @@ private:
 	static Vec3f artColor;
 	static bool singleSelected;
 
-	std::vector<float> vecPos;
-	std::vector<float> vecTex;
+	/** Ranges of the constellation in the static buffers of ConstellationMgr, in vertices */
+	unsigned int linesFirst = 0, linesCount = 0;
+	unsigned int boundaryFirst[2] = {0, 0}, boundaryCount[2] = {0, 0};
+	unsigned int artFirst = 0, artCount = 0;
+
+	/** Line color and boundary intensity last written in the buffers of ConstellationMgr */
+	Vec4f linesState;
+	float boundaryState = -1.f;
 };
 
 #endif // _CONSTELLATION_H_
@@ -25,6 +25,8 @@
 
 // Class used to manage group of constellation
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -63,30 +65,43 @@ void ConstellationMgr::createShader()
 //ART
 	shaderArt = new shaderProgram();
 	shaderArt->init("constellationArt.vert", "constellationArt.geom","constellationArt.frag");
-	shaderArt->setUniformLocation("Intensity");
-	shaderArt->setUniformLocation("Color");
+	uniformArtMat = shaderArt->setUniformLocation("Mat");
+	uniformArtIntensity = shaderArt->setUniformLocation("Intensity");
+	uniformArtColor = shaderArt->setUniformLocation("Color");
 
 	//BOUNDARY
 	shaderBoundary = new shaderProgram();
-	shaderBoundary->init("constellationBoundary.vert", "constellationBoundary.frag");
-	shaderBoundary->setUniformLocation("Color");
+	shaderBoundary->init("constellationBoundary.vert", "constellationBoundary.geom", "constellationBoundary.frag");
+	uniformBoundaryMat = shaderBoundary->setUniformLocation("Mat");
+	uniformBoundaryColor = shaderBoundary->setUniformLocation("Color");
 
 	//LINES
 	shaderLines = new shaderProgram();
-	shaderLines->init("constellationLines.vert", "constellationLines.frag");
-
-	glGenVertexArrays(1,&constellation.vao);
-	glBindVertexArray(constellation.vao);
-
-	glGenBuffers(1,&constellation.tex);
-	glGenBuffers(1,&constellation.pos);
-	glGenBuffers(1,&constellation.color);
-	glGenBuffers(1,&constellation.mag);
+	shaderLines->init("constellationLines.vert", "constellationLines.geom", "constellationLines.frag");
+	uniformLinesMat = shaderLines->setUniformLocation("Mat");
 
+	glGenVertexArrays(1,&artGL.vao);
+	glBindVertexArray(artGL.vao);
+	glGenBuffers(1,&artGL.pos);
+	glGenBuffers(1,&artGL.tex);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
+
+	glGenVertexArrays(1,&linesGL.vao);
+	glBindVertexArray(linesGL.vao);
+	glGenBuffers(1,&linesGL.pos);
+	glGenBuffers(1,&linesGL.color);
+	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(2);
+
+	glGenVertexArrays(1,&boundaryGL.vao);
+	glBindVertexArray(boundaryGL.vao);
+	glGenBuffers(1,&boundaryGL.pos);
+	glGenBuffers(1,&boundaryGL.mag);
+	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(3);
+
+	glBindVertexArray(0);
 }
 
 void ConstellationMgr::deleteShader()
@@ -98,11 +113,15 @@ void ConstellationMgr::deleteShader()
 	if(shaderLines) delete shaderLines;
 		shaderLines=nullptr;
 
-	glDeleteBuffers(1,&constellation.tex);
-	glDeleteBuffers(1,&constellation.color);
-	glDeleteBuffers(1,&constellation.pos);
-	glDeleteVertexArrays(1,&constellation.vao);
-
+	glDeleteBuffers(1,&artGL.pos);
+	glDeleteBuffers(1,&artGL.tex);
+	glDeleteVertexArrays(1,&artGL.vao);
+	glDeleteBuffers(1,&linesGL.pos);
+	glDeleteBuffers(1,&linesGL.color);
+	glDeleteVertexArrays(1,&linesGL.vao);
+	glDeleteBuffers(1,&boundaryGL.pos);
+	glDeleteBuffers(1,&boundaryGL.mag);
+	glDeleteVertexArrays(1,&boundaryGL.vao);
 }
 
 
@@ -232,6 +251,11 @@ int ConstellationMgr::loadLinesAndArt(const string &skyCultureDir)
 	// Set current states
 	setCurrentStates();
 
+	// art and boundaries of the previous constellations are no longer valid
+	buildLines();
+	buildArt();
+	buildBoundaries();
+
 	FILE *fic = fopen(artfileName.c_str(), "r");
 	if (!fic) {
 		Log.write("ConstellationMgr::loadLinesAndArt Can't open " + artfileName, cLog::LOG_TYPE::L_ERROR);
@@ -344,6 +368,7 @@ int ConstellationMgr::loadLinesAndArt(const string &skyCultureDir)
 	}
 	artFile.close();
 
+	buildArt();
 	loadBoundaries(boundaryfileName);
 
 	return 0;
@@ -371,55 +396,125 @@ void ConstellationMgr::draw(const Projector * prj,const Navigator * nav)
 //! Draw constellations art textures
 void ConstellationMgr::drawArt(const Projector * prj, const Navigator * nav)
 {
+	if (!hasArt)
+		return;
+
 	StateGL::BlendFunc(GL_ONE, GL_ONE);
 	StateGL::enable(GL_BLEND);
 	StateGL::enable(GL_CULL_FACE);
 	glFrontFace(GL_CW);
 	//~ StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	vector < Constellation * >::const_iterator iter;
-
 	shaderArt->use();
+	shaderArt->setUniform(uniformArtMat, prj->getMatJ2000ToEye());
+	shaderArt->setUniform(uniformArtColor, Constellation::artColor);
 
+	glBindVertexArray(artGL.vao);
+	// one call per constellation, each one has its own texture
+	vector < Constellation * >::const_iterator iter;
 	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter) {
-		(*iter)->drawArt(prj, nav, shaderArt, constellation);
+		const float intensity = (*iter)->art_fader.getInterstate();
+		if (!(*iter)->artCount || !intensity)
+			continue;
+		glBindTexture(GL_TEXTURE_2D, (*iter)->art_tex->getID());
+		shaderArt->setUniform(uniformArtIntensity, intensity);
+		glDrawArrays(GL_LINES_ADJACENCY, (*iter)->artFirst, (*iter)->artCount);
 	}
+	glBindVertexArray(0);
 
 	shaderArt->unuse();
 	glFrontFace(GL_CCW);
 	StateGL::disable(GL_CULL_FACE);
 }
 
+void ConstellationMgr::buildLines()
+{
+	vector<float> pos;
+	vector < Constellation * >::const_iterator iter;
+	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter)
+		(*iter)->buildLines(pos);
+	linesColor.assign(pos.size()/3*4, 0.f);
+	linesJD = HipStarMgr::getCurrentJDay();
+
+	glBindVertexArray(linesGL.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER,linesGL.pos);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*pos.size(),pos.data(),GL_STATIC_DRAW);
+	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindBuffer(GL_ARRAY_BUFFER,linesGL.color);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*linesColor.size(),linesColor.data(),GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(2,4,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindVertexArray(0);
+}
+
+void ConstellationMgr::buildArt()
+{
+	vector<float> pos;
+	vector<float> tex;
+	vector < Constellation * >::const_iterator iter;
+	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter)
+		(*iter)->buildArt(pos, tex);
+	hasArt = !pos.empty();
+
+	glBindVertexArray(artGL.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER,artGL.pos);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*pos.size(),pos.data(),GL_STATIC_DRAW);
+	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindBuffer(GL_ARRAY_BUFFER,artGL.tex);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*tex.size(),tex.data(),GL_STATIC_DRAW);
+	glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindVertexArray(0);
+}
+
 //! Draw constellations lines
 void ConstellationMgr::drawLines(const Projector * prj)
 {
-	vector<float> vLinesPos;
-	vector<float> vLinesColor;
+	if (linesColor.empty())
+		return;
 
+	// the stars move slowly with their proper motion
+	if (fabs(HipStarMgr::getCurrentJDay() - linesJD) > 365.25)
+		buildLines();
+
+	// only the constellations whose color or fader changed are written again
+	bool changed = false;
+	bool visible = false;
 	vector < Constellation * >::const_iterator iter;
 	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter) {
-		(*iter)->drawLines(prj, vLinesPos, vLinesColor);
+		Constellation *cons = *iter;
+		const Vec4f state(cons->lineColor[0], cons->lineColor[1], cons->lineColor[2], cons->line_fader.getInterstate());
+		if (state[3])
+			visible = true;
+		if (state == cons->linesState)
+			continue;
+		cons->linesState = state;
+		for (unsigned int i = cons->linesFirst; i < cons->linesFirst + cons->linesCount; i++)
+			std::copy((const float*)state, (const float*)state + 4, linesColor.begin() + 4*i);
+		changed = true;
 	}
 
-	if (vLinesPos.size()==0)
+	if (changed) {
+		glBindBuffer(GL_ARRAY_BUFFER,linesGL.color);
+		glBufferSubData(GL_ARRAY_BUFFER,0,sizeof(float)*linesColor.size(),linesColor.data());
+	}
+
+	if (!visible)
 		return;
 
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
 	shaderLines->use();
+	shaderLines->setUniform(uniformLinesMat, prj->getMatJ2000ToEye());
 
-	glBindVertexArray(constellation.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,constellation.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vLinesPos.size(),vLinesPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glBindBuffer(GL_ARRAY_BUFFER,constellation.color);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vLinesColor.size(),vLinesColor.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(2,4,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glDrawArrays(GL_LINES, 0, vLinesPos.size()/2);
+	glBindVertexArray(linesGL.vao);
+	glDrawArrays(GL_LINES, 0, linesColor.size()/4);
+	glBindVertexArray(0);
 
 	shaderLines->unuse();
 }
@@ -436,6 +531,7 @@ void ConstellationMgr::drawNames(const Projector * prj)
 		if (prj->projectJ2000Check((*iter)->XYZname, (*iter)->XYname))
 			(*iter)->drawName(asterFont, prj);
 	}
+	asterFont->flush();
 }
 
 Constellation *ConstellationMgr::isStarIn(const Object &s) const
@@ -865,41 +961,82 @@ bool ConstellationMgr::loadBoundaries(const string& boundaryFile)
 	Log.write("(" + Utility::intToString(i) + " segments loaded)", cLog::LOG_TYPE::L_INFO);
 	delete points;
 
+	buildBoundaries();
+
 	return true;
 }
 
-//! Draw constellations lines
+//! The buffer holds two layouts : every boundary once, owned by one constellation,
+//! then all the boundaries around each constellation for the single selection
+void ConstellationMgr::buildBoundaries()
+{
+	vector<float> pos;
+	vector < Constellation * >::const_iterator iter;
+	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter)
+		(*iter)->buildBoundaries(pos, false);
+	nbSharedBoundary = pos.size()/3;
+	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter)
+		(*iter)->buildBoundaries(pos, true);
+	boundaryIntensity.assign(pos.size()/3, 0.f);
+
+	glBindVertexArray(boundaryGL.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER,boundaryGL.pos);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*pos.size(),pos.data(),GL_STATIC_DRAW);
+	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindBuffer(GL_ARRAY_BUFFER,boundaryGL.mag);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*boundaryIntensity.size(),boundaryIntensity.data(),GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(3,1,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindVertexArray(0);
+}
+
+//! Draw constellations boundaries
 void ConstellationMgr::drawBoundaries(const Projector * prj)
 {
-	vector<float> vBoundariesPos;
-	vector<float> vBoundariesIntensity;
+	if (boundaryIntensity.empty())
+		return;
 
+	// only the constellations whose fader changed are written again
+	bool changed = false;
+	bool visible = false;
 	vector < Constellation * >::const_iterator iter;
 	for (iter = asterisms.begin(); iter != asterisms.end(); ++iter) {
-		(*iter)->drawBoundary(prj, vBoundariesPos,vBoundariesIntensity);
+		Constellation *cons = *iter;
+		const float intensity = cons->boundary_fader.getInterstate();
+		if (intensity)
+			visible = true;
+		if (intensity == cons->boundaryState)
+			continue;
+		cons->boundaryState = intensity;
+		for (int isolated = 0; isolated < 2; isolated++)
+			std::fill_n(boundaryIntensity.begin() + cons->boundaryFirst[isolated], cons->boundaryCount[isolated], intensity);
+		changed = true;
+	}
+
+	if (changed) {
+		glBindBuffer(GL_ARRAY_BUFFER,boundaryGL.mag);
+		glBufferSubData(GL_ARRAY_BUFFER,0,sizeof(float)*boundaryIntensity.size(),boundaryIntensity.data());
 	}
 
-	if (vBoundariesPos.size()==0)
+	if (!visible)
 		return;
 
+	const unsigned int first = Constellation::singleSelected ? nbSharedBoundary : 0;
+	const unsigned int count = Constellation::singleSelected ? boundaryIntensity.size() - nbSharedBoundary : nbSharedBoundary;
+
 	//~ StateGL::disable(GL_BLEND);
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
 	shaderBoundary->use();
+	shaderBoundary->setUniform(uniformBoundaryMat, prj->getMatJ2000ToEye());
+	shaderBoundary->setUniform(uniformBoundaryColor, boundaryColor);
 
-	shaderBoundary->setUniform("Color", boundaryColor);
-	glBindVertexArray(constellation.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,constellation.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vBoundariesPos.size(),vBoundariesPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glBindBuffer(GL_ARRAY_BUFFER,constellation.mag);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vBoundariesIntensity.size(),vBoundariesIntensity.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(3,1,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glDrawArrays(GL_LINES, 0, vBoundariesPos.size()/2);
+	glBindVertexArray(boundaryGL.vao);
+	glDrawArrays(GL_LINES, first, count);
+	glBindVertexArray(0);
 
 	shaderBoundary->unuse();
 }
@@ -206,6 +206,11 @@ private:
 	void drawBoundaries(const Projector* prj);
 	void setSelectedConst(Constellation* c);
 
+	//! Upload the J2000 positions of all the lines, art quads and boundaries into their static buffers
+	void buildLines();
+	void buildArt();
+	void buildBoundaries();
+
 	Constellation* isStarIn(const Object &s) const;
 	Constellation* findFromAbbreviation(const std::string& abbreviation) const;
 	std::vector<Constellation*> asterisms;
@@ -233,7 +238,17 @@ private:
 	shaderProgram *shaderArt=nullptr;
 	shaderProgram *shaderBoundary=nullptr;
 	shaderProgram *shaderLines=nullptr;
-	DataGL constellation;
+	UniformHandle uniformArtMat, uniformArtIntensity, uniformArtColor;
+	UniformHandle uniformBoundaryMat, uniformBoundaryColor;
+	UniformHandle uniformLinesMat;
+
+	// static buffers of all the constellations, projected by the geometry shaders
+	DataGL linesGL, artGL, boundaryGL;
+	std::vector<float> linesColor;			// copy of the color buffer of the lines
+	std::vector<float> boundaryIntensity;	// copy of the intensity buffer of the boundaries
+	unsigned int nbSharedBoundary = 0;		// vertices of the shared boundaries, the isolated ones follow
+	double linesJD = 0.0;					// date of the star positions in linesGL
+	bool hasArt = false;
 };
 
 #endif // _CONSTELLATION_MGR_H_
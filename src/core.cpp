@@ -46,6 +46,8 @@
 #include "starLines.hpp"
 #include "body_trace.hpp"
 #include "screenFader.hpp"
+#include "ephemeris_cache.hpp"
+#include "frame_scheduler.hpp"
 
 using namespace std;
 
@@ -73,8 +75,9 @@ Core::Core(AppSettings* _settings, ScreenFader* _screenFader, int width, int hei
 	shaderProgram::setLogDir(settings->getLogDir() );
 
 	ubo_cam = new UBOCam("cam_block");
+	frameScheduler = new FrameScheduler();
 	tone_converter = new ToneReproductor();
-	atmosphere = new Atmosphere();
+	atmosphere = new Atmosphere(frameScheduler);
 	ssystem = new SolarSystem();
 	timeMgr = new TimeMgr();
 	observatory = new Observer(*ssystem);
@@ -125,7 +128,7 @@ Core::Core(AppSettings* _settings, ScreenFader* _screenFader, int width, int hei
 	meteors = new MeteorMgr(10, 60);
 	landscape = new Landscape();
 	skyloc = new SkyLocalizer(settings->getSkyCultureDir());
-	hip_stars = new HipStarMgr(width,height);
+	hip_stars = new HipStarMgr(width,height, frameScheduler);
 	asterisms = new ConstellationMgr(hip_stars);
 	text_usr = new TextMgr();
 	mCity = new mCity_Mgr();
@@ -275,6 +278,7 @@ Core::~Core()
 	delete executorInUniverse;
 	
 	delete anchorManager;
+	delete frameScheduler;
 }
 
 
@@ -378,6 +382,7 @@ void Core::init(const InitParser& conf, const int viewW, const int viewH )
 	ssystem->setFlagHints(conf.getBoolean("astro:flag_planets_hints"));
 	ssystem->setFlagPlanetsOrbits(conf.getBoolean("astro:flag_planets_orbits"));
 	setFlagLightTravelTime(conf.getBoolean("astro", "flag_light_travel_time"));
+	EphemerisCache::setFlagEnabled(conf.getBoolean("astro", "flag_ephemeris_cache"));
 	ssystem->setFlagTrails(conf.getBoolean("astro", "flag_object_trails"));
 	startPlanetsTrails(conf.getBoolean("astro", "flag_object_trails"));
 	nebulas->setFlagShow(conf.getBoolean("astro:flag_nebula"));
@@ -522,6 +527,7 @@ void Core::init(const InitParser& conf, const int viewW, const int viewH )
 	bodyDecor->setAtmosphereState(conf.getBoolean("landscape:flag_atmosphere"));
 	atmosphere->setFlagShow(conf.getBoolean("landscape:flag_atmosphere"));
 	atmosphere->setFaderDuration(conf.getDouble("viewing","atmosphere_fade_duration"));
+	atmosphere->setFlagIncremental(conf.getBoolean("viewing","flag_atmosphere_incremental"));
 
 	// Viewing section
 	asterisms->setFlagLines( conf.getBoolean("viewing:flag_constellation_drawing"));
@@ -723,38 +729,23 @@ void Core::updateInSolarSystem(int delta_time)
 
 	// pd.stopTimer("Core::update$update_Part1");
 
-	std::future<void> a = std::async(std::launch::async, &Core::ssystemComputePreDraw, this);
-	// pd.startTimer("Core::update$computePreDraw");
-	// ssystem->computePreDraw(projection, navigation);
-	// pd.stopTimer("Core::update$computePreDraw");
-
-	// pd.startTimer("Core::update$atmosphere_compute_color");
-	std::future<void> b = std::async(std::launch::async, &Core::atmosphereComputeColor, this, sunPos, moonPos);
-	// Compute the atmosphere color and intensity
-	// atmosphere->computeColor(timeMgr->getJDay(), sunPos, moonPos,
-	//                           ssystem->getMoon()->get_phase(ssystem->getEarth()->get_heliocentric_ecliptic_pos()),
-	//                           tone_converter, projection, observatory->getHomePlanetEnglishName(), observatory->getLatitude(), observatory->getAltitude(),
-	//                           //~ tone_converter, projection, observatory->getHomePlanet()->getEnglishName(), observatory->getLatitude(), observatory->getAltitude(),
-	//                           15.f, 40.f);	// Temperature = 15c, relative humidity = 40%
-	//~ tone_converter->setWorldAdaptationLuminance(atmosphere->getWorldAdaptationLuminance());
-	// pd.stopTimer("Core::update$atmosphere_compute_color");
-
-	std::future<void> c = std::async(std::launch::async, &Core::hipStarMgrPreDraw, this);
-	// pd.startTimer("Core::update$hip_stars_preDraw");
-	// hip_stars->preDraw(geodesic_grid, tone_converter, projection, timeMgr,observatory->getAltitude());
-	// pd.stopTimer("Core::update$hip_stars_preDraw");
-
-	/*
-	 * 
-	 * Récupération des résultats de async
-	 * 
-	 */
-	a.get();
-	b.get();
-	c.get();
-
-
-	tone_converter->setWorldAdaptationLuminance(atmosphere->getWorldAdaptationLuminance());
+	// the three heavy computations are independent, the tone adaptation must wait for
+	// the atmosphere and for the stars which read the previous adaptation luminance
+	frameScheduler->addJob("Core::update$computePreDraw", [this] { ssystemComputePreDraw(); });
+	FrameScheduler::JobId atmosphereJob = frameScheduler->addJob("Core::update$atmosphere_compute_color",
+	                                      [this, sunPos, moonPos] { atmosphereComputeColor(sunPos, moonPos); });
+	FrameScheduler::JobId starsJob = frameScheduler->addJob("Core::update$hip_stars_preDraw",
+	                                 [this] { hipStarMgrPreDraw(); });
+	frameScheduler->addJob("Core::update$tone_adaptation", [this] {
+		tone_converter->setWorldAdaptationLuminance(atmosphere->getWorldAdaptationLuminance());
+	}, {atmosphereJob, starsJob});
+
+	frameScheduler->run();
+
+	// the atmosphere computation is split over the scheduler threads and measures itself
+	pd.addMeasure(atmosphere->getFlagRecomputed() ? "Atmosphere::computeColor$computed" : "Atmosphere::computeColor$kept",
+	              atmosphere->getComputeCpuTime(), atmosphere->getComputeWallTime());
+
 	sunPos.normalize();
 	moonPos.normalize();
 
@@ -797,29 +788,23 @@ void Core::updateInSolarSystem(int delta_time)
 
 void Core::ssystemComputePreDraw()
 {
-	pd.startTimer("Core::update$computePreDraw");
 	ssystem->computePreDraw(projection, navigation);
-	pd.stopTimer("Core::update$computePreDraw");
 }
 
 
 void Core::atmosphereComputeColor(Vec3d sunPos, Vec3d moonPos )
 {
-	pd.startTimer("Core::update$atmosphere_compute_color");
 	atmosphere->computeColor(timeMgr->getJDay(), sunPos, moonPos,
 	                          ssystem->getMoon()->get_phase(ssystem->getEarth()->get_heliocentric_ecliptic_pos()),
 	                          tone_converter, projection, observatory->getHomePlanetEnglishName(), observatory->getLatitude(), observatory->getAltitude(),
 	                          //~ tone_converter, projection, observatory->getHomePlanet()->getEnglishName(), observatory->get_latitude(), observatory->get_altitude(),
 	                          15.f, 40.f);	// Temperature = 15c, relative humidity = 40%
 	//~ tone_converter->set_world_adaptation_luminance(atmosphere->get_world_adaptation_luminance());
-	pd.stopTimer("Core::update$atmosphere_compute_color");
 }
 
 void Core::hipStarMgrPreDraw()
 {
-	pd.startTimer("Core::update$hip_stars_preDraw");
 	hip_stars->preDraw(geodesic_grid, tone_converter, projection, timeMgr,observatory->getAltitude());
-	pd.stopTimer("Core::update$hip_stars_preDraw");
 }
 
 void Core::uboCamUpdate()
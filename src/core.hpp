@@ -75,6 +75,7 @@ class Media;
 class StarLines;
 class BodyTrace;
 class ScreenFader;
+class FrameScheduler;
 
 //!  @brief Main class for application core processing.
 //!
@@ -762,6 +763,7 @@ private:
 	StarLines* starLines;				// permet de tracer des lignes dans la galaxie
 	OjmMgr * ojmMgr;					// représente les obj3D 
 	ScreenFader* screenFader;			// représente une copie de screenFader
+	FrameScheduler* frameScheduler;		// threads persistants pour les calculs de chaque frame
 	float sky_brightness;				// Current sky Brightness in ?
 	bool object_pointer_visibility;		// Should selected object pointer be drawn
 	std::string getCursorPos(int x, int y);  //not used now
@@ -0,0 +1,162 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <cassert>
+#include <cmath>
+
+#include "ephemeris_cache.hpp"
+
+std::atomic<bool> EphemerisCache::flagEnabled {true};
+
+EphemerisCache::EphemerisCache(PositionFunctionType *_positionFunction) :
+	positionFunction(_positionFunction)
+{
+	assert(positionFunction != nullptr);
+}
+
+void EphemerisCache::getPosition(double JD, double *v)
+{
+	if (!flagEnabled || disabled) {
+		positionFunction(JD, v);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (window == 0.0) {
+		calibrate(JD);
+		if (disabled) {
+			positionFunction(JD, v);
+			return;
+		}
+	}
+
+	long index = (long)floor(JD / window);
+	double t = 2.0 * (JD - index * window) / window - 1.0;
+
+	// frames successives dans la même fenêtre
+	if (lastSegment != nullptr && index == lastIndex) {
+		if (lastSegment->valid)
+			evalSegment(*lastSegment, t, v);
+		else
+			positionFunction(JD, v);
+		return;
+	}
+
+	auto it = segments.find(index);
+	if (it == segments.end()) {
+		// première demande : pas encore rentable d'ajuster cette fenêtre
+		if (!hasLastMiss || lastMiss != index) {
+			lastMiss = index;
+			hasLastMiss = true;
+			positionFunction(JD, v);
+			return;
+		}
+		if (segments.size() >= MAX_SEGMENTS) {
+			segments.clear();
+			lastSegment = nullptr;
+		}
+		it = segments.emplace(index, Segment()).first;
+		fitSegment(index, window, it->second, CHECK_MARGIN * RELATIVE_TOLERANCE);
+		hasLastMiss = false;
+	}
+
+	lastSegment = &it->second;
+	lastIndex = index;
+	if (lastSegment->valid)
+		evalSegment(*lastSegment, t, v);
+	else
+		positionFunction(JD, v);
+}
+
+void EphemerisCache::calibrate(double JD)
+{
+	Segment segment;
+	for (double length = MAX_WINDOW; length >= MIN_WINDOW; length /= 2.0) {
+		if (fitSegment((long)floor(JD / length), length, segment, CALIBRATION_MARGIN * RELATIVE_TOLERANCE)) {
+			window = length;
+			return;
+		}
+	}
+	disabled = true;
+}
+
+bool EphemerisCache::fitSegment(long index, double length, Segment &segment, double relativeTolerance) const
+{
+	const double start = index * length;
+	double values[NB_NODES][3];
+	double minDist = HUGE_VAL;	// la tolérance la plus stricte de la fenêtre
+
+	// valeurs aux noeuds de Tchebychev
+	for (int j = 0; j < NB_NODES; j++) {
+		double x = cos(M_PI * (j + 0.5) / NB_NODES);
+		positionFunction(start + (x + 1.0) * 0.5 * length, values[j]);
+		double dist = sqrt(values[j][0]*values[j][0] + values[j][1]*values[j][1] + values[j][2]*values[j][2]);
+		if (dist < minDist)
+			minDist = dist;
+	}
+
+	for (int c = 0; c < 3; c++) {
+		for (int k = 0; k < NB_NODES; k++) {
+			double sum = 0.0;
+			for (int j = 0; j < NB_NODES; j++)
+				sum += values[j][c] * cos(M_PI * k * (j + 0.5) / NB_NODES);
+			segment.coeffs[c][k] = 2.0 * sum / NB_NODES;
+		}
+	}
+
+	// contrôle de la distance entre la série et le polynôme en CHECKS_PER_NODE points
+	// par intervalle entre noeuds, répartis comme les noeuds et bords de la fenêtre compris
+	const double tolerance = relativeTolerance * minDist;
+	const int nbChecks = CHECKS_PER_NODE * NB_NODES;
+	segment.valid = true;
+	for (int j = 0; j <= nbChecks; j++) {
+		double x = cos(M_PI * j / nbChecks);
+		double exact[3], approx[3];
+		positionFunction(start + (x + 1.0) * 0.5 * length, exact);
+		evalSegment(segment, x, approx);
+		double dx = exact[0] - approx[0], dy = exact[1] - approx[1], dz = exact[2] - approx[2];
+		if (sqrt(dx*dx + dy*dy + dz*dz) > tolerance) {
+			segment.valid = false;
+			return false;
+		}
+	}
+	return true;
+}
+
+void EphemerisCache::evalSegment(const Segment &segment, double t, double *v)
+{
+	// algorithme de Clenshaw
+	const double t2 = 2.0 * t;
+	for (int c = 0; c < 3; c++) {
+		const double *a = segment.coeffs[c];
+		double b1 = 0.0, b2 = 0.0;
+		for (int k = NB_NODES - 1; k >= 1; k--) {
+			double b0 = a[k] + t2 * b1 - b2;
+			b2 = b1;
+			b1 = b0;
+		}
+		v[c] = 0.5 * a[0] + t * b1 - b2;
+	}
+}
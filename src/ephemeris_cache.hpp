@@ -0,0 +1,133 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _EPHEMERIS_CACHE_HPP_
+#define _EPHEMERIS_CACHE_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "orbit.hpp"
+
+/**
+ * \class EphemerisCache
+ * \brief Cache de polynômes de Tchebychev pour une fonction d'éphéméride analytique
+ *
+ * Le temps est découpé en fenêtres fixes de JD. Sur chaque fenêtre utilisée, la
+ * position est approchée par un polynôme de Tchebychev de degré NB_NODES-1 par
+ * coordonnée : une lecture coûte alors quelques dizaines de flops au lieu des
+ * séries VSOP87, ELP82B, TASS17 ou L1 complètes.
+ *
+ * @section PRECISION
+ *
+ * Chaque fenêtre est vérifiée contre la série analytique en CHECKS_PER_NODE points
+ * par intervalle entre noeuds : la norme de l'écart doit y rester inférieure à
+ * CHECK_MARGIN * RELATIVE_TOLERANCE fois la plus petite distance au parent de la
+ * fenêtre, sinon la fenêtre est marquée invalide et la série analytique est
+ * utilisée pour elle. La marge couvre l'écart entre les points de contrôle et
+ * celui des séries elles-mêmes selon l'ordre des appels : elles interpolent
+ * linéairement leurs éléments entre des noeuds (10 jours pour VSOP87, 1 heure
+ * pour ELP82B). Avec 1e-7, l'écart reste sous 0.02" vu depuis le parent ; les
+ * fenêtres qui contiennent une cassure de ces interpolations échouent au contrôle.
+ *
+ * La longueur des fenêtres est choisie au premier calcul : partant de
+ * MAX_WINDOW jours, elle est divisée par deux jusqu'à ce que l'ajustement
+ * respecte CALIBRATION_MARGIN * RELATIVE_TOLERANCE (les satellites rapides ont
+ * besoin de fenêtres courtes).
+ *
+ * @section COUT
+ *
+ * Une fenêtre n'est ajustée qu'à sa deuxième demande consécutive : quand le
+ * temps avance si vite que chaque frame tombe dans une nouvelle fenêtre,
+ * le cache ne coûte qu'une recherche et la série est appelée directement.
+ */
+class EphemerisCache {
+public:
+	//! _positionFunction ne doit pas être nul
+	EphemerisCache(PositionFunctionType *_positionFunction);
+	~EphemerisCache() {};
+	EphemerisCache(EphemerisCache const &) = delete;
+	EphemerisCache& operator = (EphemerisCache const &) = delete;
+
+	//! calcule la position au jour julien JD, dans le même repère que la fonction d'éphéméride
+	void getPosition(double JD, double *v);
+
+	//! active ou désactive l'utilisation de tous les caches d'éphémérides
+	static void setFlagEnabled(bool b) {
+		flagEnabled = b;
+	}
+	static bool getFlagEnabled() {
+		return flagEnabled;
+	}
+
+	//! nombre de noeuds d'interpolation par fenêtre
+	static const int NB_NODES = 16;
+	//! nombre de points de contrôle par intervalle entre deux noeuds
+	static const int CHECKS_PER_NODE = 4;
+	//! écart maximal accepté, relatif à la distance au parent
+	static constexpr double RELATIVE_TOLERANCE = 1e-7;
+	//! part de RELATIVE_TOLERANCE exigée aux points de contrôle, le reste couvre l'écart
+	//! entre ces points et celui dû à l'ordre des appels à la série
+	static constexpr double CHECK_MARGIN = 0.5;
+	//! part de RELATIVE_TOLERANCE exigée de la fenêtre qui fixe la longueur des fenêtres
+	static constexpr double CALIBRATION_MARGIN = 0.25;
+	//! longueur maximale d'une fenêtre en jours
+	static constexpr double MAX_WINDOW = 32.0;
+	//! longueur minimale d'une fenêtre en jours
+	static constexpr double MIN_WINDOW = 1.0/64.0;
+
+private:
+	// coefficients de Tchebychev d'une fenêtre
+	struct Segment {
+		bool valid = false;		// faux si l'ajustement ne respecte pas la tolérance
+		double coeffs[3][NB_NODES];
+	};
+
+	// ajuste la fenêtre index de longueur window, renvoie vrai si l'écart reste sous
+	// relativeTolerance fois la distance au parent
+	bool fitSegment(long index, double window, Segment &segment, double relativeTolerance) const;
+	// évalue le polynôme en t dans [-1,1]
+	static void evalSegment(const Segment &segment, double t, double *v);
+	// choisit la longueur des fenêtres autour du jour JD
+	void calibrate(double JD);
+
+	PositionFunctionType *positionFunction;
+	double window = 0.0;		// longueur des fenêtres en jours, 0 tant qu'elle n'est pas choisie
+	std::atomic<bool> disabled {false};	// vrai si aucune longueur de fenêtre n'est assez précise, lu sans verrou
+
+	std::unordered_map<long, Segment> segments;
+	const Segment *lastSegment = nullptr;	// dernière fenêtre lue
+	long lastIndex = 0;
+	long lastMiss = 0;			// dernière fenêtre demandée mais pas encore ajustée
+	bool hasLastMiss = false;
+
+	std::mutex mutex;
+	static std::atomic<bool> flagEnabled;
+
+	// au-delà, le cache est vidé
+	static const unsigned int MAX_SEGMENTS = 1024;
+};
+
+#endif // _EPHEMERIS_CACHE_HPP_
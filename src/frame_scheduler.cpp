@@ -0,0 +1,211 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "frame_scheduler.hpp"
+#include "perf_debug.hpp"
+#include "ThreadPool.hpp"
+
+FrameScheduler::FrameScheduler(unsigned int _nbWorkers) : nbWorkers(_nbWorkers)
+{
+	if (nbWorkers == 0) {
+		unsigned int nbThread = std::thread::hardware_concurrency();
+		nbWorkers = (nbThread > 2) ? nbThread - 1 : 1;
+	}
+	pool.reset(new ThreadPool(nbWorkers));
+}
+
+FrameScheduler::~FrameScheduler()
+{
+	// the threads may still hold proposals of jobs taken by run(): join them first
+	pool.reset();
+}
+
+FrameScheduler::JobId FrameScheduler::addJob(const std::string &label, std::function<void()> func, const std::vector<JobId> &dependencies)
+{
+	JobId id = jobs.size();
+	std::unique_ptr<Job> job(new Job());
+	job->label = label;
+	job->func = std::move(func);
+	job->remaining = dependencies.size();
+
+	for (JobId dep : dependencies) {
+		if (dep < 0 || dep >= id)
+			throw std::out_of_range("FrameScheduler: unknown dependency for job " + label);
+		jobs[dep]->successors.push_back(id);
+	}
+	jobs.push_back(std::move(job));
+	return id;
+}
+
+void FrameScheduler::run()
+{
+	if (jobs.empty())
+		return;
+
+	nbPending = jobs.size();
+
+	// list the jobs without dependencies before any thread starts to release the others
+	std::vector<Job*> ready;
+	for (auto &job : jobs) {
+		if (job->remaining == 0)
+			ready.push_back(job.get());
+	}
+	for (Job* job : ready)
+		pushJob(job);
+
+	// the calling thread works too until the whole frame is done
+	while (nbPending > 0) {
+		Job* job = popJob();
+		if (job != nullptr) {
+			execute(job);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(readyMutex);
+		wakeUp.wait(lock, [this] { return nbPending == 0 || !readyJobs.empty(); });
+	}
+
+	// PerformanceDebugger is not thread safe: report from here only
+	for (auto &job : jobs)
+		pd.addMeasure(job->label, job->cpuTime, job->wallTime);
+	jobs.clear();
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(errorMutex);
+		std::swap(error, firstError);
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void FrameScheduler::pushJob(Job* job)
+{
+	{
+		std::lock_guard<std::mutex> lock(readyMutex);
+		readyJobs.push_back(job);
+	}
+	wakeUp.notify_one();
+	// one proposal per ready job: the thread which gets it runs the oldest ready job,
+	// or nothing if the calling thread was faster
+	pool->enqueue([this] {
+		Job* job = popJob();
+		if (job != nullptr)
+			execute(job);
+	});
+}
+
+void FrameScheduler::parallelFor(size_t nbParts, const std::function<void(size_t)> &func)
+{
+	// shared with the helpers, which may only start after the return of parallelFor
+	struct Parts {
+		std::function<void(size_t)> func;
+		size_t nbParts;
+		std::atomic<size_t> next {0};
+		std::atomic<size_t> done {0};
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::exception_ptr error;
+
+		void work() {
+			for (size_t i = next++; i < nbParts; i = next++) {
+				try {
+					func(i);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (!error)
+						error = std::current_exception();
+				}
+				if (++done == nbParts) {
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+					}
+					finished.notify_all();
+				}
+			}
+		}
+	};
+
+	if (nbParts == 0)
+		return;
+
+	std::shared_ptr<Parts> parts = std::make_shared<Parts>();
+	parts->func = func;
+	parts->nbParts = nbParts;
+	const size_t nbHelpers = std::min<size_t>(nbParts - 1, nbWorkers);
+	for (size_t i = 0; i < nbHelpers; i++)
+		pool->enqueue([parts] { parts->work(); });
+
+	parts->work();
+
+	std::unique_lock<std::mutex> lock(parts->mutex);
+	parts->finished.wait(lock, [&parts] { return parts->done == parts->nbParts; });
+	if (parts->error)
+		std::rethrow_exception(parts->error);
+}
+
+FrameScheduler::Job* FrameScheduler::popJob()
+{
+	std::lock_guard<std::mutex> lock(readyMutex);
+	if (readyJobs.empty())
+		return nullptr;
+	Job* job = readyJobs.front();
+	readyJobs.pop_front();
+	return job;
+}
+
+void FrameScheduler::execute(Job* job)
+{
+	unsigned long long cpuStart = PerformanceDebugger::threadCpuTime();
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+	try {
+		job->func();
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(errorMutex);
+		if (!firstError)
+			firstError = std::current_exception();
+	}
+
+	job->cpuTime = PerformanceDebugger::threadCpuTime() - cpuStart;
+	job->wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count();
+
+	for (JobId succ : job->successors) {
+		Job* next = jobs[succ].get();
+		if (--next->remaining == 0)
+			pushJob(next);
+	}
+
+	if (--nbPending == 0) {
+		// take the lock so that run() can't miss the wake up between its test and its wait
+		{
+			std::lock_guard<std::mutex> lock(readyMutex);
+		}
+		wakeUp.notify_all();
+	}
+}
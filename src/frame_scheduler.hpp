@@ -0,0 +1,131 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _FRAME_SCHEDULER_HPP_
+#define _FRAME_SCHEDULER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * \class FrameScheduler
+ * \brief Ordonnanceur des tâches calculées à chaque frame
+ *
+ * Les tâches sont exécutées par un ThreadPool créé une seule fois au lancement
+ * du logiciel, au lieu de lancer un std::async (donc un thread système) par tâche
+ * et par frame.
+ *
+ * @section FONCTIONNEMENT
+ *
+ * À chaque frame, l'appelant déclare ses tâches avec addJob() en précisant
+ * éventuellement les tâches dont elles dépendent, puis appelle run().
+ *
+ * JobId a = scheduler->addJob("label_a", fa);
+ * JobId b = scheduler->addJob("label_b", fb);
+ * scheduler->addJob("label_c", fc, {a, b});	// fc attend la fin de fa et fb
+ * scheduler->run();
+ *
+ * run() bloque jusqu'à la fin de toutes les tâches. Les tâches prêtes sont placées
+ * dans une file commune : chacune est proposée au ThreadPool, et le thread appelant
+ * prend lui aussi dans cette file au lieu d'attendre sans rien faire.
+ *
+ * Une tâche peut découper son propre calcul avec parallelFor(), qui utilise le même
+ * ThreadPool : les modules n'ont pas à créer leurs propres threads.
+ *
+ * Les durées CPU et réelles de chaque tâche sont transmises au PerformanceDebugger
+ * depuis le thread appelant, une fois la frame terminée.
+ */
+class FrameScheduler {
+public:
+	typedef int JobId;
+
+	//! \param nbWorkers nombre de threads du ThreadPool, 0 pour l'adapter au processeur
+	FrameScheduler(unsigned int nbWorkers = 0);
+	~FrameScheduler();
+	FrameScheduler(FrameScheduler const &) = delete;
+	FrameScheduler& operator = (FrameScheduler const &) = delete;
+
+	//! déclare une tâche pour la prochaine exécution de run()
+	//! \param label nom de la tâche, utilisé comme nom de timer par le PerformanceDebugger
+	//! \param func la tâche à exécuter
+	//! \param dependencies tâches de la même frame qui doivent être terminées avant celle-ci
+	//! \return l'identifiant de la tâche, valable jusqu'à la fin de run()
+	JobId addJob(const std::string &label, std::function<void()> func, const std::vector<JobId> &dependencies = {});
+
+	//! exécute toutes les tâches déclarées et attend leur fin.
+	//! La première exception levée par une tâche est relancée ici.
+	void run();
+
+	//! exécute func(0) à func(nbParts-1) sur le ThreadPool et attend leur fin.
+	//! Utilisable depuis une tâche de run() : le thread appelant calcule lui-même les parts
+	//! qu'aucun thread n'a encore prises, il n'attend que des parts en cours de calcul.
+	//! La première exception levée par une part est relancée ici.
+	void parallelFor(size_t nbParts, const std::function<void(size_t)> &func);
+
+	//! renvoie le nombre de threads du ThreadPool
+	unsigned int getNbWorkers() const {
+		return nbWorkers;
+	}
+
+private:
+	// description d'une tâche de la frame courante
+	struct Job {
+		std::string label;
+		std::function<void()> func;
+		std::vector<JobId> successors;		// tâches qui attendent celle-ci
+		std::atomic<int> remaining {0};		// nombre de dépendances non terminées
+		unsigned long long cpuTime = 0;		// durée CPU en microsecondes
+		unsigned long long wallTime = 0;	// durée réelle en microsecondes
+	};
+
+	// place une tâche prête dans la file et la propose au ThreadPool
+	void pushJob(Job* job);
+	// récupère la plus ancienne tâche prête, nullptr si la file est vide
+	Job* popJob();
+	// exécute une tâche et libère celles qui en dépendent
+	void execute(Job* job);
+
+	unsigned int nbWorkers;
+	std::unique_ptr<ThreadPool> pool;
+	std::vector<std::unique_ptr<Job>> jobs;			// tâches de la frame courante
+
+	std::mutex readyMutex;
+	std::condition_variable wakeUp;		// réveille le thread appelant de run()
+	std::deque<Job*> readyJobs;			// tâches prêtes non encore prises
+	std::atomic<int> nbPending {0};		// tâches de la frame non terminées
+
+	std::mutex errorMutex;
+	std::exception_ptr firstError;
+};
+
+#endif // _FRAME_SCHEDULER_HPP_
@@ -15,6 +15,7 @@
 
 
 #include "halo.hpp"
+#include "halo_batch.hpp"
 #include "body.hpp"
 #include "navigator.hpp"
 #include "projector.hpp"
@@ -27,6 +28,8 @@ using namespace std;
 
 DataGL Halo::HaloData;
 shaderProgram* Halo::shaderHalo = nullptr;
+UniformHandle Halo::uniformColor;
+UniformHandle Halo::uniformCmag;
 s_texture * Halo::tex_halo = nullptr;
 
 Halo::Halo(Body * _body)
@@ -52,8 +55,8 @@ void Halo::drawHalo(const Navigator* nav, const Projector* prj, const ToneReprod
 
 	shaderHalo->use();
 	//~ shaderHalo->setUniform("Color", bodyColor.halo_color);
-	shaderHalo->setUniform("Color", body->myColor->getHalo());
-	shaderHalo->setUniform("cmag", cmag);
+	shaderHalo->setUniform(uniformColor, body->myColor->getHalo());
+	shaderHalo->setUniform(uniformCmag, cmag);
 
 	glBindVertexArray(HaloData.vao);
 
@@ -74,7 +77,7 @@ void Halo::drawHalo(const Navigator* nav, const Projector* prj, const ToneReprod
 	vecHaloTex.clear();
 }
 
-void Halo::computeHalo(const Navigator* nav, const Projector* prj, const ToneReproductor* eye)
+bool Halo::computeSize(const Navigator* nav, const Projector* prj, const ToneReproductor* eye)
 {
 	//~ cout << "compute halo planete " << body->englishName << endl;
 
@@ -82,7 +85,8 @@ void Halo::computeHalo(const Navigator* nav, const Projector* prj, const ToneRep
 	if (fov_q > 60) fov_q = 60;
 	fov_q = 1.f/(fov_q*fov_q);
 
-	rmag = sqrtf(eye->adaptLuminance((expf(-0.92103f*(body->computeMagnitude(nav->getObserverHelioPos()) + 12.12331f)) * 108064.73f) * fov_q)) * 30.f * Body::object_scale;
+	const float mag = body->computeMagnitude(nav->getObserverHelioPos());
+	rmag = sqrtf(eye->adaptLuminance((expf(-0.92103f*(mag + 12.12331f)) * 108064.73f) * fov_q)) * 30.f * Body::object_scale;
 
 	if (body->is_satellite)	{
 		if (prj->getFov()>60) rmag=rmag/25; // usefull when going there
@@ -93,7 +97,7 @@ void Halo::computeHalo(const Navigator* nav, const Projector* prj, const ToneRep
 	// if size of star is too small (blink) we put its size to 1.2 --> no more blink
 	// And we compensate the difference of brighteness with cmag
 	if (rmag<1.2f) {
-		if (body->computeMagnitude(nav->getObserverHelioPos())>0.) cmag=rmag*rmag/1.44f;
+		if (mag>0.) cmag=rmag*rmag/1.44f;
 		else cmag=rmag/1.2f;
 		rmag=1.2f;
 	} else {
@@ -134,10 +138,13 @@ void Halo::computeHalo(const Navigator* nav, const Projector* prj, const ToneRep
 			}
 	}
 
-	if (rmag<1.21 && cmag < 0.05)
-		return;
-
+	return !(rmag<1.21 && cmag < 0.05);
+}
 
+void Halo::computeHalo(const Navigator* nav, const Projector* prj, const ToneReproductor* eye)
+{
+	if (!computeSize(nav, prj, eye))
+		return;
 
 	Vec2f screenPosF ((float) body->screenPos[0], (float)body->screenPos[1]);
 
@@ -163,13 +170,20 @@ void Halo::computeHalo(const Navigator* nav, const Projector* prj, const ToneRep
 
 }
 
+void Halo::addToBatch(const Navigator* nav, const Projector* prj, const ToneReproductor* eye, HaloBatch &batch)
+{
+	if (!computeSize(nav, prj, eye))
+		return;
+	batch.add(Vec2f((float) body->screenPos[0], (float) body->screenPos[1]), rmag, body->myColor->getHalo() * cmag);
+}
+
 void Halo::createShader()
 {
 
 	shaderHalo = new shaderProgram();
 	shaderHalo->init( "body_halo.vert", "body_halo.frag");
-	shaderHalo->setUniformLocation("Color");
-	shaderHalo->setUniformLocation("cmag");
+	uniformColor = shaderHalo->setUniformLocation("Color");
+	uniformCmag = shaderHalo->setUniformLocation("cmag");
 
 	glGenVertexArrays(1,&HaloData.vao);
 	glBindVertexArray(HaloData.vao);
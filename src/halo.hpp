@@ -26,6 +26,7 @@
 #include <vector>
 
 class Body;
+class HaloBatch;
 class Navigator;
 class Projector;
 class ToneReproductor;
@@ -43,19 +44,30 @@ public:
 
 	void computeHalo(const Navigator* nav, const Projector* prj, const ToneReproductor* eye);
 
+	//! ajoute le halo au lot au lieu de le dessiner seul
+	void addToBatch(const Navigator* nav, const Projector* prj, const ToneReproductor* eye, HaloBatch &batch);
+
 	static bool setTexHaloMap(const std::string &texMap);
 
 	static void deleteDefaultTexMap();
 
+	static s_texture* getTexHaloMap() {
+		return tex_halo;
+	}
+
 	static void createShader();
 	static void deleteShader();
 
 private:
 
+	// calcule rmag et cmag, renvoie faux si le halo est trop faible pour être dessiné
+	bool computeSize(const Navigator* nav, const Projector* prj, const ToneReproductor* eye);
+
 	Body * body;
 
 	static DataGL HaloData;
 	static shaderProgram* shaderHalo;
+	static UniformHandle uniformColor, uniformCmag;
 	std::vector<float> vecHaloPos;
 	std::vector<float> vecHaloTex;
 	static s_texture * tex_halo;			// Little halo texture
@@ -0,0 +1,108 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include "halo_batch.hpp"
+#include "halo.hpp"
+#include "s_texture.hpp"
+#include "stateGL.hpp"
+
+shaderProgram* HaloBatch::shaderBatch = nullptr;
+
+HaloBatch::~HaloBatch()
+{
+	if (batchData.vao != 0) {
+		glDeleteBuffers(1, &batchData.color);
+		glDeleteBuffers(1, &batchData.scale);
+		glDeleteBuffers(1, &batchData.pos);
+		glDeleteVertexArrays(1, &batchData.vao);
+	}
+}
+
+void HaloBatch::createGLBuffer()
+{
+	glGenVertexArrays(1, &batchData.vao);
+	glBindVertexArray(batchData.vao);
+
+	glGenBuffers(1, &batchData.pos);
+	glBindBuffer(GL_ARRAY_BUFFER, batchData.pos);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+
+	glGenBuffers(1, &batchData.scale);
+	glBindBuffer(GL_ARRAY_BUFFER, batchData.scale);
+	glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 0, NULL);
+
+	glGenBuffers(1, &batchData.color);
+	glBindBuffer(GL_ARRAY_BUFFER, batchData.color);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+}
+
+void HaloBatch::draw()
+{
+	if (radius.empty() || Halo::getTexHaloMap() == nullptr)
+		return;
+
+	if (batchData.vao == 0)
+		createGLBuffer();
+
+	StateGL::BlendFunc(GL_ONE, GL_ONE);
+	StateGL::enable(GL_BLEND);
+	StateGL::disable(GL_DEPTH_TEST);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, Halo::getTexHaloMap()->getID());
+
+	shaderBatch->use();
+	glBindVertexArray(batchData.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, batchData.pos);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*pos.size(), pos.data(), GL_DYNAMIC_DRAW);
+
+	glBindBuffer(GL_ARRAY_BUFFER, batchData.scale);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*radius.size(), radius.data(), GL_DYNAMIC_DRAW);
+
+	glBindBuffer(GL_ARRAY_BUFFER, batchData.color);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*color.size(), color.data(), GL_DYNAMIC_DRAW);
+
+	glDrawArrays(GL_POINTS, 0, radius.size());
+
+	shaderBatch->unuse();
+}
+
+void HaloBatch::createShader()
+{
+	shaderBatch = new shaderProgram();
+	shaderBatch->init("body_halo_batch.vert", "body_halo_batch.geom", "body_halo_batch.frag");
+}
+
+void HaloBatch::deleteShader()
+{
+	if (shaderBatch) {
+		delete shaderBatch;
+		shaderBatch = nullptr;
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _HALO_BATCH_HPP_
+#define _HALO_BATCH_HPP_
+
+#include <vector>
+
+#include "shader.hpp"
+
+/**
+ * \class HaloBatch
+ * \brief Halos des petits corps dessinés en un seul appel
+ *
+ * Un corps trop petit à l'écran pour être tracé se réduit à son halo. Au lieu d'un
+ * appel de dessin par corps, les halos sont rangés par attribut (position à l'écran,
+ * rayon et couleur déjà multipliée par cmag) puis envoyés ensemble comme des points que
+ * le geometry shader transforme en carrés texturés.
+ */
+class HaloBatch {
+
+public:
+	HaloBatch() {};
+	~HaloBatch();
+	HaloBatch(HaloBatch const &) = delete;
+	HaloBatch& operator = (HaloBatch const &) = delete;
+
+	void clear() {
+		pos.clear();
+		radius.clear();
+		color.clear();
+	}
+
+	//! ajoute un halo de rayon _radius en pixels autour de screenPos
+	void add(const Vec2f &screenPos, float _radius, const Vec3f &_color) {
+		pos.push_back(screenPos[0]);
+		pos.push_back(screenPos[1]);
+		radius.push_back(_radius);
+		color.push_back(_color[0]);
+		color.push_back(_color[1]);
+		color.push_back(_color[2]);
+	}
+
+	unsigned int size() const {
+		return radius.size();
+	}
+
+	//! dessine tous les halos du lot
+	void draw();
+
+	static void createShader();
+	static void deleteShader();
+
+private:
+	// vertex buffers du lot, créés au premier affichage
+	void createGLBuffer();
+
+	std::vector<float> pos;
+	std::vector<float> radius;
+	std::vector<float> color;
+
+	DataGL batchData;
+	static shaderProgram* shaderBatch;
+};
+
+#endif // _HALO_BATCH_HPP_
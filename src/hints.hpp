@@ -44,6 +44,11 @@ public :
 		hint_fader = b;
 	}
 
+	//! vrai tant que les indications sont affichées, même en cours de fondu
+	bool isVisible() const {
+		return hint_fader.getInterstate() > 0.f;
+	}
+
 	void drawHints(const Navigator* nav, const Projector* prj);
 
 	void drawHintCircle(const Navigator* nav, const Projector* prj);
@@ -110,10 +110,16 @@ public:
 
 	ObjectBaseP createStelObject(const SpecialZoneArray<Star1> *a, const SpecialZoneData<Star1> *z) const;
 
+	//! coefficients of the zone axis giving the position of the star
+	void getAxisCoeffs(double movement_factor, double &c0, double &c1) const {
+		c0 = (float)(getX0())+movement_factor*getDx0();
+		c1 = (float)(getX1())+movement_factor*getDx1();
+	}
+
 	Vec3d getJ2000Pos(const ZoneData *z,double movement_factor) const {
-		Vec3d pos = z->center
-		            + ((float)(getX0())+movement_factor*getDx0())*z->axis0
-		            + ((float)(getX1())+movement_factor*getDx1())*z->axis1;
+		double c0, c1;
+		getAxisCoeffs(movement_factor, c0, c1);
+		Vec3d pos = z->center + c0*z->axis0 + c1*z->axis1;
 		pos.normalize();
 		return pos;
 	}
@@ -168,10 +174,16 @@ public :
 
 	ObjectBaseP createStelObject(const SpecialZoneArray<Star2> *a, const SpecialZoneData<Star2> *z) const;
 
+	//! coefficients of the zone axis giving the position of the star
+	void getAxisCoeffs(double movement_factor, double &c0, double &c1) const {
+		c0 = (double)(getX0())+movement_factor*getDx0();
+		c1 = (double)(getX1())+movement_factor*getDx1();
+	}
+
 	Vec3d getJ2000Pos(const ZoneData *z,double movement_factor) const {
-		Vec3d pos = z->center
-		            + ((double)(getX0())+movement_factor*getDx0())*z->axis0
-		            + ((double)(getX1())+movement_factor*getDx1())*z->axis1;
+		double c0, c1;
+		getAxisCoeffs(movement_factor, c0, c1);
+		Vec3d pos = z->center + c0*z->axis0 + c1*z->axis1;
 		pos.normalize();
 		return pos;
 	}
@@ -216,6 +228,12 @@ public:
 
 	ObjectBaseP createStelObject(const SpecialZoneArray<Star3> *a, const SpecialZoneData<Star3> *z) const;
 
+	//! coefficients of the zone axis giving the position of the star
+	void getAxisCoeffs(double, double &c0, double &c1) const {
+		c0 = (double)(getX0());
+		c1 = (double)(getX1());
+	}
+
 	Vec3d getJ2000Pos(const ZoneData *z,double) const {
 		Vec3d pos = z->center + (double)(getX0())*z->axis0 + (double)(getX1())*z->axis1;
 		pos.normalize();
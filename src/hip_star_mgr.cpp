@@ -43,11 +43,13 @@
 #include "string_array.hpp"
 
 #include "time_mgr.hpp"
+#include "frame_scheduler.hpp"
 
 #include "log.hpp"
 
 #include <string>
 #include <list>
+#include <chrono>
 
 #include <errno.h>
 #include <string.h>
@@ -99,6 +101,12 @@ void HipStarMgr::initTriangle(int lev,int index, const Vec3d &c0, const Vec3d &c
 	if (it!=zone_arrays.end()) it->second->initTriangle(index,c0,c1,c2);
 }
 
+void HipStarMgr::initArrayTriangleFunc(int lev, int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2, void *context)
+{
+	ZoneArray *array = reinterpret_cast<ZoneArray*>(context);
+	if (lev == array->level) array->initTriangle(index,c0,c1,c2);
+}
+
 
 
 Vec3f HipStarMgr::color_table[128];
@@ -176,12 +184,14 @@ static void InitColorTableFromConfigFile(const InitParser &conf)
 }
 
 
-HipStarMgr::HipStarMgr(int width,int height) :
+HipStarMgr::HipStarMgr(int width,int height, FrameScheduler *_scheduler) :
 	starTexture(),
 	hip_index(new HipIndexStruct[NR_OF_HIP+1]),
 	mag_converter(new MagConverter(*this)),
 	fontSize(13.),
-	starFont(0)
+	starFont(0),
+	twinkle_seed(0),
+	scheduler(_scheduler)
 {
 	starsFader.setDuration(3000);
 	setMagConverterMaxScaled60DegMag(6.5f);
@@ -201,6 +211,9 @@ HipStarMgr::HipStarMgr(int width,int height) :
 	shaderFBO->init("fbo.vert","fbo.frag");
 
 	createShaderParams( width, height);
+
+	// more parts than threads to share the load between dense and empty zones
+	drawBuffers.resize(4*(scheduler->getNbWorkers()+1));
 }
 
 //TODO fix float[NBR_MAX_STARS];
@@ -284,6 +297,12 @@ void HipStarMgr::createShaderParams(int width,int height)
 
 HipStarMgr::~HipStarMgr(void)
 {
+	// the pool finishes the loadings already started before its threads are joined
+	delete loadPool;
+	for (PendingCatalog &catalog : pendingCatalogs)
+		delete catalog.job.get().array;
+	pendingCatalogs.clear();
+
 	ZoneArrayMap::iterator it(zone_arrays.end());
 	while (it!=zone_arrays.begin()) {
 		--it;
@@ -355,6 +374,7 @@ void HipStarMgr::init(float font_size, const string& font_name, const InitParser
 
 void HipStarMgr::setGrid(GeodesicGrid* geodesic_grid)
 {
+	grid = geodesic_grid;
 	geodesic_grid->visitTriangles(max_geodesic_grid_level,initTriangleFunc,this);
 	for (ZoneArrayMap::const_iterator it(zone_arrays.begin()); it!=zone_arrays.end(); it++) {
 		it->second->scaleAxis();
@@ -375,37 +395,64 @@ void HipStarMgr::load_data(const InitParser &baseConf)
 	InitParser conf;
 	conf.load(AppSettings::Instance()->getConfigDir() + "stars.ini");
 
+	// the headers give the level of each catalogue: the geodesic grid
+	// can be sized before the end of the loadings
+	std::vector<PendingCatalog> hipCatalogs;
 	for (int i=0; i<8; i++) {
 		char key_name[64];
 		sprintf(key_name,"cat_file_name_%02d",i);
 		const string cat_file_name = conf.getStr("stars",key_name).c_str();
-		if (!cat_file_name.empty()) {
-			Log.write(_("Loading catalog ") + string(cat_file_name) , cLog::LOG_TYPE::L_INFO);
-			ZoneArray *const z = ZoneArray::create(*this,cat_file_name);
-			if (z) {
-				if (max_geodesic_grid_level < z->level) {
-					max_geodesic_grid_level = z->level;
-				}
-				ZoneArray *&pos(zone_arrays[z->level]);
-				if (pos) {
-					cerr << cat_file_name << ", " << z->level << ": duplicate level" << endl;
-					delete z;
-				} else {
-					pos = z;
-				}
-			}
+		if (cat_file_name.empty())
+			continue;
+		int level, type;
+		if (!ZoneArray::readHeader(cat_file_name, level, type)) {
+			Log.write("HipStarMgr: can't read catalog " + cat_file_name, cLog::LOG_TYPE::L_ERROR);
+			continue;
+		}
+		bool duplicate = false;
+		for (const PendingCatalog &catalog : hipCatalogs)
+			duplicate |= (catalog.level == level);
+		for (const PendingCatalog &catalog : pendingCatalogs)
+			duplicate |= (catalog.level == level);
+		if (duplicate) {
+			cerr << cat_file_name << ", " << level << ": duplicate level" << endl;
+			continue;
+		}
+		if (max_geodesic_grid_level < level) {
+			max_geodesic_grid_level = level;
 		}
+		// type 0: Hipparcos stars, the brightest ones and the only ones with a HIP number
+		std::vector<PendingCatalog> &target = (type == 0) ? hipCatalogs : pendingCatalogs;
+		target.push_back({cat_file_name, level, std::future<CatalogLoad>()});
 	}
 
+	// open and read (or map) all the catalogues at once
+	unsigned int nbThreads = std::thread::hardware_concurrency();
+	nbThreads = std::max(1u, std::min(nbThreads, (unsigned int)(hipCatalogs.size() + pendingCatalogs.size())));
+	loadPool = new ThreadPool(nbThreads);
+	for (PendingCatalog &catalog : hipCatalogs)
+		catalog.job = loadPool->enqueue(&HipStarMgr::loadCatalog, this, catalog.fileName);
+	for (PendingCatalog &catalog : pendingCatalogs)
+		catalog.job = loadPool->enqueue(&HipStarMgr::loadCatalog, this, catalog.fileName);
+
+	// the constellations and the searches need the HIP numbers right after init:
+	// the Hipparcos catalogues are waited for, the fainter stars are drawn as soon as they arrive
+	for (PendingCatalog &catalog : hipCatalogs)
+		addCatalog(catalog);
+
 	for (int i=0; i<=NR_OF_HIP; i++) {
 		hip_index[i].a = 0;
 		hip_index[i].z = 0;
 		hip_index[i].s = 0;
 	}
+	// a HIP number belongs to one level only, so the arrays write to distinct entries
+	std::vector<const ZoneArray*> arrays;
 	for (ZoneArrayMap::const_iterator it(zone_arrays.begin());
-	        it != zone_arrays.end(); it++) {
-		it->second->updateHipIndex(hip_index);
-	}
+	        it != zone_arrays.end(); it++)
+		arrays.push_back(it->second);
+	scheduler->parallelFor(arrays.size(), [this, &arrays](size_t i) {
+		arrays[i]->updateHipIndex(hip_index);
+	});
 
 	const string cat_hip_sp_file_name = conf.getStr("stars","cat_hip_sp_file_name").c_str();
 	if (cat_hip_sp_file_name.empty()) {
@@ -431,11 +478,66 @@ void HipStarMgr::load_data(const InitParser &baseConf)
 
 	last_max_search_level = max_geodesic_grid_level;
 	std::ostringstream oss;
-	oss <<  "finished, max_geodesic_level: " << max_geodesic_grid_level;
+	oss <<  "finished, max_geodesic_level: " << max_geodesic_grid_level << ", " << pendingCatalogs.size() << " catalogs still loading";
 	Log.write( oss.str() , cLog::LOG_TYPE::L_INFO);
 	Log.mark();
 }
 
+HipStarMgr::CatalogLoad HipStarMgr::loadCatalog(const HipStarMgr *mgr, const string &fileName)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ZoneArray *array = ZoneArray::create(*mgr, fileName);
+	return {array, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()};
+}
+
+ZoneArray *HipStarMgr::addCatalog(PendingCatalog &catalog)
+{
+	const CatalogLoad load = catalog.job.get();
+	std::ostringstream oss;
+	if (load.array == nullptr) {
+		oss << "HipStarMgr: failed to load catalog " << catalog.fileName;
+		Log.write(oss.str(), cLog::LOG_TYPE::L_ERROR);
+		return nullptr;
+	}
+	// the header said another level than the data
+	if (load.array->level != catalog.level || zone_arrays.count(load.array->level)) {
+		cerr << catalog.fileName << ", " << load.array->level << ": duplicate level" << endl;
+		delete load.array;
+		return nullptr;
+	}
+	zone_arrays[load.array->level] = load.array;
+	oss << "Loaded catalog " << catalog.fileName << ": level " << load.array->level << ", "
+	    << load.array->getNrOfStars() << " stars in " << load.loadTime << " ms";
+	Log.write(oss.str(), cLog::LOG_TYPE::L_INFO);
+	return load.array;
+}
+
+void HipStarMgr::checkPendingCatalogs()
+{
+	// the triangles of the zones are initialized from the grid
+	if (grid == nullptr)
+		return;
+
+	for (std::vector<PendingCatalog>::iterator it = pendingCatalogs.begin(); it != pendingCatalogs.end();) {
+		if (it->job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+		ZoneArray *array = addCatalog(*it);
+		if (array) {
+			grid->visitTriangles(array->level, initArrayTriangleFunc, array);
+			array->scaleAxis();
+			array->updateHipIndex(hip_index);
+		}
+		it = pendingCatalogs.erase(it);
+	}
+
+	if (pendingCatalogs.empty()) {
+		delete loadPool;
+		loadPool = nullptr;
+	}
+}
+
 //! Load common names from file
 int HipStarMgr::loadCommonNames(const string& commonNameFile)
 {
@@ -536,9 +638,27 @@ void HipStarMgr::loadSciNames(const string& sciNameFile)
 	fclose(snFile);
 }
 
-int HipStarMgr::drawStar(const Projector *prj,const Vec3d &XY, const float rc_mag[2], const Vec3f &color) const
+// integer hash (lowbias32), good enough to decorrelate neighbour keys
+static inline unsigned int hashTwinkle(unsigned int x)
 {
-	if (rc_mag[0]<=0.f || rc_mag[1]<=0.f || nbStarsToDraw >= NBR_MAX_STARS) return -1;
+	x ^= x >> 16;
+	x *= 0x7feb352dU;
+	x ^= x >> 15;
+	x *= 0x846ca68bU;
+	x ^= x >> 16;
+	return x;
+}
+
+float HipStarMgr::twinkleNoise(unsigned int star_key, unsigned int channel) const
+{
+	const unsigned int h = hashTwinkle(hashTwinkle(star_key) ^ (3*twinkle_seed + channel));
+	// 24 bits fit exactly in a float: result in [0,1)
+	return (h >> 8) * (1.f/16777216.f);
+}
+
+int HipStarMgr::drawStar(const Projector *prj, double x, double y, const float rc_mag[2], const Vec3f &color, unsigned int star_key, StarDrawBuffer &buffer) const
+{
+	if (rc_mag[0]<=0.f || rc_mag[1]<=0.f || buffer.nbStars >= NBR_MAX_STARS) return -1;
 
 	float mag = 2.f*rc_mag[0];
 
@@ -548,14 +668,14 @@ int HipStarMgr::drawStar(const Projector *prj,const Vec3d &XY, const float rc_ma
 	if( mag > rolloff )
 		mag = rolloff;
 
-	dataPos.push_back(XY[0]);
-	dataPos.push_back(XY[1]);
-	dataMag.push_back(mag);
-	dataColor.push_back(color[0]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX));
-	dataColor.push_back(color[1]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX));
-	dataColor.push_back(color[2]*rc_mag[1]*(1.-twinkle_amount*rand()/RAND_MAX));
+	buffer.pos.push_back(x);
+	buffer.pos.push_back(y);
+	buffer.mag.push_back(mag);
+	buffer.color.push_back(color[0]*rc_mag[1]*(1.-twinkle_amount*twinkleNoise(star_key, 0)));
+	buffer.color.push_back(color[1]*rc_mag[1]*(1.-twinkle_amount*twinkleNoise(star_key, 1)));
+	buffer.color.push_back(color[2]*rc_mag[1]*(1.-twinkle_amount*twinkleNoise(star_key, 2)));
 
-	nbStarsToDraw += 1;
+	buffer.nbStars += 1;
 
 	return 0;
 }
@@ -658,18 +778,30 @@ double HipStarMgr::preDraw(GeodesicGrid* grid, ToneReproductor* eye, Projector*
 	// Set temporary static variable for optimization
 	if (flagStarTwinkle) twinkle_amount = twinkleAmount*twinkle_param;
 	else twinkle_amount = 0;
+	// one new twinkle pattern per frame, the same on every run
+	twinkle_seed++;
 	const float names_brightness = names_fader.getInterstate() * starsFader.getInterstate();
 
-	float rcmag_table[2*256];
+	// list the zones to draw level by level, they are projected all together afterwards
+	zonesToDraw.clear();
+	rcmagTables.clear();
+	maxMagStarNames.clear();
+	double result = 1.;
 
 	for (ZoneArrayMap::const_iterator it(zone_arrays.begin()); it!=zone_arrays.end(); it++) {
 		const float mag_min = 0.001f*it->second->mag_min;
+		const int levelIndex = maxMagStarNames.size();
+		rcmagTables.resize(rcmagTables.size() + 2*256);
+		float *rcmag_table = rcmagTables.data() + 2*256*levelIndex;
 
 		const float k = (0.001f*it->second->mag_range)/it->second->mag_steps;
 		for (int i=it->second->mag_steps-1; i>=0; i--) {
 			const float mag = mag_min+k*i;
 			if (mag_converter->computeRCMag(mag, eye, rcmag_table + 2*i) < 0) {
-				if (i==0) return 0.; //goto exit_loop;
+				if (i==0) {
+					result = 0.;
+					goto exit_loop;
+				}
 			}
 			rcmag_table[2*i] *= starsFader.getInterstate();
 		}
@@ -680,17 +812,49 @@ double HipStarMgr::preDraw(GeodesicGrid* grid, ToneReproductor* eye, Projector*
 			int x = (int)((maxMagStarName-mag_min)/k);
 			if (x > 0) max_mag_star_name = x;
 		}
+		maxMagStarNames.push_back(max_mag_star_name);
+
 		int zone;
 		for (GeodesicSearchInsideIterator it1(*geodesic_search_result,it->first); (zone = it1.next()) >= 0;) {
-			it->second->draw(zone,true,rcmag_table,prj, max_mag_star_name,names_brightness, starNameToDraw);
+			zonesToDraw.push_back({it->second, zone, true, levelIndex});
 		}
 		for (GeodesicSearchBorderIterator it1(*geodesic_search_result,it->first); (zone = it1.next()) >= 0;) {
-			it->second->draw(zone,false,rcmag_table,prj, max_mag_star_name,names_brightness, starNameToDraw);
+			zonesToDraw.push_back({it->second, zone, false, levelIndex});
 		}
 
 	}
-//~ exit_loop:
-	return 1.;
+exit_loop:
+	projectZones(prj, names_brightness);
+	return result;
+}
+
+void HipStarMgr::projectZones(Projector* prj, float names_brightness)
+{
+	// contiguous parts of zonesToDraw, so that merging the buffers in order
+	// gives the same stars as a projection of the zones one after the other
+	const size_t nbParts = std::min(zonesToDraw.size(), drawBuffers.size());
+	scheduler->parallelFor(nbParts, [this, prj, names_brightness, nbParts](size_t p) {
+		const size_t begin = zonesToDraw.size()*p/nbParts;
+		const size_t end = zonesToDraw.size()*(p+1)/nbParts;
+		StarDrawBuffer &buffer = drawBuffers[p];
+		buffer.clear();
+		for (size_t i=begin; i<end && buffer.nbStars<NBR_MAX_STARS; i++) {
+			const ZoneToDraw &zd = zonesToDraw[i];
+			zd.array->draw(zd.zone, zd.inside, rcmagTables.data() + 2*256*zd.levelIndex, prj,
+			               maxMagStarNames[zd.levelIndex], names_brightness, buffer);
+		}
+	});
+
+	for (size_t p=0; p<nbParts && nbStarsToDraw<NBR_MAX_STARS; p++) {
+		const StarDrawBuffer &buffer = drawBuffers[p];
+		const int n = std::min(buffer.nbStars, NBR_MAX_STARS-nbStarsToDraw);
+		dataPos.insert(dataPos.end(), buffer.pos.begin(), buffer.pos.begin() + 2*n);
+		dataMag.insert(dataMag.end(), buffer.mag.begin(), buffer.mag.begin() + n);
+		dataColor.insert(dataColor.end(), buffer.color.begin(), buffer.color.begin() + 3*n);
+		for (size_t j=0; j<buffer.names.size() && buffer.nameStar[j]<n; j++)
+			starNameToDraw.push_back(buffer.names[j]);
+		nbStarsToDraw += n;
+	}
 }
 
 double HipStarMgr::draw(GeodesicGrid* grid, ToneReproductor* eye, Projector* prj, TimeMgr* timeMgr, float altitude)
@@ -768,6 +932,7 @@ void HipStarMgr::drawStarName( Projector* prj )
 		prj->printGravity180(starFont, std::get<0>(token), std::get<1>(token), std::get<2>(token), std::get<3>(token), true,4,4);
 		//  prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
 	}
+	starFont->flush();
 	//cout << "Nombre de nom à afficher : " << starNameToDraw.size() << endl;
 }
 
@@ -29,10 +29,12 @@
 #include <cstdlib>
 #include <cstdio>
 #include <tuple>
+#include <future>
 #include "fader.hpp"
 #include "object_type.hpp"
 #include "shader.hpp"
 #include "stateGL.hpp"
+#include "ThreadPool.hpp"
 
 class Translator;
 class InitParser;
@@ -45,9 +47,29 @@ class TimeMgr;
 class s_font;
 class HipStarMgr;
 class GeodesicGrid;
+class FrameScheduler;
 
 typedef std::tuple<double, double, const std::string , const Vec4f > starDBtoDraw;
 
+//! stars projected by one thread of HipStarMgr::preDraw, merged at the end of the projection
+struct StarDrawBuffer {
+	std::vector<float> pos;
+	std::vector<float> mag;
+	std::vector<float> color;
+	std::vector<starDBtoDraw> names;
+	std::vector<int> nameStar;	//! index in this buffer of the star owning each name
+	int nbStars = 0;
+
+	void clear() {
+		pos.clear();
+		mag.clear();
+		color.clear();
+		names.clear();
+		nameStar.clear();
+		nbStars = 0;
+	}
+};
+
 namespace BigStarCatalog {
 class ZoneArray;
 class HipIndexStruct;
@@ -129,7 +151,8 @@ private:
 
 class HipStarMgr {
 public:
-	HipStarMgr(int width,int height);
+	//! \param scheduler fournit les threads de la projection des zones
+	HipStarMgr(int width,int height, FrameScheduler *scheduler);
 	virtual ~HipStarMgr(void);
 	HipStarMgr(HipStarMgr const &) = delete;
 	HipStarMgr& operator = (HipStarMgr const &) = delete;
@@ -156,9 +179,12 @@ public:
 
 	//! Update any time-dependent features.
 	//! Includes fading in and out stars and labels when they are turned on and off.
+	//! Also adds the catalogues whose loading has finished since the last frame.
 	virtual void update(double deltaTime) {
 		names_fader.update(deltaTime);
 		starsFader.update(deltaTime);
+		if (!pendingCatalogs.empty())
+			checkPendingCatalogs();
 	}
 
 	//! Translate text.
@@ -407,8 +433,9 @@ public:
 		return flagSciNames;
 	}
 
-	//! Draw a star of specified position, magnitude and color.
-	int drawStar(const Projector *prj, const Vec3d &XY, const float rc_mag[2], const Vec3f &color) const;
+	//! Add to buffer a star of specified window position, magnitude and color.
+	//! star_key identifies the star in the catalogue and drives its twinkle.
+	int drawStar(const Projector *prj, double x, double y, const float rc_mag[2], const Vec3f &color, unsigned int star_key, StarDrawBuffer &buffer) const;
 
 	//! Get the (translated) common name for a star with a specified
 	//! Hipparcos catalogue number.
@@ -437,10 +464,30 @@ public:
 
 private:
 	//! Load all the stars from the files.
+	//! Only the Hipparcos catalogues are waited for, the other ones are added by update() when they are ready.
 	void load_data(const InitParser &conf);
 
+	// un catalogue chargé en arrière-plan par loadPool
+	struct CatalogLoad {
+		BigStarCatalog::ZoneArray *array;
+		double loadTime;	// ms
+	};
+	struct PendingCatalog {
+		std::string fileName;
+		int level;
+		std::future<CatalogLoad> job;
+	};
+	static CatalogLoad loadCatalog(const HipStarMgr *mgr, const std::string &fileName);
+	//! attend la fin du chargement et range le catalogue dans zone_arrays, renvoie nullptr en cas d'échec
+	BigStarCatalog::ZoneArray *addCatalog(PendingCatalog &catalog);
+	//! ajoute les catalogues arrivés depuis la dernière frame, thread principal seulement
+	void checkPendingCatalogs();
+
 	void drawStarName( Projector* prj );
 
+	//! project the zones of zonesToDraw on the threads of the scheduler and merge the results
+	void projectZones(Projector* prj, float names_brightness);
+
 	LinearFader names_fader;
 	LinearFader starsFader;
 
@@ -467,6 +514,13 @@ private:
 
 	void initTriangle(int lev, int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2);
 
+	// initialise les triangles d'un seul catalogue, arrivé après setGrid
+	static void initArrayTriangleFunc(int lev, int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2, void *context);
+
+	GeodesicGrid *grid = nullptr;					//! known from setGrid
+	std::vector<PendingCatalog> pendingCatalogs;	//! catalogues still loading
+	ThreadPool *loadPool = nullptr;					//! deleted once all the catalogues are loaded
+
 	BigStarCatalog::HipIndexStruct *hip_index; //! array of hiparcos stars
 
 	MagConverter *mag_converter;
@@ -485,19 +539,36 @@ private:
 	s_font* starFont;
 	static bool flagSciNames;
 	float twinkle_amount;
+	unsigned int twinkle_seed;	//! frame counter feeding twinkleNoise
+
+	//! deterministic noise in [0,1) for a star, a color channel and the current frame
+	float twinkleNoise(unsigned int star_key, unsigned int channel) const;
 
 	std::vector<starDBtoDraw> starNameToDraw;
 
 	s_texture* texPointer;		//! The selection pointer texture
 
-	mutable int nbStarsToDraw;
+	int nbStarsToDraw;
 	void createShaderParams(int width,int height);
 	void deleteShader();
 	shaderProgram* shaderStars;
 	shaderProgram* shaderFBO;
-	mutable std::vector<float> dataPos;
-	mutable std::vector<float> dataMag;
-	mutable std::vector<float> dataColor;
+	std::vector<float> dataPos;
+	std::vector<float> dataMag;
+	std::vector<float> dataColor;
+
+	// a zone of a ZoneArray to project, levelIndex refers to rcmagTables and maxMagStarNames
+	struct ZoneToDraw {
+		const BigStarCatalog::ZoneArray *array;
+		int zone;
+		bool inside;
+		int levelIndex;
+	};
+	std::vector<ZoneToDraw> zonesToDraw;	//! in the drawing order of the catalogue
+	std::vector<float> rcmagTables;			//! 2*256 values for each level
+	std::vector<unsigned int> maxMagStarNames;
+	FrameScheduler *scheduler;
+	std::vector<StarDrawBuffer> drawBuffers;	//! one for each part of zonesToDraw
 	DataGL stars, drawFBO;
 	int sizeTexFbo;
 	bool starTrace = false;
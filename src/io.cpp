@@ -22,6 +22,7 @@
  *
  */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream> //ServerSocket
 #include <sstream>
@@ -32,9 +33,12 @@
 #include "spacecrafter.hpp"
 #include "utility.hpp"
 
-#ifdef WIN32
-#include <direct.h>
-#endif
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -59,6 +63,10 @@ Mise à jour le 17/07/2017
 #define BUFFER_SIZE 65536 //Taille du buffer par defaut (en octets)
 #define STATS_PERIOD 5000 //Durée minimum entre deux récapitulatifs dans la boucle (en millisecondes)
 #define MAX_BUFFER 1024 //la taille d'un buffer à envoyer comme réponse via le TCP
+#define INPUT_QUEUE_SIZE 4096 //Nombre de commandes en transit vers le thread principal
+#define MAX_EVENTS 64 //Nombre d'événements traités par appel à epoll_wait
+#define MAX_WRITE_BUFFER 1048576 //Données en attente au-delà desquelles les messages à un client lent sont perdus
+#define PARTIAL_LINE_TIMEOUT 20 //Délai en ms après lequel une commande sans \n est traitée
 
 /* Valeurs d'avertissement */
 #define LOT_OF_CLIENTS 32 //Limite de clients simulatannés considérée comme grande et non testée
@@ -67,13 +75,27 @@ Mise à jour le 17/07/2017
 
 
 
-ServerSocket::ServerSocket(unsigned int port, int logLevel)
+
+namespace {
+
+/* Identification des descripteurs dans epoll : place du client et socket */
+const uint32_t SERVER_SLOT = 0xFFFFFFFF;
+const uint32_t WAKE_SLOT = 0xFFFFFFFE;
+
+uint64_t epollTag(int fd, uint32_t slot)
+{
+	return ((uint64_t)(uint32_t)fd << 32) | slot;
+}
+
+}
+
+ServerSocket::ServerSocket(unsigned int port, int logLevel) : inputQueue(INPUT_QUEUE_SIZE)
 {
 	initErrorCode = init(port, MAX_CLIENTS, BUFFER_SIZE, logLevel, IO_DEBUG_ALL);
 	if(initErrorCode != IO_NO_ERROR) throw initErrorCode;
 }
 
-ServerSocket::ServerSocket(unsigned int port, unsigned int maxClients, unsigned int bufferSize, int logLevel, int logScope)
+ServerSocket::ServerSocket(unsigned int port, unsigned int maxClients, unsigned int bufferSize, int logLevel, int logScope) : inputQueue(INPUT_QUEUE_SIZE)
 {
 	initErrorCode = init(port, maxClients, bufferSize, logLevel, logScope);
 	if(initErrorCode != IO_NO_ERROR) throw initErrorCode;
@@ -145,9 +167,11 @@ int ServerSocket::init(unsigned int port, unsigned int maxClients, unsigned int
 	initErrorCode = -1;
 	serverOpen = false;
 	stopThread = false;
-	activeSocketsCount = 0;
 	clientCount = 0;
-	broadcastId = 0;
+	serverSocket = -1;
+	epollFd = -1;
+	wakeFd = -1;
+	buffer = nullptr;
 
 	/* Initialisation des variables de statistiques */
 	maxSimultaneousClient = 0;
@@ -161,79 +185,41 @@ int ServerSocket::init(unsigned int port, unsigned int maxClients, unsigned int
 	dataSend = 0;
 	requestSendFailed = 0;
 	statsPeriod = STATS_PERIOD;
-	timeout = SDL_GetTicks();
+	timeout = std::chrono::steady_clock::now();
 
-	/* Initialisation de SDL_net */
-	if (SDLNet_Init() < 0) {
+	/* Création de l'instance epoll qui surveille tous les sockets */
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (epollFd < 0) {
 		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_NET_INIT_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_NET_INIT_ERROR_CODE;
-	}
-
-	/* Préparation de la connexion du serveur */
-	if(SDLNet_ResolveHost(&serverIP, NULL, this->port) < 0) {
-		if(debug(IO_DEBUG_ERROR, IO_DEBUG_SERVER))
-			debugOut("SDL_RESOLEVHOST_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_RESOLEVHOST_ERROR_CODE;
+			debugOut("EPOLL_CREATE_ERROR "+ (std::string)strerror(errno)); //Debug
+		return EPOLL_CREATE_ERROR_CODE;
 	}
 
-	/* Création d'un SocketSet pour surveiller les sockets */
-	socketSet = SDLNet_AllocSocketSet(maxClients + 1);
-	if (socketSet == NULL) {
+	/* Création de l'eventfd qui réveille la boucle quand il y a des données à envoyer */
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (wakeFd < 0) {
 		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_ALLOCSOCKETSET_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_ALLOCSOCKETSET_ERROR_CODE;
+			debugOut("EVENTFD_CREATE_ERROR "+ (std::string)strerror(errno)); //Debug
+		::close(epollFd);
+		return EVENTFD_CREATE_ERROR_CODE;
 	}
 
-	/* Création du mutex pour protéger l'exécution du thread */
-	running = SDL_CreateMutex();
-	if (running == NULL) {
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u64 = epollTag(wakeFd, WAKE_SLOT);
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
 		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_CREATEMUTEX_ERROR_CODE;
+			debugOut("EPOLL_ADD_EVENTFD_ERROR "+ (std::string)strerror(errno)); //Debug
+		::close(wakeFd);
+		::close(epollFd);
+		return EPOLL_ADD_EVENTFD_ERROR_CODE;
 	}
 
-	/* Initialisation du tableau de sockets clients */
-	clientSocketTab = new TCPsocket[maxClients]; //Allocation du tableau de sockets clients
-	if(clientSocketTab == NULL) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("NEW_TCPSOCKET_TAB_ERROR"); //Debug
-		return NEW_TCPSOCKET_TAB_ERROR_CODE;
-	}
-	clientBroadcastTab = new bool[maxClients];
-	if(clientBroadcastTab == NULL) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("NEW_BOOL_TAB_ERROR"); //Debug
-		return NEW_BOOL_TAB_ERROR_CODE;
-	}
-	for (unsigned int i = 0; i < maxClients; i++)	{
-		clientSocketTab[i] = NULL; //Initialisation de tous les sockets clients à NULL
-		clientBroadcastTab[i] = false;
-	}
+	/* Initialisation du tableau de clients */
+	clients.assign(maxClients, Client());
 
-	/* Initialisation du buffer */
-	buffer = new char[bufferSize];
-	if(buffer == NULL) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("NEW_BUFFER_ERROR"); //Debug
-		return NEW_BUFFER_ERROR_CODE;
-	}
-
-	/* Création du mutex pour protéger la file d'entrée des clients */
-	outputting = SDL_CreateMutex();
-	if (outputting == NULL) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_CREATEMUTEX_ERROR_CODE;
-	}
-
-	/* Création du mutex pour protéger la file de sortie des clients */
-	inputting = SDL_CreateMutex();
-	if (inputting == NULL) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_CREATEMUTEX_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_CREATEMUTEX_ERROR_CODE;
-	}
+	/* Initialisation du buffer de réception */
+	buffer = new char[bufferSize + 1];
 
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
 		debugOut("INIT_END"); //Debug
@@ -249,31 +235,50 @@ int ServerSocket::open()
 	if(debug(IO_DEBUG_INFO, IO_DEBUG_SERVER))
 		debugOut("SERVER_START "+ toString(port)); //Debug
 
-	/* Ouverture du socket serveur */
-	serverSocket = SDLNet_TCP_Open(&serverIP);
-	if (!serverSocket) {
+	/* Ouverture du socket serveur, non-bloquant, sur toutes les IPs */
+	serverSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (serverSocket >= 0) {
+		int reuse = 1;
+		setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		struct sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		address.sin_port = htons(port);
+		if (bind(serverSocket, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(serverSocket, SOMAXCONN) < 0) {
+			::close(serverSocket);
+			serverSocket = -1;
+		}
+	}
+	if (serverSocket < 0) {
 		if(debug(IO_DEBUG_ERROR, IO_DEBUG_SERVER))
-			debugOut("SDL_OPEN_SERVER_SOCKET_ERROR "+ (std::string)SDLNet_GetError() + " (port "  + toString(this->port) + ")"); //Debug
+			debugOut("OPEN_SERVER_SOCKET_ERROR "+ (std::string)strerror(errno) + " (port "  + toString(this->port) + ")"); //Debug
 		return SERVER_SOCKET_OPEN_ERROR_CODE;
 	}
 
 	/* Changement du flag d'état du serveur */
 	serverOpen = true;
 
-	/* Ajout du socket serveur au socketSet pour le surveiller */
-	if(SDLNet_TCP_AddSocket(socketSet, serverSocket) <= 0) {
+	/* Ajout du socket serveur à epoll pour le surveiller */
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u64 = epollTag(serverSocket, SERVER_SLOT);
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, serverSocket, &event) < 0) {
 		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_ADDSOCKET_SERVER_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		SDLNet_TCP_Close(serverSocket); //Fermeture du socket serveur
-		return SDL_ADDSOCKET_SERVER_ERROR_CODE;
+			debugOut("EPOLL_ADD_SERVER_ERROR "+ (std::string)strerror(errno)); //Debug
+		::close(serverSocket); //Fermeture du socket serveur
+		serverOpen = false;
+		return EPOLL_ADD_SERVER_ERROR_CODE;
 	}
 
 	/* Lancement du thread de traitement */
-	thread = SDL_CreateThread(threadWrapper, "Loop thread", this);
-	if (thread == NULL) {
+	try {
+		thread = std::thread(&ServerSocket::run, this);
+	} catch (const std::system_error &e) {
 		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_CREATETHREAD_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-		return SDL_CREATETHREAD_ERROR_CODE;
+			debugOut("CREATETHREAD_ERROR "+ (std::string)e.what()); //Debug
+		return CREATETHREAD_ERROR_CODE;
 	}
 
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
@@ -300,24 +305,23 @@ int ServerSocket::close()
 	killThread();
 
 	//Fermerture de tous les clients ouverts
-	strcpy(buffer, "GOODBYE"); //Préparation du message
 	for (unsigned int client = 0; client < maxClients; client++) { //Parcourt tous les clients
 		if(clientCount <= 0) break; //Si on a déjà fermé tous les sockets clients on s'arrête
-		if (clientSocketTab[client] != NULL) { //S'il le socket est utilisé
-			send(clientSocketTab[client]); //Envoi du message au client
+		if (clients[client].fd >= 0) { //S'il le socket est utilisé
+			send(client, "GOODBYE"); //Envoi du message au client
 			close(client); //Opérations de fermeture du socket du client
 		}
 	}
 
-	SDLNet_TCP_Close(serverSocket);	//Fermeture du socket serveur
+	::close(serverSocket);	//Fermeture du socket serveur
+	serverSocket = -1;
 
 	serverOpen = false; //Changement du flag d'état du serveur
 
-	return IO_NO_ERROR;
-
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
 		debugOut("END_CLOSE"); //Debug
 
+	return IO_NO_ERROR;
 }
 
 ServerSocket::~ServerSocket()
@@ -328,15 +332,15 @@ ServerSocket::~ServerSocket()
 
 	if(serverOpen) close(); //Fermeture du serveur
 
-	SDLNet_FreeSocketSet(socketSet);//Libération du SocketSet
-	delete[] clientSocketTab; //Libération du tableau de sockets
+	::close(wakeFd); //Fermeture de l'eventfd
+	::close(epollFd); //Fermeture de l'instance epoll
 	delete[] buffer; //Libération du buffer
-	SDL_DestroyMutex(running); //Libération du mutex
-	SDLNet_Quit(); //Fermeture de SDL_net
 
 	stats(); //Affichage des statistiques
 
-	while(!inputQueue.empty()) inputQueue.pop(); //Vidage de la file d'entrée
+	std::string data;
+	while(inputQueue.pop(data)); //Vidage de la file d'entrée
+	pendingInput.clear();
 	while(!outputQueue.empty()) outputQueue.pop(); //Vidage de la file de sortie
 
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
@@ -400,45 +404,36 @@ std::string ServerSocket::humanReadable(unsigned int data)
 
 std::string ServerSocket::clientIp(unsigned int client)
 {
-
-	Uint32 ip = SDLNet_TCP_GetPeerAddress(clientSocketTab[client])->host;
-	return (toString(ip & 0x000000ff) + "." + toString((ip & 0x0000ff00) >> 8) + "." + toString((ip & 0x00ff0000) >> 16) + "." + toString((ip & 0xff000000) >> 24));
-
+	return clients[client].ip;
 }
 
 std::string ServerSocket::getInput()
 {
-	if(lock(inputting) == IO_NO_ERROR) {
-		std::string data;
-		if(inputQueue.empty()) data = "";
-		else {
-			data = inputQueue.front();
-			inputQueue.pop();
-		}
-		unlock(inputting);
-		return data;
-	} else return "";
+	std::string data;
+	inputQueue.pop(data); //data reste vide si la file est vide
+	return data;
 }
 
 
 void ServerSocket::setstatsPeriod(unsigned int statsPeriod)
 {
 	this->statsPeriod = statsPeriod;
-	timeout = SDL_GetTicks() + this->statsPeriod;
+	timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->statsPeriod);
 }
 
 
 void ServerSocket::setOutput(std::string data)
 {
-	if(lock(outputting) == IO_NO_ERROR) {
-		unsigned sz = data.size();
-		if (sz>MAX_BUFFER) {
-			Log.write("ServerSocket data setOutput too big", cLog::LOG_TYPE::L_WARNING);
-			data.resize(MAX_BUFFER);
-		}
+	unsigned sz = data.size();
+	if (sz>MAX_BUFFER) {
+		Log.write("ServerSocket data setOutput too big", cLog::LOG_TYPE::L_WARNING);
+		data.resize(MAX_BUFFER);
+	}
+	{
+		std::lock_guard<std::mutex> lock(outputting);
 		outputQueue.push(data);
-		unlock(outputting);
 	}
+	wakeUp(); //La boucle envoie les données sans attendre le prochain événement réseau
 }
 
 bool ServerSocket::debug(int level, int scope)
@@ -478,54 +473,68 @@ void ServerSocket::debugOut(std::string msg)
 
 /* thread */
 
-
-int ServerSocket::threadWrapper(void *Data)
-{
-	return ((ServerSocket *)Data)->run();
-}
-
-int ServerSocket::run(void)
+int ServerSocket::run()
 {
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER)) debugOut("RUN_START"); //Debug
 	#endif
 
-	while(true) {
+	struct epoll_event events[MAX_EVENTS];
 
-		unlock(running); //Thread inactif
+	while(!stopThread) {
 
-		if(stopThread) {
-			stopThread = false;
-			return IO_NO_ERROR;
-		}
+		flushPendingInput(); //Commandes qui n'avaient pas de place dans la file d'entrée
 
-		activeSocketsCount = SDLNet_CheckSockets(socketSet, 1); //Attente d'activité sur le SocketSet (timeout de 1ms)
-		if(lock(running) == IO_NO_ERROR) { //Thread actif
-			if(activeSocketsCount > 0) { //S'il y a des sockets actifs
-				#ifdef IO_DEBUG_DEBUG_IN_LOOP
-				if(debug(IO_DEBUG_DEBUG, IO_DEBUG_SERVER))
-					debugOut("SDL_CHECKSOCKETS_ACTIVITY " + toString(activeSocketsCount)); //Debug
-				#endif
-				checkNewClient(); //Regarde s'il y a des nouveaux clients et les traite
-				if(activeSocketsCount) checkNewData(); //Regarde s'il y a des nouvelles données et les traites
-			} else if(activeSocketsCount < 0) { //S'il y a eu une erreur lors de la récupération du nombre de sockets actifs
-				if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-					debugOut("SDL_CHECKSOCKETS_ERROR " + (std::string)SDLNet_GetError()); //Debug
-				close(); //Ferme de le serveur
-				return SDL_CHECKSOCKETS_ERROR_CODE;
-			}
+		int waitTime = -1; //Attente sans limite d'un événement
+		#ifdef DEBUG_PERIODIC_STATS_ENABLED
+		waitTime = std::max(0L, (long)std::chrono::duration_cast<std::chrono::milliseconds>(timeout - std::chrono::steady_clock::now()).count());
+		#endif
+		if(!pendingInput.empty() && (waitTime < 0 || waitTime > 1))
+			waitTime = 1; //Le thread principal ne signale pas qu'il a vidé la file d'entrée
+		int partialWait = checkPartialLines(); //Commandes sans \n dont le client n'envoie plus rien
+		if(partialWait >= 0 && (waitTime < 0 || waitTime > partialWait))
+			waitTime = partialWait;
+
+		int activeSocketsCount = epoll_wait(epollFd, events, MAX_EVENTS, waitTime);
+		if(activeSocketsCount < 0) {
+			if(errno == EINTR)
+				continue;
+			if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
+				debugOut("EPOLL_WAIT_ERROR " + (std::string)strerror(errno)); //Debug
+			return EPOLL_WAIT_ERROR_CODE;
+		}
 
-			checkDataToSend(); //Vérifie s'il y a des données à envoyer aux clients
+		#ifdef IO_DEBUG_DEBUG_IN_LOOP
+		if(activeSocketsCount > 0 && debug(IO_DEBUG_DEBUG, IO_DEBUG_SERVER))
+			debugOut("EPOLL_ACTIVITY " + toString(activeSocketsCount)); //Debug
+		#endif
 
-			#ifdef DEBUG_PERIODIC_STATS_ENABLED
-			if(SDL_GetTicks() >= timeout) {
-				timeout = SDL_GetTicks() + statsPeriod;
-				stats();
+		for(int i = 0; i < activeSocketsCount; i++) {
+			uint32_t slot = (uint32_t)events[i].data.u64;
+			int fd = (int)(events[i].data.u64 >> 32);
+
+			if(slot == WAKE_SLOT) {
+				uint64_t count;
+				if(read(wakeFd, &count, sizeof(count)) < 0) {} //Remise à zéro de l'eventfd, checkDataToSend suit
+			} else if(slot == SERVER_SLOT) {
+				checkNewClient(); //Traite les nouveaux clients
+			} else if(slot < maxClients && clients[slot].fd == fd) { //Le client n'a pas été fermé plus tôt dans cette itération
+				if(events[i].events & EPOLLOUT)
+					checkWrite(slot); //Le socket accepte de nouveau des données
+				if(clients[slot].fd == fd && (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+					checkNewData(slot); //Nouvelles données, fin de connexion ou erreur
 			}
-			#endif
+		}
+
+		checkDataToSend(); //Vérifie s'il y a des données à envoyer aux clients
 
+		#ifdef DEBUG_PERIODIC_STATS_ENABLED
+		if(std::chrono::steady_clock::now() >= timeout) {
+			timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(statsPeriod);
+			stats();
 		}
+		#endif
 	}
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
@@ -533,8 +542,6 @@ int ServerSocket::run(void)
 	#endif
 
 	return IO_NO_ERROR;
-
-
 }
 
 void ServerSocket::checkNewClient()
@@ -544,72 +551,66 @@ void ServerSocket::checkNewClient()
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_CLIENT)) debugOut("CHECKNEWCLIENT_START"); //Debug
 	#endif
 
-	if (SDLNet_SocketReady(serverSocket) != 0) { //S'il y a des nouveaux clients
-		if (clientCount < maxClients) { //S'il y a de la place pour le client
-			unsigned int freeSpot = maxClients - 1;
-			for (unsigned int socket = 0; socket < maxClients; socket++) {
-				if (clientSocketTab[socket] == NULL) {
-					freeSpot = socket; //Garde le numéro du socket à utiliser
-					break;
-				}
-			}
-
-			clientSocketTab[freeSpot] = SDLNet_TCP_Accept(serverSocket); //Accept le client et le met dans le tableau de sockets
-
-			#ifdef IO_DEBUG_INFO_IN_LOOP
-			if(debug(IO_DEBUG_INFO, IO_DEBUG_CLIENT))
-				debugOut("New client " + clientIp(freeSpot)); //Debug
-			#endif
-
-			if(clientSocketTab[freeSpot] == NULL) { //Erreu lors de l'acceptation du client
+	while(true) { //Accepte tous les clients en attente
+		struct sockaddr_in address;
+		socklen_t addressSize = sizeof(address);
+		int fd = accept4(serverSocket, (struct sockaddr*)&address, &addressSize, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(fd < 0) {
+			if(errno == EINTR)
+				continue;
+			if(errno != EAGAIN && errno != EWOULDBLOCK) { //Erreur lors de l'acceptation du client
 				cannotAcceptClient++; //Incrément le nombre total d'erreurs lors de l'acceptation du client
 				if(debug(IO_DEBUG_WARN, IO_DEBUG_CLIENT))
-					debugOut("SDL_ACCEPT_CLIENT_ERROR"); //Debug
-			} else {
-				if(SDLNet_TCP_AddSocket(socketSet, clientSocketTab[freeSpot]) <= 0) { //Ajoute le socket client au SocketSet
-					if(debug(IO_DEBUG_ERROR, IO_DEBUG_SERVER))
-						debugOut("SDL_ADDSOCKET_CLIENT_ERROR "+ (std::string)SDLNet_GetError()); //Debug
-					close(freeSpot); //Ferme le socket temporaire
-				} else {
-					connection++; //Incrémente le nombre total de connexions
-					clientCount++; //Incrémente le nombre de clients connectés
-					if(clientCount > maxSimultaneousClient)
-						maxSimultaneousClient = clientCount; //Mise à jour du nombre maximum de clients connectés simulatannément
-
-					//strcpy(buffer, SERVER_MSG_HELLO_FINAL); //Prépare le message
-					//send(clientSocketTab[freeSpot]); //Envoi du message au client //Supprimé pour rester plus sobre et mieux supporter les clients http ou autre
-
-					#ifdef IO_DEBUG_INFO_IN_LOOP
-					if(debug(IO_DEBUG_INFO, IO_DEBUG_CLIENT))
-						debugOut("CLIENT_COUNT " + toString(clientCount) + "/" + toString(maxClients)); //Debug
-					#endif
-				}
-
+					debugOut("ACCEPT_CLIENT_ERROR " + (std::string)strerror(errno)); //Debug
 			}
-		} else { //S'il n'y a pas de place pour le client
+			break;
+		}
 
+		if (clientCount >= maxClients) { //S'il n'y a pas de place pour le client
 			refusedConnectionServerFull++; //Incrémente le nombre de connexion refusées pour cause de serveur plein
 			#ifdef IO_DEBUG_WARN_IN_LOOP
 			if(debug(IO_DEBUG_WARN, IO_DEBUG_CLIENT))
 				debugOut("server full"); //Debug
 			#endif
+			if(::send(fd, "SERVER_FULL", sizeof("SERVER_FULL"), MSG_NOSIGNAL) < 0) {} //Envoi du message au client, sans garantie
+			::close(fd); //Ferme le socket
+			continue;
+		}
 
-			TCPsocket tempSock = SDLNet_TCP_Accept(serverSocket); //Accepte le client dans un socket
+		unsigned int freeSpot = 0;
+		while (clients[freeSpot].fd >= 0)
+			freeSpot++; //Garde le numéro de la place à utiliser
 
-			if(tempSock == NULL) { //Erreur lors de l'acceptation du client
-				cannotAcceptClient++;
-				#ifdef IO_DEBUG_WARN_IN_LOOP
-				if(debug(IO_DEBUG_WARN, IO_DEBUG_CLIENT))
-					debugOut("SDL_ACCEPT_CLIENT_ERROR"); //Debug
-				#endif
-			}
+		char ip[INET_ADDRSTRLEN];
+		inet_ntop(AF_INET, &address.sin_addr, ip, sizeof(ip));
+		clients[freeSpot].fd = fd;
+		clients[freeSpot].ip = ip;
 
-			strcpy(buffer, "SERVER_FULL"); //Prépare le message
-			send(tempSock); //Envoi du message au client
-			SDLNet_TCP_Close(tempSock); //Ferme le socket
+		#ifdef IO_DEBUG_INFO_IN_LOOP
+		if(debug(IO_DEBUG_INFO, IO_DEBUG_CLIENT))
+			debugOut("New client " + clientIp(freeSpot)); //Debug
+		#endif
 
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u64 = epollTag(fd, freeSpot);
+		if(epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) { //Ajoute le socket client à epoll
+			if(debug(IO_DEBUG_ERROR, IO_DEBUG_SERVER))
+				debugOut("EPOLL_ADD_CLIENT_ERROR "+ (std::string)strerror(errno)); //Debug
+			::close(fd);
+			clients[freeSpot] = Client();
+			continue;
 		}
-		activeSocketsCount--; //Décrémente le nombre de sockets actifs
+
+		connection++; //Incrémente le nombre total de connexions
+		clientCount++; //Incrémente le nombre de clients connectés
+		if(clientCount > maxSimultaneousClient)
+			maxSimultaneousClient = clientCount; //Mise à jour du nombre maximum de clients connectés simulatannément
+
+		#ifdef IO_DEBUG_INFO_IN_LOOP
+		if(debug(IO_DEBUG_INFO, IO_DEBUG_CLIENT))
+			debugOut("CLIENT_COUNT " + toString(clientCount) + "/" + toString(maxClients)); //Debug
+		#endif
 	}
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
@@ -619,55 +620,38 @@ void ServerSocket::checkNewClient()
 
 }
 
-void ServerSocket::checkNewData()
+void ServerSocket::checkNewData(unsigned int client)
 {
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_CLIENT)) debugOut("CHECKNEWDATA_START"); //Debug
 	#endif
 
-	int clientSocketActivity;
-	for (unsigned int client = 0; client < maxClients; client++) { //Parcours de tous les clients connectés
-
-		if(clientSocketTab[client] != NULL) { //Si le socket est ouvert
-
-			clientSocketActivity = SDLNet_SocketReady(clientSocketTab[client]); //Récupération de l'activité du socket
-			if (clientSocketActivity) { //S'il y a de l'activité sur le socket
-
-				int receivedByteCount = SDLNet_TCP_Recv(clientSocketTab[client], buffer, bufferSize); //Réception des données du client
-				if (receivedByteCount <= 0) { //Déconnexion du client
-					#ifdef IO_DEBUG_INFO_IN_LOOP
-					if (receivedByteCount < 0 && debug(IO_DEBUG_INFO, IO_DEBUG_CLIENT))
-						debugOut("RESETED_BY_PEER "+ clientIp(client)); //Debug
-					#endif
-					close(client); //Opérations de fermeture du socket du client
-				} else if ((unsigned int)receivedByteCount >= bufferSize) { //Buffer overflow
-					possibleBufferOverflow++; //Incrémente le nombre total de buffer overflow
-					strcpy(buffer, "SERVER_OVERFLOW"); //Prépare le message
-					send(clientSocketTab[client]); //Envoi du message
-					#ifdef IO_DEBUG_WARN_IN_LOOP
-					if(debug(IO_DEBUG_WARN, IO_DEBUG_STREAM))
-						debugOut("BUFFER_OVERFLOW too many data "+ clientIp(client)); //Debug
-					#endif
-					close(client); //Fermeture du socket client
-				} else {
-
-					requestRecieved++; //Incrémente le nombre total de requêtes reçues
-					dataRecieved += receivedByteCount; //Incrémente le nombre total de données réçues
-
-					#ifdef IO_DEBUG_INFO_IN_LOOP
-					if(debug(IO_DEBUG_INFO, IO_DEBUG_STREAM))
-						debugOut("CLIENT_DATA_QUANTITY " + clientIp(client) + " " + toString(receivedByteCount)); //Debug
-					#endif
-
-					for(int i=0; i < receivedByteCount; i++) if(buffer[i] == '\r' || buffer[i] == '\0') buffer[i] = '\n';// Remplace \r et \0 par \n
-					buffer[receivedByteCount] = '\0'; //Termine la chaîne (on sait jamais)
-					computeNewData(client); //Traite les nouvelles données
-				}
-				activeSocketsCount--; //Décrément le nombre de sockets actifs
-			}
+	int receivedByteCount = recv(clients[client].fd, buffer, bufferSize, 0); //Réception des données du client
+	if (receivedByteCount == 0) { //Déconnexion du client
+		computePartialLine(client); //Dernière commande sans \n, envoyée juste avant la fermeture
+		if (clients[client].fd >= 0)
+			close(client); //Opérations de fermeture du socket du client
+	} else if (receivedByteCount < 0) {
+		if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+			#ifdef IO_DEBUG_INFO_IN_LOOP
+			if (debug(IO_DEBUG_INFO, IO_DEBUG_CLIENT))
+				debugOut("RESETED_BY_PEER "+ clientIp(client)); //Debug
+			#endif
+			close(client); //Opérations de fermeture du socket du client
 		}
-		if(activeSocketsCount <= 0) break; //S'arrête si on a traité le nombre de sockets actifs
+	} else if (!clients[client].closeAfterWrite) { //Un client HTTP n'a plus rien à demander
+		dataRecieved += receivedByteCount; //Incrémente le nombre total de données réçues
+
+		#ifdef IO_DEBUG_INFO_IN_LOOP
+		if(debug(IO_DEBUG_INFO, IO_DEBUG_STREAM))
+			debugOut("CLIENT_DATA_QUANTITY " + clientIp(client) + " " + toString(receivedByteCount)); //Debug
+		#endif
+
+		for(int i=0; i < receivedByteCount; i++) if(buffer[i] == '\r' || buffer[i] == '\0') buffer[i] = '\n';// Remplace \r et \0 par \n
+		clients[client].readBuffer.append(buffer, receivedByteCount); //Ajoute à la fin de la ligne incomplète précédente
+		clients[client].lastRead = std::chrono::steady_clock::now();
+		computeNewData(client); //Traite les lignes complètes
 	}
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
@@ -676,32 +660,77 @@ void ServerSocket::checkNewData()
 
 }
 
-void ServerSocket::computeNewData(unsigned int client)
+bool ServerSocket::computeNewData(unsigned int client)
 {
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_STREAM)) debugOut("COMPUTENEWDATA_START"); //Debug
 	#endif
 
-	std::string data = buffer; //Transforme les données du buffer en string
+	std::string &data = clients[client].readBuffer;
 
 	#ifdef IO_DEBUG_DEBUG_IN_LOOP
 	if(debug(IO_DEBUG_DEBUG, IO_DEBUG_STREAM)) debugOut("DATA_AS_STRING "+ data); //Debug
 	#endif
 
-	unsigned int begin = 0; //Début de la chaine
-	unsigned int end; //Fin de la chaine
-	bool continues;
-	do {
-		end = data.find('\n', begin); //Cherche le saut de ligne
-		if(begin < data.size() && (end - begin >= 1))
-			continues = computeString(client, data.substr(begin, end - begin)); //Avant \n
+	size_t begin = 0; //Début de la chaine
+	size_t end; //Fin de la chaine
+	while((end = data.find('\n', begin)) != std::string::npos) { //Seules les lignes terminées par \n sont traitées ici, cf checkPartialLines
+		if(end > begin) {
+			requestRecieved++; //Incrémente le nombre total de requêtes reçues
+			if(!computeString(client, data.substr(begin, end - begin)))
+				return false; //Client HTTP, la connexion se termine
+		}
 		begin = end + 1; //Après \n
-	} while(end != (unsigned int)std::string::npos && continues); //Tant qu'il y a des \n dans la chaine
+	}
+	data.erase(0, begin); //Garde la ligne incomplète pour la prochaine lecture
+
+	if(data.size() >= bufferSize) { //Ligne plus longue que le buffer : buffer overflow
+		possibleBufferOverflow++; //Incrémente le nombre total de buffer overflow
+		send(client, "SERVER_OVERFLOW"); //Envoi du message
+		#ifdef IO_DEBUG_WARN_IN_LOOP
+		if(debug(IO_DEBUG_WARN, IO_DEBUG_STREAM))
+			debugOut("BUFFER_OVERFLOW too many data "+ clientIp(client)); //Debug
+		#endif
+		close(client); //Fermeture du socket client
+		return false;
+	}
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_STREAM)) debugOut("COMPUTENEWDATA_END"); //Debug
 	#endif
+
+	return true;
+}
+
+void ServerSocket::computePartialLine(unsigned int client)
+{
+	std::string &last = clients[client].readBuffer;
+	if (last.empty() || clients[client].closeAfterWrite)
+		return;
+	requestRecieved++;
+	std::string line;
+	line.swap(last);
+	computeString(client, line);
+}
+
+int ServerSocket::checkPartialLines()
+{
+	int waitTime = -1;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	for(unsigned int client = 0; client < maxClients; client++) {
+		if(clients[client].fd < 0 || clients[client].readBuffer.empty() || clients[client].closeAfterWrite)
+			continue;
+		std::chrono::steady_clock::time_point deadline = clients[client].lastRead + std::chrono::milliseconds(PARTIAL_LINE_TIMEOUT);
+		if(now >= deadline) {
+			computePartialLine(client); //Le client attend la réponse à une commande sans \n
+			continue;
+		}
+		int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+		if(waitTime < 0 || left < waitTime)
+			waitTime = left;
+	}
+	return waitTime;
 }
 
 bool ServerSocket::computeString(unsigned int client, std::string string)
@@ -736,7 +765,6 @@ bool ServerSocket::computeString(unsigned int client, std::string string)
 bool ServerSocket::computeHttp(unsigned int client, std::string string)
 {
 	//TODO proprer
-	#ifdef LINUX
 	if(string.substr(0,3) == "GET") { //Client HTTP
 
 		/* Traitement de l'url */
@@ -766,12 +794,13 @@ bool ServerSocket::computeHttp(unsigned int client, std::string string)
 				command = replace(command, "+", " "); //Décodes les espaces
 				command = replace(command, "%3A", ":"); //Décodes les ":"
 				printf("COMMAND : \"%s\"\n", command.c_str());
-				inputQueue.push(command); //Rajoute la chaine à la file de sortie
+				pushInput(command); //Rajoute la chaine à la file de sortie
 				broadcast(clientIp(client) + CLIENT_SEPARATOR2 + "HTTP" + CLIENT_SEPARATOR1 + command + '\n'); //Envoi la chaîne à tous les clients
 			}
 		}
 
 		/* Envoi du fichier */
+		clients[client].closeAfterWrite = true; //La réponse entière est gardée si le socket n'accepte pas tout
 
 		struct stat filestat;
 		if(!stat(filename.c_str(), &filestat)) { //Récupère les statistiques du fichier
@@ -784,62 +813,75 @@ bool ServerSocket::computeHttp(unsigned int client, std::string string)
 				else if(extension == "js" || extension == "JS") type = "application/x-javascript;charset=UTF-8";
 				else if(extension == "jpeg" || extension == "JPEG" || extension == "jpg" || extension == "JPEG") type = "image/jpeg";
 				else if(extension == "png" || extension == "PNG") type = "image/png";
-				else if(extension == "gif" || extension == "GIF") type == "image/gif";
+				else if(extension == "gif" || extension == "GIF") type = "image/gif";
 				else type = "text/plain";
 
-				strcpy(buffer, ("HTTP/1.0 200 OK\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: " + toString(filestat.st_size) + "\nContent-Type: " + type + "\r\n\r\n").c_str());
-				SDLNet_TCP_Send(clientSocketTab[client], (void *)buffer, strlen(buffer)); //Envoi des entêtes
-				unsigned int size;
+				std::string header = "HTTP/1.0 200 OK\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: " + toString(filestat.st_size) + "\nContent-Type: " + type + "\r\n\r\n";
+				sendRaw(client, header.c_str(), header.size()); //Envoi des entêtes
+				size_t size;
 				do {
 					size = fread(buffer, 1, bufferSize, file); //Lecture du fichier dans le buffer
-					SDLNet_TCP_Send(clientSocketTab[client], (void *)buffer, size); //Envoi du buffer
+					sendRaw(client, buffer, size); //Envoi du buffer
 				} while(size == bufferSize); //Pas à la fin du fichier
 				fclose(file); //Fermeture du fichier
 			}
 		} else { //Problème à l'ouverture du fichier (inexistant...))
-			strcpy(buffer, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
-			send(clientSocketTab[client]); //Envoi des entêtes
+			send(client, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n"); //Envoi des entêtes
 		}
 
-		close(client); //Fermeture de la connection
+		if(clients[client].writeBuffer.empty())
+			close(client); //Fermeture de la connection
+		else
+			watchWrite(client, true); //Fermeture quand tout sera envoyé
 		return true;
-	} else 
+	} else
 	if (string.substr(0,4) == "POST") { //Requête HTTP POST (pas supportée)
-		strcpy(buffer, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
-		send(clientSocketTab[client]);
-		close(client);
+		clients[client].closeAfterWrite = true;
+		send(client, "HTTP/1.0 500 Internal Error\r\nServer: SpaceCrafter (HTTP/BETA)\r\nContent-Length: 0\r\n\r\n");
+		if(clients[client].writeBuffer.empty())
+			close(client);
+		else
+			watchWrite(client, true);
 		return true;
-	} else 
+	} else
 		return false;
-	#else
-	return true;
-	#endif
 }
 
 void ServerSocket::computeNormalString(unsigned int client, std::string string)
 {
 	//TODO proprer
 	if(string.substr(0, 7) == "$NOTICE") { //Commande NOTICE
-		strcpy(buffer, "$NOTICE $LOGON $LOGOFF");
-		send(clientSocketTab[client]);
-	} else 
+		send(client, "$NOTICE $LOGON $LOGOFF");
+	} else
 	if(string.substr(0, 4) == "$LOG") { //Commande LOG
-		if(string.substr(4, 2) == "ON" && !clientBroadcastTab[client]) { //LOGON
-			clientBroadcastTab[client] = true; //Changement des préférences du client
-			strcpy(buffer, "Vous receverez maintenant les logs\n");
-		} else 
-		if(string.substr(4, 3) == "OFF" && clientBroadcastTab[client]) { //LOGOFF
-			clientBroadcastTab[client] = false; //Changement des préférences du client
-			strcpy(buffer, "Vous receverez maintenant PLUS les logs\n");
+		if(string.substr(4, 2) == "ON" && !clients[client].broadcast) { //LOGON
+			clients[client].broadcast = true; //Changement des préférences du client
+			send(client, "Vous receverez maintenant les logs\n");
+		} else
+		if(string.substr(4, 3) == "OFF" && clients[client].broadcast) { //LOGOFF
+			clients[client].broadcast = false; //Changement des préférences du client
+			send(client, "Vous receverez maintenant PLUS les logs\n");
 		} else
-			strcpy(buffer, "REQUEST ERROR");
-		send(clientSocketTab[client]); //Envoi du buffer au client
+			send(client, "REQUEST ERROR");
 	} else {
-		inputQueue.push(string); //Rajoute la chaine à la file de sortie
+		pushInput(string); //Rajoute la chaine à la file de sortie
 		//broadcast(clientIp(client) + CLIENT_SEPARATOR1 + string + '\n'); //Envoi la chaîne à tous les clients
 	}
 }
 
+void ServerSocket::pushInput(std::string string)
+{
+	if(pendingInput.empty() && inputQueue.push(std::move(string)))
+		return;
+	pendingInput.push_back(std::move(string)); //File d'entrée pleine : l'ordre des commandes est conservé
+}
+
+void ServerSocket::flushPendingInput()
+{
+	while(!pendingInput.empty() && inputQueue.push(std::move(pendingInput.front())))
+		pendingInput.pop_front();
+}
+
 void ServerSocket::checkDataToSend()
 {
 
@@ -847,12 +889,14 @@ void ServerSocket::checkDataToSend()
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER)) debugOut("CHECKDATATOSEND_START"); //Debug
 	#endif
 
-	if(lock(outputting) == IO_NO_ERROR) {
-		while(!outputQueue.empty()) { //File non-vide
-			broadcast(outputQueue.front() + '\n'); //Envoi à tous les clients de la tête de la file
-			outputQueue.pop(); //Défile
-		}
-		unlock(outputting);
+	std::queue<std::string> toSend;
+	{
+		std::lock_guard<std::mutex> lock(outputting);
+		std::swap(toSend, outputQueue); //setOutput n'attend pas les envois
+	}
+	while(!toSend.empty()) { //File non-vide
+		broadcast(toSend.front() + '\n'); //Envoi à tous les clients de la tête de la file
+		toSend.pop(); //Défile
 	}
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
@@ -874,25 +918,28 @@ int ServerSocket::broadcast(std::string data)
 		debugOut("BROADCAST_DATA "+ data); //Debug
 	#endif
 
-	strcpy(buffer, data.c_str()); //Prépare le message
 	unsigned int sent = 0; //Nombre de clients auquels est envoyé la données
 	for (unsigned int client = 0; client < maxClients; client++) { //Parcours de tous les clients connectés
-		if(clientBroadcastTab[client]) { //Si le client demande des feedback
-			send(clientSocketTab[client]); //Envoi au client
+		if(clients[client].fd >= 0 && clients[client].broadcast) { //Si le client demande des feedback
+			send(client, data); //Envoi au client
 			sent++; //Incrémente le nombre total de requêtes envoyées
 		}
 	}
 
-	return sent;
-
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
 		debugOut("BROADCAST_END"); //Debug
 	#endif
 
+	return sent;
 }
 
-int ServerSocket::send(TCPsocket client)
+int ServerSocket::send(unsigned int client, const std::string &data)
+{
+	return sendRaw(client, data.c_str(), data.size() + 1); //Envoi de la chaîne avec son \0
+}
+
+int ServerSocket::sendRaw(unsigned int client, const char* data, size_t size)
 {
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
@@ -900,18 +947,41 @@ int ServerSocket::send(TCPsocket client)
 		debugOut("SEND_START"); //Debug
 	#endif
 
-	unsigned int size = strlen(buffer) + 1; //Taille de la chaine
-	unsigned int sendCount = SDLNet_TCP_Send(client, (void *)buffer, size); //Envoi le contenu du buffer au client
-	if(sendCount < size) { //Problème lors de l'envoi
-		requestSendFailed++; //Incrémente le nombre total de d'erreurs d'envoi de requête
+	Client &c = clients[client];
+	if(!c.closeAfterWrite && !c.writeBuffer.empty() && c.writeBuffer.size() + size > MAX_WRITE_BUFFER) { //Client qui ne lit plus
+		requestSendFailed++; //Le message est abandonné en entier, rien n'en part sur le socket
 		#ifdef IO_DEBUG_WARN_IN_LOOP
 		if(debug(IO_DEBUG_WARN, IO_DEBUG_STREAM))
-			debugOut("SDL_SEND_ERROR"); //Debug
+			debugOut("SEND_ERROR client too slow " + clientIp(client)); //Debug
 		#endif
-		return SDL_SEND_ERROR_CODE;
-	} else	requestSend++; //Incrémente le nombre total de requêtes envoyées
+		return SEND_ERROR_CODE;
+	}
 
-	dataSend += sendCount; //Incrément le total de données envoyées
+	size_t sendCount = 0;
+	if(c.writeBuffer.empty()) { //Rien en attente : envoi direct
+		ssize_t count = ::send(c.fd, data, size, MSG_NOSIGNAL);
+		if(count < 0) {
+			if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) { //Problème lors de l'envoi
+				requestSendFailed++; //Incrémente le nombre total de d'erreurs d'envoi de requête
+				#ifdef IO_DEBUG_WARN_IN_LOOP
+				if(debug(IO_DEBUG_WARN, IO_DEBUG_STREAM))
+					debugOut("SEND_ERROR " + (std::string)strerror(errno)); //Debug
+				#endif
+				return SEND_ERROR_CODE;
+			}
+			count = 0;
+		}
+		sendCount = count;
+		dataSend += sendCount; //Incrément le total de données envoyées
+	}
+
+	if(sendCount < size) { //Le socket est plein : le reste part quand il sera de nouveau disponible, même au-delà de MAX_WRITE_BUFFER pour ne pas couper le message
+		bool wasEmpty = c.writeBuffer.empty();
+		c.writeBuffer.append(data + sendCount, size - sendCount);
+		if(wasEmpty && !c.closeAfterWrite)
+			watchWrite(client, true);
+	}
+	requestSend++; //Incrémente le nombre total de requêtes envoyées
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
@@ -921,6 +991,43 @@ int ServerSocket::send(TCPsocket client)
 	return IO_NO_ERROR;
 }
 
+void ServerSocket::checkWrite(unsigned int client)
+{
+	Client &c = clients[client];
+	while(!c.writeBuffer.empty()) {
+		ssize_t count = ::send(c.fd, c.writeBuffer.data(), c.writeBuffer.size(), MSG_NOSIGNAL);
+		if(count < 0) {
+			if(errno == EINTR)
+				continue;
+			if(errno == EAGAIN || errno == EWOULDBLOCK)
+				return; //Toujours plein, EPOLLOUT reste surveillé
+			requestSendFailed++;
+			#ifdef IO_DEBUG_WARN_IN_LOOP
+			if(debug(IO_DEBUG_WARN, IO_DEBUG_STREAM))
+				debugOut("SEND_ERROR " + (std::string)strerror(errno)); //Debug
+			#endif
+			close(client);
+			return;
+		}
+		dataSend += count;
+		c.writeBuffer.erase(0, count);
+	}
+
+	if(c.closeAfterWrite)
+		close(client); //Réponse HTTP terminée
+	else
+		watchWrite(client, false);
+}
+
+void ServerSocket::watchWrite(unsigned int client, bool write)
+{
+	struct epoll_event event;
+	event.events = (clients[client].closeAfterWrite ? 0u : (uint32_t)EPOLLIN) | (write ? (uint32_t)EPOLLOUT : 0u);
+	event.data.u64 = epollTag(clients[client].fd, client);
+	if(epoll_ctl(epollFd, EPOLL_CTL_MOD, clients[client].fd, &event) < 0 && debug(IO_DEBUG_ERROR, IO_DEBUG_STREAM))
+		debugOut("EPOLL_MOD_CLIENT_ERROR " + (std::string)strerror(errno)); //Debug
+}
+
 int ServerSocket::close(unsigned int client)
 {
 
@@ -934,14 +1041,8 @@ int ServerSocket::close(unsigned int client)
 		debugOut("CLIENT_DISCONECTED "+ clientIp(client)); //Debug
 	#endif
 
-	int socketCount = SDLNet_TCP_DelSocket(socketSet, clientSocketTab[client]); //Suppression du socket client du SocketSet
-	if(socketCount < 0) {
-		if(debug(IO_DEBUG_ERROR, IO_DEBUG_STREAM)) debugOut("SDL_DELSOCKET_CLIENT_ERROR"); //Debug
-		return SDL_DELSOCKET_CLIENT_ERROR_CODE;
-	}
-	SDLNet_TCP_Close(clientSocketTab[client]); //Fermeture du socket client
-	clientSocketTab[client] = NULL; //Nullation du socket client
-	clientBroadcastTab[client] = false; //Falsation de l'état de la demande de feedback
+	::close(clients[client].fd); //Fermeture du socket client, qui le retire aussi d'epoll
+	clients[client] = Client(); //Libère la place, les données en attente et la demande de feedback
 	clientCount--; //Décrémentation du nombre de clients connectés
 
 	#ifdef IO_DEBUG_INFO_IN_LOOP
@@ -957,6 +1058,12 @@ int ServerSocket::close(unsigned int client)
 	return IO_NO_ERROR;
 }
 
+void ServerSocket::wakeUp()
+{
+	uint64_t one = 1;
+	if(write(wakeFd, &one, sizeof(one)) < 0) {} //Le compteur de l'eventfd ne peut pas déborder ici
+}
+
 int ServerSocket::killThread()
 {
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
@@ -964,41 +1071,17 @@ int ServerSocket::killThread()
 		debugOut("KILLTHREAD_START"); //Debug
 	#endif
 
-	stopThread = true; //Demande d'arrêt du thread
-	SDL_WaitThread(thread, &threadReturnValue); //Attente du thread
+	if(thread.joinable()) {
+		stopThread = true; //Demande d'arrêt du thread
+		wakeUp(); //Sort la boucle de epoll_wait
+		thread.join(); //Attente du thread
+		stopThread = false;
+	}
 
 	#ifdef IO_DEBUG_TRACE_IN_LOOP
 	if(debug(IO_DEBUG_TRACE, IO_DEBUG_SERVER))
 		debugOut("KILLTHREAD_END"); //Debug
 	#endif
 
-	return threadReturnValue;
-}
-
-int ServerSocket::lock(SDL_mutex *mutex)
-{
-
-	if (SDL_LockMutex(mutex)) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_LOCKMUTEX_ERROR" + (std::string)SDLNet_GetError()); //Debug
-		return SDL_LOCKMUTEX_ERROR_CODE;
-	}
-
 	return IO_NO_ERROR;
-
 }
-
-int ServerSocket::unlock(SDL_mutex *mutex)
-{
-
-	if (SDL_UnlockMutex(mutex)) {
-		if(debug(IO_DEBUG_FATAL, IO_DEBUG_SERVER))
-			debugOut("SDL_UNLOCKMUTEX_ERROR" + (std::string)SDLNet_GetError()); //Debug
-		return SDL_UNLOCKMUTEX_ERROR_CODE;
-	}
-
-	return IO_NO_ERROR;
-
-}
-
-
@@ -25,14 +25,21 @@
 #ifndef IO_H
 #define IO_H
 
-#include <SDL2/SDL_thread.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include <queue> //ServerSocket
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 #include "spacecrafter.hpp"
 #include "app_settings.hpp"
 #include <cstring>
-#include <SDL2/SDL_net.h> //ServerSocket
 #include <iostream> //ServerSocket
 #include "log.hpp"
+#include "spsc_queue.hpp"
 
 #ifdef LINUX
 //for pipe
@@ -59,6 +66,15 @@ Utilité : ce programme permet de dialoguer avec l'application par le réseau
 Usage : à inclure dans le programme C++
 Auteur : Aurélien Schwab <aurelien.schwab+dev@gmail.com> pour association-sirius.org
 Mise à jour le 17/05/2016
+
+La boucle du serveur attend les événements avec epoll : elle ne se réveille que
+lorsqu'un client se connecte ou envoie des données, lorsque setOutput() signale
+des données à diffuser (eventfd) ou pour les statistiques périodiques.
+Les sockets sont non-bloquants et chaque client garde ses lignes incomplètes
+d'une lecture à l'autre. Une commande se termine par \n, \r ou \0 ; une
+commande sans fin de ligne est tout de même traitée quand le client n'envoie
+plus rien pendant PARTIAL_LINE_TIMEOUT ms ou se déconnecte. Les commandes reçues passent au thread principal par
+une file SPSC sans verrou.
 */
 
 /* Niveau de debug */
@@ -80,25 +96,18 @@ Mise à jour le 17/05/2016
 #define IO_NO_ERROR 0 //Par d'erreur
 
 /* Codes d'erreur dans l'initialisation */
-#define SDL_NET_INIT_ERROR_CODE 1 //Erreur lors de l'initialisation de SDL
-#define SDL_RESOLEVHOST_ERROR_CODE 2 //Erreur lors de la préparation de la structure pour le serveur
-#define SDL_ALLOCSOCKETSET_ERROR_CODE 3 //Erreur lors de l'allocation du SocketSet
-#define SDL_CREATEMUTEX_ERROR_CODE 4 //Erreur lors de la création du mutex de verouillage d'activité du thread
-#define NEW_TCPSOCKET_TAB_ERROR_CODE 5 //Erreur lors de l'allocation du tableau de sockets clients
-#define NEW_BOOL_TAB_ERROR_CODE 6 //Erreur lors de l'allocation du tableau de sockets clients
-#define NEW_BUFFER_ERROR_CODE 7 //Erreur lors de l'allocation du buffer
+#define EPOLL_CREATE_ERROR_CODE 1 //Erreur lors de la création de l'instance epoll
+#define EVENTFD_CREATE_ERROR_CODE 2 //Erreur lors de la création de l'eventfd de réveil
+#define EPOLL_ADD_EVENTFD_ERROR_CODE 3 //Erreur lors de l'ajout de l'eventfd à epoll
 
 /* Codes d'erreur dans l'ouverture */
 #define SERVER_SOCKET_OPEN_ERROR_CODE 101 //Erreur lors de l'ouverture du socket serveur
-#define SDL_ADDSOCKET_SERVER_ERROR_CODE 102 //Erreur lors de l'ajout du socket serveur au SocketSet
-#define SDL_CREATETHREAD_ERROR_CODE 103
+#define EPOLL_ADD_SERVER_ERROR_CODE 102 //Erreur lors de l'ajout du socket serveur à epoll
+#define CREATETHREAD_ERROR_CODE 103
 
 /* Codes d'erreur dans le traitement */
-#define SDL_LOCKMUTEX_ERROR_CODE 201
-#define SDL_UNLOCKMUTEX_ERROR_CODE 202
-#define SDL_CHECKSOCKETS_ERROR_CODE 203 //Erreur lors de la vérification du SocketSet
-#define SDL_SEND_ERROR_CODE 204
-#define SDL_DELSOCKET_CLIENT_ERROR_CODE 205
+#define EPOLL_WAIT_ERROR_CODE 203 //Erreur lors de l'attente des événements
+#define SEND_ERROR_CODE 204
 
 /* Codes d'erreur dans la fermeture */
 #define SERVER_NOT_OPEN_CODE 301
@@ -110,18 +119,28 @@ Mise à jour le 17/05/2016
 
 class ServerSocket {
 private:
+	/* Etat d'un client connecté */
+	struct Client {
+		int fd = -1; //Socket du client, -1 si la place est libre
+		std::string ip; //Adresse IP du client
+		std::string readBuffer; //Ligne incomplète reçue lors des lectures précédentes
+		std::string writeBuffer; //Données pas encore acceptées par le socket
+		bool broadcast = false; //Demande de feedback
+		bool closeAfterWrite = false; //Fermeture dès que writeBuffer est vide (HTTP)
+		std::chrono::steady_clock::time_point lastRead; //Date de la dernière réception, pour les lignes incomplètes
+	};
+
 	/* Variables configurables */
 	unsigned int port; //Port d'écoute du serveur
-	unsigned int maxClients; //Nombre maxium de clients (comme le serveur prends une place dans le set de sockets, ce nombre est égal à la taille du set -1)
-	unsigned int bufferSize; //Taille du buffer de réception
+	unsigned int maxClients; //Nombre maxium de clients
+	unsigned int bufferSize; //Taille maximale d'une ligne reçue
 	int logLevel; //Niveau de debug
 	int logScope; //Scope du debug
 	cLog::LOG_TYPE logType; //Type de log (spécifique à l'application)
 
-	/* Variables d'état */
+	/* Variables d'état */
 	bool serverOpen; //Etat du serveur
 	unsigned int clientCount; //Nombre de clients actuellement connectés au serveur
-	unsigned int broadcastId; //Id du message de broadcast
 
 	/* Variables de statistiques */
 	unsigned int maxSimultaneousClient; //Nombre maximum de clients connectés simulatannément
@@ -130,7 +149,7 @@ private:
 	unsigned int refusedConnectionServerFull; //Nombre total de connexions refusées pour cause de serveur plein
 	unsigned int cannotAcceptClient; //Nombre total d'erreurs lors de l'acceptation du client
 
-	unsigned int requestRecieved; //Nombre total de requêtes
+	unsigned int requestRecieved; //Nombre total de lignes reçues
 	unsigned int dataRecieved; //Total de données reçues
 	unsigned int possibleBufferOverflow; //Nombre total de buffer overflow
 
@@ -139,52 +158,52 @@ private:
 	unsigned int requestSendFailed; //Nombre total d'erreurs lors de l'envoi de la requête
 
 	unsigned int statsPeriod;
-	Uint32 timeout;
+	std::chrono::steady_clock::time_point timeout; //Date des prochaines statistiques
 
 	/* Variables du serveur */
-	IPaddress serverIP; //IP du serveur (0.0.0.0 pour écouter sur toutes les IPs du serveur)
-	TCPsocket serverSocket; //Socket d'écoute du serveurs
-	SDLNet_SocketSet socketSet; //Tableau de surveillance des sockets
-	TCPsocket* clientSocketTab; //Tableau de sockets client
-	bool* clientBroadcastTab; //Tableau de demandes de feedback
+	int serverSocket; //Socket d'écoute du serveur
+	int epollFd; //Instance epoll qui surveille tous les descripteurs
+	int wakeFd; //eventfd écrit par setOutput() et close() pour réveiller la boucle
+	std::vector<Client> clients; //Tableau des clients
+	char* buffer; //Buffer de réception
 
 	/* Variables du thread */
-	SDL_Thread *thread; //Thread du serveur qui attends les paquets
-	int threadReturnValue; //Valeur de retour du thread
-	bool stopThread;
-	int lock(SDL_mutex *mutex);
-	int unlock(SDL_mutex *mutex);
-	SDL_mutex *running; //Mutex de serveur actif
-	int activeSocketsCount; //Nombre de sockets actifs
-	char* buffer; //Buffer de réception
+	std::thread thread; //Thread du serveur qui attend les événements
+	std::atomic<bool> stopThread;
 
 	/* Variables de stockage des données */
-	std::queue<std::string> inputQueue; //File d'entrée
+	SpscQueue<std::string> inputQueue; //File d'entrée vers le thread principal
+	std::deque<std::string> pendingInput; //Lignes en attente quand inputQueue est pleine
 	std::queue<std::string> outputQueue; //File de sortie
-	SDL_mutex *inputting; //Mutex de la file d'entrée
-	SDL_mutex *outputting; //Mutex de la file de sortie
+	std::mutex outputting; //Mutex de la file de sortie
 
 	/* Fonction et code d'initialisation */
 	int init(unsigned int port, unsigned int maxClients, unsigned int bufferSize, int logLevel, int logScope); //Fonction d'initialisation appellée par les constructeurs
 	int initErrorCode; //Code d'erreur de l'initialisation
 
 	/* Fonctions de traitement */
-	static int threadWrapper(void *Data); //Fonction qui délègue run
-	int run(void); //Boucle de traitement des données entrantes
-	void checkNewClient(); //Fonction de vérification de nouveaux clients
-	void checkNewData(); //Fonction de vérification de nouvelles données
-	void computeNewData(unsigned int client); //Fonction de traitement des données
+	int run(); //Boucle de traitement des événements
+	void checkNewClient(); //Accepte tous les clients en attente
+	void checkNewData(unsigned int client); //Lit toutes les données disponibles d'un client
+	void checkWrite(unsigned int client); //Envoie les données en attente quand le socket est de nouveau disponible
+	bool computeNewData(unsigned int client); //Découpe les lignes complètes reçues, renvoie faux si le client a été fermé
+	void computePartialLine(unsigned int client); //Traite la ligne incomplète comme une commande
+	int checkPartialLines(); //Traite les lignes incomplètes restées sans suite, renvoie le délai avant la prochaine échéance
 	bool computeString(unsigned int client, std::string string); //Fonction de traitement de la chaîne
 	bool computeHttp(unsigned int client, std::string string);//Fonction de traitement d'une requête HTTP (BETA)
 	void computeNormalString(unsigned int client, std::string string);//Fonction de traitement d'une requête normale
+	void pushInput(std::string string); //Transmet une commande au thread principal
+	void flushPendingInput(); //Transmet les commandes en attente
 	void checkDataToSend(); //Fonction d'envoi de données reçues de l'application
 	int broadcast(std::string data); //Fonction de broadcast aux clients
 	int close(unsigned int client); //Fonction de fermeture du socket client
 
 	/* Fonctions de factorisation ou d'assistance */
-	int send(TCPsocket client); //Fonction qui envoi la chaine contenue dans le buffer
-	int resetThread(); //Fonction qui redémarre le thread de traiement quand il est inactif
-	int killThread(); //Fonction qui kill le thread de traitement quand il est inactif
+	int send(unsigned int client, const std::string &data); //Envoie la chaîne terminée par \0
+	int sendRaw(unsigned int client, const char* data, size_t size); //Envoie ou met en attente les données
+	void watchWrite(unsigned int client, bool write); //Surveille ou non la disponibilité en écriture du socket
+	void wakeUp(); //Réveille la boucle de traitement
+	int killThread(); //Fonction qui arrête le thread de traitement
 
 	std::string humanReadable(unsigned int); //Fonction qui renvoi une chaine formatée (B, KB, MB, GB)
 	std::string clientIp(unsigned int client); //Fonction qui renvoi l'adresse IP du client sous forme de chaîne
@@ -214,6 +233,7 @@ public:
 	/* Fonction d'affichage des statistiques non-nulles */
 	void stats();
 
+	//! renvoie la plus ancienne commande reçue, "" s'il n'y en a pas (thread principal uniquement)
 	std::string getInput();
 
 	unsigned int getstatsPeriod() {
@@ -32,6 +32,7 @@
 #include "log.hpp"
 #include "perf_debug.hpp"
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <cstdlib>
@@ -49,6 +50,8 @@
 #include <sys/stat.h>
 #include "checkkeys.hpp"
 #include "translator.hpp"
+#include "script.hpp"
+#include "texture_cache.hpp"
 
 
 #ifdef LINUX
@@ -109,6 +112,7 @@ static void usage(char **argv)
 {
 	cout << APP_NAME << endl;
 	cout << _("Usage: %s [OPTION] ...\n -v, --version          Output version information and exit.\n -h, --help             Display this help and exit.\n");
+	cout << _(" --check-script PATH    Parse the script PATH or all the scripts under the directory PATH, report errors and exit.\n");
 }
 
 // Check command line arguments
@@ -125,6 +129,11 @@ static void check_command_line(int argc, char **argv)
 		}
 	}
 
+	if (argc == 3 && !strcmp(argv[1],"--check-script")) {
+		// no window nor configuration: the scripts are only parsed
+		exit(Script::checkScripts(argv[2]) ? 0 : 1);
+	}
+
 	if (argc > 1) {
 		cout << APP_NAME << endl;
 		cout << _("%s: Bad command line argument(s)\n")<< endl;
@@ -244,6 +253,10 @@ int main(int argc, char **argv)
 
 	Log.setDebug(conf.getBoolean("main:debug"));
 
+	// images décodées gardées d'un démarrage à l'autre, taille en Mo
+	if (conf.getBoolean("main:flag_texture_cache"))
+		TextureCache::setDirectory(ini->getCacheDir(), (uint64_t)std::max(0, conf.getInt("main:texture_cache_size")) * 1024 * 1024);
+
 
 	#ifdef LINUX
 	if (conf.getBoolean("main:CPU_info")) {
@@ -29,8 +29,6 @@
 #include "vecmath.hpp"
 #include <vector>
 
-class Projector;
-class Navigator;
 class ToneReproductor;
 
 // all in km - altitudes make up meteor range
@@ -39,34 +37,88 @@ class ToneReproductor;
 #define LOW_ALTITUDE 70.f
 #define VISIBLE_RADIUS 457.8f
 
-class Meteor {
+/**
+ * \class MeteorPool
+ * \brief Ensemble des météores actifs, rangés en tableaux (structure of arrays)
+ *
+ * Un météore suit une droite parallèle à l'axe z du repère du radiant. Sa tête et
+ * la fin de sa traînée ne diffèrent que par leur coordonnée z : chaque météore ne
+ * garde donc que sa droite en coordonnées équatoriales terrestres (un point et la
+ * direction de l'axe z) et l'abscisse de ses deux extrémités sur cette droite.
+ *
+ * La capacité est fixée à la construction : aucune allocation pendant la vie du pool.
+ * Un météore éteint est remplacé par le dernier du tableau, l'ordre des météores
+ * n'ayant pas d'importance pour l'affichage. Quand le pool est plein, les
+ * nouveaux météores sont ignorés.
+ */
+class MeteorPool {
 
 public:
-	Meteor( Projector *proj, Navigator *nav, ToneReproductor* eye, double v);
-	virtual ~Meteor();
-	bool update(int delta_time);  // update position
-	bool draw(Projector *proj, Navigator* nav, std::vector<float> &vecPos, std::vector<float> &vecColor);		// Draw the meteor
-	bool isAlive(void);          // see if burned out yet
+	MeteorPool(unsigned int _capacity = MAX_METEORS);
+	~MeteorPool() {};
+	MeteorPool(MeteorPool const &) = delete;
+	MeteorPool& operator = (MeteorPool const &) = delete;
+
+	//! matrice qui aligne l'axe z sur la direction de déplacement de la Terre, ou sur le radiant
+	//! d'un essaim connu, selon la direction du soleil sun_dir en coordonnées équatoriales terrestres
+	static Mat4d radiantMatrix(Vec3d sun_dir);
+
+	//! tire nb trajectoires autour de l'observateur situé en obs_equ (coordonnées équatoriales terrestres)
+	//! et garde les météores visibles. Renvoie le nombre de météores ajoutés
+	unsigned int create(unsigned int nb, const Mat4d &mmat, const Vec3d &obs_equ, double velocity, ToneReproductor* eye, float fov);
+
+	//! avance tous les météores de delta_time ms et retire ceux qui sont éteints
+	void update(int delta_time);
+
+	//! positions de la tête, du milieu et de la fin de la traînée du météore i, en coordonnées équatoriales terrestres
+	void getTrain(unsigned int i, Vec3d &head, Vec3d &middle, Vec3d &tail) const {
+		Vec3d base(baseX[i], baseY[i], baseZ[i]);
+		Vec3d dir(dirX[i], dirY[i], dirZ[i]);
+		head = base + dir * headZ[i];
+		middle = base + dir * (headZ[i] + (trainZ[i] - headZ[i])/2);
+		tail = base + dir * trainZ[i];
+	}
+
+	//! intensité de la tête du météore i, corrigée de sa distance à l'observateur
+	double getIntensity(unsigned int i) const {
+		return mag[i] * distMultiplier[i];
+	}
+
+	unsigned int size() const {
+		return nbMeteors;
+	}
+
+	unsigned int getCapacity() const {
+		return capacity;
+	}
+
+	void clear() {
+		nbMeteors = 0;
+	}
+
+	static const unsigned int MAX_METEORS = 16384;
 
 private:
-	Mat4d mmat; // tranformation matrix to align radiant with earth direction of travel
-	Vec3d obs;  // observer position in meteor coord. system
-	Vec3d position;  // equatorial coordinate position
-	Vec3d pos_internal;  // middle of train
-	Vec3d pos_train;  // end of train
-
-	double start_h;  // start height above center of earth
-	double end_h;    // end height
-	double velocity; // km/s
-	bool alive;      // is it still visible?
-	float mag;	   // Apparent magnitude at head, 0-1
-	float max_mag;  // 0-1
-	float abs_mag;  // absolute magnitude
-	float vis_mag;  // visual magnitude at observer
-	double xydistance; // distance in XY plane (orthogonal to meteor path) from observer to meteor
-	double init_dist;  // initial distance from observer
-	double min_dist;  // nearest point to observer along path
-	double dist_multiplier;  // scale magnitude due to changes in distance
+	// copie le météore src à la place du météore dst
+	void moveMeteor(unsigned int src, unsigned int dst);
+
+	unsigned int capacity;
+	unsigned int nbMeteors = 0;
+
+	// trajectoire : point d'abscisse nulle et direction, en coordonnées équatoriales terrestres
+	std::vector<double> baseX, baseY, baseZ;
+	std::vector<double> dirX, dirY, dirZ;
+
+	std::vector<double> headZ;		// abscisse de la tête
+	std::vector<double> trainZ;		// abscisse de la fin de la traînée
+	std::vector<double> startH;		// start height above center of earth
+	std::vector<double> endH;		// end height
+	std::vector<double> velocity;	// km/s
+	std::vector<double> obsZ;		// abscisse de l'observateur dans le repère du radiant
+	std::vector<double> xyDist2;	// carré de la distance de l'observateur à la trajectoire
+	std::vector<double> minDist2;	// carré de la distance du point le plus proche de l'observateur encore en combustion
+	std::vector<double> distMultiplier;	// scale magnitude due to changes in distance
+	std::vector<float> mag;			// Apparent magnitude at head, 0-1
 };
 
 
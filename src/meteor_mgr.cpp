@@ -41,6 +41,9 @@ MeteorMgr::MeteorMgr(int zhr, int maxv )
 	zhr_to_wsr = 1.6667f/3600.f;
 	// this is a correction factor to adjust for the model as programmed to match observed rates
 
+	vecPos.resize(8*active.getCapacity());
+	vecColor.resize(16*active.getCapacity());
+
 	createShader();
 }
 
@@ -67,19 +70,8 @@ void MeteorMgr::setMaxVelocity(int maxv)
 void MeteorMgr::update(Projector *proj, Navigator* nav, TimeMgr* timeMgr, ToneReproductor* eye, int delta_time)
 {
 
-	// step through and update all active meteors
-	int n =0;
-	for (vector<Meteor*>::iterator iter = active.begin(); iter != active.end(); ++iter) {
-		n++;
-		//printf("Meteor %d update\n", ++n);
-		if ( !( (*iter)->update(delta_time) ) ) {
-			// remove dead meteor
-			//      printf("Meteor \tdied\n");
-			delete *iter;
-			active.erase(iter);
-			iter--;  // important!
-		}
-	}
+	// step through and update all active meteors, dead ones are removed
+	active.update(delta_time);
 
 	// only makes sense given lifetimes of meteors to draw when time_speed is realtime
 	// otherwise high overhead of large numbers of meteors
@@ -107,17 +99,20 @@ void MeteorMgr::update(Projector *proj, Navigator* nav, TimeMgr* timeMgr, ToneRe
 	int mpf = (int)((double)ZHR*zhr_to_wsr*(double)delta_time/1000.0f + 0.5);
 	if ( mpf < 1 ) mpf = 1;
 
-	int mlaunch = 0;
+	unsigned int mlaunch = 0;
 	for (int i=0; i<mpf; i++) {
 
 		// start new meteor based on ZHR time probability
 		double prob = (double)rand()/((double)RAND_MAX+1);
-		if ( ZHR > 0 && prob < ((double)ZHR*zhr_to_wsr*(double)delta_time/1000.0f/(double)mpf) ) {
-			Meteor *m = new Meteor(proj, nav, eye, max_velocity);
-			active.push_back(m);
+		if ( ZHR > 0 && prob < ((double)ZHR*zhr_to_wsr*(double)delta_time/1000.0f/(double)mpf) )
 			mlaunch++;
-		}
 	}
+	if (mlaunch == 0)
+		return;
+
+	// all the meteors of the frame share the same radiant and observer position
+	Mat4d mmat = MeteorPool::radiantMatrix(nav->helioToEarthEqu(Vec3d(0,0,0)));
+	active.create(mlaunch, mmat, nav->localToEarthEqu(Vec3d(0,0,EARTH_RADIUS)), max_velocity, eye, proj->getFov());
 	//  printf("mpf: %d\tm launched: %d\t(mps: %f)\t%d\n", mpf, mlaunch, ZHR*zhr_to_wsr, delta_time);
 }
 
@@ -131,7 +126,14 @@ void MeteorMgr::createShader()
 	glBindVertexArray(meteor.vao);
 
 	glGenBuffers(1,&meteor.color);
+	glBindBuffer(GL_ARRAY_BUFFER,meteor.color);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecColor.size(),NULL,GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(1,4,GL_FLOAT,GL_FALSE,0,NULL);
+
 	glGenBuffers(1,&meteor.pos);
+	glBindBuffer(GL_ARRAY_BUFFER,meteor.pos);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecPos.size(),NULL,GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
@@ -139,7 +141,8 @@ void MeteorMgr::createShader()
 
 void MeteorMgr::deleteShader()
 {
-	if(shaderMeteor) shaderMeteor=nullptr;
+	if(shaderMeteor) delete shaderMeteor;
+	shaderMeteor=nullptr;
 
 	glDeleteBuffers(1,&meteor.pos);
 	glDeleteBuffers(1,&meteor.color);
@@ -148,32 +151,72 @@ void MeteorMgr::deleteShader()
 
 void MeteorMgr::draw(Projector *proj, Navigator* nav)
 {
-	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	StateGL::enable(GL_BLEND);
+	if (active.size()==0)
+		return;
 
-	for (vector<Meteor*>::iterator iter = active.begin(); iter != active.end(); ++iter)
-		(*iter)->draw(proj, nav, vecPos, vecColor);
+	float* pos = vecPos.data();
+	float* color = vecColor.data();
+	unsigned int nbDrawn = 0;
+
+	Vec3d spos, ipos, epos;
+	Vec3d start, intpos, end;
+	for (unsigned int i=0; i < active.size(); i++) {
+		active.getTrain(i, spos, ipos, epos);
+
+		// convert to local and correct for earth radius [since equ and local coordinates use same 0 point!]
+		spos = nav->earthEquToLocal( spos );
+		epos = nav->earthEquToLocal( epos );
+		spos[2] -= EARTH_RADIUS;
+		epos[2] -= EARTH_RADIUS;
+
+		int t1 = proj->projectLocalCheck(spos/1216, start);  // 1216 is to scale down under 1 for desktop version
+		int t2 = proj->projectLocalCheck(epos/1216, end);
+
+		// don't draw if not visible (but may come into view)
+		if ( t1 + t2 == 0 )
+			continue;
+
+		// compute an intermediate point so can curve slightly along projection distortions
+		ipos = nav->earthEquToLocal( ipos );
+		ipos[2] -= EARTH_RADIUS;
+		proj->projectLocal(ipos/1216, intpos);
+
+		double tmag = active.getIntensity(i);
+
+		// end -> intermediate point
+		*pos++ = end[0];
+		*pos++ = end[1];
+		*pos++ = intpos[0];
+		*pos++ = intpos[1];
+		*color++ = 0; *color++ = 0; *color++ = 0; *color++ = 0;
+		*color++ = 1; *color++ = 1; *color++ = 1; *color++ = tmag/2;
+
+		// intermediate point -> start
+		*pos++ = intpos[0];
+		*pos++ = intpos[1];
+		*pos++ = start[0];
+		*pos++ = start[1];
+		*color++ = 1; *color++ = 1; *color++ = 1; *color++ = tmag/2;
+		*color++ = 1; *color++ = 1; *color++ = 1; *color++ = tmag;
+
+		nbDrawn++;
+	}
 
-	if (vecPos.size()==0)
+	if (nbDrawn==0)
 		return;
 
+	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	StateGL::enable(GL_BLEND);
+
 	glBindVertexArray(meteor.vao);
 
 	glBindBuffer(GL_ARRAY_BUFFER,meteor.color);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecColor.size(),vecColor.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(1,4,GL_FLOAT,GL_FALSE,0,NULL);
+	glBufferSubData(GL_ARRAY_BUFFER,0,sizeof(float)*16*nbDrawn,vecColor.data());
 
 	glBindBuffer(GL_ARRAY_BUFFER,meteor.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecPos.size(),vecPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
+	glBufferSubData(GL_ARRAY_BUFFER,0,sizeof(float)*8*nbDrawn,vecPos.data());
 
 	shaderMeteor->use();
-
-	for(unsigned int i=0; i < (vecPos.size()/3) ; i++)
-		glDrawArrays(GL_LINE_STRIP, 3*i, 3);
-
+	glDrawArrays(GL_LINES, 0, 4*nbDrawn);
 	shaderMeteor->unuse();
-
-	vecPos.clear();
-	vecColor.clear();
 }
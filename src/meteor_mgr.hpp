@@ -57,12 +57,13 @@ private:
 	void createShader();
 	void deleteShader();
 
-	std::vector<Meteor*> active;		// Vector containing all active meteors
+	MeteorPool active;		// all active meteors
 	int ZHR;
 	int max_velocity;
 	double zhr_to_wsr;  // factor to convert from zhr to whole earth per second rate
 
-	// un meteor = 3 positions, donc 6 floats points
+	// un meteor = 2 segments, donc 4 sommets : 8 floats de position et 16 de couleur
+	// tous les meteors sont tracés en un seul appel
 	std::vector<float> vecPos;
 	std::vector<float> vecColor;
 
@@ -37,6 +37,8 @@ using namespace std;
 
 s_texture * Nebula::tex_NEBULA = nullptr;
 shaderProgram * Nebula::shaderNebulaTex = nullptr;
+UniformHandle Nebula::uniformMat;
+UniformHandle Nebula::uniformFader;
 s_font* Nebula::nebulaFont = nullptr;
 float Nebula::circleScale = 1.f;
 float Nebula::hintsBrightness = 0;
@@ -59,8 +61,7 @@ static float magToLuminance(float mag, float surface)
 
 //todo path est inutile
 Nebula::Nebula(string _englishName, string _mtype, string _constellation, float _ra, float _de, float _mag, float _size, string _classe,
-               float _distance, string tex_name, bool path, float tex_angular_size, float tex_rotation, string tex_credit, float _luminance, bool _deletable, bool _hidden) :
-	neb_tex(nullptr)
+               float _distance, string tex_name, bool path, float tex_angular_size, float tex_rotation, string tex_credit, float _luminance, bool _deletable, bool _hidden)
 {
 	neb_color=Vec3f(0.2,0.2,1.);
 	tex_circle = nullptr;
@@ -103,13 +104,12 @@ Nebula::Nebula(string _englishName, string _mtype, string _constellation, float
 	// Calc the angular size in radian
 	m_angular_size = tex_angular_size/2/60*C_PI/180;
 
-	neb_tex = new s_texture(tex_name, TEX_LOAD_TYPE_PNG_ALPHA, true);  // use mipmaps
+	// the texture is packed with the others by NebulaMgr, which also sets its average luminance
+	texName = tex_name;
+	tex_avg_luminance = 1.f;
 
 	luminance = magToLuminance(mag, tex_angular_size*tex_angular_size*3600);
 
-	// this is a huge performance drag if called every frame, so cache here
-	tex_avg_luminance = neb_tex->getAverageLuminance();
-
 	Vec3d imagev = Mat4d::zrotation(myRA-C_PI_2) * Mat4d::xrotation(myDe) * Vec3d(0,1,0);
 	Vec3d ortho1 = Mat4d::zrotation(myRA-C_PI_2) * Vec3d(1,0,0);
 	Vec3d ortho2 = imagev^ortho1;
@@ -194,8 +194,6 @@ Nebula::Nebula(string _englishName, string _mtype, string _constellation, float
 
 Nebula::~Nebula()
 {
-	if (neb_tex) delete neb_tex;
-	neb_tex = nullptr;
 }
 
 nebula_type Nebula::getDsoType( string type)
@@ -302,120 +300,46 @@ double Nebula::getCloseFov(const Navigator*) const
 	return m_angular_size * 180./C_PI * 4;
 }
 
-void Nebula::drawTex(const Projector* prj, const Navigator* nav, ToneReproductor* eye, double sky_brightness)
+void Nebula::drawTex(const Projector* prj, const Navigator* nav, ToneReproductor* eye, double sky_brightness, vector<float> &vecTexPos, vector<float> &vecTexCoord, vector<float> &vecTexLum)
 {
-	StateGL::enable(GL_BLEND);
-	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	if (!neb_tex || m_hidden || !m_selected) return;
+	if (texLayer.array < 0 || m_hidden || !m_selected) return;
 
 	// daylight hackery
 	float ad_lum=eye->adaptLuminance(luminance);
 
+	// nebulaBrightness is applied to the whole batch by the shader
 	float color = 1;
-	if (flagBright && sky_brightness < 0.011 && (getOnScreenSize(prj, nav) > prj->getViewportHeight()/64.)) {
-		//cout << "Bright nebula drawn for" << getEnglishName() << endl;
-		color *= nebulaBrightness;
-	} else {
+	if (!(flagBright && sky_brightness < 0.011 && (getOnScreenSize(prj, nav) > prj->getViewportHeight()/64.))) {
 		// TODO this should be revisited to be less ad hoc
 		// 3 is a fudge factor since only about 1/3 of a texture is not black background
-		float cmag = 3 * ad_lum / tex_avg_luminance * texLuminanceAdjust;
-		color = color * cmag * nebulaBrightness;
-		//cout << "No bright nebula drawn for" << getEnglishName() << endl;
+		color = 3 * ad_lum / tex_avg_luminance * texLuminanceAdjust;
 	}
 
-	shaderNebulaTex->use();
-	shaderNebulaTex->setUniform("Mat", prj->getMatJ2000ToEye());
-	shaderNebulaTex->setUniform("fader", color);
-
-	glBindTexture (GL_TEXTURE_2D, neb_tex->getID());
-	glBindVertexArray(nebulaTex.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,nebulaTex.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*sDataPos.size(),sDataPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
-	glEnableVertexAttribArray(0); //layout 0
-
-	glBindBuffer(GL_ARRAY_BUFFER,nebulaTex.tex);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*8,sDataTex,GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
-	glEnableVertexAttribArray(1); //layout 1
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	shaderNebulaTex->unuse();
+	// the triangle strip 0 1 2 3 as two triangles
+	static const int order[6] = { 0, 1, 2, 2, 1, 3 };
+	for (int i : order) {
+		vecTexPos.insert(vecTexPos.end(), {sDataPos[3*i], sDataPos[3*i+1], sDataPos[3*i+2]});
+		vecTexCoord.insert(vecTexCoord.end(), {sDataTex[2*i], sDataTex[2*i+1], (float)texLayer.layer});
+		vecTexLum.push_back(color);
+	}
 }
 
 void Nebula::drawHint(const Projector* prj, const Navigator * nav, vector<float> &vecHintPos, vector<float> &vecHintTex, vector<float> &vecHintColor)
 {
 	if (m_hidden || !m_selected) return;
 	if (2.f/getOnScreenSize(prj, nav)<0.1) return;
-	float r = dsoPictoSize;
 
+	// lower left corner of the pictogram in tex_NEBULA, the quad of size dsoPictoSize is built by the shader
 	if (displaySpecificHint) {
-		//~ printf("color specific: %f %f %f\n", neb_color[0] , neb_color[1] , neb_color[2]);
-		vecHintColor.push_back( neb_color[0] );
-		vecHintColor.push_back(  neb_color[1] );
-		vecHintColor.push_back( neb_color[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-		vecHintColor.push_back( neb_color[0] );
-		vecHintColor.push_back(  neb_color[1] );
-		vecHintColor.push_back( neb_color[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-		vecHintColor.push_back( neb_color[0] );
-		vecHintColor.push_back(  neb_color[1] );
-		vecHintColor.push_back( neb_color[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-		vecHintColor.push_back( neb_color[0] );
-		vecHintColor.push_back(  neb_color[1] );
-		vecHintColor.push_back( neb_color[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-
-		vecHintTex.push_back( posTex[0] );
-		vecHintTex.push_back( posTex[1] );
-		vecHintTex.push_back( posTex[0]+.25 );
-		vecHintTex.push_back( posTex[1] );
-		vecHintTex.push_back( posTex[0] );
-		vecHintTex.push_back( posTex[1]+.25 );
-		vecHintTex.push_back( posTex[0]+.25 );
-		vecHintTex.push_back( posTex[1]+.25 );
+		vecHintColor.insert(vecHintColor.end(), {neb_color[0], neb_color[1], neb_color[2]});
+		vecHintTex.insert(vecHintTex.end(), {posTex[0], posTex[1]});
 	} else {
-		//~ printf("color circle: %f %f %f\n",circleColor[0], circleColor[1], circleColor[2]);
-		vecHintColor.push_back( circleColor[0] );
-		vecHintColor.push_back(  circleColor[1] );
-		vecHintColor.push_back( circleColor[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-		vecHintColor.push_back( circleColor[0] );
-		vecHintColor.push_back(  circleColor[1] );
-		vecHintColor.push_back( circleColor[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-		vecHintColor.push_back( circleColor[0] );
-		vecHintColor.push_back(  circleColor[1] );
-		vecHintColor.push_back( circleColor[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-		vecHintColor.push_back( circleColor[0] );
-		vecHintColor.push_back(  circleColor[1] );
-		vecHintColor.push_back( circleColor[2] );
-		//~ vecHintColor.push_back( hintsBrightness );
-
-		vecHintTex.push_back(0.75);
-		vecHintTex.push_back(0.);
-		vecHintTex.push_back(1.0);
-		vecHintTex.push_back(0.);
-		vecHintTex.push_back(0.75);
-		vecHintTex.push_back(0.25);
-		vecHintTex.push_back(1.0);
-		vecHintTex.push_back(0.25);
+		vecHintColor.insert(vecHintColor.end(), {circleColor[0], circleColor[1], circleColor[2]});
+		vecHintTex.insert(vecHintTex.end(), {0.75f, 0.f});
 	}
 
-	vecHintPos.push_back( (float) (XY[0] + r) );
-	vecHintPos.push_back( (float) (XY[1] - r) );
-	vecHintPos.push_back( (float) (XY[0] - r) );
-	vecHintPos.push_back( (float) (XY[1] - r) );
-	vecHintPos.push_back( (float) (XY[0] + r) );
-	vecHintPos.push_back( (float) (XY[1] + r) );
-	vecHintPos.push_back( (float) (XY[0] - r) );
-	vecHintPos.push_back( (float) (XY[1] + r) );
+	vecHintPos.push_back( (float) XY[0] );
+	vecHintPos.push_back( (float) XY[1] );
 }
 
 void Nebula::drawName(const Projector* prj)
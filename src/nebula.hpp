@@ -31,6 +31,7 @@
 #include "projector.hpp"
 #include "navigator.hpp"
 #include "s_texture.hpp"
+#include "texture_array.hpp"
 #include "s_font.hpp"
 #include "tone_reproductor.hpp"
 #include "translator.hpp"
@@ -165,8 +166,10 @@ protected:
 	}
 
 private:
-	void drawTex(const Projector* prj, const Navigator * nav, ToneReproductor* eye, double sky_brightness);
+	//! append the two triangles of the texture to the batch of NebulaMgr
+	void drawTex(const Projector* prj, const Navigator * nav, ToneReproductor* eye, double sky_brightness, std::vector<float> &vecTexPos, std::vector<float> &vecTexCoord, std::vector<float> &vecTexLum);
 	void drawName(const Projector* prj);
+	//! append the hint, one point expanded by the geometry shader, to the batch of NebulaMgr
 	void drawHint(const Projector* prj, const Navigator * nav, std::vector<float> &vecHintPos, std::vector<float> &vecHintTex, std::vector<float> &vecHintColor);
 	nebula_type getDsoType( std::string type);
 
@@ -185,7 +188,8 @@ private:
 	Vec3d XY;						// Store temporary 2D position
 	nebula_type DSOType;			// say what type of nebula it is
 
-	s_texture * neb_tex = nullptr;	// Texture
+	std::string texName;			// Texture file, loaded by NebulaMgr
+	TextureArray::Layer texLayer;	// Texture location in the texture arrays of NebulaMgr
 	float sDataTex[8];				// The 8 indices for the 4 vertex
 	std::vector<float> sDataPos;	//all coordonates points for the 4 vertex
 	float luminance;				// Object luminance to use (value computed to compensate the texture avergae luminosity)
@@ -209,6 +213,7 @@ private:
 	static s_texture * tex_NEBULA;
 
 	static shaderProgram * shaderNebulaTex;
+	static UniformHandle uniformMat, uniformFader;
 	static DataGL nebulaTex;
 
 	static s_font* nebulaFont;			// Font used for names printing
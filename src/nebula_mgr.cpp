@@ -38,9 +38,8 @@
 
 using namespace std;
 
-NebulaMgr::NebulaMgr(void)
+NebulaMgr::NebulaMgr(void) : nebIndex(NEB_INDEX_LEVEL)
 {
-	nebZones = new vector<Nebula*>[nebGrid.getNbPoints()];
 	if (! initTexPicto())
 		Log.write("DSO: error while loading pictogram texture", cLog::LOG_TYPE::L_ERROR);
 
@@ -63,8 +62,6 @@ NebulaMgr::~NebulaMgr()
 
 	deleteShaderHint();
 	deleteShaderTex();
-
-	delete[] nebZones;
 }
 
 
@@ -72,17 +69,19 @@ void NebulaMgr::createShaderTex()
 {
 	Nebula::shaderNebulaTex = new shaderProgram();
 	Nebula::shaderNebulaTex->init("nebulaTex.vert","nebulaTex.geom","nebulaTex.frag");
-	Nebula::shaderNebulaTex->setUniformLocation("Mat");
-	Nebula::shaderNebulaTex->setUniformLocation("fader");
+	Nebula::uniformMat = Nebula::shaderNebulaTex->setUniformLocation("Mat");
+	Nebula::uniformFader = Nebula::shaderNebulaTex->setUniformLocation("fader");
 
 	glGenVertexArrays(1,&Nebula::nebulaTex.vao);
 	glBindVertexArray(Nebula::nebulaTex.vao);
 
 	glGenBuffers(1,&Nebula::nebulaTex.tex);
 	glGenBuffers(1,&Nebula::nebulaTex.pos);
+	glGenBuffers(1,&Nebula::nebulaTex.mag);
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
 }
 
 void NebulaMgr::deleteShaderTex()
@@ -93,6 +92,7 @@ void NebulaMgr::deleteShaderTex()
 
 	glDeleteBuffers(1,&Nebula::nebulaTex.pos);
 	glDeleteBuffers(1,&Nebula::nebulaTex.tex);
+	glDeleteBuffers(1,&Nebula::nebulaTex.mag);
 	glDeleteVertexArrays(1,&Nebula::nebulaTex.vao);
 }
 
@@ -111,8 +111,9 @@ void NebulaMgr::deleteShaderHint()
 void NebulaMgr::createShaderHint()
 {
 	shaderNebulaHint = new shaderProgram();
-	shaderNebulaHint->init("nebulaHint.vert","nebulaHint.frag");
-	shaderNebulaHint->setUniformLocation("fader");
+	shaderNebulaHint->init("nebulaHint.vert","nebulaHint.geom","nebulaHint.frag");
+	uniformHintFader = shaderNebulaHint->setUniformLocation("fader");
+	uniformHintRadius = shaderNebulaHint->setUniformLocation("radius");
 
 	glGenVertexArrays(1,&nebulaHint.vao);
 	glBindVertexArray(nebulaHint.vao);
@@ -162,7 +163,6 @@ string NebulaMgr::removeNebula(const string& name, bool showOriginal=true)
 	string uname = name;
 	transform(uname.begin(), uname.end(), uname.begin(), ::toupper);
 	vector <Nebula*>::iterator iter;
-	vector <Nebula*>::iterator iter2;
 
 	for (iter = neb_array.begin(); iter != neb_array.end(); ++iter) {
 		string testName = (*iter)->getEnglishName();
@@ -176,20 +176,9 @@ string NebulaMgr::removeNebula(const string& name, bool showOriginal=true)
 				continue;
 			}
 
-			// erase from locator grid
-			int zone = nebGrid.GetNearest((*iter)->XYZ);
-
-			for (iter2 = nebZones[zone].begin(); iter2!=nebZones[zone].end(); ++iter2) {
-				if(*iter2 == *iter) {
-//					cerr << "Deleting nebula from zone " << zone << " with name " << (*iter2)->englishName << endl;
-					nebZones[zone].erase(iter2);
-					break;
-				}
-			}
-
-			// Delete nebula
-			delete *iter;
+			deleteNebula(*iter);
 			neb_array.erase(iter);
+			nebIndex.build();
 //			cerr << "Erased nebula " << uname << endl;
 
 			return "";
@@ -205,7 +194,6 @@ string NebulaMgr::removeSupplementalNebulae()
 {
 
 	vector<Nebula *>::iterator iter;
-	vector<Nebula *>::iterator iter2;
 
 	for (iter=neb_array.begin(); iter!=neb_array.end(); iter++) {
 
@@ -214,28 +202,25 @@ string NebulaMgr::removeSupplementalNebulae()
 			(*iter)->select();
 		} else {
 
-			// erase from locator grid
-			int zone = nebGrid.GetNearest((*iter)->XYZ);
-
-			for (iter2 = nebZones[zone].begin(); iter2!=nebZones[zone].end(); ++iter2) {
-				if(*iter2 == *iter) {
-//					cerr << "Deleting nebula from zone " << zone << " with name " << (*iter2)->englishName << endl;
-					nebZones[zone].erase(iter2);
-					break;
-				}
-			}
-
-			// Delete nebula
-			delete *iter;
+			deleteNebula(*iter);
 			neb_array.erase(iter);
 			iter--;
 			// cerr << "Erased nebula " << uname << endl;
 		}
 	}
+	nebIndex.build();
 
 	return "";
 }
 
+void NebulaMgr::deleteNebula(Nebula *n)
+{
+	nebIndex.remove(n);
+	texPending.erase(std::remove(texPending.begin(), texPending.end(), n), texPending.end());
+	nebTextures.release(n->texLayer);
+	delete n;
+}
+
 // Draw all the Nebulae
 void NebulaMgr::draw(const Projector* prj, const Navigator * nav, ToneReproductor* eye, double sky_brightness)
 {
@@ -250,31 +235,24 @@ void NebulaMgr::draw(const Projector* prj, const Navigator * nav, ToneReproducto
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_ONE, GL_ONE);
 
-	Vec3f pXYZ;
-
-	// Find the star zones which are in the screen
-	int nbZones=0;
+	// Find the sky cells which are in the screen
 	// FOV is currently measured vertically, so need to adjust for wide screens
 	// TODO: projector should probably use largest measurement itself
 	float max_fov = myMax( prj->getFov(), prj->getFov()*prj->getViewportWidth()/prj->getViewportHeight());
-	nbZones = nebGrid.Intersect(nav->getPrecEquVision(), max_fov*C_PI/180.f*1.2f);
-	static int * zoneList = nebGrid.getResult();
+	nebIndex.searchCone(nav->getPrecEquVision(), max_fov*C_PI/180.f*0.6f, nebRanges);
 
 	//~ prj->set_orthographic_projection();	// set 2D coordinate
 
-	// Print all the stars of all the selected zones
-	static vector<Nebula *>::iterator end;
-	static vector<Nebula *>::iterator iter;
+	// Print all the nebulae of all the selected cells
 	Nebula* n;
 
 	// speed up the computation of n->getOnScreenSize(prj, nav)>5:
 	const float size_limit = 5.0 * (C_PI/180.0) * (prj->getFov()/prj->getViewportHeight());
 
-	for (int i=0; i<nbZones; ++i) {
-		end = nebZones[zoneList[i]].end();
-		for (iter = nebZones[zoneList[i]].begin(); iter!=end; ++iter) {
+	for (const SkyRange &range : nebRanges) {
+		for (unsigned int i = range.first; i < range.last; ++i) {
 
-			n = *iter;
+			n = nebIndex[i];
 
 			// improve performance by skipping if too small to see
 			if ( n->m_angular_size>size_limit|| (hintsFader.getInterstate()>0.0001 && n->mag <= getMaxMagHints())) {
@@ -282,7 +260,7 @@ void NebulaMgr::draw(const Projector* prj, const Navigator * nav, ToneReproducto
 				prj->projectJ2000(n->XYZ,n->XY);
 
 				if (n->m_angular_size>size_limit) {
-					n->drawTex(prj, nav, eye, sky_brightness);
+					texVisible.push_back(n);
 				}
 
 				if (textFader) {
@@ -295,16 +273,79 @@ void NebulaMgr::draw(const Projector* prj, const Navigator * nav, ToneReproducto
 			}
 		}
 	}
+	drawAllTex(prj, nav, eye, sky_brightness);
+	if (textFader)
+		Nebula::nebulaFont->flush();
 	drawAllHint(prj);
 }
 
+void NebulaMgr::drawAllTex(const Projector* prj, const Navigator *nav, ToneReproductor *eye, double sky_brightness)
+{
+	if (texVisible.empty())
+		return;
+
+	// one draw call per texture array
+	std::stable_sort(texVisible.begin(), texVisible.end(), [](const Nebula *a, const Nebula *b) {
+		return a->texLayer.array < b->texLayer.array;
+	});
+
+	vector<int> rangeArray;
+	vector<unsigned int> rangeFirst;
+	for (Nebula *n : texVisible) {
+		const unsigned int first = vecTexLum.size();
+		n->drawTex(prj, nav, eye, sky_brightness, vecTexPos, vecTexCoord, vecTexLum);
+		if (vecTexLum.size() > first && (rangeArray.empty() || rangeArray.back() != n->texLayer.array)) {
+			rangeArray.push_back(n->texLayer.array);
+			rangeFirst.push_back(first);
+		}
+	}
+	texVisible.clear();
+	rangeFirst.push_back(vecTexLum.size());
+
+	if (!rangeArray.empty()) {
+		StateGL::enable(GL_BLEND);
+		StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		Nebula::shaderNebulaTex->use();
+		Nebula::shaderNebulaTex->setUniform(Nebula::uniformMat, prj->getMatJ2000ToEye());
+		Nebula::shaderNebulaTex->setUniform(Nebula::uniformFader, Nebula::nebulaBrightness);
+
+		glBindVertexArray(Nebula::nebulaTex.vao);
+
+		glBindBuffer(GL_ARRAY_BUFFER,Nebula::nebulaTex.pos);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTexPos.size(),vecTexPos.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glBindBuffer(GL_ARRAY_BUFFER,Nebula::nebulaTex.tex);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTexCoord.size(),vecTexCoord.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glBindBuffer(GL_ARRAY_BUFFER,Nebula::nebulaTex.mag);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTexLum.size(),vecTexLum.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(2,1,GL_FLOAT,GL_FALSE,0,NULL);
+
+		for (unsigned int i = 0; i < rangeArray.size(); i++) {
+			glBindTexture(GL_TEXTURE_2D_ARRAY, nebTextures.getID(rangeArray[i]));
+			glDrawArrays(GL_TRIANGLES, rangeFirst[i], rangeFirst[i+1] - rangeFirst[i]);
+		}
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		Nebula::shaderNebulaTex->unuse();
+	}
+
+	vecTexPos.clear();
+	vecTexCoord.clear();
+	vecTexLum.clear();
+}
+
 void NebulaMgr::drawAllHint(const Projector* prj)
 {
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
 	shaderNebulaHint->use();
-	shaderNebulaHint->setUniform("fader", hintsFader.getInterstate());
+	shaderNebulaHint->setUniform(uniformHintFader, hintsFader.getInterstate());
+	shaderNebulaHint->setUniform(uniformHintRadius, (float)Nebula::dsoPictoSize);
 
 	glBindTexture (GL_TEXTURE_2D, Nebula::tex_NEBULA->getID());
 
@@ -323,8 +364,8 @@ void NebulaMgr::drawAllHint(const Projector* prj)
 		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecHintColor.size(),vecHintColor.data(),GL_DYNAMIC_DRAW);
 		glVertexAttribPointer(2,3,GL_FLOAT,GL_FALSE,0,NULL);
 
-		for(unsigned int i=0; i < (vecHintPos.size()/8) ; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, 4*i, 4);
+		// one point per hint, expanded into a quad by the geometry shader
+		glDrawArrays(GL_POINTS, 0, vecHintPos.size()/2);
 
 		vecHintPos.clear();
 		vecHintTex.clear();
@@ -426,25 +467,41 @@ vector<Object> NebulaMgr::searchAround(Vec3d v, double lim_fov) const
 	vector<Object> result;
 	v.normalize();
 	double cos_lim_fov = cos(lim_fov * C_PI/180.);
-	static Vec3d equPos;
-
-	vector<Nebula*>::const_iterator iter = neb_array.begin();
-	while (iter != neb_array.end()) {
-		equPos = (*iter)->XYZ;
-		equPos.normalize();
-		if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]>=cos_lim_fov) {
+	Vec3d equPos;
+
+	vector<SkyRange> ranges;
+	nebIndex.searchCone(v, lim_fov * C_PI/180., ranges);
+	for (const SkyRange &range : ranges) {
+		for (unsigned int i = range.first; i < range.last; ++i) {
+			Nebula *n = nebIndex[i];
+			// the cells inside the circle need no test
+			if (!range.inside) {
+				equPos = n->XYZ;
+				equPos.normalize();
+				if (equPos[0]*v[0] + equPos[1]*v[1] + equPos[2]*v[2]<cos_lim_fov)
+					continue;
+			}
 
 			// NOTE: non-labeled nebulas are not returned!
 			// Otherwise cursor select gets invisible nebulas - Rob
-			if ((*iter)->getNameI18n() != "" && (*iter)->m_hidden==false) result.push_back(*iter);
+			if (n->getNameI18n() != "" && n->m_hidden==false) result.push_back(n);
 		}
-		iter++;
 	}
 	return result;
 }
 
 bool NebulaMgr::loadDeepskyObject(string _englishName, string _DSOType, string _constellation, float _ra, float _de, float _mag, float _size, string _classe,
                                   float _distance, string tex_name, bool path, float tex_angular_size, float _rotation, string _credit, float _luminance, bool deletable)
+{
+	bool result = createDeepskyObject(_englishName, _DSOType, _constellation, _ra, _de, _mag, _size, _classe, _distance, tex_name, path,
+	                                  tex_angular_size, _rotation, _credit, _luminance, deletable);
+	nebIndex.build();
+	loadPendingTextures();
+	return result;
+}
+
+bool NebulaMgr::createDeepskyObject(string _englishName, string _DSOType, string _constellation, float _ra, float _de, float _mag, float _size, string _classe,
+                                    float _distance, string tex_name, bool path, float tex_angular_size, float _rotation, string _credit, float _luminance, bool deletable)
 {
 	Nebula *e = searchNebula(_englishName, false);
 	if(e) {
@@ -462,12 +519,33 @@ bool NebulaMgr::loadDeepskyObject(string _englishName, string _DSOType, string _
 
 	if (e != nullptr) {
 		neb_array.push_back(e);
-		nebZones[nebGrid.GetNearest(e->XYZ)].push_back(e);
+		nebIndex.insert(e, e->XYZ);
+		texPending.push_back(e);
 		return true;
 	} else
 		return false;
 }
 
+void NebulaMgr::loadPendingTextures()
+{
+	if (texPending.empty())
+		return;
+
+	vector<string> names;
+	for (Nebula *n : texPending)
+		names.push_back(n->texName);
+
+	vector<TextureArray::Layer> layers;
+	vector<float> avgLuminance;
+	nebTextures.load(names, PNG_ALPHA, layers, avgLuminance);
+
+	for (unsigned int i = 0; i < texPending.size(); i++) {
+		texPending[i]->texLayer = layers[i];
+		texPending[i]->tex_avg_luminance = avgLuminance[i];
+	}
+	texPending.clear();
+}
+
 
 // read from file
 bool NebulaMgr::loadDeepskyObjectFromCat(const string& cat)
@@ -496,8 +574,8 @@ bool NebulaMgr::loadDeepskyObjectFromCat(const string& cat)
 		        >>  distance >> tex_name >> tex_angular_size >> tex_rotation >> credits >> texLuminanceAdjust )) {
 			data_drop++;
 		} else {
-			if ( ! loadDeepskyObject(name, type, constellation, ra, de, mag, scale, deep_class, distance,
-			                         tex_name, false, tex_angular_size, tex_rotation, credits, texLuminanceAdjust,false)) {
+			if ( ! createDeepskyObject(name, type, constellation, ra, de, mag, scale, deep_class, distance,
+			                           tex_name, false, tex_angular_size, tex_rotation, credits, texLuminanceAdjust,false)) {
 				//printf("error creating nebula\n");
 				data_drop++;
 			}
@@ -505,6 +583,9 @@ bool NebulaMgr::loadDeepskyObjectFromCat(const string& cat)
 		}
 	}
 	ngcFile.close();
+	nebIndex.build();
+	// all the textures of the catalog at once, in a few arrays
+	loadPendingTextures();
 	Log.write("Nebula: "+ Utility::intToString(i) + " items loaded, " + Utility::intToString(data_drop) + " dropped", cLog::LOG_TYPE::L_INFO);
 	return true;
 }
@@ -30,8 +30,8 @@
 #include <vector>
 #include "object.hpp"
 #include "fader.hpp"
-#include "grid.hpp"
 #include "nebula.hpp"
+#include "sky_index.hpp"
 
 
 
@@ -226,26 +226,44 @@ protected:
 	void deleteShaderTex();
 	void deleteShaderHint();
 	void drawAllHint(const Projector* prj);
+	void drawAllTex(const Projector* prj, const Navigator *nav, ToneReproductor *eye, double sky_brightness);
 
 private:
 	bool loadDeepskyObjectFromCat(const std::string& cat); //!< load DSO with reading file cat
 
+	//! create the DSO without its texture, loaded later by loadPendingTextures
+	bool createDeepskyObject(std::string _englishName, std::string _DSOType, std::string _constellation, float _ra, float _de, float _mag, float _size, std::string _classe,
+	                         float _distance, std::string tex_name, bool path, float tex_angular_size, float _rotation, std::string _credit, float _luminance, bool deletable);
+	//! pack the textures of the new DSO into texture arrays
+	void loadPendingTextures();
+	//! remove the DSO from the sky index and free it, nebIndex.build() must follow
+	void deleteNebula(Nebula *n);
+
 	std::vector<Nebula*> neb_array;		//!< The nebulas list
 	LinearFader hintsFader;			//!< Hint about position and number of dso
 	LinearFader showFader;			//!< For display all DSO fonctionnalities
 	LinearFader textFader;			//!< Display names smoothly
 
-	std::vector<Nebula*>* nebZones;		//!< array of nebula vector with the grid id as array rank
-	littleGrid nebGrid;				//! Grid for opimisation
+	SkyIndex<Nebula*> nebIndex;		//!< DSO sorted by sky cell
+	std::vector<SkyRange> nebRanges;	//!< parts of nebIndex in the field of view
+	static const int NEB_INDEX_LEVEL = 4;	//!< 5120 cells, about 3° wide
 
 	float maxMagHints;				//!< Define maximum magnitude at which nebulae hints are displayed
 
 	shaderProgram *shaderNebulaHint;
+	UniformHandle uniformHintFader, uniformHintRadius;
 	DataGL nebulaHint;
 
 	std::vector<float> vecHintPos;		//!< array of coordinates of the nebula's position
 	std::vector<float> vecHintTex;		//!< array of coordinates of the nebula's texture
 	std::vector<float> vecHintColor;		//!< array of the nebula's color
+
+	TextureArray nebTextures;			//!< all the DSO textures, packed by size
+	std::vector<Nebula*> texPending;	//!< DSO whose texture is not loaded yet
+	std::vector<Nebula*> texVisible;	//!< DSO whose texture is drawn in this frame
+	std::vector<float> vecTexPos;		//!< J2000 corners of the visible textures
+	std::vector<float> vecTexCoord;		//!< texture coordinates and layer of the visible textures
+	std::vector<float> vecTexLum;		//!< luminance of the visible textures
 };
 
 #endif // _NEBULA_MGR_H_
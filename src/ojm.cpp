@@ -1,6 +1,5 @@
 #include "ojm.hpp"
-#include <fstream>
-#include <sstream>
+#include "log.hpp"
 #include <iostream>
 #include <cmath>
 
@@ -12,43 +11,174 @@ using namespace std;
 //
 // *****************************************************************************
 
+Ojm::Ojm(const std::string& _fileName)
+{
+	fileName = _fileName;
+	size_t found = fileName.find_last_of("/\\");
+	if (found != string::npos)
+		pathFile = fileName.substr(0, found + 1);
+	init();
+}
 
 Ojm::Ojm(/*const string _directoryName,*/ const string & _fileName, const string & _pathFile, float multiplier)
 {
-	is_ok = false;
+	fileName = _fileName;
+	pathFile = _pathFile;
+	init(multiplier);
 }
 
 Ojm::~Ojm()
 {
-}
-
-Ojm::Ojm(const std::string& _fileName){
+	delGLparam();
 }
 
 bool Ojm::init(float multiplier)
 {
+	delGLparam();
+	is_ok = readOJM(fileName, multiplier);
 	return is_ok;
 }
 
-bool Ojm::testIndices()
+void Ojm::draw(shaderProgram * shader)
 {
-	return false;
+	if (!is_ok)
+		return;
+
+	for (const Shape &shape : shapes) {
+		shader->setUniform("Material.Ka", shape.Ka);
+		shader->setUniform("Material.Kd", shape.Kd);
+		shader->setUniform("Material.Ks", shape.Ks);
+		shader->setUniform("Material.Ns", shape.Ns);
+
+		if (shape.map_Ka != nullptr) {
+			shader->setUniform("useTexture", true);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, shape.map_Ka->getID());
+		} else
+			shader->setUniform("useTexture", false);
+
+		glBindVertexArray(shape.dGL.vao);
+		glDrawElements(GL_TRIANGLES, shape.nbIndices, GL_UNSIGNED_INT, (void*)0);
+	}
+	glBindVertexArray(0);
 }
 
-void Ojm::draw(shaderProgram * shader)
+void Ojm::initGLparam(Shape &shape, const OjmFile::ShapeData &data, float multiplier)
 {
+	glGenVertexArrays(1, &shape.dGL.vao);
+	glBindVertexArray(shape.dGL.vao);
+
+	glGenBuffers(1, &shape.dGL.pos);
+	glBindBuffer(GL_ARRAY_BUFFER, shape.dGL.pos);
+	if (multiplier == 1.0 || data.nbVertices == 0) {
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3f) * data.nbVertices, data.vertices, GL_STATIC_DRAW);
+	} else {
+		// la mise à l'échelle est écrite directement dans le buffer, sans tableau intermédiaire
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3f) * data.nbVertices, nullptr, GL_STATIC_DRAW);
+		Vec3f *dst = (Vec3f*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(Vec3f) * data.nbVertices, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		bool mapped = (dst != nullptr);
+		if (mapped) {
+			for (unsigned int i = 0; i < data.nbVertices; i++)
+				dst[i] = data.vertices[i] * multiplier;
+			mapped = (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE);
+		}
+		if (!mapped) {
+			Log.write("Ojm: glMapBufferRange failed on shape " + shape.name + " of " + fileName + ", copy with glBufferData", cLog::LOG_TYPE::L_WARNING);
+			std::vector<Vec3f> scaled(data.nbVertices);
+			for (unsigned int i = 0; i < data.nbVertices; i++)
+				scaled[i] = data.vertices[i] * multiplier;
+			glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3f) * data.nbVertices, scaled.data(), GL_STATIC_DRAW);
+		}
+	}
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+	glEnableVertexAttribArray(0);
+
+	if (data.nbUvs > 0) {
+		glGenBuffers(1, &shape.dGL.tex);
+		glBindBuffer(GL_ARRAY_BUFFER, shape.dGL.tex);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Vec2f) * data.nbUvs, data.uvs, GL_STATIC_DRAW);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+		glEnableVertexAttribArray(1);
+	}
+
+	if (data.nbNormals > 0) {
+		glGenBuffers(1, &shape.dGL.norm);
+		glBindBuffer(GL_ARRAY_BUFFER, shape.dGL.norm);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3f) * data.nbNormals, data.normals, GL_STATIC_DRAW);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+		glEnableVertexAttribArray(2);
+	}
+
+	glGenBuffers(1, &shape.dGL.elementBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shape.dGL.elementBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * data.nbIndices, data.indices, GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void Ojm::initGLparam()
+void Ojm::delGLparam()
 {
+	for (Shape &shape : shapes) {
+		glDeleteBuffers(1, &shape.dGL.pos);
+		if (shape.dGL.tex)
+			glDeleteBuffers(1, &shape.dGL.tex);
+		if (shape.dGL.norm)
+			glDeleteBuffers(1, &shape.dGL.norm);
+		glDeleteBuffers(1, &shape.dGL.elementBuffer);
+		glDeleteVertexArrays(1, &shape.dGL.vao);
+
+		if (shape.map_Ka) delete shape.map_Ka;
+		if (shape.map_Kd) delete shape.map_Kd;
+		if (shape.map_Ks) delete shape.map_Ks;
+	}
+	shapes.clear();
 }
 
 bool Ojm::readOJM(const string& filename, float multiplier)
 {
-	return false;
+	OjmFile file;
+	if (!file.load(filename)) {
+		Log.write("Ojm: could not load " + filename + ": " + file.getError(), cLog::LOG_TYPE::L_ERROR);
+		return false;
+	}
+
+	auto loadTexture = [this](const std::string &mapName) -> s_texture* {
+		if (mapName.empty())
+			return nullptr;
+		return new s_texture(pathFile + mapName, TEX_LOAD_TYPE_PNG_SOLID_REPEAT, true);
+	};
+
+	const std::vector<OjmFile::ShapeData> &datas = file.getShapes();
+	shapes.resize(datas.size());
+	for (unsigned int i = 0; i < datas.size(); i++) {
+		const OjmFile::ShapeData &data = datas[i];
+		Shape &shape = shapes[i];
+		shape.name = data.name;
+		shape.Ka = data.Ka;
+		shape.Kd = data.Kd;
+		shape.Ks = data.Ks;
+		shape.Ns = data.Ns;
+		shape.T = data.T;
+		shape.map_Ka = loadTexture(data.mapKa);
+		shape.map_Kd = loadTexture(data.mapKd);
+		shape.map_Ks = loadTexture(data.mapKs);
+		shape.nbIndices = data.nbIndices;
+		initGLparam(shape, data, multiplier);
+	}
+
+	Log.write("Ojm: " + filename + (file.isBinary() ? " (binary) " : " (text) ") + std::to_string(shapes.size()) + " shapes", cLog::LOG_TYPE::L_INFO);
+	return true;
 }
 
 
 void Ojm::print()
 {
+	cout << "Ojm " << fileName << (is_ok ? "" : " not loaded") << endl;
+	for (const Shape &shape : shapes) {
+		cout << "  shape " << shape.name << " : " << shape.nbIndices / 3 << " triangles";
+		if (shape.map_Ka)
+			cout << ", texture " << shape.map_Ka->getID();
+		cout << endl;
+	}
 }
@@ -2,6 +2,7 @@
 #define OJM_HPP_INCLUDED
 
 #include "vecmath.hpp"
+#include "ojm_file.hpp"
 #include "s_texture.hpp"
 #include "shader.hpp"
 #include <vector>
@@ -10,11 +11,6 @@
 struct Shape {
     std::string name;
 
-	std::vector<Vec3f> vertices;
-	std::vector<Vec2f> uvs;
-	std::vector<Vec3f> normals;
-	std::vector<unsigned int> indices;
-
 	Vec3f Ka;
 	Vec3f Kd;
 	Vec3f Ks;
@@ -25,9 +21,18 @@ struct Shape {
 	s_texture *map_Kd=nullptr;
 	s_texture *map_Ks=nullptr;
 
+	//! les vertex ne sont gardés que sur le GPU
+	unsigned int nbIndices = 0;
 	DataGL dGL;
 };
 
+/**
+ * \class Ojm
+ * \brief Objet 3D au format OJM, binaire (v2) ou texte
+ *
+ * Le fichier est lu par OjmFile : au format binaire il est projeté en mémoire
+ * et les buffers GL sont remplis directement depuis la projection.
+ */
 class Ojm {
 public:
 	Ojm(const std::string& _fileName);
@@ -50,9 +55,6 @@ public:
 
 private:
 	bool is_ok = false; //say if the model is correctly initialised and operationnal
-	//! vérifie si les indices coincident dans l'objet
-
-	bool testIndices();
 
 	//! charge un objet OJM du disque dur
 	bool readOJM(const std::string& filename, float multiplier= 1.0);
@@ -60,8 +62,8 @@ private:
 	//! indices des différents morceaux de l'objet
 	std::vector<Shape> shapes;
 
-	//! initialise tous les parametres GL de l'ojm
-	void initGLparam();
+	//! initialise les parametres GL d'une shape à partir des données du fichier
+	void initGLparam(Shape &shape, const OjmFile::ShapeData &data, float multiplier);
 
 	//! supprime les paramètres GL de l'ojm
 	void delGLparam();
@@ -0,0 +1,349 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ojm_file.hpp"
+#include "ojm_format.hpp"
+
+namespace {
+
+// lit jusqu'à nb valeurs dans args, renvoie le nombre de valeurs lues
+int readFloats(const char *args, float *values, int nb)
+{
+	char *end;
+	for (int i = 0; i < nb; i++) {
+		values[i] = strtof(args, &end);
+		if (end == args)
+			return i;
+		args = end;
+	}
+	return nb;
+}
+
+int readIndices(const char *args, unsigned int *values, int nb)
+{
+	char *end;
+	for (int i = 0; i < nb; i++) {
+		values[i] = strtoul(args, &end, 10);
+		if (end == args)
+			return i;
+		args = end;
+	}
+	return nb;
+}
+
+}
+
+OjmFile::~OjmFile()
+{
+	close();
+}
+
+bool OjmFile::load(const std::string &fileName)
+{
+	close();
+	error.clear();
+
+	if (!mapFile(fileName))
+		return false;
+
+	uint32_t magic = 0;
+	if (size >= sizeof(magic))
+		memcpy(&magic, data, sizeof(magic));
+	binary = (magic == OJM_BINARY_MAGIC);
+
+	bool ok = binary ? readBinary() : readText();
+	// au format texte tout a été copié dans les shapes
+	if (!binary)
+		unmapFile();
+	if (ok)
+		ok = testIndices();
+	if (!ok)
+		close();
+	return ok;
+}
+
+void OjmFile::close()
+{
+	shapes.clear();
+	unmapFile();
+	binary = false;
+}
+
+bool OjmFile::mapFile(const std::string &fileName)
+{
+#ifndef WIN32
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = "can't open " + fileName + ": " + strerror(errno);
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		error = "empty file " + fileName;
+		return false;
+	}
+	int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+	// tout le fichier sera lu par l'envoi au GPU : autant éviter les défauts de page un par un
+	flags |= MAP_POPULATE;
+#endif
+	mapping = mmap(nullptr, st.st_size, PROT_READ, flags, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		error = "mmap failed on " + fileName + ": " + strerror(errno);
+		return false;
+	}
+	size = st.st_size;
+	data = (const char*)mapping;
+#else
+	FILE *f = fopen(fileName.c_str(), "rb");
+	if (f == nullptr) {
+		error = "can't open " + fileName;
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	long length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (length <= 0) {
+		fclose(f);
+		error = "empty file " + fileName;
+		return false;
+	}
+	buffer.resize(length);
+	size_t nbRead = fread(buffer.data(), 1, length, f);
+	fclose(f);
+	if (nbRead != (size_t)length) {
+		buffer.clear();
+		error = "can't read " + fileName;
+		return false;
+	}
+	size = length;
+	data = buffer.data();
+#endif
+	return true;
+}
+
+void OjmFile::unmapFile()
+{
+#ifndef WIN32
+	if (mapping != nullptr)
+		munmap(mapping, size);
+#endif
+	mapping = nullptr;
+	buffer.clear();
+	buffer.shrink_to_fit();
+	data = nullptr;
+	size = 0;
+}
+
+bool OjmFile::readBinary()
+{
+	OjmFileHeader header;
+	if (size < sizeof(header)) {
+		error = "truncated header";
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (header.version != OJM_BINARY_VERSION) {
+		error = "unsupported OJM version " + std::to_string(header.version);
+		return false;
+	}
+	if (header.fileSize != size || sizeof(header) + (uint64_t)header.nbShapes * sizeof(OjmShapeEntry) > size) {
+		error = "truncated file";
+		return false;
+	}
+
+	// un bloc doit tenir dans le fichier et être aligné pour des lectures de float
+	auto checkBlock = [this](uint64_t offset, uint64_t length) {
+		return offset % sizeof(float) == 0 && offset <= size && length <= size - offset;
+	};
+	auto readString = [this](uint64_t offset, std::string &str) {
+		if (offset >= size || memchr(data + offset, 0, size - offset) == nullptr)
+			return false;
+		str.assign(data + offset);
+		return true;
+	};
+
+	shapes.resize(header.nbShapes);
+	for (unsigned int i = 0; i < header.nbShapes; i++) {
+		OjmShapeEntry entry;
+		memcpy(&entry, data + sizeof(header) + i * sizeof(OjmShapeEntry), sizeof(entry));
+		ShapeData &shape = shapes[i];
+
+		if (!readString(entry.name, shape.name) || !readString(entry.mapKa, shape.mapKa) ||
+		        !readString(entry.mapKd, shape.mapKd) || !readString(entry.mapKs, shape.mapKs)) {
+			error = "bad string in shape " + std::to_string(i);
+			return false;
+		}
+		shape.Ka = Vec3f(entry.Ka[0], entry.Ka[1], entry.Ka[2]);
+		shape.Kd = Vec3f(entry.Kd[0], entry.Kd[1], entry.Kd[2]);
+		shape.Ks = Vec3f(entry.Ks[0], entry.Ks[1], entry.Ks[2]);
+		shape.Ns = entry.Ns;
+		shape.T = entry.T;
+
+		if ((entry.nbUvs != 0 && entry.nbUvs != entry.nbVertices) ||
+		        (entry.nbNormals != 0 && entry.nbNormals != entry.nbVertices) ||
+		        !checkBlock(entry.vertices, 3 * sizeof(float) * (uint64_t)entry.nbVertices) ||
+		        !checkBlock(entry.uvs, 2 * sizeof(float) * (uint64_t)entry.nbUvs) ||
+		        !checkBlock(entry.normals, 3 * sizeof(float) * (uint64_t)entry.nbNormals) ||
+		        !checkBlock(entry.indices, sizeof(uint32_t) * (uint64_t)entry.nbIndices)) {
+			error = "bad data block in shape " + std::to_string(i);
+			return false;
+		}
+		shape.nbVertices = entry.nbVertices;
+		shape.nbUvs = entry.nbUvs;
+		shape.nbNormals = entry.nbNormals;
+		shape.nbIndices = entry.nbIndices;
+		shape.vertices = reinterpret_cast<const Vec3f*>(data + entry.vertices);
+		shape.uvs = reinterpret_cast<const Vec2f*>(data + entry.uvs);
+		shape.normals = reinterpret_cast<const Vec3f*>(data + entry.normals);
+		shape.indices = reinterpret_cast<const unsigned int*>(data + entry.indices);
+	}
+	return true;
+}
+
+bool OjmFile::readText()
+{
+	const char *pos = data;
+	const char *end = data + size;
+	ShapeData *shape = nullptr;
+	std::string line;
+	float values[3];
+	unsigned int indices[9];
+
+	while (pos < end) {
+		const char *eol = (const char*)memchr(pos, '\n', end - pos);
+		if (eol == nullptr)
+			eol = end;
+		line.assign(pos, eol);
+		pos = eol + 1;
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		size_t space = line.find(' ');
+		std::string prefix = line.substr(0, space);
+		const char *args = (space == std::string::npos) ? "" : line.c_str() + space + 1;
+
+		if (prefix == "o") {
+			shapes.emplace_back();
+			shape = &shapes.back();
+			shape->name = args;
+			continue;
+		}
+		if (shape == nullptr) {
+			// fichier sans ligne o, comme ceux d'OjmL : une seule shape sans nom
+			shapes.emplace_back();
+			shape = &shapes.back();
+		}
+
+		bool ok = true;
+		if (prefix == "v") {
+			ok = readFloats(args, values, 3) == 3;
+			shape->vertexData.push_back(Vec3f(values[0], values[1], values[2]));
+		} else if (prefix == "u") {
+			ok = readFloats(args, values, 2) == 2;
+			shape->uvData.push_back(Vec2f(values[0], values[1]));
+		} else if (prefix == "n") {
+			ok = readFloats(args, values, 3) == 3;
+			shape->normalData.push_back(Vec3f(values[0], values[1], values[2]));
+		} else if (prefix == "j") {
+			ok = readIndices(args, indices, 9) == 9;
+			shape->indexData.insert(shape->indexData.end(), indices, indices + 9);
+		} else if (prefix == "i") {
+			ok = readIndices(args, indices, 3) == 3;
+			shape->indexData.insert(shape->indexData.end(), indices, indices + 3);
+		} else if (prefix == "ka") {
+			ok = readFloats(args, shape->Ka, 3) == 3;
+		} else if (prefix == "kd") {
+			ok = readFloats(args, shape->Kd, 3) == 3;
+		} else if (prefix == "ks") {
+			ok = readFloats(args, shape->Ks, 3) == 3;
+		} else if (prefix == "Ns") {
+			ok = readFloats(args, &shape->Ns, 1) == 1;
+		} else if (prefix == "t") {
+			ok = readFloats(args, &shape->T, 1) == 1;
+		} else if (prefix == "map_ka") {
+			shape->mapKa = args;
+		} else if (prefix == "map_kd") {
+			shape->mapKd = args;
+		} else if (prefix == "map_ks") {
+			shape->mapKs = args;
+		}
+		if (!ok) {
+			error = "bad line in shape " + shape->name + ": " + line;
+			return false;
+		}
+	}
+
+	for (ShapeData &s : shapes) {
+		if ((!s.uvData.empty() && s.uvData.size() != s.vertexData.size()) ||
+		        (!s.normalData.empty() && s.normalData.size() != s.vertexData.size())) {
+			error = "uvs or normals don't match the vertices in shape " + s.name;
+			return false;
+		}
+		s.vertices = s.vertexData.data();
+		s.uvs = s.uvData.data();
+		s.normals = s.normalData.data();
+		s.indices = s.indexData.data();
+		s.nbVertices = s.vertexData.size();
+		s.nbUvs = s.uvData.size();
+		s.nbNormals = s.normalData.size();
+		s.nbIndices = s.indexData.size();
+	}
+	return true;
+}
+
+bool OjmFile::testIndices()
+{
+	for (const ShapeData &shape : shapes) {
+		if (shape.nbIndices % 3 != 0) {
+			error = "incomplete triangle in shape " + shape.name;
+			return false;
+		}
+		for (unsigned int i = 0; i < shape.nbIndices; i++) {
+			if (shape.indices[i] >= shape.nbVertices) {
+				error = "index out of range in shape " + shape.name;
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#ifndef _OJM_FILE_HPP_
+#define _OJM_FILE_HPP_
+
+#include <string>
+#include <vector>
+
+#include "vecmath.hpp"
+
+/**
+ * \class OjmFile
+ * \brief Lecture d'un fichier OJM, binaire (v2) ou texte, sans aucun appel GL
+ *
+ * Le fichier est projeté en mémoire (lu en entier sous WIN32). Au format binaire,
+ * les tableaux de chaque shape pointent directement dans la projection : rien
+ * n'est copié avant l'envoi au GPU. Au format texte, les valeurs sont décodées
+ * dans des vecteurs propres à la shape et la projection est libérée aussitôt.
+ *
+ * Les pointeurs de ShapeData restent valides jusqu'à close() ou la destruction
+ * de l'OjmFile.
+ */
+class OjmFile {
+public:
+	struct ShapeData {
+		std::string name;
+		std::string mapKa;
+		std::string mapKd;
+		std::string mapKs;
+		Vec3f Ka;
+		Vec3f Kd;
+		Vec3f Ks;
+		float Ns = 100.0;
+		float T = 1.0;
+
+		const Vec3f *vertices = nullptr;
+		const Vec2f *uvs = nullptr;
+		const Vec3f *normals = nullptr;
+		const unsigned int *indices = nullptr;
+		unsigned int nbVertices = 0;
+		unsigned int nbUvs = 0;
+		unsigned int nbNormals = 0;
+		unsigned int nbIndices = 0;
+
+		// stockage des valeurs du format texte
+		std::vector<Vec3f> vertexData;
+		std::vector<Vec2f> uvData;
+		std::vector<Vec3f> normalData;
+		std::vector<unsigned int> indexData;
+	};
+
+	OjmFile() {};
+	~OjmFile();
+	OjmFile(OjmFile const &) = delete;
+	OjmFile& operator = (OjmFile const &) = delete;
+
+	//! lit le fichier, au format binaire ou texte selon son en-tête
+	bool load(const std::string &fileName);
+
+	//! libère la projection et les shapes
+	void close();
+
+	bool isBinary() const {
+		return binary;
+	}
+
+	const std::vector<ShapeData> &getShapes() const {
+		return shapes;
+	}
+
+	//! cause du dernier échec de load()
+	const std::string &getError() const {
+		return error;
+	}
+
+private:
+	bool mapFile(const std::string &fileName);
+	void unmapFile();
+	bool readBinary();
+	bool readText();
+	//! vérifie que les indices désignent des vertex existants
+	bool testIndices();
+
+	std::vector<ShapeData> shapes;
+	bool binary = false;
+	std::string error;
+
+	const char *data = nullptr;
+	size_t size = 0;
+	void *mapping = nullptr;
+	std::vector<char> buffer;	// contenu du fichier quand il n'est pas projeté
+};
+
+#endif // _OJM_FILE_HPP_
@@ -0,0 +1,93 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#ifndef _OJM_FORMAT_HPP_
+#define _OJM_FORMAT_HPP_
+
+#include <cstdint>
+
+/**
+ * @file ojm_format.hpp
+ * \brief Format binaire OJM v2, écrit par ojm_conv et lu par OjmFile
+ *
+ * Le fichier est fait pour être projeté en mémoire : les blocs de vertex, d'uv,
+ * de normales et d'indices de chaque shape sont alignés sur OJM_BLOCK_ALIGN octets
+ * et peuvent être envoyés tels quels à glBufferData.
+ *
+ * @section ORGANISATION
+ *
+ * OjmFileHeader
+ * OjmShapeEntry x nbShapes		table des matériaux et des blocs
+ * chaînes terminées par \0		noms des shapes et des textures
+ * blocs alignés				float[3] x nbVertices, float[2] x nbUvs, float[3] x nbNormals, uint32 x nbIndices
+ *
+ * Tous les décalages sont comptés depuis le début du fichier, dans l'ordre
+ * d'octets de la machine qui a écrit le fichier (little endian en pratique).
+ */
+
+//! "OJMB" lu en little endian
+#define OJM_BINARY_MAGIC 0x424d4a4f
+#define OJM_BINARY_VERSION 2
+#define OJM_BLOCK_ALIGN 16
+
+struct OjmFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t nbShapes;
+	uint32_t reserved;
+	uint64_t fileSize;
+};
+
+struct OjmShapeEntry {
+	uint64_t name;			// décalage des chaînes
+	uint64_t mapKa;
+	uint64_t mapKd;
+	uint64_t mapKs;
+	float Ka[3];
+	float Kd[3];
+	float Ks[3];
+	float Ns;
+	float T;
+	uint32_t nbVertices;
+	uint32_t nbUvs;			// 0 ou nbVertices
+	uint32_t nbNormals;		// 0 ou nbVertices
+	uint32_t nbIndices;
+	uint32_t reserved;
+	uint64_t vertices;		// décalage des blocs
+	uint64_t uvs;
+	uint64_t normals;
+	uint64_t indices;
+};
+
+static_assert(sizeof(OjmFileHeader) == 24, "OjmFileHeader must not be padded");
+static_assert(sizeof(OjmShapeEntry) == 128, "OjmShapeEntry must not be padded");
+
+//! arrondit offset au début du bloc suivant
+inline uint64_t ojmAlignBlock(uint64_t offset)
+{
+	return (offset + OJM_BLOCK_ALIGN - 1) & ~(uint64_t)(OJM_BLOCK_ALIGN - 1);
+}
+
+#endif // _OJM_FORMAT_HPP_
@@ -1,6 +1,6 @@
 #include "ojml.hpp"
-#include <fstream>
-#include <sstream>
+#include "ojm_file.hpp"
+#include "log.hpp"
 #include <iostream>
 #include <cmath>
 
@@ -86,74 +86,25 @@ void OjmL::initGLparam()
 
 bool OjmL::readOJML(const string & _fileName)
 {
-    std::ifstream stream;
-    char line[265];
-
-    stream.open(_fileName.c_str(),std::ios_base::in);
-
-    if(stream.is_open())
-    {
-        while(!stream.eof()) {
-            stream.getline(line,256);
-
-            switch(line[0])
-            {
-                case 'v':
-                    {
-                        Vec3f vertex;
-                        std::stringstream ss(std::string(line+2));
-                        ss>>vertex.v[0];
-                        ss>>vertex.v[1];
-                        ss>>vertex.v[2];
-                        vertices.push_back(vertex);
-                    }
-                break;
-                case 'u':
-                    {
-                        Vec2f uv;
-                        std::stringstream ss(std::string(line+2));
-                        ss>>uv.v[0];
-                        ss>>uv.v[1];
-                        uvs.push_back(uv);
-                    }
-                break;
-
-                case 'n':
-                    {
-                        Vec3f normal;
-                        std::stringstream ss(std::string(line+2));
-                        ss>>normal.v[0];
-                        ss>>normal.v[1];
-                        ss>>normal.v[2];
-                        normals.push_back(normal);
-                    }
-                break;
-
-                case 'j':
-                    {
-                        unsigned int indice[9];
-                        std::stringstream ss(std::string(line+2));
-                        ss>>indice[0] >> indice[1] >> indice[2] >> indice[3] >> 
-                            indice[4] >> indice[5] >> indice[6] >> indice[7] >> 
-                            indice[8];
-                        for(unsigned int k=0; k<9; k++)
-							indices.push_back(indice[k]);
-                    }
-                    break;
+	OjmFile file;
+	if (!file.load(_fileName)) {
+		Log.write("OjmL: could not load " + _fileName + ": " + file.getError(), cLog::LOG_TYPE::L_ERROR);
+		return false;
+	}
 
-                case 'i':
-                    {
-                        unsigned int indice1, indice2, indice3;
-                        std::stringstream ss(std::string(line+2));
-                        ss>>indice1 >> indice2 >> indice3;
-                        indices.push_back(indice1);
-                        indices.push_back(indice2);
-                        indices.push_back(indice3);
-                    }
-                break;
-            }
-        };
-        return true;
-    }
-	return false;
+	// un OjmL n'a qu'une shape : celles du fichier sont mises bout à bout
+	for (const OjmFile::ShapeData &shape : file.getShapes()) {
+		unsigned int offset = vertices.size();
+		vertices.insert(vertices.end(), shape.vertices, shape.vertices + shape.nbVertices);
+		if (shape.nbUvs > 0)
+			uvs.insert(uvs.end(), shape.uvs, shape.uvs + shape.nbUvs);
+		if (shape.nbNormals > 0)
+			normals.insert(normals.end(), shape.normals, shape.normals + shape.nbNormals);
+		// une shape sans uv ou sans normale garde les tableaux alignés sur les vertex
+		uvs.resize(vertices.size(), Vec2f(0.f, 0.f));
+		normals.resize(vertices.size(), Vec3f(0.f, 0.f, 0.f));
+		for (unsigned int i = 0; i < shape.nbIndices; i++)
+			indices.push_back(shape.indices[i] + offset);
+	}
+	return true;
 }
@@ -26,7 +26,7 @@ private:
 	//! charge et initialise un objet OJM
 	bool init(const std::string& _fileName);
 
-	//! charge un objet OJM du disque dur
+	//! charge un objet OJM du disque dur, au format binaire ou texte (via OjmFile)
 	bool readOJML(const std::string& _fileName);
 
 	//! initialise tous les parametres GL de l'ojm
@@ -14,6 +14,7 @@
 
 #include "solve.hpp"
 #include "orbit.hpp"
+#include "ephemeris_cache.hpp"
 
 //~ #include "threads.h"
 #include "planetsephems/stellplanet.h"
@@ -583,41 +584,56 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 
 	positionFunction = nullptr;
 	osculatingFunction = nullptr;
+	positionFunction_r = nullptr;
+	osculatingFunction_r = nullptr;
 
 
-	if (ephemerisName=="sun_special")
+	if (ephemerisName=="sun_special") {
 		positionFunction = &get_sun_helio_coordsv;
+		positionFunction_r = &get_sun_helio_coordsv_r;
+	}
 
 	if (ephemerisName=="mercury_special") {
 		positionFunction = &get_mercury_helio_coordsv;
+		positionFunction_r = &get_mercury_helio_coordsv_r;
 		osculatingFunction = &get_mercury_helio_osculating_coords;
+		osculatingFunction_r = &get_mercury_helio_osculating_coords_r;
 	}
 
 	if (ephemerisName=="venus_special") {
 		positionFunction = &get_venus_helio_coordsv;
+		positionFunction_r = &get_venus_helio_coordsv_r;
 		osculatingFunction = &get_venus_helio_osculating_coords;
+		osculatingFunction_r = &get_venus_helio_osculating_coords_r;
 	}
 
 	if (ephemerisName=="earth_special") {
 		positionFunction = &get_earth_helio_coordsv;
+		positionFunction_r = &get_earth_helio_coordsv_r;
 		osculatingFunction = &get_earth_helio_osculating_coords;
+		osculatingFunction_r = &get_earth_helio_osculating_coords_r;
 		stable = false;
 	}
 
 	// Earth-Moon Barycenter
 	if (ephemerisName=="emb_special") {
 		positionFunction = &get_emb_helio_coordsv;
+		positionFunction_r = &get_emb_helio_coordsv_r;
 		osculatingFunction = &get_emb_helio_osculating_coords;
+		osculatingFunction_r = &get_emb_helio_osculating_coords_r;
 	}
 
 	if (ephemerisName=="lunar_special") {
 		positionFunction = &get_lunar_parent_coordsv;
+		positionFunction_r = &get_lunar_parent_coordsv_r;
 		m_UseParentPrecession = false;
 	}
 
 	if (ephemerisName=="mars_special") {
 		positionFunction = &get_mars_helio_coordsv;
+		positionFunction_r = &get_mars_helio_coordsv_r;
 		osculatingFunction = &get_mars_helio_osculating_coords;
+		osculatingFunction_r = &get_mars_helio_osculating_coords_r;
 	}
 
 	if (ephemerisName=="phobos_special")
@@ -628,7 +644,9 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 
 	if (ephemerisName=="jupiter_special") {
 		positionFunction = &get_jupiter_helio_coordsv;
+		positionFunction_r = &get_jupiter_helio_coordsv_r;
 		osculatingFunction = &get_jupiter_helio_osculating_coords;
+		osculatingFunction_r = &get_jupiter_helio_osculating_coords_r;
 	}
 
 	if (ephemerisName=="europa_special")
@@ -645,7 +663,9 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 
 	if (ephemerisName=="saturn_special") {
 		positionFunction = &get_saturn_helio_coordsv;
+		positionFunction_r = &get_saturn_helio_coordsv_r;
 		osculatingFunction = &get_saturn_helio_osculating_coords;
+		osculatingFunction_r = &get_saturn_helio_osculating_coords_r;
 		stable = false;
 	}
 
@@ -675,7 +695,9 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 
 	if (ephemerisName=="uranus_special") {
 		positionFunction = &get_uranus_helio_coordsv;
+		positionFunction_r = &get_uranus_helio_coordsv_r;
 		osculatingFunction = &get_uranus_helio_osculating_coords;
+		osculatingFunction_r = &get_uranus_helio_osculating_coords_r;
 		stable = false;
 	}
 
@@ -696,15 +718,25 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 
 	if (ephemerisName=="neptune_special") {
 		positionFunction = &get_neptune_helio_coordsv;
+		positionFunction_r = &get_neptune_helio_coordsv_r;
 		osculatingFunction = &get_neptune_helio_osculating_coords;
+		osculatingFunction_r = &get_neptune_helio_osculating_coords_r;
 		stable = false;
 	}
 
-	if (ephemerisName=="pluto_special")
+	if (ephemerisName=="pluto_special") {
 		positionFunction = &get_pluto_helio_coordsv;
+		positionFunction_r = &get_pluto_helio_coordsv_r;
+	}
 
 	// \todo better error checking
 
+	cache = positionFunction ? new EphemerisCache(positionFunction) : nullptr;
+}
+
+SpecialOrbit::~SpecialOrbit()
+{
+	delete cache;
 }
 
 
@@ -715,8 +747,28 @@ SpecialOrbit::SpecialOrbit(std::string ephemerisName) :
 // parent_rot_obliquity and parent_rot_ascendingnode must be supplied.
 void SpecialOrbit::positionAtTimevInVSOP87Coordinates(double JD0, double JD, double* v) const
 {
-	if(osculatingFunction) (*osculatingFunction)(JD0, JD, v);
-	else positionFunction(JD, v);
+	// the osculating orbit at its own date is the real position: read it from the cache
+	if (osculatingFunction && JD0 != JD) (*osculatingFunction)(JD0, JD, v);
+	else if (cache) cache->getPosition(JD, v);
+	else v[0] = v[1] = v[2] = 0.0;	// orbite invalide, cf isValid()
+}
+
+void SpecialOrbit::fastPositionAtTimevInVSOP87Coordinates(double JD0, double JD, double* v) const
+{
+	// orbit samples are spread over a whole period: don't fill the cache with them
+	if (osculatingFunction) (*osculatingFunction)(JD0, JD, v);
+	else if (positionFunction) positionFunction(JD, v);
+	else v[0] = v[1] = v[2] = 0.0;
+}
+
+void SpecialOrbit::samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double* v, EphemerisContext *ctx) const
+{
+	if (positionFunction_r == nullptr) {
+		fastPositionAtTimevInVSOP87Coordinates(JD0, JD, v);
+		return;
+	}
+	if (osculatingFunction_r) (*osculatingFunction_r)(ctx, JD0, JD, v);
+	else positionFunction_r(ctx, JD, v);
 }
 
 
@@ -822,6 +874,17 @@ void MixedOrbit::positionAtTimevInVSOP87Coordinates(double JD0, double JD, doubl
 		afterApprox->positionAtTimevInVSOP87Coordinates(JD0, JD, v);
 }
 
+// like fastPositionAtTimevInVSOP87Coordinates, the real position at JD
+void MixedOrbit::samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v, EphemerisContext *ctx) const
+{
+	if (JD < begin)
+		beforeApprox->positionAtTimevInVSOP87Coordinates(JD, JD, v);
+	else if (JD < end)
+		primary->samplePositionAtTimevInVSOP87Coordinates(JD, JD, v, ctx);
+	else
+		afterApprox->positionAtTimevInVSOP87Coordinates(JD, JD, v);
+}
+
 bool MixedOrbit::isStable(double jd) const
 {
 	if (jd < begin)
@@ -876,6 +939,11 @@ void BinaryOrbit::fastPositionAtTimevInVSOP87Coordinates(double JD0, double JD,
 	barycenter->positionAtTimevInVSOP87Coordinates(JD0, JD, v);
 }
 
+void BinaryOrbit::samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v, EphemerisContext *ctx) const
+{
+	barycenter->samplePositionAtTimevInVSOP87Coordinates(JD0, JD, v, ctx);
+}
+
 
 bool BinaryOrbit::isStable(double jd) const
 {
@@ -17,7 +17,13 @@
 typedef void (PositionFunctionType)(double jd,double xyz[3]);
 typedef void (OsculatingFunctionType)(double jd0,double jd,double xyz[3]);
 
+// The same with the interpolation state of the series in ctx
+struct EphemerisContext;
+typedef void (PositionFunctionType_r)(EphemerisContext *ctx,double jd,double xyz[3]);
+typedef void (OsculatingFunctionType_r)(EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+
 //~ class OrbitSampleProc;
+class EphemerisCache;
 
 class Body;
 
@@ -39,6 +45,12 @@ public:
 		positionAtTimevInVSOP87Coordinates(JD, JD, v);
 	}
 
+	// Same as above from a thread other than the main one, the series keep their state in ctx
+	// Only called when isThreadSafe() is true
+	virtual void samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v, EphemerisContext *ctx) const {
+		fastPositionAtTimevInVSOP87Coordinates(JD0, JD, v);
+	}
+
 	virtual OsculatingFunctionType * getOsculatingFunction() const {
 		return nullptr;
 	};
@@ -57,6 +69,11 @@ public:
 		return true;
 	}
 
+	// Can positions be computed from another thread while the main thread updates the bodies?
+	virtual bool isThreadSafe() const {
+		return true;
+	}
+
 	virtual std::string saveOrbit() const = 0;
 
 private:
@@ -160,7 +177,7 @@ private:
 class SpecialOrbit : public Orbit {
 public:
 	SpecialOrbit(std::string ephemerisName);
-	virtual ~SpecialOrbit(void) {};
+	virtual ~SpecialOrbit(void);
 
 	// Compute position for a specified Julian date and return coordinates
 	// given in "dynamical equinox and ecliptic J2000"
@@ -169,6 +186,16 @@ public:
 	// parent_rot_obliquity and parent_rot_ascendingnode must be supplied.
 	virtual void positionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v) const;
 
+	// Same as above but always from the analytic series, for orbit plotting
+	virtual void fastPositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v) const;
+
+	virtual void samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v, EphemerisContext *ctx) const;
+
+	// the series of the satellites keep their state in statics shared by all threads
+	virtual bool isThreadSafe() const {
+		return positionFunction_r != nullptr;
+	}
+
 	virtual OsculatingFunctionType * getOsculatingFunction() const {
 		return osculatingFunction;
 	}
@@ -192,8 +219,11 @@ public:
 private:
 	PositionFunctionType *positionFunction;
 	OsculatingFunctionType *osculatingFunction;
+	PositionFunctionType_r *positionFunction_r;		// reentrant versions, nullptr if none
+	OsculatingFunctionType_r *osculatingFunction_r;
 	bool stable;  // does not osculate noticeably for performance caching orbit visualization
 	bool m_UseParentPrecession;
+	EphemerisCache *cache;	// polynômes de Tchebychev de positionFunction
 };
 
 
@@ -220,6 +250,12 @@ public:
 	// Do the body coordinates precess with the parent?
 	virtual bool useParentPrecession(double jd) const;
 
+	virtual void samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v, EphemerisContext *ctx) const;
+
+	virtual bool isThreadSafe() const {
+		return primary->isThreadSafe();
+	}
+
 	virtual std::string saveOrbit() const;
 	
 private:
@@ -255,6 +291,8 @@ public:
 	// If possible, do faster (and less accurate) calculation for orbits
 	virtual void fastPositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v) const;
 
+	virtual void samplePositionAtTimevInVSOP87Coordinates(double JD0, double JD, double *v, EphemerisContext *ctx) const;
+
 	virtual bool isStable(double jd) const;
 
 	// Do the body coordinates precess with the parent?
@@ -262,6 +300,10 @@ public:
 		return barycenter->useParentPrecession(jd);
 	}
 
+	virtual bool isThreadSafe() const {
+		return barycenter->isThreadSafe() && (secondary == nullptr || secondary->isThreadSafe());
+	}
+
 	virtual void setSecondaryOrbit(Orbit *second) {
 		secondary = second;
 	}
@@ -334,6 +376,11 @@ public:
 	bool useParentPrecession(double) const {
 		return false;
 	}
+
+	// reads the positions that the main thread computes for bodyA and bodyB
+	bool isThreadSafe() const {
+		return false;
+	}
 	
 	std::string saveOrbit() const;
 
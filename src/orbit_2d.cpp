@@ -22,6 +22,9 @@ void Orbit2D::drawOrbit(const Navigator * nav, const Projector* prj, const Mat4d
 	Vec3d onscreen;
 	if (!body->re.sidereal_period)
 		return;
+	// no point computed yet
+	if (!orbit_ready)
+		return;
 
 	computeShader();
 
@@ -42,6 +42,9 @@ void Orbit3D::drawOrbit(const Navigator * nav, const Projector* prj, const Mat4d
 
 	if (!body->re.sidereal_period)
 		return; // TODO change name to visualization_period
+	// no point computed yet
+	if (!orbit_ready)
+		return;
 
 	StateGL::enable(GL_DEPTH_TEST);
 
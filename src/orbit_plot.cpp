@@ -17,10 +17,24 @@
 #include "orbit_plot.hpp"
 #include "body.hpp"
 #include "orbit.hpp"
+#include "ThreadPool.hpp"
+#include "planetsephems/stellplanet.h"
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
 
+namespace {
+
+// threads shared by all the orbits to compute their points
+ThreadPool& samplingPool()
+{
+	static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()/2));
+	return pool;
+}
+
+}
+
 shaderProgram* OrbitPlot::shaderOrbit2d = nullptr;
 DataGL OrbitPlot::Orbit2dData;
 
@@ -33,12 +47,19 @@ OrbitPlot::OrbitPlot(Body* _body, int segments)
 	body = _body;
 	ORBIT_POINTS = segments;
 	orbitPoint = new Vec3d[ORBIT_POINTS];
+	orbitPointBack = new Vec3d[ORBIT_POINTS];
 	orbit_cached = 0;
+	orbit_ready = false;
+	last_orbitJD = 0.0;
 }
 
 OrbitPlot::~OrbitPlot()
 {
-	delete[] orbitPoint;	
+	// the job writes in orbitPointBack
+	if (samplingJob.valid())
+		samplingJob.wait();
+	delete[] orbitPoint;
+	delete[] orbitPointBack;
 }
 
 void OrbitPlot::init()
@@ -92,19 +113,16 @@ void OrbitPlot::deleteShader()
 	glDeleteVertexArrays(1,&Orbit2dData.vao);
 }
 
-void OrbitPlot::computeOrbit(double date){
-	
-	
-	// Large performance advantage from avoiding object overhead
-	OsculatingFunctionType *oscFunc = body->orbit->getOsculatingFunction();
-
+void OrbitPlot::computeOrbit(double date)
+{
+	// the previous polyline stays on screen while a sampling job is running
+	if (!collectSampling())
+		return;
 
 	// for performance only update orbit points if visible
 	if (body->visibilityFader.getInterstate()>0.000001 && delta_orbitJD > 0 && (fabs(last_orbitJD-date)>delta_orbitJD || !orbit_cached)) {
 		// calculate orbit first (for line drawing)
 		double date_increment = body->re.sidereal_period/ORBIT_POINTS;
-		double calc_date;
-		//	  int delta_points = (int)(0.5 + (date - last_orbitJD)/date_increment);
 		int delta_points;
 
 		if ( date > last_orbitJD ) {
@@ -114,67 +132,70 @@ void OrbitPlot::computeOrbit(double date){
 		}
 		double new_date = last_orbitJD + delta_points*date_increment;
 
-		//printf( "Updating orbit coordinates for %s (delta %f) (%d points)\n", name.c_str(), delta_orbitJD, delta_points);
-		//cout << englishName << ": " << delta_points << "  " << orbit_cached << endl;
-
-		if ( delta_points > 0 && delta_points < ORBIT_POINTS && orbit_cached) {
-			for ( int d=0; d<ORBIT_POINTS; d++ ) {
-				if (d + delta_points >= ORBIT_POINTS ) {
-					// calculate new points
-					calc_date = new_date + (d-ORBIT_POINTS/2)*date_increment;
-					// date increments between points will not be completely constant though
-
-					if(oscFunc) 
-						(*oscFunc)(date,calc_date,orbitPoint[d]);
-					else 
-						body->orbit->fastPositionAtTimevInVSOP87Coordinates(date,calc_date,orbitPoint[d]);
-				} else {
-					orbitPoint[d] = orbitPoint[d+delta_points];
-				}
-			}
-
-			last_orbitJD = new_date;
-
-		} 
-		else{
-			if ( delta_points < 0 && abs(delta_points) < ORBIT_POINTS && orbit_cached) {
-				for ( int d=ORBIT_POINTS-1; d>=0; d-- ) {
-					if (d + delta_points < 0 ) {
-						// calculate new points
-						calc_date = new_date + (d-ORBIT_POINTS/2)*date_increment;
-
-						if(oscFunc) 
-							(*oscFunc)(date,calc_date,orbitPoint[d]);
-						else 
-							body->orbit->fastPositionAtTimevInVSOP87Coordinates(date,calc_date,orbitPoint[d]);
-					} else {
-						orbitPoint[d] = orbitPoint[d+delta_points];
-					}
-				}
-
-				last_orbitJD = new_date;
-
-			} 
-			else{
-				if ( delta_points || !orbit_cached ) {
-					// update all points (less efficient)
-					for ( int d=0; d<ORBIT_POINTS; d++ ) {
-						calc_date = date + (d-ORBIT_POINTS/2)*date_increment;
-
-						if(oscFunc) 
-							(*oscFunc)(date,calc_date,orbitPoint[d]);
-						else 
-							body->orbit->fastPositionAtTimevInVSOP87Coordinates(date,calc_date,orbitPoint[d]);
-					}
-
-					last_orbitJD = date;
-
-					// \todo remove this for efficiency?  Can cause rendering issues near body though
-					// If orbit is largely constant through time cache it
-					if (body->orbit->isStable(date)) 
-						orbit_cached = 1;
-				}
-			}
+		// the points already computed can only be shifted if the orbit is cached
+		if (!orbit_cached || abs(delta_points) >= ORBIT_POINTS)
+			delta_points = ORBIT_POINTS;
+		else if (delta_points == 0)
+			return;
+
+		sampling_orbitJD = (delta_points == ORBIT_POINTS) ? date : new_date;
+		// \todo remove this for efficiency?  Can cause rendering issues near body though
+		// If orbit is largely constant through time cache it
+		sampling_stable = (delta_points == ORBIT_POINTS) && body->orbit->isStable(date);
+
+		// the satellite series keep their state in statics: such orbits stay in this thread
+		if (!body->orbit->isThreadSafe()) {
+			sampleOrbit(body->orbit, ORBIT_POINTS, orbitPoint, orbitPointBack, date, new_date, date_increment, delta_points);
+			swapPoints();
+			return;
+		}
+
+		samplingJob = samplingPool().enqueue(&OrbitPlot::sampleOrbit, body->orbit, ORBIT_POINTS, orbitPoint, orbitPointBack,
+		                                     date, new_date, date_increment, delta_points);
+	}
+}
+
+bool OrbitPlot::collectSampling()
+{
+	if (!samplingJob.valid())
+		return true;
+	if (samplingJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return false;
+	samplingJob.get();
+	swapPoints();
+	return true;
+}
+
+void OrbitPlot::swapPoints()
+{
+	std::swap(orbitPoint, orbitPointBack);
+	last_orbitJD = sampling_orbitJD;
+	if (sampling_stable)
+		orbit_cached = 1;
+	orbit_ready = true;
+}
+
+void OrbitPlot::sampleOrbit(const Orbit* orbit, int nbPoints, const Vec3d* src, Vec3d* dst,
+                            double date, double new_date, double date_increment, int delta_points)
+{
+	// own interpolation state of the series: nothing shared with the main thread
+	EphemerisContext ctx;
+	InitEphemerisContext(&ctx);
+
+	if (delta_points == nbPoints) {
+		// update all points (less efficient)
+		for (int d=0; d<nbPoints; d++)
+			orbit->samplePositionAtTimevInVSOP87Coordinates(date, date + (d-nbPoints/2)*date_increment, dst[d], &ctx);
+		return;
+	}
+
+	for (int d=0; d<nbPoints; d++) {
+		if (d + delta_points >= nbPoints || d + delta_points < 0) {
+			// calculate new points
+			// date increments between points will not be completely constant though
+			orbit->samplePositionAtTimevInVSOP87Coordinates(date, new_date + (d-nbPoints/2)*date_increment, dst[d], &ctx);
+		} else {
+			dst[d] = src[d+delta_points];
 		}
 	}
 }
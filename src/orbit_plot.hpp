@@ -23,9 +23,11 @@
 #include "fader.hpp"
 #include "shader.hpp"
 #include "stateGL.hpp"
+#include <future>
 #include <vector>
 
 class Body;
+class Orbit;
 class Projector;
 class Navigator;
 
@@ -43,6 +45,11 @@ public:
 		orbit_fader = b;
 	}
 
+	//! vrai tant que l'orbite est affichée, même en cours de fondu
+	bool isVisible() const {
+		return orbit_fader.getInterstate() > 0.f;
+	}
+
 	virtual void drawOrbit(const Navigator * nav, const Projector* prj, const Mat4d &mat) = 0;
 
 	static void createShader();
@@ -50,11 +57,21 @@ public:
 
 	void updateShader(double delta_time);
 
+	//! met à jour les points de l'orbite. Le calcul se fait dans un thread :
+	//! l'orbite précédente reste affichée tant que la nouvelle n'est pas prête
 	virtual void computeOrbit(double date);
 	
 	void init();
 
 protected:
+	// calcule les points de l'orbite dans dst, en réutilisant ceux de src décalés de delta_points
+	static void sampleOrbit(const Orbit* orbit, int nbPoints, const Vec3d* src, Vec3d* dst,
+	                        double date, double new_date, double date_increment, int delta_points);
+
+	// échange les tampons si le calcul en cours est terminé, renvoie faux s'il tourne encore
+	bool collectSampling();
+	// affiche les points qui viennent d'être calculés
+	void swapPoints();
 
 	Body * body;
 	
@@ -63,7 +80,13 @@ protected:
 	double delta_orbitJD;
 	double last_orbitJD;
 	bool orbit_cached;
-	Vec3d * orbitPoint;
+	bool orbit_ready;	// faux tant qu'aucune orbite n'a été calculée
+	Vec3d * orbitPoint;	// points affichés
+	Vec3d * orbitPointBack;	// points en cours de calcul
+
+	std::future<void> samplingJob;
+	double sampling_orbitJD;	// last_orbitJD une fois le calcul en cours terminé
+	bool sampling_stable;	// le calcul en cours rend l'orbite valable dans le temps
 		
 	LinearFader orbit_fader;
 
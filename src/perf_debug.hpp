@@ -17,6 +17,7 @@ Mise à jour le 07/06/2017
 #include <unordered_map>
 #include <map>
 #include <chrono>
+#include <ctime>
 #include <fstream>
 #include <math.h>
 
@@ -58,6 +59,29 @@ public:
 		} else ++t->wrongStopCount; //On incrémente le nombre d'arrêts mal éxécutés
 	}
 
+	/*!
+	*  \brief Ajoute une mesure prise ailleurs (par exemple dans un thread du FrameScheduler)
+	*  \param Label : Nom du timer
+	*  \param CpuDuration : temps CPU en microsecondes
+	*  \param WallDuration : temps réel en microsecondes
+	*/
+	void addMeasure(const std::string Label, unsigned long long CpuDuration, unsigned long long WallDuration) {
+		timer *t = &timers[Label]; //Récupère le pointeur sur le timer d'après son nom
+		++t->callCount; //Incrémentation du nombre d'appels
+		updateStats(CpuDuration, &t->cpuTime); //Mise à jour des statistiques CPU
+		updateStats(WallDuration, &t->wallTime); //Mise à jour des statistiques temps réel
+	}
+
+	/*!
+	*  \brief Temps CPU consommé par le thread appelant, pour les mesures faites hors du thread principal
+	*  \return temps en microsecondes
+	*/
+	static unsigned long long threadCpuTime() {
+		struct timespec ts;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+		return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+	}
+
 	/*!
 	*  \brief Exporte les statistiques temporelles
 	*  \param FilePath : fichier de destination (optionnel)
@@ -78,7 +78,31 @@ void GetElp82bCoor(double jd,double xyz[3]);
      From this I conclude that in the context of stellarium
      ICRF, J2000 and FK5 are the same, while the transformation
      ICRF <-> VSOP87 must be done with the matrix given above.
+
+     ATTENTION! GetElp82bCoor uses a static interpolation context,
+     it is not reentrant: threads must use GetElp82bCoor_r with their own context.
    */
+
+struct Elp82bContext {
+  double t_0,t_1,t_2;
+  double r_0[3];
+  double r_1[3];
+  double r_2[3];
+};
+
+void InitElp82bContext(struct Elp82bContext *ctx);
+  /* Must be called once before the first use of ctx.
+  */
+
+void GetElp82bCoor_r(struct Elp82bContext *ctx,double jd,double xyz[3]);
+  /* Reentrant version of GetElp82bCoor.
+  */
+
+void GetElp82bCoorDates_r(struct Elp82bContext *ctx,
+                          int nr_of_dates,const double jd[],double xyz[]);
+  /* Return the coordinates of the moon for nr_of_dates dates,
+     the coordinates for jd[i] are in xyz[i*3..i*3+2].
+  */
      
 
 #ifdef __cplusplus
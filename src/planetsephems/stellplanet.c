@@ -4,6 +4,7 @@
 #include "l1.h"
 #include "tass17.h"
 #include "gust86.h"
+#include "stellplanet.h"
 
 #define VSOP87_MERCURY  0
 #define VSOP87_VENUS    1
@@ -136,3 +137,63 @@ void get_oberon_parent_coordsv(double jd,double xyz[3])
   {GetGust86Coor(jd,GUST86_OBERON,xyz);}
 
 
+/* Reentrant versions, with the interpolation state in ctx */
+
+void InitEphemerisContext(struct EphemerisContext *ctx) {
+  InitVsop87Context(&ctx->vsop87);
+  InitElp82bContext(&ctx->elp82b);
+}
+
+void get_sun_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {xyz[0]=0.; xyz[1]=0.; xyz[2]=0.;}
+void get_pluto_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {get_pluto_helio_coords(jd, &xyz[0], &xyz[1], &xyz[2]);}
+
+void get_mercury_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_MERCURY,xyz);}
+void get_venus_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_VENUS,xyz);}
+void get_emb_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_EMB,xyz);}
+
+void get_earth_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]) {
+  double moon[3];
+  GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_EMB,xyz);
+  GetElp82bCoor_r(&ctx->elp82b,jd,moon);
+  xyz[0] -= 0.0121505677733761 * moon[0];
+  xyz[1] -= 0.0121505677733761 * moon[1];
+  xyz[2] -= 0.0121505677733761 * moon[2];
+}
+
+void get_mars_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_MARS,xyz);}
+void get_jupiter_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_JUPITER,xyz);}
+void get_saturn_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_SATURN,xyz);}
+void get_uranus_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_URANUS,xyz);}
+void get_neptune_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetVsop87Coor_r(&ctx->vsop87,jd,VSOP87_NEPTUNE,xyz);}
+
+void get_mercury_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_MERCURY,xyz);}
+void get_venus_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_VENUS,xyz);}
+void get_emb_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_EMB,xyz);}
+void get_earth_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {get_earth_helio_coordsv_r(ctx, jd, xyz);}
+void get_mars_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_MARS,xyz);}
+void get_jupiter_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_JUPITER,xyz);}
+void get_saturn_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_SATURN,xyz);}
+void get_uranus_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_URANUS,xyz);}
+void get_neptune_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3])
+  {GetVsop87OsculatingCoor_r(&ctx->vsop87,jd0,jd,VSOP87_NEPTUNE,xyz);}
+
+void get_lunar_parent_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3])
+  {GetElp82bCoor_r(&ctx->elp82b,jd,xyz);}
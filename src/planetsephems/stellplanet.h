@@ -20,6 +20,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #ifndef _STELLPLANET_H_
 #define _STELLPLANET_H_
 
+#include "vsop87.h"
+#include "elp82b.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -73,6 +76,42 @@ void get_umbriel_parent_coordsv(double jd,double xyz[3]);
 void get_titania_parent_coordsv(double jd,double xyz[3]);
 void get_oberon_parent_coordsv(double jd,double xyz[3]);
 
+/* Reentrant versions of the functions above for the bodies computed with
+   VSOP87, ELP82B or without interpolation state: a thread using its own
+   context can call them while other threads use the functions above.
+   The satellites of Mars, Jupiter, Saturn and Uranus have no such version. */
+
+struct EphemerisContext {
+  struct Vsop87Context vsop87;
+  struct Elp82bContext elp82b;
+};
+
+void InitEphemerisContext(struct EphemerisContext *ctx);
+
+void get_sun_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_mercury_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_venus_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_emb_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_earth_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_mars_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_jupiter_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_saturn_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_uranus_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_neptune_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+void get_pluto_helio_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+
+void get_mercury_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_venus_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_emb_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_earth_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_mars_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_jupiter_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_saturn_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_uranus_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+void get_neptune_helio_osculating_coords_r(struct EphemerisContext *ctx,double jd0,double jd,double xyz[3]);
+
+void get_lunar_parent_coordsv_r(struct EphemerisContext *ctx,double jd,double xyz[3]);
+
 #ifdef __cplusplus
 }
 #endif
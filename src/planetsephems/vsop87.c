@@ -137317,35 +137317,72 @@ void CalcVsop87Elem(const double t,double elem[8*6]) {
 */
 }
 
-  /* dirty caching in static variables */
-#define VSOP87_DIM (8*6)
-static double t_0 = -1e100;
-static double t_1 = -1e100;
-static double t_2 = -1e100;
-static double vsop87_elem_0[VSOP87_DIM];
-static double vsop87_elem_1[VSOP87_DIM];
-static double vsop87_elem_2[VSOP87_DIM];
 /* 10 days: */
 #define DELTA_T (10.0/365250.0)
 
-static double vsop87_jd0 = -1e100;
-static double vsop87_elem[VSOP87_DIM];
-
-void GetVsop87Coor(double jd,int body,double *xyz) {
-  GetVsop87OsculatingCoor(jd,jd,body,xyz);
+void InitVsop87Context(struct Vsop87Context *ctx) {
+  ctx->t_0 = -1e100;
+  ctx->t_1 = -1e100;
+  ctx->t_2 = -1e100;
+  ctx->jd0 = -1e100;
 }
 
-void GetVsop87OsculatingCoor(const double jd0,const double jd,
-                             const int body,double *xyz) {
-  if (jd0 != vsop87_jd0) {
+static
+void UpdateVsop87Context(struct Vsop87Context *ctx,const double jd0) {
+    /* PrepareLambdaArray and AccumulateVsop87Terms are called by
+       CalcVsop87Elem for all 8 planets at once, and only when
+       the interpolation in ctx cannot be used */
+  if (jd0 != ctx->jd0) {
     const double t0 = (jd0 - 2451545.0) / 365250.0;
-    vsop87_jd0 = jd0;
-    CalcInterpolatedElements(t0,vsop87_elem,
+    ctx->jd0 = jd0;
+    CalcInterpolatedElements(t0,ctx->elem,
                              VSOP87_DIM,
                              &CalcVsop87Elem,DELTA_T,
-                             &t_0,vsop87_elem_0,
-                             &t_1,vsop87_elem_1,
-                             &t_2,vsop87_elem_2);
+                             &ctx->t_0,ctx->elem_0,
+                             &ctx->t_1,ctx->elem_1,
+                             &ctx->t_2,ctx->elem_2);
+  }
+}
+
+void GetVsop87OsculatingCoor_r(struct Vsop87Context *ctx,
+                               const double jd0,const double jd,
+                               const int body,double *xyz) {
+  UpdateVsop87Context(ctx,jd0);
+  EllipticToRectangularA(vsop87_mu[body],ctx->elem+(body*6),jd-jd0,xyz);
+}
+
+void GetVsop87Coor_r(struct Vsop87Context *ctx,
+                     double jd,int body,double *xyz) {
+  GetVsop87OsculatingCoor_r(ctx,jd,jd,body,xyz);
+}
+
+void GetVsop87CoorAllPlanets_r(struct Vsop87Context *ctx,
+                               double jd,double xyz[8*3]) {
+  int body;
+  UpdateVsop87Context(ctx,jd);
+  for (body=0;body<8;body++) {
+    EllipticToRectangularA(vsop87_mu[body],ctx->elem+(body*6),0.0,xyz+(body*3));
   }
-  EllipticToRectangularA(vsop87_mu[body],vsop87_elem+(body*6),jd-jd0,xyz);
+}
+
+void GetVsop87CoorDates_r(struct Vsop87Context *ctx,int body,
+                          int nr_of_dates,const double jd[],double xyz[]) {
+  int i;
+  for (i=0;i<nr_of_dates;i++) {
+    GetVsop87OsculatingCoor_r(ctx,jd[i],jd[i],body,xyz+(i*3));
+  }
+}
+
+  /* context of the non reentrant functions */
+static struct Vsop87Context vsop87_default_context = {
+  -1e100,-1e100,-1e100,{0},{0},{0},-1e100,{0}
+};
+
+void GetVsop87Coor(double jd,int body,double *xyz) {
+  GetVsop87OsculatingCoor_r(&vsop87_default_context,jd,jd,body,xyz);
+}
+
+void GetVsop87OsculatingCoor(const double jd0,const double jd,
+                             const int body,double *xyz) {
+  GetVsop87OsculatingCoor_r(&vsop87_default_context,jd0,jd,body,xyz);
 }
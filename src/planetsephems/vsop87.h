@@ -42,7 +42,11 @@ Furthermore I used the addition formulas
 so that for given T the functions cos and sin have only to be called 12 times.
 
 
-ATTENTION! Due to static caching this solution is not reentrant and cannot be parallelized to run in several threads.
+The results are interpolated between evaluations of the series 10 days apart.
+The interpolation state lives in a struct Vsop87Context: the functions
+with the _r suffix are reentrant as long as each thread uses its own context.
+ATTENTION! GetVsop87Coor and GetVsop87OsculatingCoor share a static context,
+they are not reentrant and cannot be parallelized to run in several threads.
 
 ****************************************************************/
 
@@ -54,6 +58,41 @@ ATTENTION! Due to static caching this solution is not reentrant and cannot be pa
 extern "C" {
 #endif
 
+#define VSOP87_DIM (8*6)
+
+struct Vsop87Context {
+  double t_0,t_1,t_2;
+  double elem_0[VSOP87_DIM];
+  double elem_1[VSOP87_DIM];
+  double elem_2[VSOP87_DIM];
+  double jd0;
+  double elem[VSOP87_DIM];
+};
+
+void InitVsop87Context(struct Vsop87Context *ctx);
+  /* Must be called once before the first use of ctx.
+  */
+
+void GetVsop87Coor_r(struct Vsop87Context *ctx,double jd,int body,double *xyz);
+void GetVsop87OsculatingCoor_r(struct Vsop87Context *ctx,
+                               const double jd0,const double jd,
+                               const int body,double *xyz);
+  /* Reentrant versions of GetVsop87Coor and GetVsop87OsculatingCoor.
+  */
+
+void GetVsop87CoorAllPlanets_r(struct Vsop87Context *ctx,double jd,double xyz[8*3]);
+  /* Return the rectangular coordinates of the 8 planets for the date jd,
+     with one evaluation of the series shared by all the planets.
+     The coordinates of the planet body are in xyz[body*3..body*3+2].
+  */
+
+void GetVsop87CoorDates_r(struct Vsop87Context *ctx,int body,
+                          int nr_of_dates,const double jd[],double xyz[]);
+  /* Return the rectangular coordinates of one planet for nr_of_dates dates,
+     the coordinates for jd[i] are in xyz[i*3..i*3+2].
+     Sorted dates less than 10 days apart reuse the interpolation of ctx.
+  */
+
 void GetVsop87Coor(double jd,int body,double *xyz);
   /* Return the rectangular coordinates of the given planet
      and the given julian date jd expressed in dynamical time (TAI+32.184s).
@@ -245,32 +245,34 @@ bool Projector::projectCustom(const Vec3d &v,Vec3d &win, const Mat4d &mat) const
 	const double depth = win.length();
 	const double rq1 = win[0]*win[0]+win[1]*win[1];
 
-	if (rq1 <= 0 ) {
-		if (win[2] < 0.0) {
-			win[0] = viewport_center[0];
-			win[1] = viewport_center[1];
-			win[2] = 1.0;
-			return true;
-		}
-		win[0] = viewport_center[0];
-		win[1] = viewport_center[1];
-		win[2] = -1e99;
-		return false;
-	}
+	const bool visible = projectEyeToWindow(win[0], win[1], win[2], rq1);
 
-	const double oneoverh = 1.0/sqrt(rq1);
-
-	const double a = C_PI_2 + atan(win[2]*oneoverh);
-
-	double f = a * fisheye_scale_factor;
-	f *= viewport_radius * oneoverh;
-
-	win[0] = viewport_center[0] + win[0] * f;
-	win[1] = viewport_center[1] + win[1] * f;
+	if (rq1 <= 0)
+		win[2] = visible ? 1.0 : -1e99;
+	else
+		win[2] = (fabs(depth) - zNear) / (zFar-zNear);
+	return visible;
+}
 
-	win[2] = (fabs(depth) - zNear) / (zFar-zNear);
-	return (a<0.9*C_PI) ? true : false;
+void Projector::projectJ2000Batch(int n, const double *x, const double *y, const double *z, bool check,
+                                  double *win_x, double *win_y, bool *visible) const
+{
+	const Mat4d &mat = mat_j2000_to_eye;
+	double win_z[BATCH_SIZE];
+
+	// linear part, written lane by lane so that the compiler can vectorize it
+	for (int i=0; i<n; i++) {
+		win_x[i] = mat.r[0]*x[i] + mat.r[4]*y[i] +  mat.r[8]*z[i] + mat.r[12];
+		win_y[i] = mat.r[1]*x[i] + mat.r[5]*y[i] +  mat.r[9]*z[i] + mat.r[13];
+		win_z[i] = mat.r[2]*x[i] + mat.r[6]*y[i] + mat.r[10]*z[i] + mat.r[14];
+	}
 
+	// fisheye part, same code as projectCustom
+	for (int i=0; i<n; i++) {
+		visible[i] = projectEyeToWindow(win_x[i], win_y[i], win_z[i], win_x[i]*win_x[i]+win_y[i]*win_y[i]);
+		if (check && visible[i])
+			visible[i] = checkInViewport(Vec3d(win_x[i], win_y[i], 0.));
+	}
 }
 
 bool Projector::projectCustomFixedFov(const Vec3d &v,Vec3d &win, const Mat4d &mat) const
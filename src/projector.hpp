@@ -233,6 +233,15 @@ public:
 	// Same function but using a custom modelview matrix
 	bool projectCustom(const Vec3d& v, Vec3d& win, const Mat4d& mat) const;
 
+	//! maximum number of positions given to projectJ2000Batch
+	static const int BATCH_SIZE = 8;
+
+	//! Project up to BATCH_SIZE J2000 positions given as separated coordinates.
+	//! Gives the same window coordinates as projectJ2000 (or projectJ2000Check if check is true)
+	//! called on each position. The depth is not computed.
+	void projectJ2000Batch(int n, const double *x, const double *y, const double *z, bool check,
+	                       double *win_x, double *win_y, bool *visible) const;
+
 	bool projectCustomCheck(const Vec3f& v, Vec3d& win, const Mat4d& mat) const  {
 		return (projectCustom(v, win, mat) && checkInViewport(win));
 	}
@@ -332,6 +341,27 @@ protected:
 	bool flag_auto_zoom;		// Define if autozoom is on or off
 
 private:
+	// fisheye part of the projection, from eye coordinates x, y, z with rq1 = x*x+y*y
+	// to window coordinates stored in x and y
+	bool projectEyeToWindow(double &x, double &y, double z, double rq1) const {
+		if (rq1 <= 0 ) {
+			x = viewport_center[0];
+			y = viewport_center[1];
+			return (z < 0.0);
+		}
+
+		const double oneoverh = 1.0/sqrt(rq1);
+
+		const double a = C_PI_2 + atan(z*oneoverh);
+
+		double f = a * fisheye_scale_factor;
+		f *= viewport_radius * oneoverh;
+
+		x = viewport_center[0] + x * f;
+		y = viewport_center[1] + y * f;
+		return (a<0.9*C_PI);
+	}
+
 	double viewport_fov_diameter;
 	double fisheye_scale_factor;
 };
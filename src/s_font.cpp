@@ -20,6 +20,7 @@
 
 // Class to manage fonts
 
+#include <algorithm>
 #include <vector>
 #include "s_font.hpp"
 #include "utility.hpp"
@@ -34,6 +35,41 @@ shaderProgram* s_font::shaderHorizontal=nullptr;
 shaderProgram* s_font::shaderPrint=nullptr;
 
 DataGL s_font::sFont;
+DataGL s_font::sFontHorizontal;
+
+namespace {
+
+// décode le caractère UTF-8 commençant à s[i] et avance i
+Uint16 nextCodepoint(const string &s, size_t &i)
+{
+	unsigned char c = s[i++];
+	if (c < 0x80)
+		return c;
+
+	int length;
+	unsigned int code;
+	if ((c & 0xE0) == 0xC0) {
+		length = 1;
+		code = c & 0x1F;
+	} else if ((c & 0xF0) == 0xE0) {
+		length = 2;
+		code = c & 0x0F;
+	} else if ((c & 0xF8) == 0xF0) {
+		length = 3;
+		code = c & 0x07;
+	} else
+		return '?';
+
+	for (int k = 0; k < length; k++) {
+		if (i >= s.size() || (s[i] & 0xC0) != 0x80)
+			return '?';
+		code = (code << 6) | (s[i++] & 0x3F);
+	}
+	// SDL_ttf ne rend que le plan multilingue de base avec des Uint16
+	return (code > 0xFFFF) ? 0xFFFD : (Uint16)code;
+}
+
+}
 
 s_font::s_font(float size_i, const string& ttfFileName) //: lineHeightEstimate(0)
 {
@@ -47,22 +83,15 @@ s_font::s_font(float size_i, const string& ttfFileName) //: lineHeightEstimate(0
 		printf("TTF_OpenFont error: %s\n", TTF_GetError());
 		exit(-1);
 	}
+	lineHeight = TTF_FontHeight(myFont);
 	//cout << "Created new font with size: " << fontSize << " and TTF name : " << fontName << endl;
 }
 
 s_font::~s_font()
 {
-
-	clearCache();
+	if (atlasTexture)
+		glDeleteTextures(1, &atlasTexture);
 	TTF_CloseFont(myFont);
-
-	while(!vecPos.empty()) {
-		vecPos.pop_back();
-	}
-
-	while(!vecTex.empty()) {
-		vecTex.pop_back();
-	}
 }
 
 
@@ -71,22 +100,32 @@ void s_font::createShader()
 	//HORIZONTAL
 	shaderHorizontal = new shaderProgram();
 	shaderHorizontal->init("sfontHorizontal.vert","sfontHorizontal.frag");
-	shaderHorizontal->setUniformLocation("Color");
+
+	glGenVertexArrays(1,&sFontHorizontal.vao);
+	glBindVertexArray(sFontHorizontal.vao);
+
+	glGenBuffers(1,&sFontHorizontal.pos);
+	glGenBuffers(1,&sFontHorizontal.tex);
+	glGenBuffers(1,&sFontHorizontal.color);
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
 
 	//PRINT
 	shaderPrint = new shaderProgram();
 	shaderPrint->init("sfontPrint.vert","sfontPrint.frag");
-	shaderPrint->setUniformLocation("MVP");
-	shaderPrint->setUniformLocation("Color");
 
 	glGenVertexArrays(1,&sFont.vao);
 	glBindVertexArray(sFont.vao);
 
 	glGenBuffers(1,&sFont.tex);
 	glGenBuffers(1,&sFont.pos);
+	glGenBuffers(1,&sFont.color);
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
 }
 
 void s_font::deleteShader()
@@ -98,258 +137,258 @@ void s_font::deleteShader()
 
 	glDeleteBuffers(1,&sFont.tex);
 	glDeleteBuffers(1,&sFont.pos);
+	glDeleteBuffers(1,&sFont.color);
 	glDeleteVertexArrays(1, &sFont.vao);
+
+	glDeleteBuffers(1,&sFontHorizontal.tex);
+	glDeleteBuffers(1,&sFontHorizontal.pos);
+	glDeleteBuffers(1,&sFontHorizontal.color);
+	glDeleteVertexArrays(1, &sFontHorizontal.vao);
 }
 
-//! print out a string
-//! cache == 0 means do not cache rendered string texture
-//! cache == -1 means do not actually draw, just cache
-void s_font::print(float x, float y, const string& s, Vec4f Color, Mat4f MVP, int upsidedown, int cache)
+//! reserve a w x h cell in the atlas, one pixel apart from its neighbours
+bool s_font::allocate(int w, int h, int &x, int &y)
 {
-	if(s == "") return;
-
-	renderedString_struct currentRender;
-
-	// If not cached, create texture
-	if( !cache || renderCache[s].textureW == 0 ) {
-		currentRender = renderString(s);
-		if( cache ) {
-			renderCache[s] = currentRender;
-		}
-	} else {
-		// read from cache
-		currentRender = renderCache[s];
+	if (shelfX + w > ATLAS_SIZE) {
+		shelfY += shelfH + 1;
+		shelfX = 0;
+		shelfH = 0;
 	}
+	if (w > ATLAS_SIZE || shelfY + h > ATLAS_SIZE)
+		return false;
+
+	x = shelfX;
+	y = shelfY;
+	shelfX += w + 1;
+	if (h > shelfH)
+		shelfH = h;
+	return true;
+}
 
-	if(cache==-1) return; // do not draw, just wanted to cache
-
-	StateGL::enable(GL_BLEND);
-
-	// Draw
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture( GL_TEXTURE_2D, currentRender.stringTexture);
-	//~ glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-	//~ glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-
-	// Avoid edge visibility
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+//! return the glyph of a character, nullptr if the atlas is full
+const s_font::Glyph* s_font::getGlyph(Uint16 ch)
+{
+	auto it = glyphs.find(ch);
+	if (it != glyphs.end())
+		return &it->second;
+
+	if (atlasTexture == 0) {
+		vector<unsigned char> blank(ATLAS_SIZE*ATLAS_SIZE*4, 0);
+		glGenTextures(1, &atlasTexture);
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		// Avoid edge visibility
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, blank.data());
+	}
 
-	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	Glyph glyph;
+	int miny, maxy;
+	if (TTF_GlyphMetrics(myFont, ch, &glyph.minx, &glyph.maxx, &miny, &maxy, &glyph.advance)) {
+		// character not provided by the font
+		glyph.minx = glyph.maxx = glyph.advance = 0;
+	}
+	glyph.width = 0;
+	glyph.u0 = glyph.v0 = glyph.u1 = glyph.v1 = 0.f;
 
-	shaderPrint->use();
+	SDL_Color color;
+	color.r=255;
+	color.g=255;
+	color.b=255;
+	SDL_Surface *text = TTF_RenderGlyph_Blended(myFont, ch, color); //write in white
+	if (text) {
+		int x, y;
+		if (!allocate(text->w, text->h, x, y)) {
+			SDL_FreeSurface(text);
+			return nullptr;
+		}
+		glyph.width = text->w;
+		glyph.u0 = (float)x / ATLAS_SIZE;
+		glyph.v0 = (float)y / ATLAS_SIZE;
+		glyph.u1 = (float)(x + text->w) / ATLAS_SIZE;
+		glyph.v1 = (float)(y + text->h) / ATLAS_SIZE;
+
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, text->pitch / 4);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, text->w, text->h, GL_RGBA, GL_UNSIGNED_BYTE, text->pixels);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		SDL_FreeSurface(text);
+	}
 
-	shaderPrint->setUniform("MVP", MVP);
-	shaderPrint->setUniform("Color", Color);
+	return &(glyphs[ch] = glyph);
+}
 
-	glBindVertexArray(sFont.vao);
+//! place the glyphs of a string the way SDL_ttf renders it, return its width
+float s_font::layout(const string &s, vector<PlacedGlyph> &placed)
+{
+	for (int attempt = 0; attempt < 2; attempt++) {
+		placed.clear();
+		int pen = 0, minx = 0, maxx = 0;
+		Uint16 previous = 0;
+		bool full = false;
+
+		for (size_t i = 0; i < s.size() && !full; ) {
+			Uint16 ch = nextCodepoint(s, i);
+			const Glyph *glyph = getGlyph(ch);
+			if (glyph == nullptr) {
+				full = true;
+				break;
+			}
+			if (previous)
+				pen += TTF_GetFontKerningSizeGlyphs(myFont, previous, ch);
+			previous = ch;
+
+			minx = std::min(minx, pen + glyph->minx);
+			placed.push_back({glyph, (float)(pen + std::min(0, glyph->minx))});
+			pen += glyph->advance;
+			maxx = std::max(maxx, std::max(pen, pen - glyph->advance + glyph->maxx));
+		}
 
-	float h = currentRender.textureH;
-	float w = currentRender.textureW;
-
-	if(!upsidedown) {
-		y -= currentRender.stringH;  // adjust for base of text in texture
-
-		vecPos.push_back(x);
-		vecPos.push_back(y);
-		vecPos.push_back(x);
-		vecPos.push_back(y+h);
-		vecPos.push_back(x+w);
-		vecPos.push_back(y);
-		vecPos.push_back(x+w);
-		vecPos.push_back(y+h);
-
-		vecTex.push_back(0);
-		vecTex.push_back(0);
-		vecTex.push_back(0);
-		vecTex.push_back(1);
-		vecTex.push_back(1);
-		vecTex.push_back(0);
-		vecTex.push_back(1);
-		vecTex.push_back(1);
+		if (!full) {
+			// the rendered string starts at its leftmost pixel
+			for (PlacedGlyph &p : placed)
+				p.x -= minx;
+			return maxx - minx;
+		}
 
-	} else {
-		y -= currentRender.stringH;  // adjust for base of text in texture
-
-		vecPos.push_back(x+w);
-		vecPos.push_back(y+h);
-		vecPos.push_back(x);
-		vecPos.push_back(y+h);
-		vecPos.push_back(x+w);
-		vecPos.push_back(y);
-		vecPos.push_back(x);
-		vecPos.push_back(y);
-
-		vecTex.push_back(1);
-		vecTex.push_back(0);
-		vecTex.push_back(0);
-		vecTex.push_back(0);
-		vecTex.push_back(1);
-		vecTex.push_back(1);
-		vecTex.push_back(0);
-		vecTex.push_back(1);
+		// atlas full: draw what is pending and start a new one
+		flush();
+		clearCache();
 	}
+	placed.clear();
+	return 0;
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER,sFont.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecPos.size(),vecPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glBindBuffer(GL_ARRAY_BUFFER,sFont.tex);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTex.size(),vecTex.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0,4);
+//! add a string to the print stream
+//! cache == -1 means do not draw, just put the glyphs in the atlas
+void s_font::print(float x, float y, const string& s, Vec4f Color, Mat4f MVP, int upsidedown, int cache)
+{
+	if(s == "") return;
 
-	vecPos.clear();
-	vecTex.clear();
+	layout(s, placedGlyphs);
 
-	shaderPrint->unuse();
+	if(cache==-1) return; // do not draw, just wanted to cache
 
-	if(!cache) glDeleteTextures( 1, &currentRender.stringTexture);
+	y -= lineHeight;  // adjust for base of text in texture
+
+	const float *m = MVP.r;
+	auto pushVertex = [&](float px, float py, float u, float v) {
+		vecPos.push_back(m[0]*px + m[4]*py + m[12]);
+		vecPos.push_back(m[1]*px + m[5]*py + m[13]);
+		vecPos.push_back(m[2]*px + m[6]*py + m[14]);
+		vecPos.push_back(m[3]*px + m[7]*py + m[15]);
+		vecTex.push_back(u);
+		vecTex.push_back(v);
+		vecColor.push_back(Color[0]);
+		vecColor.push_back(Color[1]);
+		vecColor.push_back(Color[2]);
+		vecColor.push_back(Color[3]);
+	};
+
+	for (const PlacedGlyph &p : placedGlyphs) {
+		const Glyph &g = *p.glyph;
+		if (g.width == 0)
+			continue;
+
+		float x0 = x + p.x;
+		float x1 = x0 + g.width;
+		// top of the text at y, or at y+h when upside down
+		float vLow = upsidedown ? g.v1 : g.v0;
+		float vHigh = upsidedown ? g.v0 : g.v1;
+
+		pushVertex(x0, y, g.u0, vLow);
+		pushVertex(x1, y, g.u1, vLow);
+		pushVertex(x0, y+lineHeight, g.u0, vHigh);
+		pushVertex(x1, y, g.u1, vLow);
+		pushVertex(x1, y+lineHeight, g.u1, vHigh);
+		pushVertex(x0, y+lineHeight, g.u0, vHigh);
+	}
 }
 
 float s_font::getStrLen(const string& s, bool cache)
 {
-
 	if(s == "") return 0;
 	if(myFont==nullptr) fprintf(stderr,"myFont == NULL\n");
 
-	if( renderCache[s].textureW != 0 ) return renderCache[s].stringW;
-
-	Mat4f MVP;
-
-	// otherwise calculate (and cache if desired)
-	if(cache) {
-		print(0, 0, s, Vec4f (1.0,1.0, 1.0, 1.0), MVP , 0, -1);
-		return renderCache[s].stringW;
-	} else {
-		int w,h;
-		if(TTF_SizeText(myFont,s.c_str(),&w,&h)) {
-			printf("ERROR TTF_SizeText(myFont,s.c_str(),&w,&h)) ==%i %i\n",w,h);
-			return w;
-		} else {// perhaps print the current TTF_GetError(), the string can't be rendered...
-			//printf("ERROR : TTF_SizeText(myFont,s.c_str(),&w,&h)) ==%i %i but say ==0 \n",w,h);
-			return w;
-		}
-	}
+	return layout(s, placedGlyphs);
 }
 
 
-//! remove cached texture for string
-void s_font::clearCache(const string& s)
+//! remove all the glyphs from the atlas
+void s_font::clearCache()
 {
-	if( renderCache[s].textureW != 0 ) {
-		glDeleteTextures( 1, &renderCache[s].stringTexture);
-		renderCache.erase(s);
+	glyphs.clear();
+	shelfX = shelfY = shelfH = 0;
+
+	if (atlasTexture) {
+		// the padding between the new glyphs must be transparent again
+		vector<unsigned char> blank(ATLAS_SIZE*ATLAS_SIZE*4, 0);
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, ATLAS_SIZE, ATLAS_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, blank.data());
 	}
-
 }
 
-//! remove ALL cached textures
-void s_font::clearCache()
+//! draw every pending string in one call per stream
+void s_font::flush()
 {
-	for ( renderedStringHashIter_t iter = renderCache.begin(); iter != renderCache.end(); ++iter ) {
-		if( (*iter).second.textureW != 0 ) {
-			glDeleteTextures( 1, &((*iter).second.stringTexture));
-			//cout << "Cleared cache for string: " << (*iter).first << endl;
-		}
+	if (vecPos.empty() && vecHorizontalPos.empty())
+		return;
+
+	StateGL::enable(GL_BLEND);
+	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, atlasTexture);
+
+	if (!vecPos.empty()) {
+		shaderPrint->use();
+		glBindVertexArray(sFont.vao);
+
+		glBindBuffer(GL_ARRAY_BUFFER,sFont.pos);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecPos.size(),vecPos.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(0,4,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glBindBuffer(GL_ARRAY_BUFFER,sFont.tex);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTex.size(),vecTex.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glBindBuffer(GL_ARRAY_BUFFER,sFont.color);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecColor.size(),vecColor.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(2,4,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glDrawArrays(GL_TRIANGLES, 0, vecPos.size()/4);
+
+		shaderPrint->unuse();
+		vecPos.clear();
+		vecTex.clear();
+		vecColor.clear();
 	}
 
-	renderCache.clear();
-}
+	if (!vecHorizontalPos.empty()) {
+		shaderHorizontal->use();
+		glBindVertexArray(sFontHorizontal.vao);
 
-//! Render a string to a texture
-renderedString_struct s_font::renderString(const string &s) const
-{
+		glBindBuffer(GL_ARRAY_BUFFER,sFontHorizontal.pos);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecHorizontalPos.size(),vecHorizontalPos.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
 
-	renderedString_struct rendering;
-	SDL_Color color;
-	color.r=255;
-	color.g=255;
-	color.b=255;
-	SDL_Surface *text = TTF_RenderUTF8_Blended(myFont, s.c_str(), color ); //write in white
-
-	// Calculate opengl texture size required
-	rendering.stringW = text->w;
-	rendering.stringH = text->h;
-
-	// opengl texture dimensions must be powers of 2
-	//~ rendering.textureW = getNextPowerOf2((int)rendering.stringW);
-	//~ rendering.textureH = getNextPowerOf2((int)rendering.stringH);
-	rendering.textureW = text->w;
-	rendering.textureH = text->h;
-
-	//~ Uint32 rmask, gmask, bmask, amask;
-
-	/* SDL interprets each pixel as a 32-bit number, so our masks must depend on the endianness (byte order) of the machine */
-	//~ #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-	//~ rmask = 0xff000000;
-	//~ gmask = 0x00ff0000;
-	//~ bmask = 0x0000ff00;
-	//~ amask = 0x000000ff;
-	//~ #else
-	//~ rmask = 0x000000ff;
-	//~ gmask = 0x0000ff00;
-	//~ bmask = 0x00ff0000;
-	//~ amask = 0xff000000;
-	//~ #endif
-
-	//~ SDL_Surface *surface = SDL_CreateRGBSurface(SDL_SWSURFACE, (int)rendering.textureW, (int)rendering.textureH, 32, rmask, gmask, bmask, amask);
-	//~ renderedString_struct nothing;
-	//~ nothing.textureW = nothing.textureH = nothing.stringW = nothing.stringH = 0;
-	//~ nothing.stringTexture = 0;
-	//~ if(!surface) return nothing;
-
-	//~ SDL_Rect tmp;
-	//~ tmp.x=0;
-	//~ tmp.y=0;
-	//~ tmp.w=text->w;
-	//~ tmp.h=text->h;
-	//~ SDL_BlitSurface(text, &tmp, surface, &tmp);
-
-    // disable mipmapping on the new texture
-    //~ glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-    //~ glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-
-	// disable mipmapping on default texture
-	//~ glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	//~ glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	//~ // Avoid edge visibility
-	//~ glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
-	//~ glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
-
-	// get the number of channels in the SDL surface
-	//~ GLenum texture_format;
-	//~ GLint nOfColors = surface->format->BytesPerPixel;
-	//~ if (nOfColors == 4) {     // contains an alpha channel
-		//~ if (surface->format->Rmask == 0x000000ff)
-			//~ texture_format = GL_RGBA;
-		//~ else
-			//~ texture_format = GL_BGRA;
-	//~ } else if (nOfColors == 3) {     // no alpha channel
-		//~ if (surface->format->Rmask == 0x000000ff)  // THIS IS WRONG for someplatforms
-			//~ texture_format = GL_RGB;
-		//~ else
-			//~ texture_format = GL_BGR;
-	//~ } else {
-		//~ cerr << "Error: unable to convert surface to font texture.\n";
-		//~ if(surface) SDL_FreeSurface(surface);
-		//~ return nothing;
-	//~ }
-
-	glGenTextures( 1, &rendering.stringTexture);
-	glBindTexture( GL_TEXTURE_2D, rendering.stringTexture);
-
-    // disable mipmapping on the new texture
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, text->w, text->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, text->pixels );
-	//~ glTexImage2D( GL_TEXTURE_2D, 0, nOfColors, (GLint)rendering.textureW, (GLint)rendering.textureH, 0, texture_format, GL_UNSIGNED_BYTE, surface->pixels );
-
-	//~ if(surface) SDL_FreeSurface(surface);
-	if(text) SDL_FreeSurface(text);
-	return rendering;
+		glBindBuffer(GL_ARRAY_BUFFER,sFontHorizontal.tex);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecHorizontalTex.size(),vecHorizontalTex.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glBindBuffer(GL_ARRAY_BUFFER,sFontHorizontal.color);
+		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecHorizontalColor.size(),vecHorizontalColor.data(),GL_DYNAMIC_DRAW);
+		glVertexAttribPointer(2,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+		glDrawArrays(GL_TRIANGLES, 0, vecHorizontalPos.size()/2);
+
+		shaderHorizontal->unuse();
+		vecHorizontalPos.clear();
+		vecHorizontalTex.clear();
+		vecHorizontalColor.clear();
+	}
 }
 
 
@@ -359,25 +398,12 @@ void s_font::printHorizontal(const Projector * prj, float altitude, float azimut
 {
 	if(str == "") return;
 
-	renderedString_struct rendering;
-
 	Vec3d startV, screen;
 	Utility::spheToRect(-azimuth*C_PI/180., altitude*C_PI/180., startV);
 	prj->projectDomeFixed(startV, screen);
 	float x = screen[0];
 	float y = screen[1];
 
-	// Get rendered texture
-	if(renderCache[str].textureW == 0) {
-		rendering = renderString(str);
-		if(cache) renderCache[str] = rendering;
-	} else {
-		rendering = renderCache[str];
-	}
-
-	float textureExtentH = rendering.stringH/rendering.textureH;
-	float textureExtentW = rendering.stringW/rendering.textureW;
-
 	Vec3d center = prj->getViewportCenter();
 	float radius = center[2];
 
@@ -387,95 +413,63 @@ void s_font::printHorizontal(const Projector * prj, float altitude, float azimut
 
 	// If the text is too far away to be visible in the screen return
 	if(radius > 0) {
-		if (d > radius + rendering.stringH) return;
+		if (d > radius + lineHeight) return;
 	} else {
 		if(myMax(prj->getViewportWidth(), prj->getViewportHeight() ) > d) return;
 	}
 
-	StateGL::enable(GL_BLEND);
-
-	shaderHorizontal->use();
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, rendering.stringTexture);
-	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	float stringW = layout(str, placedGlyphs);
+	if (stringW == 0)
+		return;
 
 	float theta = C_PI + atan2f(dx, dy - 1);
-	float psi = (float)getStrLen(str)/(d + 1);  // total angle of rotation
-
-	int steps = int(psi*15);//TODO trouver le bon compromis pour la taille
-	//cout << steps << endl;
-	if(steps < 10) steps = 10;
-
-	float angle, p, q;
-
-	vector<Vec2f> meshPoints;  // screen x,y
-
-	// Pre-calculate points (more efficient)
-	for (int i=0; i<=steps; i++) {
-
-		angle = theta - i*psi/steps;
-		p = sin(angle);
-		q = cos(angle);
-
-		meshPoints.push_back(Vec2f(center[0]+p*(d-rendering.stringH), center[1]+q*(d-rendering.stringH)));
-		meshPoints.push_back(Vec2f(center[0]+p*d,center[1]+q*d));
-	}
+	float psi = stringW/(d + 1);  // total angle of rotation
+
+	auto pushVertex = [&](float angle, float r, float shiftx, float shifty, float u, float v, const Vec3f &color) {
+		vecHorizontalPos.push_back(center[0] + sin(angle)*r + shiftx);
+		vecHorizontalPos.push_back(center[1] + cos(angle)*r + shifty);
+		vecHorizontalTex.push_back(u);
+		vecHorizontalTex.push_back(v);
+		vecHorizontalColor.push_back(color[0]);
+		vecHorizontalColor.push_back(color[1]);
+		vecHorizontalColor.push_back(color[2]);
+	};
 
 	int shiftx = 0;
 	int shifty = 0;
-
 	Vec3f Color (texColor[0], texColor[1], texColor[2]);
 
-	shaderHorizontal->setUniform("Color", Color);
-
-	glBindVertexArray(sFont.vao);
-
-
 	for (int pass=0; pass<outline*4+1; pass++) {
 
 		if(outline) {
 			if(pass < 4 ) {
 				Color = v3fNull;
-				shaderHorizontal->setUniform("Color", Color);
 				if(pass<2) shiftx = -1;
 				else shiftx = 1;
 				if(pass%2) shifty = -1;
 				else shifty = 1;
 			} else {
 				Color = Vec3f(texColor[0], texColor[1], texColor[2]);
-				shaderHorizontal->setUniform("Color", Color);
 				shiftx = shifty = 0;
 			}
 		}
 
-		for (int i=0; i<=steps; i++) {
-
-			vecPos.push_back(meshPoints[i*2][0]+shiftx);
-			vecPos.push_back(meshPoints[i*2][1]+shifty);
-			vecPos.push_back(meshPoints[i*2+1][0]+shiftx);
-			vecPos.push_back(meshPoints[i*2+1][1]+shifty);
-
-			vecTex.push_back((float)i/steps*textureExtentW);
-			vecTex.push_back(0.0);
-			vecTex.push_back((float)i/steps*textureExtentW);
-			vecTex.push_back(textureExtentH);
+		// the string is bent along the circle of radius d, its top toward the center
+		for (const PlacedGlyph &p : placedGlyphs) {
+			const Glyph &g = *p.glyph;
+			if (g.width == 0)
+				continue;
+
+			float a0 = theta - p.x/stringW*psi;
+			float a1 = theta - (p.x + g.width)/stringW*psi;
+			float inner = d - lineHeight;
+
+			pushVertex(a0, inner, shiftx, shifty, g.u0, g.v0, Color);
+			pushVertex(a0, d, shiftx, shifty, g.u0, g.v1, Color);
+			pushVertex(a1, inner, shiftx, shifty, g.u1, g.v0, Color);
+			pushVertex(a1, inner, shiftx, shifty, g.u1, g.v0, Color);
+			pushVertex(a0, d, shiftx, shifty, g.u0, g.v1, Color);
+			pushVertex(a1, d, shiftx, shifty, g.u1, g.v1, Color);
 		}
-
-
-		glBindBuffer(GL_ARRAY_BUFFER,sFont.pos);
-		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecPos.size(),vecPos.data(),GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-		glBindBuffer(GL_ARRAY_BUFFER,sFont.tex);
-		glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecTex.size(),vecTex.data(),GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,0,NULL);
-
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, vecPos.size()/2);
-
-		vecPos.clear();
-		vecTex.clear();
 	}
-
-	shaderHorizontal->unuse();
-	if(!cache) glDeleteTextures( 1, &rendering.stringTexture);
 }
@@ -28,7 +28,7 @@
 #define _S_FONT_H
 
 
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <SDL2/SDL_ttf.h>
 
@@ -39,49 +39,88 @@
 
 class Projector;
 
-typedef struct {
-	GLuint stringTexture;  // Rendered string texture reference - remember to delete when done
-	float textureW; 	   // Width of texture in pixels
-	float textureH; 	   // Height of texture in pixels
-	float stringW; 	       // Width of string portion in pixels
-	float stringH; 	       // Height of string portion in pixels
-} renderedString_struct;
-
-typedef std::map< std::string, renderedString_struct > renderedStringHash_t;
-typedef renderedStringHash_t::const_iterator renderedStringHashIter_t;
-
+/**
+ * \class s_font
+ * \brief Affichage de textes à partir d'un atlas de glyphes
+ *
+ * Chaque police (fichier ttf et taille) rastérise ses glyphes une seule fois avec
+ * SDL_ttf dans une texture atlas. print() et printHorizontal() n'envoient rien à
+ * OpenGL : ils ajoutent les quads des glyphes à un flux de sommets, transformés
+ * sur le CPU par la matrice MVP de l'appel et coloriés par sommet.
+ *
+ * flush() affiche tout ce flux en un seul appel de dessin (deux si des textes
+ * horizontaux sont en attente). Le module propriétaire de la police appelle
+ * flush() à la fin de son dessin, ce qui garde l'ordre d'affichage entre modules.
+ */
 class s_font {
 
 public:
 	s_font(float size_i, const std::string& ttfFileName);
 	virtual ~s_font();
 
+	//! ajoute un texte au flux de la frame
+	//! cache == -1 prépare seulement les glyphes sans rien afficher
 	void print(float x, float y, const std::string& s, Vec4f Color, Mat4f MVP ,int upsidedown = 1, int cache = 0);
 	void printHorizontal(const Projector * prj, float altitude, float azimuth, const std::string& str, Vec3f& texColor, bool cache = 0, bool outline = 0);
 
-	void clearCache(const std::string& s);
-	void clearCache();
+	//! affiche les textes en attente
+	void flush();
 
-	renderedString_struct renderString(const std::string &s) const;
+	//! vide l'atlas de glyphes
+	void clearCache();
 
 	float getStrLen(const std::string& s, bool cache = 0);
 
 	static void createShader();
 	static void deleteShader();
 protected:
-
-	renderedStringHash_t renderCache;
+	// position d'un glyphe dans l'atlas et métriques
+	struct Glyph {
+		float u0, v0, u1, v1;	// coordonnées de texture dans l'atlas
+		int width;				// largeur de la cellule en pixels, 0 si rien à dessiner
+		int minx, maxx;			// étendue du dessin par rapport au stylo
+		int advance;			// avancée du stylo
+	};
+
+	// glyphe placé dans une chaîne
+	struct PlacedGlyph {
+		const Glyph *glyph;
+		float x;			// bord gauche de la cellule, la chaîne commençant à 0
+	};
+
+	// renvoie le glyphe du caractère, en le rastérisant dans l'atlas si besoin
+	const Glyph* getGlyph(Uint16 ch);
+	// découpe la chaîne UTF-8 en glyphes placés, renvoie sa largeur en pixels
+	float layout(const std::string &s, std::vector<PlacedGlyph> &placed);
+	// réserve une place w x h dans l'atlas, faux s'il est plein
+	bool allocate(int w, int h, int &x, int &y);
 
 	std::string fontName;
 	TTF_Font *myFont;
 	float fontSize;
+	int lineHeight;			// hauteur d'une ligne rastérisée par SDL_ttf
+
+	GLuint atlasTexture = 0;
+	int shelfX = 0, shelfY = 0, shelfH = 0;	// étagère en cours de remplissage dans l'atlas
+	std::unordered_map<Uint16, Glyph> glyphs;
+	std::vector<PlacedGlyph> placedGlyphs;
 
+	// flux des textes print() : position dans le clip space, texture et couleur
 	std::vector<float> vecPos;
 	std::vector<float> vecTex;
+	std::vector<float> vecColor;
+
+	// flux des textes printHorizontal() : position écran, texture et couleur
+	std::vector<float> vecHorizontalPos;
+	std::vector<float> vecHorizontalTex;
+	std::vector<float> vecHorizontalColor;
+
+	static const int ATLAS_SIZE = 1024;
 
 	static shaderProgram *shaderHorizontal;
 	static shaderProgram *shaderPrint;
 	static DataGL sFont;
+	static DataGL sFontHorizontal;
 };
 
 
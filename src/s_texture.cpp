@@ -24,17 +24,21 @@
  *
  */
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <stdlib.h>
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
 #include <exception>
 #include "utility.hpp"
 
 #include "s_texture.hpp"
+#include "texture_cache.hpp"
+#include "texture_streamer.hpp"
 #include "log.hpp"
 
 std::string s_texture::texDir = "./";
+TextureStreamer *s_texture::streamer = nullptr;
 std::map<std::string, s_texture::texRecap*> s_texture::texCache;
 
 s_texture::s_texture(const std::string& _textureName) : textureName(_textureName), texID(0),
@@ -57,6 +61,8 @@ s_texture::s_texture(const s_texture *t)
 	loadType = t->loadType;
 	loadWrapping = t->loadWrapping;
 	texID = t->texID;
+	imgWidth = t->imgWidth;
+	imgHeight = t->imgHeight;
 
 	it = texCache.find(textureName);
 
@@ -120,6 +126,8 @@ s_texture::s_texture(const std::string& _textureName, GLuint _imgTex)
 	glGetTexLevelParameteriv(GL_TEXTURE_2D, miplevel, GL_TEXTURE_HEIGHT, &h);
 	tmp->size = w*h*4;
 	tmp->mipmap = false;
+	tmp->width = w;
+	tmp->height = h;
 	texCache[textureName]= tmp;
 }
 
@@ -128,40 +136,6 @@ s_texture::~s_texture()
 	unload();
 }
 
-void s_texture::blend( const int type, unsigned char* const data, const unsigned int sz )
-{
-	unsigned char* a = nullptr;
-	unsigned char* ptr = data;
-	int r, g, b;
-
-	switch( type ) {
-
-		case PNG_BLEND1:
-			for( unsigned int i = 0; i < sz; i+=4 ) {
-				r = *ptr++;
-				g = *ptr++;
-				b = *ptr++;
-				a = ptr++;
-				if (r+g+b > 255) *a = 255;
-				else *a = r+g+b;
-			}
-			break;
-
-		case PNG_BLEND3:
-			for( unsigned int i = 0; i < sz; i+=4 ) {
-				r = *ptr++;
-				g = *ptr++;
-				b = *ptr++;
-				a = ptr++;
-				*a = (r+g+b)/3;
-			}
-			break;
-
-		default:
-			break;
-	}
-}
-
 bool s_texture::load(std::string fullName)
 {
 	// assume NO mipmap - DIGITALIS - put in svn
@@ -173,15 +147,52 @@ void s_texture::createEmptyTex()
 	glGenTextures (1, &texID);
 	glActiveTexture (GL_TEXTURE0);
 	glBindTexture (GL_TEXTURE_2D, texID);
+	fillEmptyTex(loadWrapping, false);
+	//~ std::cout << "texture createEmptyTex" << textureName << std::endl;
+}
 
+void s_texture::fillEmptyTex(GLint wrapping, bool pending)
+{
 	unsigned char image_data[4] = {255,0,0,255};
+	if (pending)
+		image_data[0] = image_data[3] = 0;
 	glTexImage2D (GL_TEXTURE_2D,0,GL_RGBA,1,1,0,GL_RGBA,GL_UNSIGNED_BYTE,image_data);
 	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, loadWrapping);
-	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, loadWrapping);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapping);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapping);
 	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	//~ std::cout << "texture createEmptyTex" << textureName << std::endl;
+}
+
+void s_texture::uploadImage(const TextureCache::Image &image, const unsigned char *base, bool mipmap, GLint wrapping)
+{
+	for (unsigned int level = 0; level < image.getNbLevels(); level++) {
+		const void *pixels = reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(base) + image.getOffset(level));
+		glTexImage2D (GL_TEXTURE_2D,level,GL_RGBA,image.getWidth(level),image.getHeight(level),0,GL_RGBA,GL_UNSIGNED_BYTE,pixels);
+	}
+	setParameters(mipmap && image.getNbLevels() == 1, mipmap, wrapping);
+}
+
+void s_texture::setParameters(bool generateMipmap, bool mipmap, GLint wrapping)
+{
+	// les niveaux lus dans le cache sont déjà là
+	if (generateMipmap)
+		glGenerateMipmap (GL_TEXTURE_2D);
+
+	if( mipmap ) {
+		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	} else {
+		glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	}
+
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapping);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapping);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	GLfloat max_aniso = 0.0f;
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max_aniso);
+	// set the maximum!
+	glTexParameterf (GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, max_aniso);
 }
 
 bool s_texture::load(std::string fullName, bool mipmap)
@@ -196,76 +207,45 @@ bool s_texture::load(std::string fullName, bool mipmap)
 		tmp->nbLink++;
 		//~ std::cout << "on augmente son nbLink à " << tmp->nbLink << std::endl;
 		texID = tmp->texID;
+		imgWidth = tmp->width;
+		imgHeight = tmp->height;
 		Log.write("s_texture: already in cache " + fullName , cLog::LOG_TYPE::L_INFO);
 		return true;
 	} else { //texture n'existe pas, on l'intègre dans la map
+		if (streamer != nullptr)
+			return stream(fullName, mipmap);
+
 		//code from Anthon Opengl4 tutorial
 		try {
-			int x, y, n;
-			int force_channels = 4;
-			unsigned char* image_data = nullptr;
-			image_data = stbi_load (fullName.c_str(), &x, &y, &n, force_channels);
-			if (!image_data) {
+			TextureCache::Image image;
+			if (!TextureCache::load(fullName, loadType, mipmap, image)) {
 				Log.write("s_texture: could not load " + fullName , cLog::LOG_TYPE::L_ERROR);
 				return false;
 			}
-			blend(loadType, image_data, x*y*4);
+			int x = image.getWidth();
+			int y = image.getHeight();
 
 			// NPOT check
 			if ((x & (x - 1)) != 0 || (y & (y - 1)) != 0) {
 				Log.write("s_texture: not power-of-2 dimensions for " + fullName , cLog::LOG_TYPE::L_WARNING);
 				//~ fprintf (stderr, "WARNING: texture %s is not power-of-2 dimensions\n", fullName.c_str());
 			}
-			int width_in_bytes = x * 4;
-			unsigned char *top = nullptr;
-			unsigned char *bottom = nullptr;
-			unsigned char temp = 0;
-			int half_height = y / 2;
-
-			for (int row = 0; row < half_height; row++) {
-				top = image_data + row * width_in_bytes;
-				bottom = image_data + (y - row - 1) * width_in_bytes;
-				for (int col = 0; col < width_in_bytes; col++) {
-					temp = *top;
-					*top = *bottom;
-					*bottom = temp;
-					top++;
-					bottom++;
-				}
-			}
 
 			glGenTextures (1, &texID);
 			glActiveTexture (GL_TEXTURE0);
 			glBindTexture (GL_TEXTURE_2D, texID);
-			glTexImage2D (GL_TEXTURE_2D,0,GL_RGBA,x,y,0,GL_RGBA,GL_UNSIGNED_BYTE,image_data);
-
-			if( mipmap ) {
-				glGenerateMipmap (GL_TEXTURE_2D);
-				glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			} else {
-				glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			}
-
-			glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, loadWrapping);
-			glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, loadWrapping);
-			glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			GLfloat max_aniso = 0.0f;
-			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max_aniso);
-			// set the maximum!
-			glTexParameterf (GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, max_aniso);
+			uploadImage(image, image.getData(), mipmap, loadWrapping);
 
 			texRecap * tmp = new texRecap;
 			tmp->nbLink = 1;
 			tmp->texID = texID;
 			tmp->size = x*y*4;
 			tmp->mipmap = mipmap;
+			tmp->width = imgWidth = x;
+			tmp->height = imgHeight = y;
 
 			texCache[fullName]= tmp;
 
-			// image_data != nullptr
-			stbi_image_free(image_data);
-
 		} catch( std::exception &e ) {
 			//~ std::cerr << "WARNING : failed loading texture file! " << e.what() << std::endl;
 			Log.write("s_texture: failed loading texture file " + fullName , cLog::LOG_TYPE::L_ERROR);
@@ -277,6 +257,37 @@ bool s_texture::load(std::string fullName, bool mipmap)
 	return false; //just for gcc
 }
 
+bool s_texture::stream(const std::string &fullName, bool mipmap)
+{
+	// seul l'en-tête est lu ici, l'image est décodée par le streamer
+	int x, y;
+	if (!TextureCache::readInfo(fullName, x, y)) {
+		Log.write("s_texture: could not load " + fullName , cLog::LOG_TYPE::L_ERROR);
+		return false;
+	}
+	if ((x & (x - 1)) != 0 || (y & (y - 1)) != 0)
+		Log.write("s_texture: not power-of-2 dimensions for " + fullName , cLog::LOG_TYPE::L_WARNING);
+
+	// la texture garde cet identifiant, elle reste transparente jusqu'à la fin du chargement
+	glGenTextures (1, &texID);
+	glActiveTexture (GL_TEXTURE0);
+	glBindTexture (GL_TEXTURE_2D, texID);
+	fillEmptyTex(loadWrapping, true);
+
+	texRecap * tmp = new texRecap;
+	tmp->nbLink = 1;
+	tmp->texID = texID;
+	tmp->size = x*y*4;
+	tmp->mipmap = mipmap;
+	tmp->width = imgWidth = x;
+	tmp->height = imgHeight = y;
+	texCache[fullName]= tmp;
+
+	streamer->request(fullName, texID, loadType, mipmap, loadWrapping);
+	Log.write("s_texture: streaming " + fullName , cLog::LOG_TYPE::L_INFO);
+	return true;
+}
+
 void s_texture::unload()
 {
 	//~ std::cout << "on unload la texture " << textureName << std::endl;
@@ -286,6 +297,8 @@ void s_texture::unload()
 		texRecap * tmp = it->second;
 		if (tmp->nbLink == 1) {
 			//~ std::cout << "suppression réelle de " << textureName<< std::endl;
+			if (streamer != nullptr)
+				streamer->cancel(texID);
 			glDeleteTextures(1, &texID);	// Delete The Texture
 			texID = 0;
 			delete tmp;
@@ -300,6 +313,12 @@ void s_texture::unload()
 
 void s_texture::getDimensions(int &width, int &height) const
 {
+	if (streamer != nullptr && streamer->isPending(texID)) {
+		width = imgWidth;
+		height = imgHeight;
+		return;
+	}
+
 	glBindTexture(GL_TEXTURE_2D, texID);
 
 	GLint w, h;
@@ -313,6 +332,10 @@ void s_texture::getDimensions(int &width, int &height) const
 // Return the average texture luminance : 0 is black, 1 is white
 float s_texture::getAverageLuminance(void) const
 {
+	// il faut l'image complète
+	if (streamer != nullptr)
+		streamer->finish(texID);
+
 	glBindTexture(GL_TEXTURE_2D, texID);
 	GLint w, h;
 	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
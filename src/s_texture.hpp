@@ -31,11 +31,7 @@
 #include <GL/glew.h>
 #include <map>
 
-//TODO supprimer cela et les remplacer par un enum class
-#define PNG_ALPHA  0
-#define PNG_SOLID  1
-#define PNG_BLEND1 7
-#define PNG_BLEND3 2
+#include "texture_cache.hpp"
 
 #define TEX_LOAD_TYPE_PNG_ALPHA 0
 #define TEX_LOAD_TYPE_PNG_SOLID 1
@@ -43,6 +39,7 @@
 #define TEX_LOAD_TYPE_PNG_SOLID_REPEAT 4
 #define TEX_LOAD_TYPE_PNG_BLEND1 7
 
+class TextureStreamer;
 
 class s_texture {
 public:
@@ -76,10 +73,19 @@ public:
 	static void setTexDir(const std::string& _texDir) {
 		s_texture::texDir = _texDir;
 	}
+	// Renvoie le chemin par défaut des textures.
+	static const std::string &getTexDir() {
+		return texDir;
+	}
 
 	// crée une texture rouge en cas de textures non chargée
 	void createEmptyTex();
 
+	// charge les nouvelles textures en arrière-plan avec streamer, ou tout de suite si nullptr
+	static void setStreamer(TextureStreamer *_streamer) {
+		streamer = _streamer;
+	}
+
 	// Renvoie la taille utilisée par les textures dans la carte graphique
 	static unsigned long int getTotalGPUMem();
 
@@ -88,25 +94,41 @@ public:
 	}
 
 private:
+	friend class TextureStreamer;
+
 	void unload();
 	bool load(std::string fullName);
 	bool load(std::string fullName, bool mipmap);
+	// crée la texture en attente et confie son image au streamer
+	bool stream(const std::string &fullName, bool mipmap);
 
 	struct texRecap {
 		unsigned long int size;
 		int nbLink;
 		GLuint texID;
 		bool mipmap;
+		int width;
+		int height;
 	};
 
-	void blend( const int, unsigned char* const, const unsigned int );
+	// envoie tous les niveaux de image dans la texture liée, puis fixe ses paramètres.
+	// base est image.getData(), ou nullptr si image a été copiée au début du PBO lié
+	static void uploadImage(const TextureCache::Image &image, const unsigned char *base, bool mipmap, GLint wrapping);
+	// remplit la texture liée d'un pixel rouge, ou transparent si elle est en cours de chargement
+	static void fillEmptyTex(GLint wrapping, bool pending);
+	// filtres, mipmaps et répétition de la texture liée
+	static void setParameters(bool generateMipmap, bool mipmap, GLint wrapping);
 
 	std::string textureName;
 	GLuint texID;
 	int loadType;
 	GLint loadWrapping;
+	// dimensions lues dans l'en-tête du fichier, connues avant la fin du chargement
+	int imgWidth = 0;
+	int imgHeight = 0;
 
 	static std::string texDir;
+	static TextureStreamer *streamer;
 	static std::map<std::string, texRecap*> texCache;
 	std::map<std::string, texRecap*>::iterator it;
 };
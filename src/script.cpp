@@ -24,9 +24,15 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
 #include "script.hpp"
 #include <cstddef>
 #include "log.hpp"
+#include "app_command_interface.hpp"
 
 using namespace std;
 
@@ -36,163 +42,268 @@ using namespace std;
 		//~ Log.write(v[n],  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
 //~ }
 
-Token::Token(const std::string &s, const std::string &p)
+Token::Token() :
+	path(make_shared<const string>()), commandId(-1)
 {
-	elmt.clear();
-	path.clear();
-	pNext=nullptr;
-	elmt=s;
-	path=p;
 }
 
-Token::~Token()
+Token::Token(const std::string &s, const std::string &p) :
+	Token(s, make_shared<const string>(p))
 {
-	if (pNext != nullptr) delete pNext;
 }
 
-void Token::printToken()
+Token::Token(const std::string &s, const std::shared_ptr<const std::string> &p) :
+	elmt(s), path(p)
 {
-	Log.write("Token script : " + path + " : " + elmt,  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
+	error = parse(elmt, command, args);
+	commandId = AppCommandInterface::getCommandId(command);
+}
+
+void Token::printToken() const
+{
+	Log.write("Token script : " + *path + " : " + elmt,  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
+}
+
+std::string Token::parse(const std::string &line, std::string &command, stringHash_t &arguments)
+{
+	istringstream commandstr( line );
+	string key, value, error;
+	char nextc = 0;
+
+	commandstr >> command;
+	transform(command.begin(), command.end(), command.begin(), ::tolower);
+
+	while (commandstr >> key) {
+		if (!(commandstr >> value)) {
+			error = "argument " + key + " without value";
+			break;
+		}
+		if (value[0] == '"') {
+			// pull in all text inside quotes
+			if (value[value.length()-1] == '"') {
+				// one word in quotes
+				value = value.substr(1, value.length() -2 );
+			} else {
+				// multiple words in quotes
+				value = value.substr(1, value.length() -1 );
+
+				while (1) {
+					nextc = commandstr.get();
+					if ( nextc == '"' || !commandstr.good()) break;
+					value.push_back( nextc );
+				}
+				if (nextc != '"')
+					error = "missing closing quote for argument " + key;
+			}
+		}
+		transform(key.begin(), key.end(), key.begin(), ::tolower);
+		arguments[key] = value;
+	}
+
+	#ifdef PARSE_DEBUG
+	Log.write("Command: " + command + "Argument hash:", cLog::LOG_TYPE::L_DEBUG);
+	for ( stringHashIter_t iter = arguments.begin(); iter != arguments.end(); ++iter ) {
+		Log.write("\t" + iter->first + " : " + iter->second, cLog::LOG_TYPE::L_DEBUG);
+	}
+	#endif
+	return error;
 }
 
 Script::Script()
 {
-	//cout << "Script->init()" << endl;
-	pFirst=nullptr;
-	pLast=nullptr;
-	p2First=nullptr;
-	p2Last=nullptr;
 }
 
 Script::~Script()
 {
-	if (pFirst != nullptr) delete pFirst;
 }
 
 void Script::printScript()
 {
-	Token *pMove=pFirst;
 	Log.write("Printing script: --BEGIN",  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
-	while (pMove !=nullptr) {
-		Log.write("   " + pMove->getToken(),  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
-		pMove=pMove->pNext;
-	}
+	for (const Token &token : commands)
+		Log.write("   " + token.getToken(),  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
 	Log.write("Printing script: --END",  cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
 }
 
 void Script::clean()
 {
-	if (pFirst != nullptr) delete pFirst;
-	pFirst = nullptr;
-	pLast = nullptr;
-	p2First = nullptr;
-	p2Last = nullptr;
+	commands.clear();
 }
 
 int Script::load(const std::string &script_file, const std::string &script_path )
 {
-	if (pFirst == nullptr) {
-		//cout << "loading script "<< script_file << " when no script is playing" << endl;
-		return loadInternal(script_file, script_path ,ListPosition::first);
-	} else {
-		//cout << "loading script " << script_file << " when script is playing" << endl;
-		return loadInternal(script_file, script_path ,ListPosition::second);
-	}
+	vector<Token> tokens;
+	if (!compile(script_file, script_path, tokens))
+		return 0;
+
+	// a script loaded while another one is playing runs before the rest of it
+	commands.insert(commands.begin(), make_move_iterator(tokens.begin()), make_move_iterator(tokens.end()));
+	//printScript();
+	return 1;
 }
 
-int Script::loadInternal(const std::string &script_file,const std::string & script_path , ListPosition wp)
+int Script::compile(const std::string &script_file, const std::string &script_path, std::vector<Token> &tokens)
 {
 	//~ printf("s : %s p : %s\n", script_file.c_str() , script_path.c_str() );
-	input_file = new ifstream(script_file.c_str());
+	ifstream input_file(script_file.c_str());
 
-	if (! input_file->is_open()) {
+	if (! input_file.is_open()) {
 		Log.write("Unable to open script: " + script_file,  cLog::LOG_TYPE::L_ERROR, cLog::LOG_FILE::SCRIPT);
 		return 0;
 	}
-	vector <string> fields;
 
-	bool is_script_empty=true;
+	shared_ptr<const string> path = make_shared<const string>(script_path);
 	string line;
-	Token *token=nullptr;
-	while (! input_file->eof() ) {
-		getline(*input_file,line);
+	while (! input_file.eof() ) {
+		getline(input_file,line);
 
 		if ( line[0] != '#' && line[0] != 0 && line[0] != '\r' && line[0] != '\n') {
 			//cout << "[script.cpp => Line is: " << line << "]"<< endl;
-			token=new Token(line, script_path);
-			is_script_empty=false;
-			if (wp==ListPosition::first)
-				addFirst(token);
-			else
-				addSecond(token);
+			tokens.emplace_back(line, path);
 		}
 	}
-	input_file->close();
-	if ((! is_script_empty) && (wp==ListPosition::second)) {
-		p2Last->pNext=pFirst;
-		pFirst=p2First;
-		p2Last=nullptr;
-		p2First=nullptr;
-	}
-	//printScript();
+	input_file.close();
 	return 1;
 }
 
-void Script::addFirstInQueue(Token * token){
-	
-	if (pFirst == nullptr) {
-		pFirst=token;
-		pLast=token;
-	}else {
-		
-		Token * temp = pFirst;
-		pFirst = token;
-		token->pNext = temp;
-	}
+void Script::addFirstInQueue(const Token &token)
+{
+	commands.push_front(token);
 }
 
-void Script::addFirst(Token *token)
+int Script::getFirst(Token &token)
 {
-	if (pFirst == nullptr) {
-		pFirst=token;
-		pLast=token;
-	} else {
-		pLast->pNext=token;
-		pLast=pLast->pNext;
+	if (commands.empty()) {
+		Log.write("End of script",  cLog::LOG_TYPE::L_INFO, cLog::LOG_FILE::SCRIPT);
+		token = Token("script action end", "");
+		return 0;
+	}
+
+	token = std::move(commands.front());
+	commands.pop_front();
+	if (token.getToken()=="script action end" && !commands.empty()) {
+		Log.write("End of script  detected but not at end of the execution stack", cLog::LOG_TYPE::L_WARNING, cLog::LOG_FILE::SCRIPT);
 	}
+	//cout << " script.cpp : " << token.getToken() << endl;
+	return 1;
 }
 
-void Script::addSecond(Token *token)
+// liste récursivement les fichiers .sts de path
+static void listScripts(const string &path, vector<string> &files)
 {
-	if (p2First == nullptr) {
-		p2First=token;
-		p2Last=token;
-	} else {
-		p2Last->pNext=token;
-		p2Last=p2Last->pNext;
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+		return;
+
+	if (!S_ISDIR(st.st_mode)) {
+		files.push_back(path);
+		return;
+	}
+
+	DIR *dp = opendir(path.c_str());
+	if (dp == NULL)
+		return;
+	struct dirent *entryp;
+	vector<string> entries;
+	while ((entryp = readdir(dp)) != NULL) {
+		string name = entryp->d_name;
+		if (name == "." || name == "..")
+			continue;
+		entries.push_back(name);
+	}
+	closedir(dp);
+	sort(entries.begin(), entries.end());
+
+	string dir = (path.back() == '/') ? path : path + "/";
+	for (const string &name : entries) {
+		string full = dir + name;
+		if (stat(full.c_str(), &st) != 0)
+			continue;
+		if (S_ISDIR(st.st_mode))
+			listScripts(full, files);
+		else if (name.length()>4 && name.find(".sts", name.length()-4)!=string::npos)
+			files.push_back(full);
 	}
 }
 
-int Script::getFirst(string &command, string &dataDir)
+bool Script::checkScripts(const std::string &path)
 {
-	Token *pMove;
-	if (pFirst == nullptr) {
-		Log.write("End of script",  cLog::LOG_TYPE::L_INFO, cLog::LOG_FILE::SCRIPT);
-		command="script action end";
-		dataDir="";
-		return 0;
-	} else {
-		pMove=pFirst;
-		//pFirst->printToken();
-		dataDir=pFirst->getTokenPath();
-		command=pFirst->getToken();
-		if (command=="script action end" && (pFirst->pNext != nullptr)) {
-			Log.write("End of script  detected but not at end of the execution stack", cLog::LOG_TYPE::L_WARNING, cLog::LOG_FILE::SCRIPT);
+	vector<string> files;
+	listScripts(path, files);
+	if (files.empty()) {
+		cout << "No script found in " << path << endl;
+		return false;
+	}
+
+	unsigned long nbCommands = 0, nbErrors = 0, nbBytes = 0;
+	double parseTime = 0.0;
+
+	for (const string &file : files) {
+		string dir = file.substr(0, file.find_last_of('/') + 1);
+		vector<Token> tokens;
+
+		auto start = chrono::steady_clock::now();
+		int ok = compile(file, dir, tokens);
+		parseTime += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		if (!ok) {
+			cout << file << ": unable to open" << endl;
+			nbErrors++;
+			continue;
+		}
+
+		// les blocs struct loop et struct if doivent être fermés dans le fichier
+		int loopDepth = 0, ifDepth = 0;
+		for (const Token &token : tokens) {
+			nbCommands++;
+			nbBytes += token.getToken().size() + 1;
+
+			string error = token.getError();
+			if (error.empty() && token.getCommandId() < 0 && !token.getCommand().empty())
+				error = "unknown command " + token.getCommand();
+
+			if (error.empty() && token.getCommand() == "struct") {
+				stringHash_t::const_iterator it = token.getArgs().find("loop");
+				if (it != token.getArgs().end()) {
+					if (it->second != "end")
+						loopDepth++;
+					else if (--loopDepth < 0) {
+						error = "struct loop end without struct loop";
+						loopDepth = 0;
+					}
+				}
+				it = token.getArgs().find("if");
+				if (it != token.getArgs().end()) {
+					if (it->second == "else") {
+						if (ifDepth == 0)
+							error = "struct if else without struct if";
+					} else if (it->second != "end")
+						ifDepth++;
+					else if (--ifDepth < 0) {
+						error = "struct if end without struct if";
+						ifDepth = 0;
+					}
+				}
+			}
+
+			if (!error.empty()) {
+				cout << file << ": " << error << ": " << token.getToken() << endl;
+				nbErrors++;
+			}
+		}
+		if (loopDepth > 0) {
+			cout << file << ": struct loop without struct loop end" << endl;
+			nbErrors++;
+		}
+		if (ifDepth > 0) {
+			cout << file << ": struct if without struct if end" << endl;
+			nbErrors++;
 		}
-		//cout << " script.cpp : " << command << endl;
-		pFirst=pFirst->pNext;
-		pMove->pNext=nullptr;
-		delete pMove;
-		return 1;
 	}
+
+	cout << files.size() << " scripts, " << nbCommands << " commands, " << nbErrors << " errors" << endl;
+	if (parseTime > 0.0)
+		cout << "parsed in " << parseTime * 1000.0 << " ms: " << nbCommands / parseTime << " commands/s, "
+		     << nbBytes / parseTime / (1024.0 * 1024.0) << " MB/s" << endl;
+	return nbErrors == 0;
 }
@@ -29,29 +29,64 @@
 #ifndef _SCRIPT_H_
 #define _SCRIPT_H_
 
+#include <deque>
+#include <memory>
 #include <vector>
 #include <string>
 
+#include "utility.hpp"
+
 //gestion des lignes de code d'un script
+//chaque ligne est analysée une seule fois, au chargement : l'exécution et les
+//tours de boucle réutilisent le nom de commande, son identifiant et ses arguments
 class Token {
 public:
+	Token();
 	//s: ligne of script_file p: path of script_file
 	Token(const std::string &s, const std::string &p);
-	~Token();
-	void printToken();
-	Token * pNext= nullptr;
+	//s: ligne of script_file p: path of script_file, partagé par toutes les lignes du fichier
+	Token(const std::string &s, const std::shared_ptr<const std::string> &p);
+	void printToken() const;
 
-	std::string getToken() {
+	//! ligne d'origine
+	const std::string &getToken() const {
 		return elmt;
 	}
 
-	std::string getTokenPath() {
-		return path;
+	const std::string &getTokenPath() const {
+		return *path;
+	}
+
+	//! nom de la commande, en minuscules
+	const std::string &getCommand() const {
+		return command;
 	}
 
+	//! arguments : clés en minuscules, valeurs sans les guillemets
+	const stringHash_t &getArgs() const {
+		return args;
+	}
+
+	//! identifiant de la commande pour AppCommandInterface, négatif si elle est inconnue
+	int getCommandId() const {
+		return commandId;
+	}
+
+	//! erreur de syntaxe relevée à l'analyse, vide si aucune
+	const std::string &getError() const {
+		return error;
+	}
+
+	//! découpe une ligne de script en nom de commande et arguments, renvoie l'erreur de syntaxe éventuelle
+	static std::string parse(const std::string &line, std::string &command, stringHash_t &arguments);
+
 private:
 	std::string elmt;
-	std::string path;
+	std::shared_ptr<const std::string> path;
+	std::string command;
+	stringHash_t args;
+	int commandId;
+	std::string error;
 };
 
 //gestion complete des scripts
@@ -69,37 +104,21 @@ public:
 	//! vide la pile d'instructions de scripts en mémoire
 	void clean();
 
-	//!renvoie un élément de la liste avec son chemin
-	int getFirst(std::string &command, std::string &dataDir);
+	//! retire la première commande de la pile, renvoie 0 si le script est terminé
+	int getFirst(Token &token);
 
 	//! adds the given Token in first position in the command queue
-	void addFirstInQueue(Token * token);
+	void addFirstInQueue(const Token &token);
+
+	//! analyse tous les scripts .sts de path (un fichier ou un répertoire parcouru récursivement)
+	//! sans rien exécuter, affiche les erreurs et la vitesse d'analyse. Renvoie vrai s'il n'y a pas d'erreur
+	static bool checkScripts(const std::string &path);
 
 private:
+	//! analyse un fichier script, renvoie 0 s'il ne peut pas être lu
+	static int compile(const std::string &script_file, const std::string &script_path, std::vector<Token> &tokens);
 
-	typedef enum {
-		first,
-		second
-	} ListPosition;
-
-	Token *pFirst=nullptr;
-	Token *pLast=nullptr;
-	Token *p2First=nullptr;
-	Token *p2Last=nullptr;
-	int loadInternal(const std::string &script_file , const std::string &script_path , ListPosition wp);
-
-	/* 
-	 * adds the given Token in the queue named pFirst
-	 * /!\ the value is inserted at the end of the queue
-	 * if you want to insert at the begining of the queue use addFirst_in_queue
-	 */
-	void addFirst(Token *token);
-	
-	//! adds the given Token int the queue named pSecond
-	void addSecond(Token *token);
-
-	std::ifstream *input_file=nullptr;
-	std::string the_path;
+	std::deque<Token> commands;	//!< commandes restant à exécuter
 };
 
 #endif
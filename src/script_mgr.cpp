@@ -30,6 +30,7 @@
 #include <dirent.h>
 #include <cstdio>
 #include <set>
+#include <chrono>
 #include "script_mgr.hpp"
 #include "utility.hpp"
 #include "log.hpp"
@@ -39,6 +40,7 @@
 #include "script.hpp"
 #include "call_system.hpp"
 #include "media.hpp"
+#include "perf_debug.hpp"
 
 using namespace std;
 
@@ -93,8 +95,7 @@ bool ScriptMgr::playScript(const std::string &fullFileName)
  */
 bool ScriptMgr::addScriptFirst(const std::string & script){
 		
-	vector <Token*> commands;
-	Token *token=nullptr;
+	vector <Token> commands;
 	
 	istringstream iss(script);
 	string line;
@@ -103,8 +104,7 @@ bool ScriptMgr::addScriptFirst(const std::string & script){
 	while (getline(iss, line)){
 		
 		if ( line[0] != '#' && line[0] != 0 && line[0] != '\r' && line[0] != '\n') {
-			token = new Token(line, getScriptPath());
-			commands.push_back(token);
+			commands.emplace_back(line, getScriptPath());
 		}
 	}
 	
@@ -274,51 +274,85 @@ void ScriptMgr::resetTimer()
 	elapsed_time = 0;
 }
 
-// runs maximum of one command per update note that waits can drift by up to 1/fps seconds
+// runs every command due in this frame, within frameBudget. Note that waits can drift by up to 1/fps seconds
 void ScriptMgr::update(int delta_time)
 {
 	if (recording) record_elapsed_time += delta_time;
 
-	if (playing && !play_paused) {
-		elapsed_time += delta_time;  // time elapsed since last command (should have been) executed
-
-		if (elapsed_time >= wait_time) {
-			elapsed_time -= wait_time;
-			string comd;
-
-			unsigned long int wait;
-
-			if (repeatLoop) {
-				//~ printf("tour de boucle %i\n", nbrLoop);
-				if (indiceInLoop < loopVector.size()) {
-					commander->executeCommand(loopVector[indiceInLoop], wait); //, 0);  // untrusted commands
-					wait_time = wait;
-					indiceInLoop++;
-				} else { //fin de tour de boucle on recommence sauf si nbrLoop==0
-					nbrLoop=nbrLoop-1;
-
-					if (nbrLoop == 0) {
-						repeatLoop = false;
-						indiceInLoop = 0;
-						loopVector.clear();
-					} else {
-						indiceInLoop = 0;
-					}
-				}
-			} else if ( (script->getFirst(comd,DataDir)) == 1 ) {
-
-				if (isInLoop) {//on est dans une boucle et on doit copier la boucle dans une list.
-					loopVector.push_back(comd);
-				}
-				commander->executeCommand(comd, wait); //, 0);  // untrusted commands
-				wait_time = wait;
+	frameCommands = 0;
+	frameWallTime = frameCpuTime = 0;
+
+	if (!playing || play_paused)
+		return;
+
+	elapsed_time += delta_time;  // time elapsed since last command (should have been) executed
+
+	if (elapsed_time < wait_time)
+		return;
+
+	unsigned long long cpuStart = PerformanceDebugger::threadCpuTime();
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+	// a command can end, pause or replace the script: test again before each one.
+	// the end of a loop turn keeps the previous wait, as when one command was run per frame
+	while (playing && !play_paused && elapsed_time >= wait_time) {
+		elapsed_time -= wait_time;
+		if (executeNext())
+			frameCommands++;
+
+		if (frameBudget == 0)
+			break;
+		frameWallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count();
+		if (frameWallTime >= frameBudget) {
+			if (playing && elapsed_time >= wait_time)
+				Log.write("ScriptMgr: frame budget reached after " + std::to_string(frameCommands) + " commands", cLog::LOG_TYPE::L_DEBUG, cLog::LOG_FILE::SCRIPT);
+			break;
+		}
+	}
+
+	frameWallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count();
+	frameCpuTime = PerformanceDebugger::threadCpuTime() - cpuStart;
+}
+
+bool ScriptMgr::executeNext()
+{
+	unsigned long int wait;
+
+	if (repeatLoop) {
+		//~ printf("tour de boucle %i\n", nbrLoop);
+		if (indiceInLoop < loopVector.size()) {
+			commander->executeCommand(loopVector[indiceInLoop], wait); //, 0);  // untrusted commands
+			wait_time = wait;
+			indiceInLoop++;
+			return true;
+		} else { //fin de tour de boucle on recommence sauf si nbrLoop==0
+			nbrLoop=nbrLoop-1;
+
+			if (nbrLoop == 0) {
+				repeatLoop = false;
+				indiceInLoop = 0;
+				loopVector.clear();
 			} else {
-				// script done
-				DataDir = "";
-				commander->executeCommand("script action end");
+				indiceInLoop = 0;
 			}
+			return false;
+		}
+	}
+
+	Token token;
+	if ( (script->getFirst(token)) == 1 ) {
+		DataDir = token.getTokenPath();
+		if (isInLoop) {//on est dans une boucle et on doit copier la boucle dans une list.
+			loopVector.push_back(token);
 		}
+		commander->executeCommand(token, wait); //, 0);  // untrusted commands
+		wait_time = wait;
+	} else {
+		// script done
+		DataDir = "";
+		commander->executeCommand("script action end");
 	}
+	return true;
 }
 
 // get a list of script files from directory in alphabetical order
@@ -36,9 +36,10 @@
 #include <list>
 #include <vector>
 
+#include "script.hpp"
+
 class AppCommandInterface;
 class Media;
-class Script;
 
 class ScriptMgr {
 
@@ -100,8 +101,34 @@ public:
 	void resetTimer();
 
 	//! execute commands in running script
+	//! all the commands due in this frame are executed, within the frame budget
 	void update(int delta_time);
 
+	//! fixe le temps maximal en ms consacré aux commandes d'un script par frame.
+	//! 0 : une seule commande par frame
+	void setFrameBudget(float ms) {
+		frameBudget = (ms > 0.f) ? (unsigned long long)(ms * 1000.f) : 0;
+	}
+
+	float getFrameBudget() const {
+		return frameBudget / 1000.f;
+	}
+
+	//! nombre de commandes exécutées lors du dernier update
+	unsigned int getFrameCommands() const {
+		return frameCommands;
+	}
+
+	//! temps réel en µs passé dans les commandes lors du dernier update
+	unsigned long long getFrameWallTime() const {
+		return frameWallTime;
+	}
+
+	//! temps CPU en µs passé dans les commandes lors du dernier update
+	unsigned long long getFrameCpuTime() const {
+		return frameCpuTime;
+	}
+
 	//! get list of scripts in a directory
 	std::string getScriptList(const std::string &directory);
 
@@ -133,6 +160,10 @@ public:
 
 private:
 	std::string getRecordDate();
+	//! exécute la prochaine commande du script ou de la boucle en cours
+	//! renvoie vrai si une commande a été exécutée
+	bool executeNext();
+
 	Media* media = nullptr;
 	AppCommandInterface * commander = nullptr;  //!< for executing script commands
 	Script * script = nullptr; //!< currently loaded script
@@ -149,8 +180,13 @@ private:
 	bool isInLoop; 		//!< on est entrain de lire les instructions d'une loop
 	bool repeatLoop; 	//!< on est entrain de répéter une boucle
 	int nbrLoop;		//!< nombre de tours de boucles restants
-	std::vector<std::string> loopVector; //!< le vector qui contient les instructions de loop à répéter
+	std::vector<Token> loopVector; //!< le vector qui contient les instructions de loop à répéter
 	unsigned int indiceInLoop; //!< indique l'endroit ou l'on se trouve dans la loop
+
+	unsigned long long frameBudget = 0;	//!< µs maximum de commandes par frame, 0 pour une commande par frame
+	unsigned int frameCommands = 0;		//!< commandes exécutées lors du dernier update
+	unsigned long long frameWallTime = 0;	//!< µs réelles du dernier update
+	unsigned long long frameCpuTime = 0;	//!< µs CPU du dernier update
 };
 
 
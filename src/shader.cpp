@@ -51,6 +51,7 @@ shaderProgram::~shaderProgram()
 		glDeleteShader(fshader);
 	}
 	uniformLocations.clear();
+	uniformSlots.clear();
 	subroutineLocations.clear();
 	glDeleteProgram(program);
 }
@@ -380,6 +381,8 @@ void shaderProgram::init(GLuint vs,GLuint tcs,GLuint tes,GLuint gs,GLuint fs)
 
 	glLinkProgram(program);
 	debugProgram();
+	// the link gives back the default values to all the uniforms
+	resetUniformCache();
 }
 
 
@@ -394,108 +397,225 @@ void shaderProgram::unuse()
 }
 
 
-void shaderProgram::setUniformLocation(const char * name )
+UniformHandle shaderProgram::setUniformLocation(const char * name )
 {
-	std::map<string, GLuint>::iterator pos;
+	std::map<string, int>::iterator pos;
 	pos = uniformLocations.find(name);
 
+	UniformHandle u;
 	if( pos == uniformLocations.end() ) {
-		uniformLocations[name] = glGetUniformLocation(program, name);
-	} else
+		UniformSlot slot;
+		slot.location = glGetUniformLocation(program, name);
+		u.slot = uniformSlots.size();
+		uniformSlots.push_back(slot);
+		uniformLocations[name] = u.slot;
+	} else {
 		printf("%i : setUniformLocation name %s already found !!!\n", program, name);
-	//todo retour
+		u.slot = pos->second;
+	}
+	return u;
 }
 
-
-int shaderProgram::getUniformLocation(const char * name )
+UniformHandle shaderProgram::getUniformHandle(const char * name ) const
 {
-	std::map<string, GLuint>::iterator pos;
-	pos = uniformLocations.find(name);
+	UniformHandle u;
+	std::map<string, int>::const_iterator pos = uniformLocations.find(name);
+	if( pos != uniformLocations.end() )
+		u.slot = pos->second;
+	return u;
+}
 
-	if( pos == uniformLocations.end() ) {
+UniformHandle shaderProgram::getUniformLocation(const char * name )
+{
+	UniformHandle u = getUniformHandle(name);
+	if (u.slot < 0)
 		printf("%i : erreur avec %s atribution uniformLocations\n", program, name);
-		//~ uniformLocations[name] = glGetUniformLocation(program, name);
-		return 0;
-	}
-	return uniformLocations[name];
+	return u;
+}
+
+void shaderProgram::forgetUniform(UniformHandle u)
+{
+	if (u.slot >= 0)
+		uniformSlots[u.slot].size = 0;
 }
 
+void shaderProgram::resetUniformCache()
+{
+	for (UniformSlot &slot : uniformSlots)
+		slot.size = 0;
+}
+
+bool shaderProgram::changeUniform(UniformHandle u, const void * value, unsigned int size)
+{
+	if (u.slot < 0)
+		return false;
+	UniformSlot &slot = uniformSlots[u.slot];
+	if (slot.location < 0)
+		return false;
+	if (slot.size == size && memcmp(slot.value, value, size) == 0)
+		return false;
+	memcpy(slot.value, value, size);
+	slot.size = size;
+	return true;
+}
+
+// the functions by name always give the value to GL: they stay usable when the
+// uniform was changed outside of this class. The kept value is updated for the handles.
 void shaderProgram::setUniform( const char *name, const Vec3f & v)
 {
-	GLint loc = getUniformLocation(name);
-	glUniform3fv(loc,1,v);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, v);
 }
 
 void shaderProgram::setUniform( const char *name, const Vec4f & v)
 {
-	GLint loc = getUniformLocation(name);
-	glUniform4fv(loc,1, v);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, v);
 }
 
 void shaderProgram::setUniform( const char *name, const Vec2f & v)
 {
-	GLint loc = getUniformLocation(name);
-	glUniform2fv(loc,1, v);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, v);
 }
 
 void shaderProgram::setUniform( const char *name, const Vec3i & v)
 {
-	GLint loc = getUniformLocation(name);
-	glUniform3iv(loc,1,v);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, v);
 }
 
 void shaderProgram::setUniform( const char *name, const Vec4i & v)
 {
-	GLint loc = getUniformLocation(name);
-	glUniform4iv(loc,1, v);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, v);
 }
 
 void shaderProgram::setUniform( const char *name, const Vec2i & v)
 {
-	GLint loc = getUniformLocation(name);
-	glUniform2iv(loc,1, v);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, v);
 }
 
 void shaderProgram::setUniform( const char *name, const Mat4f & m)
 {
-	GLint loc = getUniformLocation(name);
-	glUniformMatrix4fv(loc, 1, GL_FALSE, m);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, m);
 }
 
-
 void shaderProgram::setUniform( const char *name, float val )
 {
-	GLint loc = getUniformLocation(name);
-	glUniform1f(loc, val);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, val);
 }
 
-
 void shaderProgram::setUniform( const char *name, double val )
 {
-	float _val = val;
-	GLint loc = getUniformLocation(name);
-	glUniform1f(loc, _val);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, val);
 }
 
-
 void shaderProgram::setUniform( const char *name, int val )
 {
-	GLint loc = getUniformLocation(name);
-	glUniform1i(loc, val);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, val);
 }
 
-
 void shaderProgram::setUniform( const char *name, GLuint val )
 {
-	GLint loc = getUniformLocation(name);
-	glUniform1ui(loc, val);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, val);
 }
 
-
 void shaderProgram::setUniform( const char *name, bool val )
 {
-	int loc = getUniformLocation(name);
-	glUniform1i(loc, val);
+	UniformHandle u = getUniformLocation(name);
+	forgetUniform(u);
+	setUniform(u, val);
+}
+
+
+// glProgramUniform sets the value in this program whatever the program in use,
+// so the kept values are always those of the program
+void shaderProgram::setUniform( UniformHandle u, const Vec3f & v)
+{
+	if (changeUniform(u, (const float*)v, sizeof(float)*3))
+		glProgramUniform3fv(program, uniformSlots[u.slot].location, 1, v);
+}
+
+void shaderProgram::setUniform( UniformHandle u, const Vec4f & v)
+{
+	if (changeUniform(u, (const float*)v, sizeof(float)*4))
+		glProgramUniform4fv(program, uniformSlots[u.slot].location, 1, v);
+}
+
+void shaderProgram::setUniform( UniformHandle u, const Vec2f & v)
+{
+	if (changeUniform(u, (const float*)v, sizeof(float)*2))
+		glProgramUniform2fv(program, uniformSlots[u.slot].location, 1, v);
+}
+
+void shaderProgram::setUniform( UniformHandle u, const Vec3i & v)
+{
+	if (changeUniform(u, (const int*)v, sizeof(int)*3))
+		glProgramUniform3iv(program, uniformSlots[u.slot].location, 1, v);
+}
+
+void shaderProgram::setUniform( UniformHandle u, const Vec4i & v)
+{
+	if (changeUniform(u, (const int*)v, sizeof(int)*4))
+		glProgramUniform4iv(program, uniformSlots[u.slot].location, 1, v);
+}
+
+void shaderProgram::setUniform( UniformHandle u, const Vec2i & v)
+{
+	if (changeUniform(u, (const int*)v, sizeof(int)*2))
+		glProgramUniform2iv(program, uniformSlots[u.slot].location, 1, v);
+}
+
+void shaderProgram::setUniform( UniformHandle u, const Mat4f & m)
+{
+	if (changeUniform(u, (const float*)m, sizeof(float)*16))
+		glProgramUniformMatrix4fv(program, uniformSlots[u.slot].location, 1, GL_FALSE, m);
+}
+
+void shaderProgram::setUniform( UniformHandle u, float val )
+{
+	if (changeUniform(u, &val, sizeof(float)))
+		glProgramUniform1f(program, uniformSlots[u.slot].location, val);
+}
+
+void shaderProgram::setUniform( UniformHandle u, double val )
+{
+	setUniform(u, (float)val);
+}
+
+void shaderProgram::setUniform( UniformHandle u, int val )
+{
+	if (changeUniform(u, &val, sizeof(int)))
+		glProgramUniform1i(program, uniformSlots[u.slot].location, val);
+}
+
+void shaderProgram::setUniform( UniformHandle u, GLuint val )
+{
+	if (changeUniform(u, &val, sizeof(GLuint)))
+		glProgramUniform1ui(program, uniformSlots[u.slot].location, val);
+}
+
+void shaderProgram::setUniform( UniformHandle u, bool val )
+{
+	setUniform(u, (int)val);
 }
 
 
@@ -3,6 +3,7 @@
 
 #include <GL/glew.h>
 #include <string>
+#include <vector>
 #include "vecmath.hpp"
 #include <map>
 //~ #include "stateGL.hpp"
@@ -32,7 +33,8 @@
 	Prog.printinformations();
 
 	//with uniforms
-	prog.getUniformLocation("texunit0");
+	prog.setUniformLocation("texunit0");
+	UniformHandle fader = prog.setUniformLocation("fader");
 
 	// with subroutine
 	prog.setSubroutineLocation(GL_VERTEX_SHADER,"fct1");
@@ -40,6 +42,7 @@
 
     prog.use();
 	prog.setUniform("texunit0",0);
+	prog.setUniform(fader, 0.5f);	// no string lookup, no GL call if fader is already 0.5
 	prog.setSubroutine(GL_VERTEX_SHADER,"fct2");
 
     glActiveTexture(GL_TEXTURE0);
@@ -60,6 +63,15 @@ struct DataGL {
 
 const unsigned int NOSHADER = ~0;
 
+/**
+*   \struct UniformHandle
+*   Uniform resolved once by shaderProgram::setUniformLocation or getUniformHandle.
+*   It is the index of the uniform in the uniform array of its program.
+*/
+struct UniformHandle {
+	int slot = -1;
+};
+
 /**
 *   \class Program
 *   Creates a program for the pipeline from a vertex shader and a fragment shader.
@@ -131,7 +143,20 @@ public:
 	*/
 	void printInformations();
 
-	void setUniformLocation(const char * name );
+	/**
+	*   \fn setUniformLocation
+	*   Resolve a uniform of the program once for all.
+	*   \param name: name of the uniform in the shader source.
+	*   \return the handle of the uniform, to give to setUniform.
+	*/
+	UniformHandle setUniformLocation(const char * name );
+
+	/**
+	*   \fn getUniformHandle
+	*   Find the handle of a uniform already resolved by setUniformLocation.
+	*   \return the handle, invalid (slot -1) if the uniform is unknown.
+	*/
+	UniformHandle getUniformHandle(const char * name ) const;
 
 	void setSubroutineLocation(GLenum ShaderType, const char* name);
 	void setSubroutine(GLenum ShaderType, const char * name );
@@ -149,6 +174,30 @@ public:
 	void setUniform( const char *name, bool val );
 	void setUniform( const char *name, GLuint val );
 
+	// Same functions with a handle : the value is kept and the GL call is skipped
+	// when the uniform already has this value. They don't need the program to be in use.
+	// A uniform changed without this class (glUniform*) must be followed by
+	// resetUniformCache(), or set again by name, which never skips the GL call.
+	void setUniform( UniformHandle u, const Vec2f & v);
+	void setUniform( UniformHandle u, const Vec3f & v);
+	void setUniform( UniformHandle u, const Vec2i & v);
+	void setUniform( UniformHandle u, const Vec3i & v);
+	void setUniform( UniformHandle u, const Vec4f & v);
+	void setUniform( UniformHandle u, const Vec4i & v);
+	void setUniform( UniformHandle u, const Mat4f & m);
+	void setUniform( UniformHandle u, float val);
+	void setUniform( UniformHandle u, double val);
+	void setUniform( UniformHandle u, int val );
+	void setUniform( UniformHandle u, bool val );
+	void setUniform( UniformHandle u, GLuint val );
+
+	/**
+	*   \fn resetUniformCache
+	*   Forget the values kept for the handles: the next setUniform by handle is always given to GL.
+	*   Done after each link of the program.
+	*/
+	void resetUniformCache();
+
 private:
 	GLuint program;
 	GLuint vshader; // vertex shader
@@ -164,9 +213,21 @@ private:
 	void debugProgram();
 
 	std::string loadFileToString(const char * fname);
-	std::map<std::string, GLuint> uniformLocations;
+
+	// a uniform and the last value given to GL
+	struct UniformSlot {
+		GLint location;
+		unsigned int size = 0;	// size of value in bytes, 0 while no value was given
+		unsigned char value[sizeof(float)*16];
+	};
+	std::vector<UniformSlot> uniformSlots;
+	std::map<std::string, int> uniformLocations;	// slot of each uniform name
 	std::map<std::string, GLuint> subroutineLocations;
-	GLint getUniformLocation(const char * name);
+	UniformHandle getUniformLocation(const char * name);
+	// forget the kept value of one uniform
+	void forgetUniform(UniformHandle u);
+	// return true if the value of the uniform must be given to GL, and keep it
+	bool changeUniform(UniformHandle u, const void * value, unsigned int size);
 
 	void init(GLuint vs,GLuint tcs=NOSHADER,GLuint tes=NOSHADER,GLuint gs=NOSHADER,GLuint fs=NOSHADER);
 
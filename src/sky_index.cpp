@@ -0,0 +1,180 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <cmath>
+
+#include "sky_index.hpp"
+
+namespace {
+
+// marge sur le rayon des calottes, pour les points posés sur un bord de cellule
+const double CAP_MARGIN = 1e-9;
+
+double angleBetween(const Vec3d &a, const Vec3d &b)
+{
+	double c = a*b;
+	if (c > 1.0) c = 1.0;
+	else if (c < -1.0) c = -1.0;
+	return acos(c);
+}
+
+Vec3d triangleCenter(const Vec3d &c0, const Vec3d &c1, const Vec3d &c2)
+{
+	Vec3d center = c0 + c1 + c2;
+	center.normalize();
+	return center;
+}
+
+}
+
+SkyCells::SkyCells(int _level) : level(_level), grid(_level), capRadius(_level+1, 0.0)
+{
+	for (int i = 0; i < 20; i++) {
+		Vec3d c0, c1, c2;
+		grid.getTriangleCorners(0, i, c0, c1, c2);
+		measureTriangle(0, c0, c1, c2);
+	}
+	for (double &r : capRadius)
+		r += CAP_MARGIN;
+}
+
+void SkyCells::measureTriangle(int lev, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2)
+{
+	const Vec3d center = triangleCenter(c0, c1, c2);
+	capRadius[lev] = std::max(capRadius[lev], angleBetween(center, c0));
+	capRadius[lev] = std::max(capRadius[lev], angleBetween(center, c1));
+	capRadius[lev] = std::max(capRadius[lev], angleBetween(center, c2));
+	if (lev == level)
+		return;
+
+	// même découpage que GeodesicGrid::initTriangle
+	Vec3d e0 = c1 + c2;
+	e0.normalize();
+	Vec3d e1 = c2 + c0;
+	e1.normalize();
+	Vec3d e2 = c0 + c1;
+	e2.normalize();
+	measureTriangle(lev+1, c0, e2, e1);
+	measureTriangle(lev+1, e2, c1, e0);
+	measureTriangle(lev+1, e1, e0, c2);
+	measureTriangle(lev+1, e0, e1, e2);
+}
+
+unsigned int SkyCells::cellOf(Vec3d v) const
+{
+	v.normalize();
+	return grid.searchZone(v, level);
+}
+
+void SkyCells::searchCone(const Vec3d &dir, double radius, std::vector<SkyRange> &ranges) const
+{
+	StelGeom::ConvexS cone(1);
+	cone[0].n = dir;
+	cone[0].d = cos(radius);
+	search(cone, ranges);
+}
+
+void SkyCells::search(const StelGeom::ConvexS &convex, std::vector<SkyRange> &ranges) const
+{
+	ranges.clear();
+
+	std::vector<Bound> bounds;
+	bounds.reserve(convex.size());
+	for (const StelGeom::HalfSpace &h : convex) {
+		const double norm = h.n.length();
+		if (norm == 0.0) {
+			// tout l'espace ou rien
+			if (h.d > 0.0)
+				return;
+			continue;
+		}
+		Bound b;
+		b.n = h.n / norm;
+		b.d = h.d / norm;
+		if (b.d > 1.0)
+			return;
+		const double angle = (b.d < -1.0) ? M_PI : acos(b.d);
+		for (double r : capRadius) {
+			// hors du demi-espace si l'angle au centre dépasse angle+r, dedans s'il reste sous angle-r
+			b.cosOutside.push_back((angle + r < M_PI) ? cos(angle + r) : -2.0);
+			b.cosInside.push_back((angle - r >= 0.0) ? cos(angle - r) : 2.0);
+		}
+		bounds.push_back(b);
+	}
+
+	for (int i = 0; i < 20; i++) {
+		Vec3d c0, c1, c2;
+		grid.getTriangleCorners(0, i, c0, c1, c2);
+		searchTriangle(0, i, c0, c1, c2, bounds, ranges);
+	}
+}
+
+void SkyCells::searchTriangle(int lev, unsigned int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2,
+                              const std::vector<Bound> &bounds, std::vector<SkyRange> &ranges) const
+{
+	const Vec3d center = triangleCenter(c0, c1, c2);
+
+	bool inside = true;
+	for (const Bound &b : bounds) {
+		const double cosDist = center*b.n;
+		if (cosDist < b.cosOutside[lev])
+			return;
+		if (cosDist >= b.cosInside[lev])
+			continue;
+		// une calotte plus petite qu'un hémisphère est convexe : les 3 coins suffisent
+		if (b.d >= 0.0 && c0*b.n >= b.d && c1*b.n >= b.d && c2*b.n >= b.d)
+			continue;
+		inside = false;
+	}
+
+	if (inside || lev == level) {
+		addRange(lev, index, inside, ranges);
+		return;
+	}
+
+	// même découpage que GeodesicGrid::initTriangle
+	Vec3d e0 = c1 + c2;
+	e0.normalize();
+	Vec3d e1 = c2 + c0;
+	e1.normalize();
+	Vec3d e2 = c0 + c1;
+	e2.normalize();
+	lev++;
+	index <<= 2;
+	searchTriangle(lev, index+0, c0, e2, e1, bounds, ranges);
+	searchTriangle(lev, index+1, e2, c1, e0, bounds, ranges);
+	searchTriangle(lev, index+2, e1, e0, c2, bounds, ranges);
+	searchTriangle(lev, index+3, e0, e1, e2, bounds, ranges);
+}
+
+void SkyCells::addRange(int lev, unsigned int index, bool inside, std::vector<SkyRange> &ranges) const
+{
+	const int shift = 2*(level-lev);
+	const unsigned int first = index << shift;
+	const unsigned int last = (index+1) << shift;
+	if (!ranges.empty() && ranges.back().last == first && ranges.back().inside == inside)
+		ranges.back().last = last;
+	else
+		ranges.push_back(SkyRange{first, last, inside});
+}
@@ -0,0 +1,214 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _SKY_INDEX_HPP_
+#define _SKY_INDEX_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include "geodesic_grid.hpp"
+
+//! intervalle [first,last) de cellules ou d'objets renvoyé par une recherche
+struct SkyRange {
+	unsigned int first;
+	unsigned int last;
+	bool inside;	//!< vrai si tout l'intervalle est dans la région cherchée
+};
+
+/**
+ * \class SkyCells
+ * \brief Découpage hiérarchique de la sphère céleste en cellules de même aire
+ *
+ * Les cellules sont les triangles du niveau level de GeodesicGrid. Les 4 enfants
+ * du triangle i de niveau l sont les triangles 4i à 4i+3 du niveau l+1 : un
+ * triangle de niveau l couvre donc 4^(level-l) cellules consécutives, et une
+ * recherche se résume à une courte liste d'intervalles de cellules.
+ *
+ * Un triangle est écarté dès que la calotte qui l'entoure est hors d'un
+ * demi-espace, et accepté en entier dès qu'il est dans tous les demi-espaces.
+ * Le rayon des calottes est celui du plus grand triangle de chaque niveau :
+ * les tests se font par produit scalaire, sans trigonométrie par triangle.
+ * Seuls les triangles à cheval sur le bord de la région sont subdivisés.
+ *
+ * Les recherches ne modifient pas l'objet et écrivent dans un vecteur fourni
+ * par l'appelant : plusieurs threads peuvent chercher en même temps.
+ */
+class SkyCells {
+public:
+	SkyCells(int _level);
+	~SkyCells() {};
+	SkyCells(SkyCells const &) = delete;
+	SkyCells& operator = (SkyCells const &) = delete;
+
+	int getLevel() const {
+		return level;
+	}
+
+	unsigned int getNbCells() const {
+		return GeodesicGrid::nrOfZones(level);
+	}
+
+	//! renvoie la cellule qui contient la direction v
+	unsigned int cellOf(Vec3d v) const;
+
+	//! remplace le contenu de ranges par les cellules qui touchent l'intersection des demi-espaces
+	void search(const StelGeom::ConvexS &convex, std::vector<SkyRange> &ranges) const;
+
+	//! remplace le contenu de ranges par les cellules qui touchent le cône de demi-angle radius (radians) autour de dir
+	void searchCone(const Vec3d &dir, double radius, std::vector<SkyRange> &ranges) const;
+
+private:
+	// demi-espace normé, avec pour chaque niveau les seuils du produit scalaire
+	// entre sa normale et le centre d'un triangle
+	struct Bound {
+		Vec3d n;
+		double d;
+		std::vector<double> cosOutside;	// en dessous, le triangle est hors du demi-espace
+		std::vector<double> cosInside;	// au dessus, le triangle est dans le demi-espace
+	};
+
+	void searchTriangle(int lev, unsigned int index, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2,
+	                    const std::vector<Bound> &bounds, std::vector<SkyRange> &ranges) const;
+	void addRange(int lev, unsigned int index, bool inside, std::vector<SkyRange> &ranges) const;
+	void measureTriangle(int lev, const Vec3d &c0, const Vec3d &c1, const Vec3d &c2);
+
+	const int level;
+	GeodesicGrid grid;
+	std::vector<double> capRadius;	//!< rayon en radians de la calotte qui entoure chaque triangle d'un niveau
+};
+
+/**
+ * \class SkyIndex
+ * \brief Objets du ciel rangés par cellule de SkyCells
+ *
+ * Les objets sont stockés cellule après cellule dans un seul tableau, si bien
+ * qu'une recherche renvoie des intervalles de ce tableau. Les objets d'un
+ * intervalle inside sont tous dans la région, ceux des autres intervalles
+ * doivent encore être testés un par un.
+ *
+ * insert, remove et clear ne modifient que la liste des objets à ranger :
+ * build() doit être appelé avant la recherche suivante. Entre deux appels à
+ * build(), les recherches peuvent se faire depuis plusieurs threads.
+ */
+template <class T>
+class SkyIndex {
+public:
+	SkyIndex(int level) : cells(level), cellStart(cells.getNbCells()+1, 0) {}
+	~SkyIndex() {};
+	SkyIndex(SkyIndex const &) = delete;
+	SkyIndex& operator = (SkyIndex const &) = delete;
+
+	//! ajoute l'objet dans la direction pos
+	void insert(T object, const Vec3d &pos) {
+		entries.push_back(Entry{cells.cellOf(pos), object});
+	}
+
+	//! retire toutes les occurrences de l'objet
+	void remove(T object) {
+		entries.erase(std::remove_if(entries.begin(), entries.end(), [object](const Entry &e) {
+			return e.object == object;
+		}), entries.end());
+	}
+
+	void clear() {
+		entries.clear();
+	}
+
+	//! range les objets par cellule
+	void build();
+
+	//! nombre d'objets rangés au dernier build()
+	unsigned int size() const {
+		return objects.size();
+	}
+
+	T operator[](unsigned int i) const {
+		return objects[i];
+	}
+
+	const SkyCells &getCells() const {
+		return cells;
+	}
+
+	//! remplace le contenu de ranges par les intervalles d'objets des cellules qui touchent la région
+	void search(const StelGeom::ConvexS &convex, std::vector<SkyRange> &ranges) const {
+		cells.search(convex, ranges);
+		toObjectRanges(ranges);
+	}
+
+	//! remplace le contenu de ranges par les intervalles d'objets des cellules qui touchent le cône
+	void searchCone(const Vec3d &dir, double radius, std::vector<SkyRange> &ranges) const {
+		cells.searchCone(dir, radius, ranges);
+		toObjectRanges(ranges);
+	}
+
+private:
+	struct Entry {
+		unsigned int cell;
+		T object;
+	};
+
+	// remplace les intervalles de cellules par les intervalles d'objets, sans les vides
+	void toObjectRanges(std::vector<SkyRange> &ranges) const;
+
+	SkyCells cells;
+	std::vector<Entry> entries;			// objets à ranger
+	std::vector<T> objects;				// objets rangés par cellule
+	std::vector<unsigned int> cellStart;	// objets de la cellule c : [cellStart[c], cellStart[c+1])
+};
+
+template <class T>
+void SkyIndex<T>::build()
+{
+	std::fill(cellStart.begin(), cellStart.end(), 0);
+	for (const Entry &e : entries)
+		cellStart[e.cell+1]++;
+	for (unsigned int c = 1; c < cellStart.size(); c++)
+		cellStart[c] += cellStart[c-1];
+
+	// tri par dénombrement, l'ordre d'insertion est gardé dans chaque cellule
+	std::vector<unsigned int> next(cellStart.begin(), cellStart.end()-1);
+	objects.resize(entries.size());
+	for (const Entry &e : entries)
+		objects[next[e.cell]++] = e.object;
+}
+
+template <class T>
+void SkyIndex<T>::toObjectRanges(std::vector<SkyRange> &ranges) const
+{
+	unsigned int nb = 0;
+	for (const SkyRange &r : ranges) {
+		SkyRange o = {cellStart[r.first], cellStart[r.last], r.inside};
+		if (o.first == o.last)
+			continue;
+		if (nb > 0 && ranges[nb-1].last == o.first && ranges[nb-1].inside == o.inside)
+			ranges[nb-1].last = o.last;
+		else
+			ranges[nb++] = o;
+	}
+	ranges.resize(nb);
+}
+
+#endif // _SKY_INDEX_HPP_
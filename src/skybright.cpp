@@ -22,6 +22,7 @@
  */
 
 #include <cstdio>
+#include <algorithm>
 #include <cmath>
 //~ #include "fmath.hpp"
 
@@ -88,30 +89,44 @@ void Skybright::setSunMoon(float cos_dist_moon_zenith, float cos_dist_sun_zenith
 	C4 = pow10(-0.4f*K*air_mass_sun);	// Term for sky brightness computation
 }
 
-#include <iostream>
 // Compute the luminance at the given position
 // Inputs : cos_dist_moon = cos(angular distance between moon and the position)
 //			cos_dist_sun  = cos(angular distance between sun  and the position)
 //			cos_dist_zenith = cos(angular distance between zenith and the position)
-float Skybright::getLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith, int cor_optoma)
+float Skybright::getLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith, int cor_optoma) const
 {
-
-	double b_total;			// Total brightness
-	float b_night;			// Dark night brightness
-	float b_twilight;		// Twilight brightness
-	float b_daylight;		// Daylight sky brightness
-	float b_moon;			// Moon brightness
-
 	// catch rounding errors here or end up with white flashes in some cases
 	if (cos_dist_moon < -1.f ) cos_dist_moon = -1.f;
 	if (cos_dist_moon > 1.f ) cos_dist_moon = 1.f;
-	if (cos_dist_sun < -1.f ) cos_dist_moon = -1.f;
+	if (cos_dist_sun < -1.f ) cos_dist_sun = -1.f;
 	if (cos_dist_sun > 1.f ) cos_dist_sun = 1.f;
 	if (cos_dist_zenith < -1.f ) cos_dist_zenith = -1.f;
 	if (cos_dist_zenith > 1.f ) cos_dist_zenith = 1.f;
 
 	if (cor_optoma) cos_dist_moon = 0;
 
+	return computeLuminance(cos_dist_moon, cos_dist_sun, cos_dist_zenith);
+}
+
+void Skybright::getLuminances(const float * cos_dist_moon, const float * cos_dist_sun, const float * cos_dist_zenith,
+                              float * luminance, int n, int cor_optoma) const
+{
+	for (int i = 0; i < n; i++) {
+		float cm = cor_optoma ? 0.f : std::min(std::max(cos_dist_moon[i], -1.f), 1.f);
+		float cs = std::min(std::max(cos_dist_sun[i], -1.f), 1.f);
+		float cz = std::min(std::max(cos_dist_zenith[i], -1.f), 1.f);
+		luminance[i] = computeLuminance(cm, cs, cz);
+	}
+}
+
+inline float Skybright::computeLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith) const
+{
+	double b_total;			// Total brightness
+	float b_night;			// Dark night brightness
+	float b_twilight;		// Twilight brightness
+	float b_daylight;		// Daylight sky brightness
+	float b_moon;			// Moon brightness
+
 	float dist_moon = acosf(cos_dist_moon);
 	float dist_sun = acosf(cos_dist_sun);
 
@@ -48,9 +48,17 @@ public:
 	// Inputs : cos_dist_moon = cos(angular distance between moon and the position)
 	//			cos_dist_sun  = cos(angular distance between sun  and the position)
 	//			cos_dist_zenith = cos(angular distance between zenith and the position)
-	float getLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith, int cor_optoma);
+	float getLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith, int cor_optoma) const;
+
+	// Same function on n positions given as separate arrays (structure of arrays)
+	// The luminances are stored in luminance
+	void getLuminances(const float * cos_dist_moon, const float * cos_dist_sun, const float * cos_dist_zenith,
+	                   float * luminance, int n, int cor_optoma) const;
 
 private:
+	// Luminance at a position, the cosines being already clamped to [-1,1]
+	inline float computeLuminance(float cos_dist_moon, float cos_dist_sun, float cos_dist_zenith) const;
+
 	float air_mass_moon;	// Air mass for the Moon
 	float air_mass_sun;		// Air mass for the Sun
 	float mag_moon;			// Moon magnitude
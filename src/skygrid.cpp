@@ -288,4 +288,5 @@ void SkyGrid::draw(const Projector* prj) const
 			}
 		}
 	}
+	font->flush();
 }
@@ -26,6 +26,7 @@
 // "A Practical Analytic Model for Daylight" by A. J. Preetham, Peter Shirley and Brian Smits.
 
 #include <string>
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -250,6 +251,61 @@ void Skylight::get_xyY_Valuev(skylight_struct2& p) const
 	}
 }
 
+// Same computation as get_xyY_Valuev() on arrays of positions.
+// The positions are handled by batches of BATCH_SIZE : the arithmetic loops have no branch
+// so that the compiler can vectorize them, only the exp and acos calls stay one by one.
+void Skylight::get_xyY_Valuesv(const float * pos_x, const float * pos_y, const float * pos_z,
+                               float * color_x, float * color_y, float * color_Y, int n) const
+{
+	float cos_dist_sun[BATCH_SIZE];
+	float dist_sun[BATCH_SIZE];
+	float Fx[BATCH_SIZE], Fy[BATCH_SIZE], FY[BATCH_SIZE];
+	float Gx[BATCH_SIZE], Gy[BATCH_SIZE], GY[BATCH_SIZE];
+
+	for (int start = 0; start < n; start += BATCH_SIZE) {
+		const int count = std::min(BATCH_SIZE, n - start);
+		const float * px = pos_x + start;
+		const float * py = pos_y + start;
+		const float * pz = pos_z + start;
+
+		for (int i = 0; i < count; i++) {
+			float c = sun_pos[0]*px[i] + sun_pos[1]*py[i] + sun_pos[2]*pz[i];
+			cos_dist_sun[i] = std::min(std::max(c, -1.f), 1.f);
+		}
+
+		for (int i = 0; i < count; i++) {
+			dist_sun[i] = std::acos(cos_dist_sun[i]);
+			Gx[i] = std::exp(Dx*dist_sun[i]);
+			Gy[i] = std::exp(Dy*dist_sun[i]);
+			GY[i] = std::exp(DY*dist_sun[i]);
+			if (pz[i] > 0.f) {
+				float one_over_cos_zenith_angle = 1.f / pz[i];
+				Fx[i] = std::exp(Bx*one_over_cos_zenith_angle);
+				Fy[i] = std::exp(By*one_over_cos_zenith_angle);
+				FY[i] = std::exp(BY*one_over_cos_zenith_angle);
+			} else {
+				Fx[i] = 0.f;
+				Fy[i] = 0.f;
+				FY[i] = 0.f;
+			}
+		}
+
+		float * cx = color_x + start;
+		float * cy = color_y + start;
+		float * cY = color_Y + start;
+		for (int i = 0; i < count; i++) {
+			const float cos_dist_sun_q = cos_dist_sun[i]*cos_dist_sun[i];
+			float x = term_x * (1.f + Ax * Fx[i]) * (1.f + Cx * Gx[i] + Ex * cos_dist_sun_q);
+			float y = term_y * (1.f + Ay * Fy[i]) * (1.f + Cy * Gy[i] + Ey * cos_dist_sun_q);
+			float Y = term_Y * (1.f + AY * FY[i]) * (1.f + CY * GY[i] + EY * cos_dist_sun_q);
+			const bool negative = (Y < 0) | (x < 0) | (y < 0);
+			cx[i] = negative ? 0.25f : x;
+			cy[i] = negative ? 0.25f : y;
+			cY[i] = negative ? 0.f : Y;
+		}
+	}
+}
+
 // Return the current zenith color in xyY color system
 void Skylight::getZenithColor(float * v) const
 {
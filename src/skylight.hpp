@@ -55,6 +55,10 @@ public:
 	// The position vectors MUST be normalized, and the vertical z component is the third one
 	void setParamsv(const float * sun_pos, float turbidity, std::string planetName);
 	void get_xyY_Valuev(skylight_struct2& position) const;
+	// Same function on n positions given as separate coordinate arrays (structure of arrays)
+	// color_x, color_y and color_Y receive the 3 components of the CIE xyY color
+	void get_xyY_Valuesv(const float * pos_x, const float * pos_y, const float * pos_z,
+	                     float * color_x, float * color_y, float * color_Y, int n) const;
 
 private:
 	float thetas;			// angular distance between the zenith and the sun in radian
@@ -83,6 +87,9 @@ private:
 
 	float sun_pos[3];
 
+	// Number of positions computed together by get_xyY_Valuesv()
+	static const int BATCH_SIZE = 64;
+
 	// Compute CIE Y (luminance) for zenith in cd/m^2
 	inline void computeZenithLuminance(void);
 	// Compute CIE x and y color components
@@ -41,6 +41,10 @@ shaderProgram* SkyLine::shaderSkylineMVPDraw=nullptr;
 
 DataGL SkyLine::skylineDraw;
 
+shaderProgram* SkyLine::shaderSkylineProj=nullptr;
+UniformHandle SkyLine::uniformProjMat;
+UniformHandle SkyLine::uniformProjColor;
+
 SkyLine::SkyLine(double _radius, unsigned int _nb_segment) :
 	radius(_radius), nb_segment(_nb_segment), color(0.f, 0.f, 1.f), font(nullptr)
 {
@@ -51,6 +55,12 @@ SkyLine::~SkyLine()
 {
 	if (font) delete font;
 	font = nullptr;
+
+	if (staticLine.vao) {
+		glDeleteBuffers(1,&staticLine.pos);
+		glDeleteBuffers(1,&staticLine.scale);
+		glDeleteVertexArrays(1,&staticLine.vao);
+	}
 }
 
 void SkyLine::setFont(float font_size, const string& font_name)
@@ -102,6 +112,13 @@ void SkyLine::createShader()
 	shaderSkylineMVPDraw->setUniformLocation("Color");
 	shaderSkylineMVPDraw->setUniformLocation("MVP");
 
+//====================
+//======static lines projected by the GPU========
+	shaderSkylineProj = new shaderProgram();
+	shaderSkylineProj->init( "skylineProj.vert","skylineProj.geom","skylineProj.frag");
+	uniformProjMat = shaderSkylineProj->setUniformLocation("Mat");
+	uniformProjColor = shaderSkylineProj->setUniformLocation("Color");
+
 
 //======VAO
 	glGenVertexArrays(1,&skylineDraw.vao);
@@ -118,12 +135,68 @@ void SkyLine::deleteShader()
 	if (shaderSkylineDraw) delete shaderSkylineDraw;
 	if (shaderTropicDrawTick) delete shaderTropicDrawTick;
 	if (shaderSkylineMVPDraw) delete shaderSkylineMVPDraw;
+	if (shaderSkylineProj) delete shaderSkylineProj;
 
 	glDeleteBuffers(1,&skylineDraw.pos);
 	glDeleteVertexArrays(1,&skylineDraw.vao);
 }
 
 
+void SkyLine::addSegment(std::vector<float> &pos, std::vector<float> &tick, const Vec3f &a, const Vec3f &b, float tickl)
+{
+	pos.insert(pos.end(), {a[0], a[1], a[2], b[0], b[1], b[2]});
+	tick.insert(tick.end(), {0.f, tickl});
+}
+
+void SkyLine::buildStaticLine(const std::vector<float> &pos, const std::vector<float> &tick)
+{
+	if (staticLine.vao == 0) {
+		glGenVertexArrays(1,&staticLine.vao);
+		glBindVertexArray(staticLine.vao);
+		glGenBuffers(1,&staticLine.pos);
+		glGenBuffers(1,&staticLine.scale);
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+	} else
+		glBindVertexArray(staticLine.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER,staticLine.pos);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*pos.size(),pos.data(),GL_STATIC_DRAW);
+	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindBuffer(GL_ARRAY_BUFFER,staticLine.scale);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*tick.size(),tick.data(),GL_STATIC_DRAW);
+	glVertexAttribPointer(1,1,GL_FLOAT,GL_FALSE,0,NULL);
+
+	glBindVertexArray(0);
+	nbStaticVertices = tick.size();
+}
+
+void SkyLine::drawStaticLine(const Mat4f &mat, const Vec4f &Color)
+{
+	shaderSkylineProj->use();
+	shaderSkylineProj->setUniform(uniformProjMat, mat);
+	shaderSkylineProj->setUniform(uniformProjColor, Color);
+
+	glBindVertexArray(staticLine.vao);
+	glDrawArrays(GL_LINES, 0, nbStaticVertices);
+	glBindVertexArray(0);
+
+	shaderSkylineProj->unuse();
+}
+
+double SkyLine::segmentAngle(const Vec3d &pt1, const Vec3d &pt2)
+{
+	const double dx = pt2[0]-pt1[0];
+	const double dy = pt2[1]-pt1[1];
+	double angle = acos((pt1[1]-pt2[1])/sqrt(dx*dx+dy*dy));
+	if ( pt1[0] < pt2[0] ) {
+		angle *= -1;
+	}
+	return angle;
+}
+
+
 // -------------------- SKYLINE_POLE ---------------------------------------------
 
 SkyLine_Pole::SkyLine_Pole(SKY_LINE_POLE_TYPE _line_pole_type, double _radius, unsigned int _nb_segment): SkyLine(_radius, _nb_segment)
@@ -1009,6 +1082,12 @@ SkyLine_Meridian::SkyLine_Meridian(double _radius = 1., unsigned int _nb_segment
 		points[i] *= radius;
 		points[i].transfo4d(rotation);
 	}
+
+	// and along the circle at 70° drawn with internalNav
+	for (unsigned int j=0; j<nb_segment+1; ++j) {
+		Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, 70*C_PI/180., points[j+nb_segment+1]);
+		points[j+nb_segment+1] *= radius;
+	}
 }
 
 SkyLine_Meridian::~SkyLine_Meridian()
@@ -1017,6 +1096,55 @@ SkyLine_Meridian::~SkyLine_Meridian()
 	points = nullptr;
 }
 
+float SkyLine_Meridian::getLabel(unsigned int i, std::ostringstream &oss, double &angle) const
+{
+	int valdeg = 0;
+	float tickl = 5.0;
+	if (i<8*(nb_segment/36))
+		valdeg = (i+1)*10/(nb_segment/36);
+	else {
+		valdeg = 180-((i+1)*10/(nb_segment/36));
+		if (valdeg<-90) valdeg=-180-valdeg;
+		else angle += C_PI;
+	}
+
+	if ((i+1)%(nb_segment/36)==0) {
+		if (valdeg<=90) oss << valdeg << "°";
+		tickl = 5.0;
+	} else if ((i+1-5)%(nb_segment/36)== 0) {
+		tickl = 3.0;
+	} else {
+		tickl = 2.0;
+	}
+
+	if ( valdeg==90 ) {
+		angle += C_PI;
+	}
+	return tickl;
+}
+
+void SkyLine_Meridian::buildLine()
+{
+	std::vector<float> pos, tick;
+
+	for (unsigned int i=0; i<nb_segment; ++i) {
+		std::ostringstream oss;
+		double angle = 0.;
+		addSegment(pos, tick, points[i], points[i+1], getLabel(i, oss, angle));
+	}
+
+	if (internalNav) {
+		for (unsigned int i=0; i<nb_segment; ++i) {
+			// hour ticks
+			const float tickl = ((i+1) % ((nb_segment/36 )*2) == 0) ? 4.f : 0.f;
+			addSegment(pos, tick, points[nb_segment+1+i], points[nb_segment+1+i+1], tickl);
+		}
+	}
+
+	buildStaticLine(pos, tick);
+	builtInternalNav = internalNav;
+}
+
 void SkyLine_Meridian::draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory)
 {
 	if (!fader.getInterstate()) return;
@@ -1028,190 +1156,49 @@ void SkyLine_Meridian::draw(const Projector *prj,const Navigator *nav, const Tim
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	//~ prj->set_orthographic_projection();	// set 2D coordinate
+	// the circles never change in the local frame: only the ticks depend on internalNav
+	if (!hasStaticLine() || builtInternalNav != internalNav)
+		buildLine();
+	drawStaticLine(prj->getMatLocalToEye(), Color);
 
-	inclination=70*C_PI/180.;
-	for (unsigned int j=0; j<nb_segment+1; ++j) {
-		Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, inclination, points[j+nb_segment+1]);
-		points[j+nb_segment+1] *= radius;
-	}
+	if (!font) return;
 
+	// only the labelled segments are still projected by the CPU
+	const Mat4f MVP = prj->getMatProjectionOrtho2D();
 	for (unsigned int i=0; i<nb_segment; ++i) {
-		if (internalNav) {
-			inclination=70*C_PI/180.;
-
+		if (internalNav && (i+1) % ((nb_segment/36 )*2) == 0) {
 			if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
-				//~ glBegin (GL_LINES);
-				//~ glVertex2f(pt1[0],pt1[1]);
-				//~ glVertex2f(pt2[0],pt2[1]);
-				//~ glEnd();
-
-				vecDrawPos.push_back( pt1[0] );
-				vecDrawPos.push_back( pt1[1] );
-				vecDrawPos.push_back( pt2[0] );
-				vecDrawPos.push_back( pt2[1] );
-
-				// Draw hour ticks
-				if ((i+1) % ((nb_segment/36 )*2) == 0) {
-					//if((i)%((nb_segment/36)*2) == 0) {
-					//if ((i+1) % 2 == 0) {
-					//TODO: Center labels
-					const double dx = pt2[0]-pt1[0];
-					const double dy = pt2[1]-pt1[1];
-					const double dq = dx*dx+dy*dy;
-					double angle;
-					const double d = sqrt(dq);
-
-					angle = acos((pt1[1]-pt2[1])/d);
-					if ( pt1[0] < pt2[0] ) {
-						angle *= -1;
-					}
-
-					// draw text label
-					std::ostringstream oss;
-					float tickl = 4.0;
-
-					double res;
-					if (i<18*(nb_segment/36)) res = 180-(i+1)/((nb_segment/36.0))*10;
-					if (i>18*(nb_segment/36)) res = 540-(i+1)/((nb_segment/36.0))*10;
-					if ((i+1)%((nb_segment/36)*2) == 0) {
-						oss << res << "°";
-						tickl = 4.0;
-					} else if ((i+2-5)%((nb_segment/36)*2) == 0) {
-						tickl = 2.0;
-					} else tickl = 1.0;
-
-					Mat4f MVP = prj->getMatProjectionOrtho2D();
-					TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-					TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-
-					//~ glPushMatrix();
-					//~ glTranslatef(pt2[0],pt2[1],0);
-					//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-
-					TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-					TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-
-					//~ glBegin (GL_LINES);
-					//~ glVertex2f(-tickl,0);
-					//~ glVertex2f(tickl,0);
-					//~ glEnd();
-					//~ glPopMatrix();
-
-					tmp = TRANSFO * Vec4f(-tickl,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-					tmp = TRANSFO * Vec4f(tickl,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-
-					//~ glEnable(GL_TEXTURE_2D);
+				//TODO: Center labels
+				const double angle = segmentAngle(pt1, pt2);
 
+				// draw text label
+				std::ostringstream oss;
+				double res = 0.;
+				if (i<18*(nb_segment/36)) res = 180-(i+1)/((nb_segment/36.0))*10;
+				if (i>18*(nb_segment/36)) res = 540-(i+1)/((nb_segment/36.0))*10;
+				oss << res << "°";
 
-					if (font) font->print(2,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
-					//~ glPopMatrix();
-					//~ glDisable(GL_TEXTURE_2D);
-				}
+				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
+				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
+				font->print(2,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
 			}
 		}
 
+		if ((i+1)%(nb_segment/36) != 0)
+			continue;
 		if ((prj->*proj_func)(points[i], pt1) && (prj->*proj_func)(points[i+1], pt2) ) {
-			const double dx = pt1[0]-pt2[0];
-			const double dy = pt1[1]-pt2[1];
-			const double dq = dx*dx+dy*dy;
-
-			double angle;
-
-			// TODO: allow for other numbers of meridians and parallels without
-			// screwing up labels?
-
-			//~ glBegin (GL_LINES);
-			//~ glVertex2f(pt1[0],pt1[1]);
-			//~ glVertex2f(pt2[0],pt2[1]);
-			//~ glEnd();
-			vecDrawPos.push_back( pt1[0] );
-			vecDrawPos.push_back( pt1[1] );
-			vecDrawPos.push_back( pt2[0] );
-			vecDrawPos.push_back( pt2[1] );
-
-			// Draw text labels and ticks on meridian
-			const double d = sqrt(dq);
-
-			angle = acos((pt1[1]-pt2[1])/d);
-			if ( pt1[0] < pt2[0] ) {
-				angle *= -1;
-			}
-
-			// draw text label
+			// Draw text labels on meridian
+			double angle = segmentAngle(pt1, pt2);
 			std::ostringstream oss;
-			int valdeg = 0;
-			float tickl = 5.0;
-			if (i<8*(nb_segment/36))
-				valdeg = (i+1)*10/(nb_segment/36);
-			else {
-				valdeg = 180-((i+1)*10/(nb_segment/36));
-				if (valdeg<-90) valdeg=-180-valdeg;
-				else angle += C_PI;
-			}
-
-			if ((i+1)%(nb_segment/36)==0) {
-				if (valdeg<=90) oss << valdeg << "°";
-				tickl = 5.0;
-			} else if ((i+1-5)%(nb_segment/36)== 0) {
-				tickl = 3.0;
-			} else {
-				tickl = 2.0;
-			}
+			getLabel(i, oss, angle);
+			if (oss.str().empty())
+				continue;
 
-			if ( valdeg==90 ) {
-				angle += C_PI;
-			}
-
-			//~ glPushMatrix();
-			//~ glTranslatef(pt2[0],pt2[1],0);
-			//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-
-			Mat4f MVP = prj->getMatProjectionOrtho2D();
 			TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
 			TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-
-
-			//~ glBegin (GL_LINES);
-			//~ glVertex2f(-tickl,0);
-			//~ glVertex2f(tickl,0);
-			//~ glEnd();
-			//~ glPopMatrix();
-
-			tmp = TRANSFO * Vec4f(-tickl,0.0,0.0,1.0);
-			vecDrawPos.push_back( tmp[0] );
-			vecDrawPos.push_back( tmp[1] );
-			tmp = TRANSFO * Vec4f(tickl,0.0,0.0,1.0);
-			vecDrawPos.push_back( tmp[0] );
-			vecDrawPos.push_back( tmp[1] );
-
-
-			//~ glEnable(GL_TEXTURE_2D);
-			if (font) font->print(2,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
-			//~ glDisable(GL_TEXTURE_2D);
+			font->print(2,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
 		}
 	}
-	//~ prj->reset_perspective_projection();
-
-	shaderSkylineDraw->use();
-	shaderSkylineDraw->setUniform("Color",Color);
-
-	glBindVertexArray(skylineDraw.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,skylineDraw.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecDrawPos.size(),vecDrawPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-	//~ glEnableVertexAttribArray(0); //layout 0
-
-	glDrawArrays(GL_LINES, 0 ,vecDrawPos.size()/2);
-
-	glUseProgram(0);
-
-	vecDrawPos.clear();
 }
 
 
@@ -1244,6 +1231,12 @@ SkyLine_Equator::SkyLine_Equator(SKY_LINE_EQUATOR_LINE _line_equator_type, doubl
 		points[i] *= radius;
 		points[i].transfo4d(rotation);
 	}
+
+	// and along the circle at 70° drawn with internalNav
+	for (unsigned int j=0; j<nb_segment+1; ++j) {
+		Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, 70*C_PI/180., points[j+nb_segment+1]);
+		points[j+nb_segment+1] *= radius;
+	}
 }
 
 SkyLine_Equator::~SkyLine_Equator()
@@ -1252,6 +1245,61 @@ SkyLine_Equator::~SkyLine_Equator()
 	points = nullptr;
 }
 
+float SkyLine_Equator::getLabel(unsigned int i, std::ostringstream &oss) const
+{
+	int tickl = 3;
+
+	if ((internalNav) && (line_equator_type != GALACTIC_EQUATOR)) {
+		//~ int divs = (15.f/(360.f/(nb_segment/2)*15));
+		double num = 360.0f/(nb_segment/2.f)*(nb_segment/2.f-(i+1)/2.f);
+		if (fmod(num,15) == 0) {
+			tickl = 8;
+			if ((i+1)/2 == 24*4) oss << " 0h   ";
+			else {
+				if ((i+1)/(2*4)<10) oss << " ";
+				oss << (i+1)/(2*4) << "h   ";
+			}
+			oss << num << "°";
+		} else if (fmod(num,7.5) == 0) {
+			oss << num << "°";
+			tickl = 4;
+		} else tickl = 2;
+		// only the hours have a tick
+		if ((i+1) % (2*4) != 0)
+			tickl = 0;
+	} else {
+		if (line_equator_type == GALACTIC_EQUATOR)
+			oss << ((i+37)%72)*5 << "°";
+		else if ((i+1)/2 == 24*4) oss << "0h";
+		else oss << (i+1)/(2*4) << "h";
+	}
+	return tickl;
+}
+
+void SkyLine_Equator::buildLine()
+{
+	std::vector<float> pos, tick;
+	std::ostringstream oss;
+
+	for (unsigned int i=0; i<nb_segment; ++i) {
+		float tickl = 0.f;
+		if ((i+1) % ((nb_segment/48)*2) == 0)
+			tickl = getLabel(i, oss);
+		addSegment(pos, tick, points[i], points[i+1], tickl);
+	}
+
+	if (internalNav && line_equator_type == EQUATOR) {
+		for (unsigned int i=0; i<nb_segment; ++i) {
+			// hour ticks
+			const float tickl = ((i+1) % ((nb_segment/48)*2) == 0) ? 4.f : 0.f;
+			addSegment(pos, tick, points[nb_segment+1+i], points[nb_segment+1+i+1], tickl);
+		}
+	}
+
+	buildStaticLine(pos, tick);
+	builtInternalNav = internalNav;
+}
+
 void SkyLine_Equator::draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory)
 {
 	if (!fader.getInterstate()) return;
@@ -1263,193 +1311,61 @@ void SkyLine_Equator::draw(const Projector *prj,const Navigator *nav, const Time
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	//~ prj->set_orthographic_projection();	// set 2D coordinate
-
-	if (line_equator_type == EQUATOR) {
-		inclination=70*C_PI/180.;
-		for (unsigned int j=0; j<nb_segment+1; ++j) {
-			Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, inclination, points[j+nb_segment+1]);
-			points[j+nb_segment+1] *= radius;
-		}
-	}
-	for (unsigned int i=0; i<nb_segment; ++i) {
-		if (internalNav) {
-			inclination=70*C_PI/180.;
-
-			if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
-				//~ glBegin (GL_LINES);
-				//~ glVertex2f(pt1[0],pt1[1]);
-				//~ glVertex2f(pt2[0],pt2[1]);
-				//~ glEnd();
-				vecDrawPos.push_back( pt1[0] );
-				vecDrawPos.push_back( pt1[1] );
-				vecDrawPos.push_back( pt2[0] );
-				vecDrawPos.push_back( pt2[1] );
-
-				// Draw hour ticks
-				if ((i+1) % ((nb_segment/48)*2) == 0) {
-					//if((i)%((nb_segment/36)*2) == 0) {
-					//if ((i+1) % 2 == 0) {
-					//TODO: Center labels
-					const double dx = pt2[0]-pt1[0];
-					const double dy = pt2[1]-pt1[1];
-					const double dq = dx*dx+dy*dy;
-					double angle;
-					const double d = sqrt(dq);
-
-					angle = acos((pt1[1]-pt2[1])/d);
-					if ( pt1[0] < pt2[0] ) {
-						angle *= -1;
-					}
+	// the circles never change in their frame: only the ticks depend on internalNav
+	if (!hasStaticLine() || builtInternalNav != internalNav)
+		buildLine();
 
-					// draw text label
-					std::ostringstream oss;
-					float tickl = 4.0;
-					if (((i)/(nb_segment/24)+1)%24>9)
-						oss << ((i)/(nb_segment/24)+1)%24 << "h   " << (24-((i)/(nb_segment/24)+1)%24)*15 << "°";
-					else
-						oss << " " << ((i)/(nb_segment/24)+1)%24 << "h   " << (24-((i)/(nb_segment/24)+1)%24)*15 << "°";
+	if (line_equator_type == GALACTIC_EQUATOR)
+		drawStaticLine(prj->getMatEarthEquToEye()* Mat4f::zrotation(14.8595*(C_PI/180))*Mat4f::yrotation(-61.8717*(C_PI/180))*Mat4f::zrotation(55.5*(C_PI/180)), Color);
+	else
+		drawStaticLine(prj->getMatEarthEquToEye(), Color);
 
-					//~ glPushMatrix();
-					//~ glTranslatef(pt2[0],pt2[1],0);
-					//~ glRotatef(180+angle*180./C_PI,0,0,-1);
+	if (!font) return;
 
-					Mat4f MVP = prj->getMatProjectionOrtho2D();
-					TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-					TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
+	// only the labelled segments are still projected by the CPU
+	const Mat4f MVP = prj->getMatProjectionOrtho2D();
+	for (unsigned int i=0; i<nb_segment; ++i) {
+		if ((i+1) % ((nb_segment/48)*2) != 0)
+			continue;
 
-					//~ glBegin (GL_LINES);
-					//~ glVertex2f(-tickl,0);
-					//~ glVertex2f(tickl,0);
-					//~ glEnd();
-					tmp = TRANSFO * Vec4f(-tickl,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-					tmp = TRANSFO * Vec4f( tickl,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
+		if (internalNav && line_equator_type == EQUATOR) {
+			if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
+				//TODO: Center labels
+				const double angle = segmentAngle(pt1, pt2);
 
-					//~ glEnable(GL_TEXTURE_2D);
+				// draw text label
+				std::ostringstream oss;
+				if (((i)/(nb_segment/24)+1)%24>9)
+					oss << ((i)/(nb_segment/24)+1)%24 << "h   " << (24-((i)/(nb_segment/24)+1)%24)*15 << "°";
+				else
+					oss << " " << ((i)/(nb_segment/24)+1)%24 << "h   " << (24-((i)/(nb_segment/24)+1)%24)*15 << "°";
 
-					if (font) font->print(-24,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
-					//~ glPopMatrix();
-					//~ glDisable(GL_TEXTURE_2D);
-				}
+				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
+				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
+				font->print(-24,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
 			}
 		}
 
+		if ((i+1)%2 != 0)
+			continue;
 		if ((prj->*proj_func)(points[i], pt1) && (prj->*proj_func)(points[i+1], pt2) ) {
-			const double dx = pt1[0]-pt2[0];
-			const double dy = pt1[1]-pt2[1];
-			const double dq = dx*dx+dy*dy;
-
-			double angle;
-
 			// TODO: allow for other numbers of meridians and parallels without
 			// screwing up labels?
+			const double angle = segmentAngle(pt1, pt2);
 
-			//~ glBegin (GL_LINES);
-			//~ glVertex2f(pt1[0],pt1[1]);
-			//~ glVertex2f(pt2[0],pt2[1]);
-			//~ glEnd();
-			vecDrawPos.push_back( pt1[0] );
-			vecDrawPos.push_back( pt1[1] );
-			vecDrawPos.push_back( pt2[0] );
-			vecDrawPos.push_back( pt2[1] );
+			// draw text label
+			std::ostringstream oss;
+			getLabel(i, oss);
 
-			// Draw text labels and ticks on equator
-			if ((i+1) % ((nb_segment/48)*2) == 0) {
-				const double d = sqrt(dq);
-				angle = acos((pt1[1]-pt2[1])/d);
-				if ( pt1[0] < pt2[0] ) {
-					angle *= -1;
-				}
-				// draw text label
-				std::ostringstream oss;
-				int tickl = 3;
-
-				if ((internalNav) && (line_equator_type != GALACTIC_EQUATOR)) {
-					//~ int divs = (15.f/(360.f/(nb_segment/2)*15));
-					double num = 360.0f/(nb_segment/2.f)*(nb_segment/2.f-(i+1)/2.f);
-					if (fmod(num,15) == 0) {
-						tickl = 8;
-						if ((i+1)/2 == 24*4) oss << " 0h   ";
-						else {
-							if ((i+1)/(2*4)<10) oss << " ";
-							oss << (i+1)/(2*4) << "h   ";
-						}
-						oss << num << "°";
-					} else if (fmod(num,7.5) == 0) {
-						oss << num << "°";
-						tickl = 4;
-					} else tickl = 2;
-				} else {
-					if (line_equator_type == GALACTIC_EQUATOR)
-						oss << ((i+37)%72)*5 << "°";
-					else if ((i+1)/2 == 24*4) oss << "0h";
-					else oss << (i+1)/(2*4) << "h";
-				}
-				//~ glPushMatrix();
-				//~ glTranslatef(pt2[0],pt2[1],0);
-				//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-				//~ glPopMatrix();
-
-				Mat4f MVP = prj->getMatProjectionOrtho2D();
-				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-
-				if ((internalNav) && (line_equator_type != GALACTIC_EQUATOR)) {
-					if ((i+1) % (2*4) == 0) {
-						//~ glBegin (GL_LINES);
-						//~ glVertex2f(-tickl,0);
-						//~ glVertex2f(tickl,0);
-						//~ glEnd();
-						tmp = TRANSFO * Vec4f(-tickl,0.0,0.0,1.0);
-						vecDrawPos.push_back( tmp[0] );
-						vecDrawPos.push_back( tmp[1] );
-						tmp = TRANSFO * Vec4f( tickl,0.0,0.0,1.0);
-						vecDrawPos.push_back( tmp[0] );
-						vecDrawPos.push_back( tmp[1] );
-					}
-				} else {
-					//~ glBegin (GL_LINES);
-					//~ glVertex2f(-tickl,0);
-					//~ glVertex2f(tickl,0);
-					//~ glEnd();
-					tmp = TRANSFO * Vec4f(-tickl,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-					tmp = TRANSFO * Vec4f( tickl,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-				}
-				//~ glEnable(GL_TEXTURE_2D);
-
-				if (((i+1)%2==0) && font && ((internalNav) && (line_equator_type != GALACTIC_EQUATOR))) font->print(-26,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
-				if (((i+1)%2==0) && font && !((internalNav) && (line_equator_type != GALACTIC_EQUATOR))) font->print(2,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
+			TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
+			TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
 
-				//~ glDisable(GL_TEXTURE_2D);
-			}
+			if ((internalNav) && (line_equator_type != GALACTIC_EQUATOR))
+				font->print(-26,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
+			else
+				font->print(2,-2,oss.str(), Color, MVP*TRANSFO ,1,1);
 		}
 	}
-	//~ prj->reset_perspective_projection();
-
-
-	shaderSkylineDraw->use();
-	shaderSkylineDraw->setUniform("Color",Color);
-	glBindVertexArray(skylineDraw.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,skylineDraw.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecDrawPos.size(),vecDrawPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-	//~ glEnableVertexAttribArray(0); //layout 0
-
-	//~ for (unsigned int i = 0; i < vecDrawPos.size()/2 ; i++)
-	glDrawArrays(GL_LINES, 0 ,vecDrawPos.size()/2);
-
-	glUseProgram(0);
-
-	vecDrawPos.clear();
 }
 
 
@@ -1503,6 +1419,28 @@ SkyLine_Tropic::~SkyLine_Tropic()
 //~ }
 
 
+void SkyLine_Tropic::buildLine(double tilt)
+{
+	inclination=tilt*C_PI/180.;
+	for (unsigned int j=0; j<nb_segment+1; ++j) {
+		Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, inclination, points[j+nb_segment+1]);
+		points[j+nb_segment+1] *= radius;
+		Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, -inclination, points[j+2*nb_segment+2]);
+		points[j+2*nb_segment+2] *= radius;
+	}
+
+	std::vector<float> pos, tick;
+	for (unsigned int i=0; i<nb_segment; ++i) {
+		// equator and northern tropic have a tick every 4 segments
+		const float tickl = ((i+1) % 4 == 0) ? 3.f : 0.f;
+		addSegment(pos, tick, points[i], points[i+1], tickl);
+		addSegment(pos, tick, points[nb_segment+1+i], points[nb_segment+1+i+1], tickl);
+		addSegment(pos, tick, points[2*nb_segment+2+i], points[2*nb_segment+2+i+1], 0.f);
+	}
+	buildStaticLine(pos, tick);
+	builtTilt = tilt;
+}
+
 void SkyLine_Tropic::draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory)
 {
 	if (!fader.getInterstate()) return;
@@ -1522,167 +1460,11 @@ void SkyLine_Tropic::draw(const Projector *prj,const Navigator *nav, const TimeM
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	//~ prj->set_orthographic_projection();	// set 2D coordinate
-	for (unsigned int i=0; i<nb_segment; ++i) {
-		inclination=observatory->getHomeBody()->getAxialTilt()*C_PI/180.;
-		//~ inclination=observatory->getHomePlanet()->getAxialTilt()*C_PI/180.;
-		for (unsigned int j=0; j<nb_segment+1; ++j) {
-			Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, inclination, points[j+nb_segment+1]);
-			points[j+nb_segment+1] *= radius;
-			Utility::spheToRect((float)j/(nb_segment)*2.f*C_PI, -inclination, points[j+2*nb_segment+2]);
-			points[j+2*nb_segment+2] *= radius;
-		}
-
-
-		// Draw equator
-		if ((prj->*proj_func)(points[i], pt1) && (prj->*proj_func)(points[i+1], pt2) ) {
-			//~ glBegin (GL_LINES);
-			//~ glVertex2f(pt1[0],pt1[1]);
-			//~ glVertex2f(pt2[0],pt2[1]);
-			//~ glEnd();
-			vecDrawPos.push_back( pt1[0] );
-			vecDrawPos.push_back( pt1[1] );
-			vecDrawPos.push_back( pt2[0] );
-			vecDrawPos.push_back( pt2[1] );
-
-			if((i+1) % 4 == 0) {
-				const double dx = pt1[0]-pt2[0];
-				const double dy = pt1[1]-pt2[1];
-				const double dq = dx*dx+dy*dy;
-				double angle;
-				const double d = sqrt(dq);
-
-				angle = acos((pt1[1]-pt2[1])/d);
-				if( pt1[0] < pt2[0] ) {
-					angle *= -1;
-				}
-
-				//~ glPushMatrix();
-				//~ glTranslatef(pt2[0],pt2[1],0);
-				//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-
-				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-				tmp = TRANSFO * Vec4f(-3.0,0.0,0.0,1.0);
-				vecDrawPos.push_back( tmp[0] );
-				vecDrawPos.push_back( tmp[1] );
-				tmp = TRANSFO * Vec4f( 3.0,0.0,0.0,1.0);
-				vecDrawPos.push_back( tmp[0] );
-				vecDrawPos.push_back( tmp[1] );
-				//~ glBegin (GL_LINES);
-				//~ glVertex2f(-3,0);
-				//~ glVertex2f(3,0);
-				//~ glEnd();
-
-				//~ glPopMatrix();
-			}
-		}
-
-		if((prj->*proj_func)(points[nb_segment+1+i], pt1) && (prj->*proj_func)(points[nb_segment+1+i+1], pt2)) {
-
-			//~ glBegin (GL_LINES);
-			//~ glVertex2f(pt1[0],pt1[1]);
-			//~ glVertex2f(pt2[0],pt2[1]);
-			//~ glEnd();
-			vecDrawPos.push_back( pt1[0] );
-			vecDrawPos.push_back( pt1[1] );
-			vecDrawPos.push_back( pt2[0] );
-			vecDrawPos.push_back( pt2[1] );
-
-			if((i+1) % 4 == 0) {
-				const double dx = pt1[0]-pt2[0];
-				const double dy = pt1[1]-pt2[1];
-				const double dq = dx*dx+dy*dy;
-				double angle;
-				const double d = sqrt(dq);
-
-				angle = acos((pt1[1]-pt2[1])/d);
-				if( pt1[0] < pt2[0] ) {
-					angle *= -1;
-				}
-
-				//~ glPushMatrix();
-				//~ glTranslatef(pt2[0],pt2[1],0);
-				//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-				tmp = TRANSFO * Vec4f(-3.0,0.0,0.0,1.0);
-				vecDrawPos.push_back( tmp[0] );
-				vecDrawPos.push_back( tmp[1] );
-				tmp = TRANSFO * Vec4f( 3.0,0.0,0.0,1.0);
-				vecDrawPos.push_back( tmp[0] );
-				vecDrawPos.push_back( tmp[1] );
-
-				//~ glBegin (GL_LINES);
-				//~ glVertex2f(-3,0);
-				//~ glVertex2f(3,0);
-				//~ glEnd();
-				//~ glPopMatrix();
-			}
-
-			if( (prj->*proj_func)(points[2*nb_segment+2+i], pt1) && (prj->*proj_func)(points[2*nb_segment+2+i+1], pt2)) {
-				//~ glBegin (GL_LINES);
-				//~ glVertex2f(pt1[0],pt1[1]);
-				//~ glVertex2f(pt2[0],pt2[1]);
-				//~ glEnd();
-				vecDrawPos.push_back( pt1[0] );
-				vecDrawPos.push_back( pt1[1] );
-				vecDrawPos.push_back( pt2[0] );
-				vecDrawPos.push_back( pt2[1] );
-			}
-
-			// Draw hour ticks
-			if ((i+1) % 4 == 0) { //drawTick( pt1, pt2);
-				const double dx = pt1[0]-pt2[0];
-				const double dy = pt1[1]-pt2[1];
-				const double dq = dx*dx+dy*dy;
-
-				double angle;
-
-				const double d = sqrt(dq);
-
-				angle = acos((pt1[1]-pt2[1])/d);
-				if ( pt1[0] < pt2[0] ) {
-					angle *= -1;
-				}
-
-				//~ glPushMatrix();
-				//~ glTranslatef(pt2[0],pt2[1],0);
-				//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-				tmp = TRANSFO * Vec4f(-3.0,0.0,0.0,1.0);
-				vecDrawPos.push_back( tmp[0] );
-				vecDrawPos.push_back( tmp[1] );
-				tmp = TRANSFO * Vec4f( 3.0,0.0,0.0,1.0);
-				vecDrawPos.push_back( tmp[0] );
-				vecDrawPos.push_back( tmp[1] );
-				//~ glBegin (GL_LINES);
-				//~ glVertex2f(-3,0);
-				//~ glVertex2f(3,0);
-				//~ glEnd();
-
-				//~ glPopMatrix();
-			}
-		}
-	}
-	//~ prj->reset_perspective_projection();
-
-	shaderSkylineDraw->use();
-	shaderSkylineDraw->setUniform("Color",Color);
-
-	glBindVertexArray(skylineDraw.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,skylineDraw.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecDrawPos.size(),vecDrawPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-	//~ glEnableVertexAttribArray(0); //layout 0
-
-	glDrawArrays(GL_LINES, 0 ,vecDrawPos.size()/2);
-
-	glUseProgram(0);
-
-	vecDrawPos.clear();
+	// the tropics only move when the home planet changes
+	const double tilt = observatory->getHomeBody()->getAxialTilt();
+	if (!hasStaticLine() || tilt != builtTilt)
+		buildLine(tilt);
+	drawStaticLine(prj->getMatEarthEquToEye(), Color);
 }
 
 
@@ -1700,6 +1482,44 @@ SkyLine_Ecliptic::~SkyLine_Ecliptic()
 {
 }
 
+float SkyLine_Ecliptic::getTick(unsigned int i)
+{
+	//                31 	     28 	31 	   30 	       31 	  30 	     31 	31 	   30 	      31         30
+	if ((i==1) || (i==32) || (i==60) || (i==91) || (i==121) || (i==152) || (i==182) || (i==213) || (i==244) || (i==274) || (i==305) || (i==335)) {
+		return 9.0;
+	} else if ((i==6)|| (i==11) || (i==16) || (i==21) || (i==26)
+	           || (i==37) || (i==42) || (i==47) || (i==52) || (i==57)
+	           || (i==65) || (i==70) || (i==75) || (i==80) || (i==85)
+	           || (i==96) || (i==101) || (i==106) || (i==111) || (i==116)
+	           || (i==126) || (i==131) || (i==136) || (i==141) || (i==146)
+	           || (i==157) || (i==162) || (i==167) || (i==172) || (i==177)
+	           || (i==187) || (i==192) || (i==197) || (i==202) || (i==207)
+	           || (i==218) || (i==223) || (i==228) || (i==233) || (i==238)
+	           || (i==249) || (i==254) || (i==259) || (i==264) || (i==269)
+	           || (i==279) || (i==284) || (i==289) || (i==294) || (i==299)
+	           || (i==310) || (i==315) || (i==320) || (i==325) || (i==330)
+	           || (i==340) || (i==345) || (i==350) || (i==355) || (i==360)) {
+		return 6.0;
+	}
+	return 3.0;
+}
+
+void SkyLine_Ecliptic::buildLine(double corr, bool labels)
+{
+	std::vector<float> pos, tick;
+	Vec3f prev(radius*cos(corr),radius*sin(corr),0.0);
+	for (unsigned int i=1; i<365+1; ++i) {
+		const double phi = corr+2*i*C_PI/365;
+		Vec3f point(radius*cos(phi),radius*sin(phi),0.0);
+		// To do: graduate in ° from vernal point
+		addSegment(pos, tick, prev, point, labels ? getTick(i) : 0.f);
+		prev = point;
+	}
+	buildStaticLine(pos, tick);
+	builtCorr = corr;
+	builtLabels = labels;
+}
+
 void SkyLine_Ecliptic::draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory)
 {
 	if (!fader.getInterstate()) return;
@@ -1715,8 +1535,6 @@ void SkyLine_Ecliptic::draw(const Projector *prj,const Navigator *nav, const Tim
 	StateGL::enable(GL_BLEND);
 	StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal transparency mode
 
-	//~ prj->set_orthographic_projection();	// set 2D coordinate
-
 	// special drawing of the ecliptic line
 	//~ Mat4d m = observatory->getHomePlanet()->getRotEquatorialToVsop87().transpose();
 	Mat4d m = observatory->getRotEquatorialToVsop87().transpose();
@@ -1727,156 +1545,48 @@ void SkyLine_Ecliptic::draw(const Projector *prj,const Navigator *nav, const Tim
 	// start labeling from the vernal equinox
 	//	  const double corr = draw_labels ? (atan2(m.r[4],m.r[0]) - 3*C_PI/6) : 0.0;
 	const double corr = draw_labels ? (atan2(m.r[4],m.r[0]) - 2.68*C_PI/6) : 0.0;
-	Vec3d point(radius*cos(corr),radius*sin(corr),0.0);
-	point.transfo4d(m);
-	bool prev_on_screen = prj->projectEarthEqu(point,pt1);
-
-	for (unsigned int i=1; i<365+1; ++i) {
-		const double phi = corr+2*i*C_PI/365;
-		Vec3d point(radius*cos(phi),radius*sin(phi),0.0);
-		point.transfo4d(m);
-		const bool on_screen = prj->projectEarthEqu(point,pt2);
-		if (on_screen && prev_on_screen) {
-			const double dx = pt2[0]-pt1[0];
-			const double dy = pt2[1]-pt1[1];
-			const double dq = dx*dx+dy*dy;
-
-			//~ glBegin (GL_LINES);
-			//~ glVertex2f(pt2[0],pt2[1]);
-			//~ glVertex2f(pt1[0],pt1[1]);
-			//~ glEnd();
-
-			vecDrawPos.push_back( pt1[0] );
-			vecDrawPos.push_back( pt1[1] );
-			vecDrawPos.push_back( pt2[0] );
-			vecDrawPos.push_back( pt2[1] );
-
-			//if(i % 4 == 0) {
-			const double d = sqrt(dq);
-			double angle;
-
-			angle = acos((pt1[1]-pt2[1])/d);
-			if ( pt1[0] < pt2[0] ) {
-				angle *= -1;
-			}
-
-			//~ glPushMatrix();
-			//~ glTranslatef(pt2[0],pt2[1],0);
-			//~ glRotatef(180+angle*180./C_PI,0,0,-1);
-			//~ glBegin (GL_LINES);
-
-			TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-			TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI-angle );
-
-			if (draw_labels) {
-				//                31 	     28 	31 	   30 	       31 	  30 	     31 	31 	   30 	      31         30
-				if ((i==1) || (i==32) || (i==60) || (i==91) || (i==121) || (i==152) || (i==182) || (i==213) || (i==244) || (i==274) || (i==305) || (i==335)) {
-					//~ printf("9\n");
-					//~ glVertex2f(-9,0);
-					tmp = TRANSFO * Vec4f(-9.0,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-					//~ glVertex2f(9,0);
-					tmp = TRANSFO * Vec4f(9.0,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-				} else if ((i==6)|| (i==11) || (i==16) || (i==21) || (i==26)
-				           || (i==37) || (i==42) || (i==47) || (i==52) || (i==57)
-				           || (i==65) || (i==70) || (i==75) || (i==80) || (i==85)
-				           || (i==96) || (i==101) || (i==106) || (i==111) || (i==116)
-				           || (i==126) || (i==131) || (i==136) || (i==141) || (i==146)
-				           || (i==157) || (i==162) || (i==167) || (i==172) || (i==177)
-				           || (i==187) || (i==192) || (i==197) || (i==202) || (i==207)
-				           || (i==218) || (i==223) || (i==228) || (i==233) || (i==238)
-				           || (i==249) || (i==254) || (i==259) || (i==264) || (i==269)
-				           || (i==279) || (i==284) || (i==289) || (i==294) || (i==299)
-				           || (i==310) || (i==315) || (i==320) || (i==325) || (i==330)
-				           || (i==340) || (i==345) || (i==350) || (i==355) || (i==360)) {
-					//~ glVertex2f(-6,0);
-					//~ glVertex2f(6,0);
-					//~ printf("6\n");
-					tmp = TRANSFO * Vec4f(-6.0,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-					tmp = TRANSFO * Vec4f(6.0,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-				} else {
-					//~ glVertex2f(-3,0);
-					//~ glVertex2f(3,0);
-					//~ printf("3\n");
-					tmp = TRANSFO * Vec4f(-3.0,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-					tmp = TRANSFO * Vec4f(3.0,0.0,0.0,1.0);
-					vecDrawPos.push_back( tmp[0] );
-					vecDrawPos.push_back( tmp[1] );
-				}
-			} // End draw ticks - To do: graduate in ° from vernal point
-			//~ glEnd();
-			//~ glPopMatrix();
-			//}
 
-			if (draw_labels && (i+15) % 30 == 3) {
+	// the circle is built in the frame of the ecliptic, the ticks follow the
+	// vernal equinox which only drifts with the precession
+	if (!hasStaticLine() || draw_labels != builtLabels || fabs(corr-builtCorr) > 1e-6)
+		buildLine(corr, draw_labels);
+	drawStaticLine(prj->getMatEarthEquToEye() * m.convert(), Color);
 
-				const double d = sqrt(dq);
-				double angle = acos((pt1[1]-pt2[1])/d);
-				if ( pt1[0] < pt2[0] ) {
-					angle *= -1;
-				}
+	if (!draw_labels) return;
 
-				// draw text label
-				std::ostringstream oss;
+	// only the labelled segments are still projected by the CPU
+	for (unsigned int i=1; i<365+1; ++i) {
+		if ((i+15) % 30 != 3)
+			continue;
 
-				// TODO: center labels
+		Vec3d point(radius*cos(corr+2*(i-1)*C_PI/365),radius*sin(corr+2*(i-1)*C_PI/365),0.0);
+		point.transfo4d(m);
+		if (!prj->projectEarthEqu(point,pt1))
+			continue;
+		point = Vec3d(radius*cos(corr+2*i*C_PI/365),radius*sin(corr+2*i*C_PI/365),0.0);
+		point.transfo4d(m);
+		if (!prj->projectEarthEqu(point,pt2))
+			continue;
 
-				// TODO cahnger cette condition
-				//~ if (observatory->getHomePlanet()->getEnglishName()=="Earth") {
-				if (observatory->getHomePlanetEnglishName()=="Earth") {
-					float degree = i-84.5;
-					if (degree < 0) degree += 360;
-					if (internalNav)
-						oss <<  month[ (i+15)/30 ] << " " << degree << "°";
-					else
-						oss << month[ (i+15)/30 ];
-				}
+		const double angle = segmentAngle(pt1, pt2);
 
-				//~ glPushMatrix();
-				//~ glTranslatef(pt2[0],pt2[1],0);
-				//~ glRotatef(-90+angle*180./C_PI,0,0,-1);
+		// draw text label
+		std::ostringstream oss;
 
-				Mat4f MVP = prj->getMatProjectionOrtho2D();
-				TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
-				TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI_2-angle );
+		// TODO: center labels
+		float degree = i-84.5;
+		if (degree < 0) degree += 360;
+		if (internalNav)
+			oss <<  month[ (i+15)/30 ] << " " << degree << "°";
+		else
+			oss << month[ (i+15)/30 ];
 
-				//~ glEnable(GL_TEXTURE_2D);
+		Mat4f MVP = prj->getMatProjectionOrtho2D();
+		TRANSFO= Mat4f::translation( Vec3f(pt2[0],pt2[1],0) );
+		TRANSFO = TRANSFO*Mat4f::rotation( Vec3f(0,0,-1), C_PI_2-angle );
 
-				font->print(0,-10,oss.str(), Color, MVP*TRANSFO ,1,1);
-				//~ glPopMatrix();
-				//~ glDisable(GL_TEXTURE_2D);
-			}
-		}
-		prev_on_screen = on_screen;
-		pt1 = pt2;
+		font->print(0,-10,oss.str(), Color, MVP*TRANSFO ,1,1);
 	}
-	//~ prj->reset_perspective_projection();
-
-
-	shaderSkylineDraw->use();
-	shaderSkylineDraw->setUniform("Color",Color);
-	glBindVertexArray(skylineDraw.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER,skylineDraw.pos);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(float)*vecDrawPos.size(),vecDrawPos.data(),GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,0,NULL);
-	//~ glEnableVertexAttribArray(0); //layout 0
-
-	//~ for (unsigned int i = 0; i < vecDrawPos.size()/2 ; i++)
-	glDrawArrays(GL_LINES, 0 ,vecDrawPos.size()/2);
-
-	glUseProgram(0);
-
-	vecDrawPos.clear();
 }
 
 
@@ -84,6 +84,19 @@ protected:
 	static void createShader();
 	static void deleteShader();
 
+	//! Ligne fixe dans son repère : les segments sont construits une fois dans un VBO
+	//! et projetés par skylineProj.geom, qui trace aussi les graduations.
+	//! tick est la demi-longueur en pixels de la graduation au bout du segment, 0 pour aucune.
+	static void addSegment(std::vector<float> &pos, std::vector<float> &tick, const Vec3f &a, const Vec3f &b, float tickl);
+	void buildStaticLine(const std::vector<float> &pos, const std::vector<float> &tick);
+	//! mat passe du repère de la ligne à l'oeil, comme les matrices de Projector
+	void drawStaticLine(const Mat4f &mat, const Vec4f &Color);
+	bool hasStaticLine() const {
+		return nbStaticVertices > 0;
+	}
+	//! angle d'un segment à l'écran, tel que l'utilisent les graduations et les labels
+	static double segmentAngle(const Vec3d &pt1, const Vec3d &pt2);
+
 	double radius;
 	unsigned int nb_segment;
 	Vec3f color;
@@ -106,6 +119,12 @@ protected:
 
 	static DataGL skylineDraw;
 
+	static shaderProgram* shaderSkylineProj;
+	static UniformHandle uniformProjMat;
+	static UniformHandle uniformProjColor;
+	DataGL staticLine;
+	int nbStaticVertices = 0;
+
 	std::vector<float> vecDrawPos;
 	std::vector<float> vecDrawMVPPos;
 };
@@ -264,9 +283,14 @@ public:
 	void draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory);
 
 private:
+	//! writes the label of segment i and returns the half length of its tick, 0 if it has none
+	float getLabel(unsigned int i, std::ostringstream &oss) const;
+	void buildLine();
+
 	SKY_LINE_EQUATOR_LINE line_equator_type;
 	mutable Vec3f* points;
 	mutable double inclination;
+	bool builtInternalNav = false;
 };
 
 //--------------------------------------------------------------------------
@@ -279,8 +303,13 @@ public:
 	void draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory);
 
 private:
+	//! writes the label of segment i, turns angle as its text and returns the half length of its tick
+	float getLabel(unsigned int i, std::ostringstream &oss, double &angle) const;
+	void buildLine();
+
 	mutable Vec3f* points;
 	mutable double inclination;
+	bool builtInternalNav = false;
 };
 //--------------------------------------------------------------------------
 
@@ -292,8 +321,12 @@ public:
 	void draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory);
 
 private:
+	//! equator and tropics for the axial tilt of the home planet, in degrees
+	void buildLine(double tilt);
+
 	mutable Vec3f* points;
 	mutable double inclination;
+	double builtTilt = 0.;
 };
 
 
@@ -307,9 +340,15 @@ public:
 	void draw(const Projector *prj,const Navigator *nav, const TimeMgr* timeMgr, const Observer* observatory);
 
 private:
+	//! half length of the tick at the end of day i
+	static float getTick(unsigned int i);
+	void buildLine(double corr, bool labels);
+
 	mutable Mat4d m;
 	mutable bool draw_labels;
 	mutable double inclination;
+	double builtCorr = 0.;
+	bool builtLabels = false;
 };
 
 
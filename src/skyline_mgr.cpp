@@ -40,6 +40,9 @@ void SkyLineMgr::draw(const Projector* prj, const Navigator *nav, const TimeMgr*
 {
 	for (std::map<std::string, SkyLine*>::iterator it=m_map.begin(); it!=m_map.end(); ++it) {
 		it->second->draw(prj, nav, timeMgr, observatory);
+		// labels of each line in one draw
+		if (it->second->font)
+			it->second->font->flush();
 	}
 }
 
@@ -197,4 +197,5 @@ void SkyPerson::draw_text(const Projector *prj,const Navigator *nav)
 				oss.clear();
 			}
 		}
+	font->flush();
 }
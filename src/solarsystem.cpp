@@ -120,6 +120,8 @@ SolarSystem::~SolarSystem()
 	//~ }
 	
 	renderedBodies.clear();
+	drawnBodies.clear();
+	pointBodies.clear();
 	//~ system_bodys.clear();
 	
 	Body::deleteDefaultTexMap();
@@ -637,6 +639,8 @@ bool SolarSystem::removeBodyNoSatellite(const std::string &name){
 	systemBodies.erase(bc->englishName);
 	if(!bc->isHidden){
 		removeFromVector(bc, renderedBodies);
+		if (!removeFromVector(bc, drawnBodies))
+			removeFromVector(bc, pointBodies);
 	}
 	
 	anchorManager->removeAnchor(bc->body);
@@ -864,19 +868,29 @@ void SolarSystem::computePreDraw(const Projector * prj, const Navigator * nav){
 	Vec3d obs_helio_pos = nav->getObserverHelioPos();
 	//	cout << "obs: " << obs_helio_pos << endl;
 
+	// Small bodies reduced to a point on screen only need their screen position:
+	// their halos are drawn together by haloBatch, in any order
+	drawnBodies.clear();
+	pointBodies.clear();
+
 	//~ pd.startTimer("SolarSystem::draw$compute_dist+magn+draw"); //Debug
 	for (auto it = renderedBodies.begin(); it != renderedBodies.end(); it++){
-		(*it)->body->compute_distance(obs_helio_pos);
-		(*it)->body->computeMagnitude(obs_helio_pos);
-		(*it)->body->computeDraw(prj, nav);
+		Body *body = (*it)->body;
+		body->compute_distance(obs_helio_pos);
+		if (body->canBeBatched() && !(selected == body) && body->computeDrawPoint(prj, nav)) {
+			pointBodies.push_back(*it);
+			continue;
+		}
+		body->computeDraw(prj, nav);
+		drawnBodies.push_back(*it);
 	}
 	//~ pd.stopTimer("SolarSystem::draw$compute_dist+magn+draw"); //Debug
 
 	//~ pd.startTimer("SolarSystem::draw$sort"); //Debug
-	// sort all body from the furthest to the closest to the observer
+	// sort the bodies drawn one by one from the furthest to the closest to the observer
 	//~ sort(system_bodys.begin(),system_bodys.end(),biggerDistance);
 	
-	sort(renderedBodies.begin(), renderedBodies.end(), biggerDistance);
+	sort(drawnBodies.begin(), drawnBodies.end(), biggerDistance);
 	
 	//~ pd.stopTimer("SolarSystem::draw$sort"); //Debug
 
@@ -891,7 +905,7 @@ void SolarSystem::computePreDraw(const Projector * prj, const Navigator * nav){
 	depthBucket db;
 
 	//~ pd.startTimer("SolarSystem::draw$loop1"); //Debug
-	for (auto it = renderedBodies.begin(); it!= renderedBodies.end();it++) {
+	for (auto it = drawnBodies.begin(); it!= drawnBodies.end();it++) {
 		if ( (*it)->body->get_parent() == sun
 
 		        // This will only work with natural planets
@@ -984,6 +998,12 @@ void SolarSystem::draw(Projector * prj, const Navigator * nav, const Observer* o
 	double z_near, z_far;
 	prj->getClippingPlanes(&z_near,&z_far); // Save clipping planes
 
+	// halos of the small bodies, in a single draw call, under the bodies drawn one by one
+	haloBatch.clear();
+	for (auto it = pointBodies.begin(); it != pointBodies.end(); it++)
+		(*it)->body->addToBatch(nav, prj, observatory, eye, drawHomePlanet, haloBatch);
+	haloBatch.draw();
+
 	dbiter = listBuckets.begin();
 
 	// clear depth buffer
@@ -1001,7 +1021,7 @@ void SolarSystem::draw(Projector * prj, const Navigator * nav, const Observer* o
 	bool needClearDepthBuffer = false;
 
 	//~ pd.startTimer("SolarSystem::draw$loop2"); //Debug
-	for (auto it = renderedBodies.begin(); it != renderedBodies.end(); it++) {
+	for (auto it = drawnBodies.begin(); it != drawnBodies.end(); it++) {
 		////pd.startTimer("SolarSystem::draw$loop2$part1"); //Debug
 		dist = (*it)->body->getEarthEquPos(nav).length();
 		if (dist < (*dbiter).znear ) {
@@ -1072,6 +1092,7 @@ void SolarSystem::draw(Projector * prj, const Navigator * nav, const Observer* o
 	}
 	//~ pd.stopTimer("SolarSystem::draw$loop2"); //Debug
 	prj->setClippingPlanes(z_near,z_far);  // Restore old clipping planes
+	if (planet_name_font) planet_name_font->flush();
 	//~ std::cout << "Fin de SolarSystem::draw" << std::endl;
 }
 
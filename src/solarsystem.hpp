@@ -44,6 +44,7 @@
 #include "anchor_manager.hpp"
 
 #include "body_color.hpp"
+#include "halo_batch.hpp"
 
 class OrbitCreator;
 
@@ -412,6 +413,9 @@ private:
 
 	std::map< std::string, BodyContainer*> systemBodies; //Map containing the bodies and related information. the key is their english name
 	std::vector<BodyContainer *> renderedBodies; //Contains bodies that are not hidden
+	std::vector<BodyContainer *> drawnBodies; // bodies drawn one by one, sorted by computePreDraw
+	std::vector<BodyContainer *> pointBodies; // small bodies reduced to their halo, drawn by haloBatch
+	HaloBatch haloBatch;
 	std::list<depthBucket>listBuckets;
 
 	bool nearLunarEclipse(const Navigator * nav, Projector * prj);
@@ -82,5 +82,6 @@ const std::string REP_WEB = "www";
 const std::string REP_MODEL3D = "model3D";
 const std::string REP_LANDSCAPE = "landscapes";
 const std::string REP_SKY_CULTURE = "sky_cultures";
+const std::string REP_CACHE = "cache";
 
 #endif /*_SPACECRAFTER_HPP_*/
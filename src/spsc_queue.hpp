@@ -0,0 +1,91 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#ifndef _SPSC_QUEUE_HPP_
+#define _SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * \class SpscQueue
+ * \brief File circulaire sans verrou entre un seul producteur et un seul consommateur
+ *
+ * push() ne doit être appelé que par un thread et pop() que par un autre.
+ * La capacité est arrondie à la puissance de deux supérieure ; quand la file est
+ * pleine push() renvoie faux et c'est au producteur de garder la valeur.
+ */
+template<class T>
+class SpscQueue {
+public:
+	SpscQueue(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		slots.resize(size);
+		mask = size - 1;
+	}
+	SpscQueue(SpscQueue const &) = delete;
+	SpscQueue& operator = (SpscQueue const &) = delete;
+
+	//! ajoute une valeur, renvoie faux si la file est pleine (côté producteur)
+	bool push(T &&value) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) > mask)
+			return false;
+		slots[t & mask] = std::move(value);
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! retire la plus ancienne valeur, renvoie faux si la file est vide (côté consommateur)
+	bool pop(T &value) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire))
+			return false;
+		value = std::move(slots[h & mask]);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const {
+		return mask + 1;
+	}
+
+private:
+	std::vector<T> slots;
+	size_t mask;
+	// sur des lignes de cache différentes pour que les deux threads ne se gênent pas
+	alignas(64) std::atomic<size_t> head {0};	// prochain élément lu
+	alignas(64) std::atomic<size_t> tail {0};	// prochain élément écrit
+};
+
+#endif // _SPSC_QUEUE_HPP_
@@ -180,4 +180,6 @@ void TextMgr::draw(const Projector* prj)
 	for (iter = textUsr.begin(); iter != textUsr.end(); ++iter) {
 		(*iter)->draw(prj,textFont);
 	}
+	for (int i=0; i<7; i++)
+		if (textFont[i]) textFont[i]->flush();
 }
@@ -0,0 +1,164 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+
+#include "texture_array.hpp"
+#include "texture_cache.hpp"
+#include "s_texture.hpp"
+#include "ThreadPool.hpp"
+#include "utility.hpp"
+#include "log.hpp"
+
+TextureArray::~TextureArray()
+{
+	for (Array &a : arrays) {
+		if (a.texID)
+			glDeleteTextures(1, &a.texID);
+	}
+}
+
+void TextureArray::load(const std::vector<std::string> &fileNames, int loadType, std::vector<Layer> &layers, std::vector<float> &avgLuminance)
+{
+	layers.assign(fileNames.size(), Layer());
+	avgLuminance.assign(fileNames.size(), 1.f);
+
+	// une seule lecture par image, même si plusieurs objets la partagent
+	std::map<std::string, unsigned int> uniqueIndex;
+	std::vector<std::string> uniqueNames;
+	std::vector<unsigned int> imageOf(fileNames.size());
+	for (unsigned int i = 0; i < fileNames.size(); i++) {
+		auto it = uniqueIndex.find(fileNames[i]);
+		if (it == uniqueIndex.end()) {
+			it = uniqueIndex.emplace(fileNames[i], uniqueNames.size()).first;
+			uniqueNames.push_back(fileNames[i]);
+		}
+		imageOf[i] = it->second;
+	}
+
+	// lecture en parallèle
+	std::vector<std::unique_ptr<TextureCache::Image>> images(uniqueNames.size());
+	std::vector<std::future<bool>> jobs(uniqueNames.size());
+	{
+		unsigned int nbThreads = std::thread::hardware_concurrency();
+		ThreadPool pool(std::max(1u, std::min(nbThreads, (unsigned int)uniqueNames.size())));
+		for (unsigned int i = 0; i < uniqueNames.size(); i++) {
+			images[i].reset(new TextureCache::Image());
+			std::string fullName = Utility::isAbsolute(uniqueNames[i]) ? uniqueNames[i] : s_texture::getTexDir() + uniqueNames[i];
+			jobs[i] = pool.enqueue(&TextureCache::load, fullName, loadType, true, std::ref(*images[i]));
+		}
+	}
+
+	// images de même taille dans le même tableau
+	std::map<std::pair<int,int>, std::vector<unsigned int>> bySize;
+	for (unsigned int i = 0; i < uniqueNames.size(); i++) {
+		if (!jobs[i].get()) {
+			Log.write("TextureArray: failed loading texture file " + uniqueNames[i], cLog::LOG_TYPE::L_ERROR);
+			continue;
+		}
+		bySize[std::make_pair(images[i]->getWidth(), images[i]->getHeight())].push_back(i);
+	}
+
+	GLint maxLayers = 256;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	GLfloat maxAniso = 0.0f;
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso);
+
+	const unsigned int firstArray = arrays.size();
+	std::vector<Layer> imageLayer(uniqueNames.size());
+	std::vector<float> imageLuminance(uniqueNames.size(), 1.f);
+	for (auto &group : bySize) {
+		const int width = group.first.first;
+		const int height = group.first.second;
+		const int nbLevels = 1 + (int)floor(log2(std::max(width, height)));
+		const std::vector<unsigned int> &members = group.second;
+
+		for (unsigned int start = 0; start < members.size(); start += maxLayers) {
+			const unsigned int nbLayers = std::min((unsigned int)maxLayers, (unsigned int)members.size() - start);
+			Array a;
+			glGenTextures(1, &a.texID);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, a.texID);
+			glTexStorage3D(GL_TEXTURE_2D_ARRAY, nbLevels, GL_RGBA8, width, height, nbLayers);
+
+			// les niveaux lus dans le cache sont envoyés tels quels, les autres sont générés
+			bool generateMipmap = false;
+			for (unsigned int l = 0; l < nbLayers; l++) {
+				const unsigned int i = members[start + l];
+				const TextureCache::Image &image = *images[i];
+				const unsigned int nbImageLevels = std::min(image.getNbLevels(), (unsigned int)nbLevels);
+				for (unsigned int level = 0; level < nbImageLevels; level++)
+					glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, l, image.getWidth(level), image.getHeight(level), 1,
+					                GL_RGBA, GL_UNSIGNED_BYTE, image.getData() + image.getOffset(level));
+				if ((int)nbImageLevels < nbLevels)
+					generateMipmap = true;
+
+				// glGetTexImage en GL_LUMINANCE prend la composante rouge
+				const unsigned char *pixels = image.getData();
+				double sum = 0.0;
+				for (int p = 0; p < width*height; p++)
+					sum += pixels[4*p];
+				imageLuminance[i] = sum / (255.0*width*height);
+
+				imageLayer[i].array = arrays.size();
+				imageLayer[i].layer = l;
+				images[i].reset();
+			}
+			if (generateMipmap)
+				glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAniso);
+
+			arrays.push_back(a);
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	for (unsigned int i = 0; i < fileNames.size(); i++) {
+		layers[i] = imageLayer[imageOf[i]];
+		avgLuminance[i] = imageLuminance[imageOf[i]];
+		if (layers[i].array >= 0)
+			arrays[layers[i].array].nbUsed++;
+	}
+
+	Log.write("TextureArray: " + Utility::intToString(uniqueNames.size()) + " images in " + Utility::intToString(arrays.size() - firstArray) + " arrays", cLog::LOG_TYPE::L_INFO);
+}
+
+void TextureArray::release(const Layer &layer)
+{
+	if (layer.array < 0)
+		return;
+	Array &a = arrays[layer.array];
+	if (a.nbUsed > 0 && --a.nbUsed == 0) {
+		glDeleteTextures(1, &a.texID);
+		a.texID = 0;
+	}
+}
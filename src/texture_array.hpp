@@ -0,0 +1,78 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _TEXTURE_ARRAY_HPP_
+#define _TEXTURE_ARRAY_HPP_
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+/**
+ * \class TextureArray
+ * \brief Regroupe des images dans quelques GL_TEXTURE_2D_ARRAY
+ *
+ * Les images de même taille vont dans les couches d'une même texture tableau :
+ * tous les objets dont l'image est dans le même tableau se dessinent avec un seul
+ * glBindTexture et un seul appel de dessin. Les images ne sont pas redimensionnées.
+ *
+ * Les images sont lues en parallèle par TextureCache, puis envoyées depuis le thread
+ * GL. Chaque appel à load() crée ses propres tableaux : le catalogue se retrouve dans
+ * quelques tableaux, les images ajoutées ensuite par script dans des tableaux à part.
+ * Un tableau est détruit quand plus aucune couche n'y est utilisée.
+ */
+class TextureArray {
+public:
+	//! emplacement d'une image : texture tableau et couche
+	struct Layer {
+		int array = -1;		// -1 si l'image n'a pas pu être lue
+		int layer = 0;
+	};
+
+	TextureArray() {};
+	~TextureArray();
+	TextureArray(TextureArray const &) = delete;
+	TextureArray& operator = (TextureArray const &) = delete;
+
+	//! lit les images fileNames, relatives au répertoire des textures, et les range dans de nouveaux tableaux.
+	//! Remplit layers et avgLuminance (luminance moyenne de chaque image, comme s_texture::getAverageLuminance)
+	void load(const std::vector<std::string> &fileNames, int loadType, std::vector<Layer> &layers, std::vector<float> &avgLuminance);
+
+	//! une couche n'est plus utilisée
+	void release(const Layer &layer);
+
+	GLuint getID(int array) const {
+		return arrays[array].texID;
+	}
+
+private:
+	struct Array {
+		GLuint texID = 0;
+		unsigned int nbUsed = 0;	// couches encore utilisées
+	};
+
+	std::vector<Array> arrays;
+};
+
+#endif // _TEXTURE_ARRAY_HPP_
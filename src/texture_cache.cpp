@@ -0,0 +1,397 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "texture_cache.hpp"
+
+std::string TextureCache::directory;
+uint64_t TextureCache::maxSize = 0;
+std::atomic<uint64_t> TextureCache::currentSize(0);
+std::atomic<unsigned int> TextureCache::nbHits(0);
+std::atomic<unsigned int> TextureCache::nbMisses(0);
+std::atomic<unsigned long long> TextureCache::loadTime(0);
+
+namespace {
+
+// les niveaux de mipmap de GL : moitié de la taille arrondie en dessous, jusqu'à 1x1
+unsigned int countLevels(int width, int height)
+{
+	unsigned int nb = 1;
+	while (width > 1 || height > 1) {
+		width = std::max(1, width / 2);
+		height = std::max(1, height / 2);
+		nb++;
+	}
+	return nb;
+}
+
+// moyenne de 2x2 pixels, les bords impairs sont répétés
+void downsample(const unsigned char *src, int srcWidth, int srcHeight, unsigned char *dst, int dstWidth, int dstHeight)
+{
+	for (int y = 0; y < dstHeight; y++) {
+		const unsigned char *row0 = src + (size_t)std::min(2 * y, srcHeight - 1) * srcWidth * 4;
+		const unsigned char *row1 = src + (size_t)std::min(2 * y + 1, srcHeight - 1) * srcWidth * 4;
+		for (int x = 0; x < dstWidth; x++) {
+			int x0 = std::min(2 * x, srcWidth - 1) * 4;
+			int x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+			for (int c = 0; c < 4; c++)
+				*dst++ = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2;
+		}
+	}
+}
+
+}
+
+TextureCache::Image::~Image()
+{
+	clear();
+}
+
+void TextureCache::Image::clear()
+{
+#ifndef WIN32
+	if (mapping != nullptr)
+		munmap(mapping, mappingSize);
+#endif
+	mapping = nullptr;
+	mappingSize = 0;
+	buffer.clear();
+	buffer.shrink_to_fit();
+	data = nullptr;
+	size = 0;
+	width = height = 0;
+	nbLevels = 0;
+}
+
+int TextureCache::Image::getWidth(unsigned int level) const
+{
+	return std::max(1, width >> level);
+}
+
+int TextureCache::Image::getHeight(unsigned int level) const
+{
+	return std::max(1, height >> level);
+}
+
+size_t TextureCache::Image::getOffset(unsigned int level) const
+{
+	size_t offset = 0;
+	for (unsigned int i = 0; i < level; i++)
+		offset += (size_t)getWidth(i) * getHeight(i) * 4;
+	return offset;
+}
+
+void TextureCache::setDirectory(const std::string &dir, uint64_t _maxSize)
+{
+	directory = dir;
+	maxSize = _maxSize;
+	currentSize = 0;
+	if (directory.empty())
+		return;
+	if (directory.back() != '/' && directory.back() != '\\')
+		directory += "/";
+	// de la place pour les images qui seront lues pendant cette session
+	trim(maxSize / 4 * 3);
+}
+
+void TextureCache::trim(uint64_t target)
+{
+	struct Entry {
+		std::string name;
+		int64_t time;
+		uint64_t size;
+	};
+	std::vector<Entry> entries;
+	uint64_t total = 0;
+
+	DIR *dir = opendir(directory.c_str());
+	if (dir == nullptr)
+		return;
+	while (struct dirent *d = readdir(dir)) {
+		std::string name = d->d_name;
+		std::string::size_type ext = name.find(".tex");
+		if (ext == std::string::npos)
+			continue;
+		std::string path = directory + name;
+		// un fichier temporaire laissé par un arrêt pendant une écriture
+		if (ext + 4 != name.size()) {
+			remove(path.c_str());
+			continue;
+		}
+		struct stat st;
+		if (stat(path.c_str(), &st) != 0)
+			continue;
+		entries.push_back(Entry{path, (int64_t)st.st_mtime, (uint64_t)st.st_size});
+		total += st.st_size;
+	}
+	closedir(dir);
+
+	// les moins récemment lues en premier
+	std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+		return a.time < b.time;
+	});
+	for (const Entry &e : entries) {
+		if (total <= target)
+			break;
+		if (remove(e.name.c_str()) == 0)
+			total -= e.size;
+	}
+	currentSize = total;
+}
+
+bool TextureCache::load(const std::string &fullName, int loadType, bool mipmap, Image &image)
+{
+	auto start = std::chrono::steady_clock::now();
+	image.clear();
+
+	bool ok;
+	if (isEnabled() && read(fullName, loadType, mipmap, image)) {
+		nbHits++;
+		ok = true;
+	} else {
+		ok = decode(fullName, loadType, mipmap && isEnabled(), image);
+		if (ok && isEnabled()) {
+			nbMisses++;
+			write(fullName, loadType, mipmap, image);
+		}
+	}
+
+	loadTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	return ok;
+}
+
+bool TextureCache::readInfo(const std::string &fullName, int &width, int &height)
+{
+	int n;
+	return stbi_info(fullName.c_str(), &width, &height, &n) != 0;
+}
+
+std::string TextureCache::getStats()
+{
+	std::ostringstream oss;
+	oss << "TextureCache: " << (isEnabled() ? directory : "disabled") << ", " << nbHits << " hits, "
+	    << nbMisses << " misses, " << loadTime / 1000 << " ms spent reading images, "
+	    << currentSize / (1024 * 1024) << " of " << maxSize / (1024 * 1024) << " MB used";
+	return oss.str();
+}
+
+std::string TextureCache::entryName(const std::string &fullName, int loadType, bool mipmap)
+{
+	// FNV-1a 64 bits
+	uint64_t hash = 14695981039346656037ULL;
+	std::string key = fullName + ":" + std::to_string(loadType) + (mipmap ? ":m" : ":n");
+	for (unsigned char c : key) {
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.tex", (unsigned long long)hash);
+	return directory + name;
+}
+
+bool TextureCache::sourceStat(const std::string &fullName, int64_t &time, uint64_t &size)
+{
+	struct stat st;
+	if (stat(fullName.c_str(), &st) != 0)
+		return false;
+	time = st.st_mtime;
+	size = st.st_size;
+	return true;
+}
+
+bool TextureCache::read(const std::string &fullName, int loadType, bool mipmap, Image &image)
+{
+	int64_t sourceTime;
+	uint64_t sourceSize;
+	if (!sourceStat(fullName, sourceTime, sourceSize))
+		return false;
+
+	std::string entry = entryName(fullName, loadType, mipmap);
+#ifndef WIN32
+	int fd = open(entry.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	Header header;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header) ||
+	        pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+		close(fd);
+		return false;
+	}
+	// une entrée périmée n'est pas projetée
+	std::string path(header.pathLength, '\0');
+	bool valid = header.magic == MAGIC && header.version == CACHE_VERSION &&
+	             header.sourceTime == sourceTime && header.sourceSize == sourceSize &&
+	             header.loadType == loadType && header.pathLength == fullName.size() &&
+	             pread(fd, &path[0], path.size(), sizeof(header)) == (ssize_t)path.size() && path == fullName &&
+	             header.dataOffset + header.dataSize == (uint64_t)st.st_size;
+	if (!valid) {
+		close(fd);
+		return false;
+	}
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// date de dernier usage, pour trim
+	futimens(fd, nullptr);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	image.mapping = mapping;
+	image.mappingSize = st.st_size;
+	image.data = (const unsigned char*)mapping + header.dataOffset;
+	image.size = header.dataSize;
+	image.width = header.width;
+	image.height = header.height;
+	image.nbLevels = header.nbLevels;
+	if (image.getOffset(image.nbLevels) != image.size) {
+		image.clear();
+		return false;
+	}
+	return true;
+#else
+	// pas de projection sous WIN32 : le cache n'est utilisé que pour écrire
+	return false;
+#endif
+}
+
+bool TextureCache::decode(const std::string &fullName, int loadType, bool mipmap, Image &image)
+{
+	int x, y, n;
+	unsigned char *pixels = stbi_load(fullName.c_str(), &x, &y, &n, 4);
+	if (pixels == nullptr)
+		return false;
+	blend(loadType, pixels, (size_t)x * y * 4);
+
+	image.width = x;
+	image.height = y;
+	image.nbLevels = mipmap ? countLevels(x, y) : 1;
+	image.size = image.getOffset(image.nbLevels);
+	image.buffer.resize(image.size);
+
+	// GL attend la première ligne en bas
+	size_t rowSize = (size_t)x * 4;
+	for (int row = 0; row < y; row++)
+		memcpy(image.buffer.data() + (size_t)(y - row - 1) * rowSize, pixels + row * rowSize, rowSize);
+	stbi_image_free(pixels);
+
+	for (unsigned int level = 1; level < image.nbLevels; level++) {
+		downsample(image.buffer.data() + image.getOffset(level - 1), image.getWidth(level - 1), image.getHeight(level - 1),
+		           image.buffer.data() + image.getOffset(level), image.getWidth(level), image.getHeight(level));
+	}
+	image.data = image.buffer.data();
+	return true;
+}
+
+void TextureCache::write(const std::string &fullName, int loadType, bool mipmap, const Image &image)
+{
+	Header header;
+	memset(&header, 0, sizeof(header));
+	if (!sourceStat(fullName, header.sourceTime, header.sourceSize))
+		return;
+	header.magic = MAGIC;
+	header.version = CACHE_VERSION;
+	header.loadType = loadType;
+	header.nbLevels = image.nbLevels;
+	header.width = image.width;
+	header.height = image.height;
+	header.pathLength = fullName.size();
+	header.dataOffset = (sizeof(header) + fullName.size() + 15) & ~(uint64_t)15;
+	header.dataSize = image.size;
+
+	// cache plein : les entrées anciennes ne sont effacées qu'au prochain démarrage
+	const uint64_t entrySize = header.dataOffset + header.dataSize;
+	if (currentSize + entrySize > maxSize)
+		return;
+
+	// écrit à côté puis renomme : un autre thread ou processus ne voit jamais d'entrée incomplète
+	std::string entry = entryName(fullName, loadType, mipmap);
+	std::string tmpName = entry + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	FILE *f = fopen(tmpName.c_str(), "wb");
+	if (f == nullptr)
+		return;
+	static const char padding[16] = {};
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+	          fwrite(fullName.data(), 1, fullName.size(), f) == fullName.size() &&
+	          fwrite(padding, 1, header.dataOffset - sizeof(header) - fullName.size(), f) == header.dataOffset - sizeof(header) - fullName.size() &&
+	          fwrite(image.data, 1, image.size, f) == image.size;
+	ok = (fclose(f) == 0) && ok;
+	// une entrée périmée est remplacée
+	struct stat st;
+	uint64_t replacedSize = (stat(entry.c_str(), &st) == 0) ? st.st_size : 0;
+	if (!ok || rename(tmpName.c_str(), entry.c_str()) != 0) {
+		remove(tmpName.c_str());
+		return;
+	}
+	currentSize += entrySize;
+	currentSize -= std::min<uint64_t>(replacedSize, currentSize);
+}
+
+void TextureCache::blend(int loadType, unsigned char *data, size_t size)
+{
+	unsigned char* ptr = data;
+	int r, g, b;
+
+	switch( loadType ) {
+
+		case PNG_BLEND1:
+			for( size_t i = 0; i < size; i+=4 ) {
+				r = *ptr++;
+				g = *ptr++;
+				b = *ptr++;
+				*ptr++ = (r+g+b > 255) ? 255 : r+g+b;
+			}
+			break;
+
+		case PNG_BLEND3:
+			for( size_t i = 0; i < size; i+=4 ) {
+				r = *ptr++;
+				g = *ptr++;
+				b = *ptr++;
+				*ptr++ = (r+g+b)/3;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
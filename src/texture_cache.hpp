@@ -0,0 +1,158 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#ifndef _TEXTURE_CACHE_HPP_
+#define _TEXTURE_CACHE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//TODO supprimer cela et les remplacer par un enum class
+#define PNG_ALPHA  0
+#define PNG_SOLID  1
+#define PNG_BLEND1 7
+#define PNG_BLEND3 2
+
+/**
+ * \class TextureCache
+ * \brief Lecture des images de s_texture, avec un cache disque des images déjà décodées
+ *
+ * Une image lue par stbi_load passe par blend, est retournée pour GL puis, si des
+ * mipmaps sont demandées, réduite jusqu'à 1x1. Le résultat est écrit dans le
+ * répertoire du cache : au démarrage suivant, le fichier est projeté en mémoire
+ * et envoyé niveau par niveau, sans décodage ni glGenerateMipmap.
+ *
+ * Une entrée est nommée d'après le chemin de l'image, son type de chargement et
+ * la présence des mipmaps. Elle recopie aussi la date de modification et la taille
+ * de l'image : si l'une des deux change, l'entrée est ignorée puis réécrite.
+ *
+ * La taille du répertoire est bornée : à l'activation, les entrées les moins
+ * récemment lues sont effacées jusqu'aux trois quarts de la limite, puis plus
+ * rien n'est écrit une fois la limite atteinte. Une lecture dans le cache remet
+ * à jour la date de modification de l'entrée, qui sert de date de dernier usage.
+ *
+ * Sans répertoire de cache, seule l'image d'origine est produite et les mipmaps
+ * restent à la charge de GL. Les fonctions statiques peuvent être appelées depuis
+ * plusieurs threads à la fois.
+ */
+class TextureCache {
+public:
+	//! image RGBA prête à envoyer à GL : les niveaux se suivent à partir du niveau 0
+	class Image {
+	public:
+		Image() {};
+		~Image();
+		Image(Image const &) = delete;
+		Image& operator = (Image const &) = delete;
+
+		const unsigned char *getData() const {
+			return data;
+		}
+		size_t getSize() const {
+			return size;
+		}
+		unsigned int getNbLevels() const {
+			return nbLevels;
+		}
+		int getWidth(unsigned int level = 0) const;
+		int getHeight(unsigned int level = 0) const;
+		//! position du niveau level dans getData()
+		size_t getOffset(unsigned int level) const;
+		//! vrai si l'image vient du cache
+		bool isCached() const {
+			return mapping != nullptr;
+		}
+
+		void clear();
+
+	private:
+		friend class TextureCache;
+
+		const unsigned char *data = nullptr;
+		size_t size = 0;
+		int width = 0;
+		int height = 0;
+		unsigned int nbLevels = 0;
+
+		void *mapping = nullptr;
+		size_t mappingSize = 0;
+		std::vector<unsigned char> buffer;
+	};
+
+	//! active le cache dans dir, limité à maxSize octets, le désactive si dir est vide. À appeler avant tout chargement
+	static void setDirectory(const std::string &dir, uint64_t maxSize);
+	static bool isEnabled() {
+		return !directory.empty();
+	}
+
+	//! lit fullName, depuis le cache s'il est à jour, et enregistre le résultat dans le cache sinon
+	static bool load(const std::string &fullName, int loadType, bool mipmap, Image &image);
+
+	//! dimensions de fullName sans décoder l'image
+	static bool readInfo(const std::string &fullName, int &width, int &height);
+
+	//! bilan des chargements depuis le démarrage, pour le log
+	static std::string getStats();
+
+	//! "SCTC"
+	static const uint32_t MAGIC = 0x43544353;
+	static const uint32_t CACHE_VERSION = 1;
+
+private:
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		int64_t sourceTime;		// date de modification de l'image
+		uint64_t sourceSize;
+		int32_t loadType;
+		uint32_t nbLevels;
+		uint32_t width;
+		uint32_t height;
+		uint32_t pathLength;	// le chemin de l'image suit l'en-tête
+		uint32_t reserved;
+		uint64_t dataOffset;	// début du niveau 0
+		uint64_t dataSize;
+	};
+
+	static std::string entryName(const std::string &fullName, int loadType, bool mipmap);
+	static bool sourceStat(const std::string &fullName, int64_t &time, uint64_t &size);
+	static bool read(const std::string &fullName, int loadType, bool mipmap, Image &image);
+	static bool decode(const std::string &fullName, int loadType, bool mipmap, Image &image);
+	static void write(const std::string &fullName, int loadType, bool mipmap, const Image &image);
+	static void blend(int loadType, unsigned char *data, size_t size);
+	// efface les entrées les plus anciennes jusqu'à ce que le cache tienne dans target octets
+	static void trim(uint64_t target);
+
+	static std::string directory;
+	static uint64_t maxSize;
+	static std::atomic<uint64_t> currentSize;	// taille des entrées du répertoire
+	static std::atomic<unsigned int> nbHits;
+	static std::atomic<unsigned int> nbMisses;
+	static std::atomic<unsigned long long> loadTime;	// µs, somme sur tous les threads
+};
+
+#endif // _TEXTURE_CACHE_HPP_
@@ -0,0 +1,202 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+#include "texture_streamer.hpp"
+#include "s_texture.hpp"
+#include "log.hpp"
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+TextureStreamer::TextureStreamer(unsigned int nbThreads, size_t _sliceSize) :
+	sliceSize(_sliceSize),
+	pool(nbThreads ? nbThreads : std::max(1u, std::thread::hardware_concurrency()/4))
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	// les décodages encore en attente s'arrêtent tout de suite, le ThreadPool attend les autres
+	for (auto &job : jobs) {
+		job->cancelled = true;
+		if (job->pbo)
+			glDeleteBuffers(1, &job->pbo);
+	}
+}
+
+void TextureStreamer::request(const std::string &fileName, GLuint texID, int loadType, bool mipmap, GLint wrapping)
+{
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->fileName = fileName;
+	job->texID = texID;
+	job->loadType = loadType;
+	job->mipmap = mipmap;
+	job->wrapping = wrapping;
+	job->requestTime = std::chrono::steady_clock::now();
+	job->decoding = pool.enqueue(&TextureStreamer::decode, job);
+	jobs.push_back(job);
+}
+
+void TextureStreamer::decode(std::shared_ptr<Job> job)
+{
+	if (job->cancelled)
+		return;
+	auto start = std::chrono::steady_clock::now();
+	TextureCache::load(job->fileName, job->loadType, job->mipmap, job->image);
+	job->decodeTime = elapsedMs(start);
+}
+
+void TextureStreamer::cancel(GLuint texID)
+{
+	for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+		if ((*it)->texID == texID) {
+			(*it)->cancelled = true;
+			if ((*it)->pbo)
+				glDeleteBuffers(1, &(*it)->pbo);
+			jobs.erase(it);
+			return;
+		}
+	}
+}
+
+bool TextureStreamer::finish(GLuint texID)
+{
+	for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+		if ((*it)->texID == texID) {
+			std::shared_ptr<Job> job = *it;
+			size_t budget = SIZE_MAX;
+			process(*job, budget, true);
+			jobs.erase(it);
+			return !job->failed;
+		}
+	}
+	return true;
+}
+
+bool TextureStreamer::isPending(GLuint texID) const
+{
+	for (const auto &job : jobs) {
+		if (job->texID == texID)
+			return true;
+	}
+	return false;
+}
+
+void TextureStreamer::update()
+{
+	size_t budget = sliceSize;
+	for (auto it = jobs.begin(); it != jobs.end(); ) {
+		if (process(**it, budget, false))
+			it = jobs.erase(it);
+		else
+			++it;
+	}
+}
+
+bool TextureStreamer::process(Job &job, size_t &budget, bool wait)
+{
+	if (!job.decoded) {
+		if (!wait && job.decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return false;
+		job.decoding.get();
+		job.decoded = true;
+		if (job.image.getData() == nullptr) {
+			fail(job);
+			return true;
+		}
+	}
+	if (budget == 0)
+		return false;
+
+	auto start = std::chrono::steady_clock::now();
+	budget -= uploadSlice(job, budget);
+	bool done = (job.uploaded == job.image.getSize());
+	int width = job.image.getWidth();
+	int height = job.image.getHeight();
+	bool cached = job.image.isCached();
+	if (done)
+		complete(job);
+	job.uploadTime += elapsedMs(start);
+	job.nbFrames++;
+
+	if (done) {
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(1) << "s_texture: loading " << job.fileName << " "
+		    << width << "x" << height << (cached ? ", cache " : ", decode ") << job.decodeTime << " ms, upload "
+		    << job.uploadTime << " ms in " << job.nbFrames << " frames, ready after "
+		    << elapsedMs(job.requestTime) << " ms";
+		Log.write(oss.str(), cLog::LOG_TYPE::L_INFO);
+	}
+	return done;
+}
+
+size_t TextureStreamer::uploadSlice(Job &job, size_t budget)
+{
+	size_t total = job.image.getSize();
+	if (job.pbo == 0) {
+		glGenBuffers(1, &job.pbo);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, total, nullptr, GL_STREAM_DRAW);
+	} else
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+
+	size_t length = std::min(budget, total - job.uploaded);
+	glBufferSubData(GL_PIXEL_UNPACK_BUFFER, job.uploaded, length, job.image.getData() + job.uploaded);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	job.uploaded += length;
+	return length;
+}
+
+void TextureStreamer::complete(Job &job)
+{
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, job.texID);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+	s_texture::uploadImage(job.image, nullptr, job.mipmap, job.wrapping);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &job.pbo);
+	job.pbo = 0;
+	job.image.clear();
+}
+
+void TextureStreamer::fail(Job &job)
+{
+	job.failed = true;
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, job.texID);
+	s_texture::fillEmptyTex(job.wrapping, false);
+	Log.write("s_texture: could not load " + job.fileName, cLog::LOG_TYPE::L_ERROR);
+}
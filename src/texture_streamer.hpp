@@ -0,0 +1,122 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+#ifndef _TEXTURE_STREAMER_HPP_
+#define _TEXTURE_STREAMER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <GL/glew.h>
+
+#include "ThreadPool.hpp"
+#include "texture_cache.hpp"
+
+/**
+ * \class TextureStreamer
+ * \brief Chargement des textures de s_texture sans bloquer le thread de rendu
+ *
+ * La texture GL est créée tout de suite avec un pixel d'attente et garde le même
+ * identifiant jusqu'au bout : les objets qui l'utilisent n'ont rien à changer.
+ *
+ * - l'image est lue par TextureCache dans un ThreadPool : décodage ou lecture du cache ;
+ * - update(), appelé à chaque frame par le thread GL, recopie au plus sliceSize octets
+ *   de l'image dans un pixel buffer object propre à la texture ;
+ * - quand le PBO est complet, glTexImage2D part du PBO (copie faite par le pilote)
+ *   pour chaque niveau, et les mipmaps absentes sont générées.
+ *
+ * Les temps de décodage et d'envoi sont écrits dans le log pour chaque texture.
+ */
+class TextureStreamer {
+public:
+	//! nbThreads à 0 : le quart des coeurs, au moins un
+	TextureStreamer(unsigned int nbThreads = 0, size_t _sliceSize = DEFAULT_SLICE_SIZE);
+	~TextureStreamer();
+	TextureStreamer(TextureStreamer const &) = delete;
+	TextureStreamer& operator = (TextureStreamer const &) = delete;
+
+	//! remplit la texture texID, déjà créée, avec l'image fileName
+	void request(const std::string &fileName, GLuint texID, int loadType, bool mipmap, GLint wrapping);
+
+	//! abandonne le chargement de texID, à appeler avant de détruire la texture
+	void cancel(GLuint texID);
+
+	//! termine tout de suite le chargement de texID, renvoie faux si l'image n'a pas pu être lue
+	bool finish(GLuint texID);
+
+	//! vrai tant que texID n'a pas reçu son image
+	bool isPending(GLuint texID) const;
+
+	//! avance les chargements en cours, depuis le thread GL
+	void update();
+
+	unsigned int getNbPending() const {
+		return jobs.size();
+	}
+
+	//! octets envoyés au plus par frame
+	static const size_t DEFAULT_SLICE_SIZE = 4 << 20;
+
+private:
+	struct Job {
+		std::string fileName;
+		GLuint texID;
+		int loadType;
+		bool mipmap;
+		GLint wrapping;
+		std::atomic<bool> cancelled {false};
+
+		// rempli par le thread de décodage
+		TextureCache::Image image;
+		double decodeTime = 0.0;	// ms
+		std::future<void> decoding;
+
+		// envoi, sur le thread GL
+		bool decoded = false;
+		bool failed = false;
+		GLuint pbo = 0;
+		size_t uploaded = 0;		// octets déjà dans le PBO
+		double uploadTime = 0.0;	// ms
+		int nbFrames = 0;
+		std::chrono::steady_clock::time_point requestTime;
+	};
+
+	static void decode(std::shared_ptr<Job> job);
+	//! envoie au plus budget octets de job, renvoie les octets envoyés
+	size_t uploadSlice(Job &job, size_t budget);
+	//! vrai si job est fini, réussi ou non
+	bool process(Job &job, size_t &budget, bool wait);
+	void complete(Job &job);
+	void fail(Job &job);
+
+	std::list<std::shared_ptr<Job>> jobs;
+	size_t sliceSize;
+	ThreadPool pool;
+};
+
+#endif // _TEXTURE_STREAMER_HPP_
@@ -67,6 +67,11 @@ public:
 	//! default value = 50 cd/m^2
 	void setDisplayAdaptationLuminance(float display_adaptation_luminance);
 
+	//! Get the eye adaptation luminance for the display
+	float getDisplayAdaptationLuminance() const {
+		return Lda;
+	}
+
 	//! Set the eye adaptation luminance for the world (and precompute what can be)
 	//! default value = 40000 cd/m^2 for Skylight
 	//! Star Light      : 0.001  cd/m^2
@@ -75,6 +80,11 @@ public:
 	//! Sun Light       : 100000 cd/m^2
 	void setWorldAdaptationLuminance(float world_adaptation_luminance);
 
+	//! Get the eye adaptation luminance for the world
+	float getWorldAdaptationLuminance() const {
+		return Lwa;
+	}
+
 	//! Set the maximum display luminance : default value = 100 cd/m^2
 	//! This value is used to scale the RGB range
 	void setMaxDisplayLuminance(float maxdL) {   //unused
@@ -23,7 +23,12 @@
 using namespace std;
 
 shaderProgram* Trail::shaderTrail=nullptr;
-DataGL Trail::TrailData;
+UniformHandle Trail::uniformMat;
+UniformHandle Trail::uniformColor;
+UniformHandle Trail::uniformFader;
+UniformHandle Trail::uniformNbPoints;
+UniformHandle Trail::uniformHead;
+UniformHandle Trail::uniformCapacity;
 
 Trail::Trail(Body * _body,
              int _MaxTrail,
@@ -31,6 +36,7 @@ Trail::Trail(Body * _body,
              double _last_trailJD,
              bool _trail_on,
              bool _first_point) :
+	trail(_MaxTrail),
 	MaxTrail(_MaxTrail),
 	DeltaTrail(_DeltaTrail),
 	last_trailJD(_last_trailJD),
@@ -45,12 +51,28 @@ Trail::Trail(Body * _body,
 
 Trail::~Trail()
 {
-	vecTrailPos.clear();
-	vecTrailColor.clear();
-	trail.clear();
+	if (TrailData.vao != 0) {
+		glDeleteBuffers(1,&TrailData.pos);
+		glDeleteVertexArrays(1,&TrailData.vao);
+	}
 	// deleteShader();
 }
 
+void Trail::createGLBuffer()
+{
+	glGenVertexArrays(1,&TrailData.vao);
+	glBindVertexArray(TrailData.vao);
+
+	glGenBuffers(1,&TrailData.pos);
+	glBindBuffer(GL_ARRAY_BUFFER,TrailData.pos);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*TrailBuffer::VERTEX_SIZE*(trail.capacity()+3), NULL, GL_DYNAMIC_DRAW);
+
+	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,sizeof(float)*TrailBuffer::VERTEX_SIZE,NULL);
+	glVertexAttribPointer(1,1,GL_FLOAT,GL_FALSE,sizeof(float)*TrailBuffer::VERTEX_SIZE,(void*)(sizeof(float)*3));
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+}
+
 void Trail::drawTrail(const Navigator * nav, const Projector* prj)
 {
 
@@ -64,59 +86,57 @@ void Trail::drawTrail(const Navigator * nav, const Projector* prj)
 	//~ if (body->hidden)
 		//~ return;
 
-	list<TrailPoint>::iterator iter;
-	list<TrailPoint>::iterator begin = trail.begin();
+	if (TrailData.vao == 0)
+		createGLBuffer();
 
-	float segment = 0;
+	glBindVertexArray(TrailData.vao);
+	glBindBuffer(GL_ARRAY_BUFFER,TrailData.pos);
+
+	// seuls les points ajoutés depuis la dernière frame sont envoyés
+	const unsigned int vertexSize = sizeof(float)*TrailBuffer::VERTEX_SIZE;
+	const float *vertices = trail.getVertices().data();
+	unsigned int first[2], nb[2];
+	unsigned int nbRanges = trail.getDirty(first, nb);
+	for (unsigned int i = 0; i < nbRanges; i++)
+		glBufferSubData(GL_ARRAY_BUFFER, vertexSize*first[i], vertexSize*nb[i], vertices + TrailBuffer::VERTEX_SIZE*first[i]);
+	trail.markClean();
+
+	GLint strips[3];
+	GLsizei sizes[3];
+	int nbStrips = trail.getStrips(strips, sizes);
+	int nbPos = trail.size();
 
 	// draw final segment to finish at current Body position
 	if ( !first_point) {
-		vecTrailPos.push_back( body->getEarthEquPos(nav)[0] );
-		vecTrailPos.push_back( body->getEarthEquPos(nav)[1] );
-		vecTrailPos.push_back( body->getEarthEquPos(nav)[2] );
-
-		vecTrailColor.push_back(1.0);
-	}
-
-	for (iter=begin; iter != trail.end(); iter++) {
-		segment++;
-		vecTrailPos.push_back( (*iter).point[0] );
-		vecTrailPos.push_back( (*iter).point[1] );
-		vecTrailPos.push_back( (*iter).point[2] );
-
-		vecTrailColor.push_back( segment);
+		Vec3d pos = body->getEarthEquPos(nav);
+		const float *newest = vertices + TrailBuffer::VERTEX_SIZE*trail.getHead();
+		float link[2*TrailBuffer::VERTEX_SIZE] = {newest[0], newest[1], newest[2], newest[3],
+		                                          (float)pos[0], (float)pos[1], (float)pos[2], newest[3]};
+		glBufferSubData(GL_ARRAY_BUFFER, vertexSize*(trail.capacity()+1), sizeof(link), link);
+		strips[nbStrips] = trail.capacity()+1;
+		sizes[nbStrips] = 2;
+		nbStrips++;
+		nbPos++;
 	}
 
-	int nbPos = vecTrailPos.size()/3 ;
 	if (nbPos >= 2) {
 
 		StateGL::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		StateGL::enable(GL_BLEND);
 
 		shaderTrail->use();
-		shaderTrail->setUniform("Mat", prj->getMatEarthEquToEye());
-		shaderTrail->setUniform("Color", body->myColor->getTrail());
-		shaderTrail->setUniform("fader", fade);
-		shaderTrail->setUniform("nbPoints", nbPos);
+		shaderTrail->setUniform(uniformMat, prj->getMatEarthEquToEye());
+		shaderTrail->setUniform(uniformColor, body->myColor->getTrail());
+		shaderTrail->setUniform(uniformFader, fade);
+		shaderTrail->setUniform(uniformNbPoints, nbPos);
+		shaderTrail->setUniform(uniformHead, (int)trail.getHead());
+		shaderTrail->setUniform(uniformCapacity, (int)trail.capacity());
 
-		glBindVertexArray(TrailData.vao);
-
-		glBindBuffer(GL_ARRAY_BUFFER,TrailData.pos);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float)*vecTrailPos.size(), vecTrailPos.data(), GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,0,NULL);
-
-		glBindBuffer(GL_ARRAY_BUFFER,TrailData.color);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float)*vecTrailColor.size(), vecTrailColor.data(), GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(1,1,GL_FLOAT,GL_FALSE,0,NULL);
-
-		glDrawArrays(GL_LINE_STRIP, 0, nbPos);
+		glMultiDrawArrays(GL_LINE_STRIP, strips, sizes, nbStrips);
 
 		shaderTrail->unuse();
 		StateGL::enable(GL_BLEND);
 	}
-
-	vecTrailPos.clear();
-	vecTrailColor.clear();
 }
 
 // update trail points as needed
@@ -141,28 +161,14 @@ void Trail::updateTrail(const Navigator* nav, const TimeMgr* timeMgr)
 	// add only one point at a time, using current position only
 	if (dt) {
 		last_trailJD = date;
-		TrailPoint tp;
 		Vec3d v = body->get_heliocentric_ecliptic_pos();
-		tp.point = nav->helioToEarthPosEqu(v);
-		tp.date = date;
-		trail.push_front( tp );
-
-		if ( trail.size() > (unsigned int)MaxTrail ) {
-			trail.pop_back();
-		}
+		// the oldest point is dropped when the trail is full
+		trail.push(nav->helioToEarthPosEqu(v), date);
 	}
 
 	// because sampling depends on speed and frame rate, need to clear out
 	// points if trail gets longer than desired
-	list<TrailPoint>::iterator iter;
-	list<TrailPoint>::iterator end = trail.end();
-
-	for ( iter=trail.begin(); iter != end; iter++) {
-		if ( fabs((*iter).date - date)/DeltaTrail > MaxTrail ) {
-			trail.erase(iter, end);
-			break;
-		}
-	}
+	trail.expire(date, MaxTrail * DeltaTrail);
 }
 
 void Trail::startTrail(bool b)
@@ -186,26 +192,15 @@ void Trail::createShader()
 
 	shaderTrail = new shaderProgram();
 	shaderTrail->init( "body_trail.vert","body_trail.geom","body_trail.frag");
-	shaderTrail->setUniformLocation("Mat");
-	shaderTrail->setUniformLocation("Color");
-	shaderTrail->setUniformLocation("fader");
-	shaderTrail->setUniformLocation("nbPoints");
-
-	glGenVertexArrays(1,&TrailData.vao);
-	glBindVertexArray(TrailData.vao);
-
-	glGenBuffers(1,&TrailData.pos);
-	glGenBuffers(1,&TrailData.color);
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
-
+	uniformMat = shaderTrail->setUniformLocation("Mat");
+	uniformColor = shaderTrail->setUniformLocation("Color");
+	uniformFader = shaderTrail->setUniformLocation("fader");
+	uniformNbPoints = shaderTrail->setUniformLocation("nbPoints");
+	uniformHead = shaderTrail->setUniformLocation("head");
+	uniformCapacity = shaderTrail->setUniformLocation("capacity");
 }
 
 void Trail::deleteShader()
 {
 	if(shaderTrail) shaderTrail=nullptr;
-
-	glDeleteBuffers(1,&TrailData.color);
-	glDeleteBuffers(1,&TrailData.pos);
-	glDeleteVertexArrays(1,&TrailData.vao);
 }
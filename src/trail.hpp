@@ -21,12 +21,10 @@
 #define _TRAIL_HPP_
 
 #include "fader.hpp"
-#include <list>
 #include <string>
 #include "shader.hpp"
 #include "stateGL.hpp"
-#include <vector>
-#include <list>
+#include "trail_buffer.hpp"
 
 
 class Body;
@@ -34,11 +32,6 @@ class Navigator;
 class Projector;
 class TimeMgr;
 
-typedef struct TrailPoint {
-	Vec3d point;
-	double date;
-} TrailPoint;
-
 class Trail {
 
 public:
@@ -61,6 +54,11 @@ public:
 		startTrail(b);
 	}
 
+	//! vrai tant que la traînée est affichée, même en cours de fondu
+	bool isVisible() const {
+		return trail_fader.getInterstate() > 0.f;
+	}
+
 	void drawTrail(const Navigator * nav, const Projector* prj);
 	void updateTrail(const Navigator* nav, const TimeMgr* timeMgr);
 	void startTrail(bool b);
@@ -71,15 +69,19 @@ public:
 
 private:
 
+	// vertex buffer de la traînée, créé au premier affichage
+	void createGLBuffer();
+
 	Body * body = nullptr;
 
 	static shaderProgram* shaderTrail;
-	static DataGL TrailData;
+	static UniformHandle uniformMat, uniformColor, uniformFader, uniformNbPoints, uniformHead, uniformCapacity;
 	LinearFader trail_fader;
 
-	std::vector<float> vecTrailPos;
-	std::vector<float> vecTrailColor;
-	std::list<TrailPoint>trail;
+	// points de la traînée, le plus récent en premier
+	TrailBuffer trail;
+	// capacity()+1 vertices de l'anneau, puis le segment qui rejoint la position courante du corps
+	DataGL TrailData;
 
 	int MaxTrail;
 	double DeltaTrail;
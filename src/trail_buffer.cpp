@@ -0,0 +1,162 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "trail_buffer.hpp"
+
+TrailBuffer::TrailBuffer(unsigned int _capacity) :
+	points(std::max(_capacity, 1u)), vertices((points.size() + 1) * VERTEX_SIZE, 0.f)
+{
+	for (unsigned int i = 0; i <= points.size(); i++)
+		vertices[i * VERTEX_SIZE + 3] = (float)(i % points.size());
+}
+
+void TrailBuffer::clear()
+{
+	count = 0;
+	direction = 0;
+	sorted = true;
+}
+
+void TrailBuffer::push(const Vec3d &point, double date)
+{
+	if (count > 0) {
+		const double last = points[head].date;
+		int sens = (date > last) ? 1 : ((date < last) ? -1 : 0);
+		if (sens != 0) {
+			if (direction == 0)
+				direction = sens;
+			else if (sens != direction)
+				sorted = false;
+		}
+	}
+
+	head = (head + 1) % points.size();
+	points[head].point = point;
+	points[head].date = date;
+	if (count < points.size())
+		count++;
+	if (nbDirty < points.size())
+		nbDirty++;
+
+	writeVertex(head, point, head);
+	// copie de l'emplacement 0 qui referme l'anneau
+	if (head == 0)
+		writeVertex(points.size(), point, 0);
+}
+
+void TrailBuffer::writeVertex(unsigned int index, const Vec3d &point, unsigned int slot)
+{
+	float *v = vertices.data() + index * VERTEX_SIZE;
+	v[0] = point[0];
+	v[1] = point[1];
+	v[2] = point[2];
+	v[3] = slot;
+}
+
+void TrailBuffer::expire(double date, double maxAge)
+{
+	if (count == 0)
+		return;
+
+	auto tooOld = [&](unsigned int i) {
+		return fabs(points[slot(i)].date - date) > maxAge;
+	};
+
+	if (!sorted) {
+		for (unsigned int i = 0; i < count; i++) {
+			if (tooOld(i)) {
+				count = i;
+				return;
+			}
+		}
+		return;
+	}
+
+	// dates triées : le point le plus récent est dans la fenêtre ou aucun ne l'est,
+	// ensuite les points sortent de la fenêtre du même côté
+	if (tooOld(0)) {
+		count = 0;
+		return;
+	}
+	unsigned int low = 1, high = count;
+	while (low < high) {
+		unsigned int middle = low + (high - low) / 2;
+		if (tooOld(middle))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	count = low;
+}
+
+unsigned int TrailBuffer::getDirty(unsigned int first[2], unsigned int nb[2]) const
+{
+	const unsigned int cap = points.size();
+	if (nbDirty == 0)
+		return 0;
+	if (nbDirty >= cap) {
+		first[0] = 0;
+		nb[0] = cap + 1;
+		return 1;
+	}
+
+	unsigned int start = (head + cap + 1 - nbDirty) % cap;
+	if (start <= head) {
+		first[0] = start;
+		nb[0] = head - start + 1;
+		if (start > 0)
+			return 1;
+		first[1] = cap;
+		nb[1] = 1;
+		return 2;
+	}
+	// jusqu'à la copie de l'emplacement 0, puis depuis le début
+	first[0] = start;
+	nb[0] = cap - start + 1;
+	first[1] = 0;
+	nb[1] = head + 1;
+	return 2;
+}
+
+unsigned int TrailBuffer::getStrips(int first[2], int nb[2]) const
+{
+	const unsigned int cap = points.size();
+	if (count == 0)
+		return 0;
+
+	unsigned int oldest = slot(count - 1);
+	if (oldest <= head) {
+		first[0] = oldest;
+		nb[0] = count;
+		return 1;
+	}
+	first[0] = oldest;
+	nb[0] = cap - oldest + 1;
+	first[1] = 0;
+	nb[1] = head + 1;
+	return 2;
+}
@@ -0,0 +1,124 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+#ifndef _TRAIL_BUFFER_HPP_
+#define _TRAIL_BUFFER_HPP_
+
+#include "vecmath.hpp"
+#include <vector>
+
+typedef struct TrailPoint {
+	Vec3d point;
+	double date;
+} TrailPoint;
+
+/**
+ * \class TrailBuffer
+ * \brief Points d'une traînée rangés dans un tampon circulaire de capacité fixe
+ *
+ * Le point le plus récent est à l'indice 0, le plus ancien à l'indice size()-1.
+ * Aucune allocation après la construction : un nouveau point remplace le plus
+ * ancien quand le tampon est plein.
+ *
+ * @section VERTEX
+ *
+ * Le tampon garde aussi une copie de ses points prête pour le vertex buffer :
+ * x, y, z et l'emplacement du point dans l'anneau (VERTEX_SIZE floats par vertex).
+ * Un point ne change jamais d'emplacement, seuls les vertices écrits depuis le
+ * dernier envoi sont à renvoyer à la carte (getDirty). Le vertex d'emplacement
+ * capacity() est une copie de l'emplacement 0 : quand l'anneau a fait le tour,
+ * la traînée se dessine en deux line strips sans perdre le segment qui les relie
+ * (getStrips). L'âge d'un point, en nombre de points, se retrouve à partir de son
+ * emplacement et de celui du point le plus récent (getHead).
+ *
+ * @section EXPIRATION
+ *
+ * Tant que le temps avance dans le même sens, les dates sont triées et les points
+ * trop anciens sont trouvés par dichotomie. Après un changement de sens, la
+ * recherche redevient linéaire jusqu'au prochain clear().
+ */
+class TrailBuffer {
+
+public:
+	TrailBuffer(unsigned int _capacity);
+	~TrailBuffer() {};
+	TrailBuffer(TrailBuffer const &) = delete;
+	TrailBuffer& operator = (TrailBuffer const &) = delete;
+
+	//! nombre de floats par vertex
+	static const unsigned int VERTEX_SIZE = 4;
+
+	//! vide la traînée
+	void clear();
+	//! ajoute le point le plus récent, en coordonnées équatoriales terrestres
+	void push(const Vec3d &point, double date);
+	//! retire le plus récent jusqu'au premier point dont la date est à plus de maxAge jours de date, et tous les plus anciens
+	void expire(double date, double maxAge);
+
+	//! i-ème point, 0 pour le plus récent
+	const TrailPoint& operator[](unsigned int i) const {
+		return points[slot(i)];
+	}
+	unsigned int size() const {
+		return count;
+	}
+	bool empty() const {
+		return count == 0;
+	}
+	unsigned int capacity() const {
+		return points.size();
+	}
+
+	//! emplacement du point le plus récent
+	unsigned int getHead() const {
+		return head;
+	}
+	//! les capacity()+1 vertices de l'anneau
+	const std::vector<float>& getVertices() const {
+		return vertices;
+	}
+	//! plages de vertices modifiées depuis le dernier markClean, renvoie leur nombre (au plus 2)
+	unsigned int getDirty(unsigned int first[2], unsigned int nb[2]) const;
+	void markClean() {
+		nbDirty = 0;
+	}
+	//! line strips qui dessinent la traînée du plus ancien au plus récent point, renvoie leur nombre (au plus 2)
+	unsigned int getStrips(int first[2], int nb[2]) const;
+
+private:
+	unsigned int slot(unsigned int i) const {
+		return (head + points.size() - i) % points.size();
+	}
+	void writeVertex(unsigned int index, const Vec3d &point, unsigned int slot);
+
+	std::vector<TrailPoint> points;
+	std::vector<float> vertices;
+	unsigned int head = 0;			// emplacement du point le plus récent
+	unsigned int count = 0;
+	unsigned int nbDirty = 0;		// points écrits depuis le dernier markClean
+	int direction = 0;				// sens du temps entre les points, 0 si inconnu
+	bool sorted = true;				// faux si le temps a changé de sens depuis le dernier clear
+};
+
+#endif // _TRAIL_BUFFER_HPP_
@@ -123,6 +123,7 @@ void UI::draw(void)
 {
 	if (FlagShowGravityUi) drawGravityUi();
 	if (getFlagShowTuiMenu()) drawTui();
+	if (tuiFont) tuiFont->flush();
 }
 
 /*******************************************************************************/
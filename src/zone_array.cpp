@@ -86,10 +86,11 @@ static inline int ReadInt(FILE *f,unsigned int &x)
 #warning Star catalogue loading has only been tested with gcc
 #endif
 
-ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const string& extended_file_name)
+// ouvre le catalogue et lit son en-tête, le fichier est renvoyé positionné juste après
+static FILE *openCatalog(const string& extended_file_name, bool &use_mmap, unsigned int header[8])
 {
 	string fname(extended_file_name);
-	bool use_mmap = false;
+	use_mmap = false;
 	if (fname.find("mmap:") != string::npos) {
 		fname = fname.substr(5);
 		use_mmap = true;
@@ -105,19 +106,47 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const string& exten
 		fprintf(stderr,"ZoneArray::create(%s): fopen failed\n", extended_file_name.c_str());
 		return 0;
 	}
-	//printf("Loading %s: ",extended_file_name.c_str());
-	unsigned int magic,major,minor,type,level,mag_min,mag_range,mag_steps;
-	if (ReadInt(f,magic) < 0 ||
-	        ReadInt(f,type) < 0 ||
-	        ReadInt(f,major) < 0 ||
-	        ReadInt(f,minor) < 0 ||
-	        ReadInt(f,level) < 0 ||
-	        ReadInt(f,mag_min) < 0 ||
-	        ReadInt(f,mag_range) < 0 ||
-	        ReadInt(f,mag_steps) < 0) {
-		printf("bad file\n");
-		return 0;
+	for (int i=0; i<8; i++) {
+		if (ReadInt(f,header[i]) < 0) {
+			printf("bad file\n");
+			fclose(f);
+			return 0;
+		}
+	}
+	return f;
+}
+
+bool ZoneArray::readHeader(const string& extended_file_name, int &level, int &type)
+{
+	bool use_mmap;
+	unsigned int header[8];
+	FILE *f = openCatalog(extended_file_name, use_mmap, header);
+	if (f == 0)
+		return false;
+	fclose(f);
+	if (header[0] == FILE_MAGIC_OTHER_ENDIAN) {
+		type = SDL_Swap32(header[1]);
+		level = SDL_Swap32(header[4]);
+	} else if (header[0] == FILE_MAGIC || header[0] == FILE_MAGIC_NATIVE) {
+		type = header[1];
+		level = header[4];
+	} else {
+		printf("no star catalogue file\n");
+		return false;
 	}
+	return true;
+}
+
+ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const string& extended_file_name)
+{
+	bool use_mmap;
+	unsigned int header[8];
+	FILE *f = openCatalog(extended_file_name, use_mmap, header);
+	if (f == 0)
+		return 0;
+	//printf("Loading %s: ",extended_file_name.c_str());
+	unsigned int magic = header[0], type = header[1], major = header[2], minor = header[3], level = header[4],
+	             mag_min = header[5], mag_range = header[6], mag_steps = header[7];
 	const bool byte_swap = (magic == FILE_MAGIC_OTHER_ENDIAN);
 	if (byte_swap) {
 		// ok, FILE_MAGIC_OTHER_ENDIAN, must swap
@@ -152,12 +181,10 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const string& exten
 		printf("no star catalogue file\n");
 		return 0;
 	}
+	// pas de Log.write ici : les catalogues sont chargés hors du thread principal,
+	// HipStarMgr écrit le résultat de chaque chargement
 	ZoneArray *rval = 0;
 
-	std::ostringstream oss;
-	oss << extended_file_name << ":" << level << ":" << type << ":" << major << ":" << minor;
-	Log.write( oss.str() , cLog::LOG_TYPE::L_INFO);
-
 	switch (type) {
 		case 0:
 			if (major > MAX_MAJOR_FILE_VERSION) {
@@ -202,11 +229,7 @@ ZoneArray *ZoneArray::create(const HipStarMgr &hip_star_mgr, const string& exten
 			printf("bad file type, ");
 			break;
 	}
-	if (rval && rval->isInitialized()) {
-		std::ostringstream oss;
-		oss <<  "stars:  " << rval->getNrOfStars();
-		Log.write( oss.str() , cLog::LOG_TYPE::L_INFO);
-	} else {
+	if (rval == 0 || !rval->isInitialized()) {
 		printf("initialization failed\n");
 		if (rval) {
 			delete rval;
@@ -285,21 +308,60 @@ template<class Star> SpecialZoneArray<Star>::~SpecialZoneArray(void)
 
 
 template<class Star>
-void SpecialZoneArray<Star>::draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, int max_mag_star_name, float names_brightness, std::vector<starDBtoDraw> &starNameToDraw) const
+void SpecialZoneArray<Star>::draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, int max_mag_star_name, float names_brightness, StarDrawBuffer &buffer) const
 {
 	SpecialZoneData<Star> *const z = getZones() + index;
-	Vec3d xy;
-	const Star *const end = z->getStars() + z->size;
 	const double d2000 = 2451545.0;
 	const double movement_factor = (C_PI/180)*(0.0001/3600)
 	                               * ((HipStarMgr::getCurrentJDay()-d2000)/365.25)
 	                               / star_position_scale;
-	for (const Star *s=z->getStars(); s<end; s++) {
-		if (is_inside
-		        ? prj->projectJ2000(s->getJ2000Pos(z,movement_factor),xy)
-		        : prj->projectJ2000Check(s->getJ2000Pos(z,movement_factor),xy)) {
-			if (0 > hip_star_mgr.drawStar(prj,xy,rcmag_table + 2*(s->getMag()), HipStarMgr::color_table[s->getBVIndex()])) {
-				break;
+
+	// the stars are decoded and projected by batch, one array per coordinate,
+	// so that the compiler can use SIMD instructions on each loop
+	double c0[Projector::BATCH_SIZE], c1[Projector::BATCH_SIZE];
+	double x[Projector::BATCH_SIZE], y[Projector::BATCH_SIZE], w[Projector::BATCH_SIZE];
+	double win_x[Projector::BATCH_SIZE], win_y[Projector::BATCH_SIZE];
+	bool visible[Projector::BATCH_SIZE];
+
+	for (int first=0; first<z->size; first+=Projector::BATCH_SIZE) {
+		const Star *const batch = z->getStars() + first;
+		const int n = (z->size-first < Projector::BATCH_SIZE) ? z->size-first : Projector::BATCH_SIZE;
+
+		for (int i=0; i<n; i++)
+			batch[i].getAxisCoeffs(movement_factor, c0[i], c1[i]);
+
+		// same operations as Star::getJ2000Pos
+		for (int i=0; i<n; i++) {
+			x[i] = z->center[0] + c0[i]*z->axis0[0] + c1[i]*z->axis1[0];
+			y[i] = z->center[1] + c0[i]*z->axis0[1] + c1[i]*z->axis1[1];
+			w[i] = z->center[2] + c0[i]*z->axis0[2] + c1[i]*z->axis1[2];
+			const double norm = 1. / sqrt(x[i]*x[i] + y[i]*y[i] + w[i]*w[i]);
+			if (norm!=0) {
+				x[i] *= norm;
+				y[i] *= norm;
+				w[i] *= norm;
+			}
+		}
+
+		// projectJ2000Check takes its position in single precision
+		if (!is_inside) {
+			for (int i=0; i<n; i++) {
+				x[i] = (float)x[i];
+				y[i] = (float)y[i];
+				w[i] = (float)w[i];
+			}
+		}
+
+		prj->projectJ2000Batch(n, x, y, w, !is_inside, win_x, win_y, visible);
+
+		for (int i=0; i<n; i++) {
+			if (!visible[i])
+				continue;
+			const Star *const s = batch+i;
+			// the rank of the star in its level is stable from one run to another
+			const unsigned int star_key = ((unsigned int)(s - stars) << 3) ^ level;
+			if (0 > hip_star_mgr.drawStar(prj, win_x[i], win_y[i], rcmag_table + 2*(s->getMag()), HipStarMgr::color_table[s->getBVIndex()], star_key, buffer)) {
+				return;
 			}
 			if (s->getMag() < max_mag_star_name) {
 				const string starname = s->getNameI18n();
@@ -308,8 +370,8 @@ void SpecialZoneArray<Star>::draw(int index,bool is_inside, const float *rcmag_t
 					            HipStarMgr::color_table[s->getBVIndex()][1]*0.75,
 					            HipStarMgr::color_table[s->getBVIndex()][2]*0.75,
 					            names_brightness);
-					// prj->printGravity180(starFont,xy[0],xy[1], starname, Color, true, 4, 4);//, false);
-					starNameToDraw.push_back(std::make_tuple(xy[0],xy[1], starname, Color));
+					buffer.names.push_back(std::make_tuple(win_x[i],win_y[i], starname, Color));
+					buffer.nameStar.push_back(buffer.nbStars-1);
 				}
 			}
 		}
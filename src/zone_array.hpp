@@ -67,6 +67,8 @@ class ZoneArray {
 
 public:
 	static ZoneArray *create(const HipStarMgr &hip_star_mgr, const std::string &extended_file_name);
+	//! lit seulement le niveau et le type du catalogue, renvoie false si le fichier n'est pas un catalogue
+	static bool readHeader(const std::string &extended_file_name, int &level, int &type);
 	virtual ~ZoneArray(void) {
 		nr_of_zones = 0;
 	}
@@ -76,7 +78,7 @@ public:
 	virtual void updateHipIndex(HipIndexStruct hip_index[]) const {};
 	virtual void searchAround(int index,const Vec3d &v,double cos_lim_fov, std::vector<ObjectBaseP > &result) = 0;
 
-	virtual void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, int max_mag_star_name,float names_brightness, std::vector<starDBtoDraw>&) const = 0;
+	virtual void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, int max_mag_star_name,float names_brightness, StarDrawBuffer &buffer) const = 0;
 
 	bool isInitialized(void) const {
 		return (nr_of_zones>0);
@@ -117,7 +119,7 @@ private:
 	#endif
 	void scaleAxis(void);
 	void searchAround(int index,const Vec3d &v,double cos_lim_fov, std::vector<ObjectBaseP > &result);
-	void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, int max_mag_star_name,float names_brightness, std::vector<starDBtoDraw>&) const;
+	void draw(int index,bool is_inside, const float *rcmag_table, Projector *prj, int max_mag_star_name,float names_brightness, StarDrawBuffer &buffer) const;
 };
 
 template<class Star> void SpecialZoneArray<Star>::scaleAxis(void)
@@ -0,0 +1,234 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure le coût par frame de la mise à jour et de la création des météores
+// quand le ZHR est poussé à des valeurs extrêmes (le raccourci clavier passe à 150000).
+//
+// "old" reproduit l'ancien MeteorMgr : un objet alloué par météore, avec sa propre
+// matrice du radiant calculée à sa création, et un vector::erase pour chaque
+// météore éteint. "pool" passe par MeteorPool : tableaux de capacité fixe,
+// radiant calculé une fois par frame et météores éteints remplacés par le dernier.
+// La projection et l'envoi à GL ne sont pas mesurés.
+//
+// usage : bench_meteor [durée simulée en secondes par ZHR]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "meteor.hpp"
+#include "tone_reproductor.hpp"
+
+namespace {
+
+const double ZHR_TO_WSR = 1.6667f/3600.f;
+const int DELTA_TIME = 16;	// ms, une frame à 60 Hz
+const double VELOCITY = 60;	// km/s, valeur de Core
+
+// état d'un météore de l'ancienne classe Meteor
+struct OldMeteor {
+	Mat4d mmat;
+	Vec3d obs;
+	Vec3d position;
+	Vec3d pos_train;
+	double start_h, end_h, velocity;
+	float mag;
+	double xydistance, min_dist, dist_multiplier;
+};
+
+// ancien constructeur de Meteor, renvoie nullptr si le météore n'est pas visible
+OldMeteor* newOldMeteor(const Vec3d &sun_dir, const Vec3d &obs_equ, ToneReproductor &eye, float fov)
+{
+	OldMeteor* m = new OldMeteor();
+	m->velocity = VELOCITY;
+	m->mmat = MeteorPool::radiantMatrix(sun_dir);
+	m->xydistance = (double)rand()/((double)RAND_MAX+1)*(VISIBLE_RADIUS);
+	double angle = (double)rand()/((double)RAND_MAX+1)*2*C_PI;
+	m->obs = obs_equ;
+	m->obs.transfo4d(m->mmat.transpose());
+	m->position[0] = m->pos_train[0] = m->xydistance*cos(angle) + m->obs[0];
+	m->position[1] = m->pos_train[1] = m->xydistance*sin(angle) + m->obs[1];
+
+	double D = sqrt(m->position[0]*m->position[0] + m->position[1]*m->position[1]);
+	if (D > EARTH_RADIUS+HIGH_ALTITUDE) {
+		delete m;
+		return nullptr;
+	}
+	m->start_h = sqrt(pow(EARTH_RADIUS+HIGH_ALTITUDE,2) - D*D);
+	if (D > EARTH_RADIUS+LOW_ALTITUDE) {
+		m->end_h = -m->start_h;
+		m->min_dist = m->xydistance;
+	} else {
+		m->end_h = sqrt(pow(EARTH_RADIUS+LOW_ALTITUDE,2) - D*D);
+		m->min_dist = sqrt(m->xydistance*m->xydistance + pow(m->end_h - m->obs[2], 2));
+	}
+	if (m->min_dist > VISIBLE_RADIUS) {
+		delete m;
+		return nullptr;
+	}
+	m->pos_train[2] = m->position[2] = m->start_h;
+
+	float Mag1 = (double)rand()/((double)RAND_MAX+1)*6.75f - 3;
+	float Mag2 = (double)rand()/((double)RAND_MAX+1)*6.75f - 3;
+	float mag = (5. + (Mag1 + Mag2)/2.0f) / 256.0;
+	float rmag = eye.adaptLuminance(expf(-0.92103f*(mag + 12.12331f)) * 108064.73f) / powf(fov, 0.85f) * 50.f;
+	m->mag = (rmag < 1.2f) ? rmag*rmag/1.44f : 1.f;
+	float scale = (m->min_dist != 0) ? 180*180/(m->min_dist*m->min_dist) : 1;
+	if (scale < 1)
+		m->mag *= scale;
+	return m;
+}
+
+// ancien Meteor::update
+bool updateOldMeteor(OldMeteor* m, int delta_time)
+{
+	bool alive = true;
+	if (m->position[2] < m->end_h) {
+		m->mag -= (double)delta_time/500.0f;
+		if (m->mag < 0)
+			alive = false;
+	}
+	m->position[2] = m->position[2] - m->velocity/1000.0f*(double)delta_time;
+	if (m->position[2] + m->velocity*0.5f > m->start_h)
+		m->pos_train[2] = m->start_h;
+	else
+		m->pos_train[2] -= m->velocity*(double)delta_time/1000.0f;
+	double dist = sqrt(m->xydistance*m->xydistance + pow(m->position[2]-m->obs[2], 2));
+	if (dist == 0)
+		dist = .01;
+	m->dist_multiplier = m->min_dist*m->min_dist / (dist*dist);
+	return alive;
+}
+
+// nombre de météores à lancer dans la frame, comme MeteorMgr::update
+unsigned int nbLaunch(int zhr)
+{
+	int mpf = (int)((double)zhr*ZHR_TO_WSR*(double)DELTA_TIME/1000.0f + 0.5);
+	if (mpf < 1)
+		mpf = 1;
+	unsigned int n = 0;
+	for (int i = 0; i < mpf; i++) {
+		double prob = (double)rand()/((double)RAND_MAX+1);
+		if (zhr > 0 && prob < ((double)zhr*ZHR_TO_WSR*(double)DELTA_TIME/1000.0f/(double)mpf))
+			n++;
+	}
+	return n;
+}
+
+struct Result {
+	double meanFrame = 0.0;		// ms
+	double worstFrame = 0.0;	// ms
+	unsigned int maxActive = 0;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// le soleil et l'observateur bougent un peu à chaque frame
+Vec3d sunDir(int frame)
+{
+	return Vec3d(cos(1e-5*frame), sin(1e-5*frame), 0.2);
+}
+
+Vec3d observer(int frame)
+{
+	return Vec3d(EARTH_RADIUS*cos(7e-5*frame), EARTH_RADIUS*sin(7e-5*frame), 0.0);
+}
+
+Result runOld(int zhr, int nbFrames, ToneReproductor &eye)
+{
+	Result result;
+	std::vector<OldMeteor*> active;
+	srand(zhr);
+	for (int f = 0; f < nbFrames; f++) {
+		auto start = std::chrono::steady_clock::now();
+		for (std::vector<OldMeteor*>::iterator iter = active.begin(); iter != active.end();) {
+			if (!updateOldMeteor(*iter, DELTA_TIME)) {
+				delete *iter;
+				iter = active.erase(iter);
+			} else
+				++iter;
+		}
+		unsigned int n = nbLaunch(zhr);
+		for (unsigned int i = 0; i < n; i++) {
+			OldMeteor* m = newOldMeteor(sunDir(f), observer(f), eye, 60.f);
+			if (m)
+				active.push_back(m);
+		}
+		double t = elapsedMs(start);
+		result.meanFrame += t / nbFrames;
+		result.worstFrame = std::max(result.worstFrame, t);
+		result.maxActive = std::max(result.maxActive, (unsigned int)active.size());
+	}
+	for (OldMeteor* m : active)
+		delete m;
+	return result;
+}
+
+Result runPool(int zhr, int nbFrames, ToneReproductor &eye, MeteorPool &pool)
+{
+	Result result;
+	pool.clear();
+	srand(zhr);
+	for (int f = 0; f < nbFrames; f++) {
+		auto start = std::chrono::steady_clock::now();
+		pool.update(DELTA_TIME);
+		unsigned int n = nbLaunch(zhr);
+		if (n > 0)
+			pool.create(n, MeteorPool::radiantMatrix(sunDir(f)), observer(f), VELOCITY, &eye, 60.f);
+		double t = elapsedMs(start);
+		result.meanFrame += t / nbFrames;
+		result.worstFrame = std::max(result.worstFrame, t);
+		result.maxActive = std::max(result.maxActive, pool.size());
+	}
+	return result;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int duration = (argc > 1) ? atoi(argv[1]) : 60;
+	int nbFrames = duration * 1000 / DELTA_TIME;
+
+	ToneReproductor eye;
+	eye.setWorldAdaptationLuminance(3.75f);
+	MeteorPool pool;
+
+	printf("%d s simulated per ZHR, %d frames, pool capacity %u\n", duration, nbFrames, pool.getCapacity());
+	printf("%9s | %26s | %26s\n", "", "old", "pool");
+	printf("%9s | %8s %8s %8s | %8s %8s %8s\n", "ZHR", "mean ms", "worst ms", "active", "mean ms", "worst ms", "active");
+	const int zhrs[] = {10, 10000, 150000, 1000000, 10000000};
+	for (int zhr : zhrs) {
+		Result old = runOld(zhr, nbFrames, eye);
+		Result soa = runPool(zhr, nbFrames, eye, pool);
+		printf("%9d | %8.4f %8.4f %8u | %8.4f %8.4f %8u\n", zhr,
+		       old.meanFrame, old.worstFrame, old.maxActive, soa.meanFrame, soa.worstFrame, soa.maxActive);
+	}
+	return 0;
+}
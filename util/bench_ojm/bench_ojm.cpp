@@ -0,0 +1,187 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+// Mesure la suppression des vertex en double et le réordonnancement des triangles
+// de ojm_conv sur des sphères synthétiques de taille croissante.
+//
+// Comme dans un fichier OBJ, chaque coin de triangle arrive avec sa position, son uv
+// et sa normale ; les vertex de la couture et des pôles sont répétés avec un léger bruit.
+// "linear" est l'ancienne recherche linéaire de obj_to_ojm.cpp, "hash" le VertexIndex actuel :
+// les deux doivent produire exactement les mêmes vertex et indices. La recherche linéaire
+// n'est mesurée que jusqu'à une taille raisonnable.
+//
+// usage : bench_ojm [nombre maximal de triangles] [nombre maximal de triangles pour "linear"]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "mesh_optimizer.hpp"
+
+namespace {
+
+struct Corners {
+	std::vector<Vec3f> vertices;
+	std::vector<Vec2f> uvs;
+	std::vector<Vec3f> normals;
+};
+
+struct Result {
+	std::vector<Vec3f> vertices;
+	std::vector<Vec2f> uvs;
+	std::vector<Vec3f> normals;
+	std::vector<unsigned int> indices;
+};
+
+// sphère de n x 2n quads en coins de triangles, chaque coin légèrement bruité
+Corners makeSphere(int n)
+{
+	Corners corners;
+	auto corner = [&](int i, int j) {
+		float theta = M_PI * i / n;
+		float phi = 2.0 * M_PI * j / (2 * n);
+		float noise = 0.001f * ((rand() % 1000) / 1000.0f - 0.5f);
+		Vec3f normal(sinf(theta) * cosf(phi), sinf(theta) * sinf(phi), cosf(theta));
+		corners.vertices.push_back(normal * 10.0f + Vec3f(noise, noise, noise));
+		corners.uvs.push_back(Vec2f(float(j) / (2 * n), float(i) / n));
+		corners.normals.push_back(normal);
+	};
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < 2 * n; j++) {
+			corner(i, j); corner(i + 1, j); corner(i + 1, j + 1);
+			corner(i, j); corner(i + 1, j + 1); corner(i, j + 1);
+		}
+	}
+	return corners;
+}
+
+bool is_near(float v1, float v2)
+{
+	return fabs( v1-v2 ) < VERTEX_TOLERANCE;
+}
+
+// ancienne recherche de obj_to_ojm.cpp
+bool getSimilarVertexIndex(const Vec3f &in_vertex, const Vec2f &in_uv, const Vec3f &in_normal, const Result &out, unsigned int &result)
+{
+	for ( unsigned int i=0; i<out.vertices.size(); i++ ) {
+		if (
+		    is_near( in_vertex[0], out.vertices[i][0] ) &&
+		    is_near( in_vertex[1], out.vertices[i][1] ) &&
+		    is_near( in_vertex[2], out.vertices[i][2] ) &&
+		    is_near( in_uv[0], out.uvs     [i][0] ) &&
+		    is_near( in_uv[1], out.uvs     [i][1] ) &&
+		    is_near( in_normal[0], out.normals [i][0] ) &&
+		    is_near( in_normal[1], out.normals [i][1] ) &&
+		    is_near( in_normal[2], out.normals [i][2] )
+		) {
+			result = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void addVertex(const Corners &corners, unsigned int j, Result &out)
+{
+	out.vertices.push_back(corners.vertices[j]);
+	out.uvs.push_back(corners.uvs[j]);
+	out.normals.push_back(corners.normals[j]);
+	out.indices.push_back(out.vertices.size() - 1);
+}
+
+Result runLinear(const Corners &corners)
+{
+	Result out;
+	for (unsigned int j = 0; j < corners.vertices.size(); j++) {
+		unsigned int index;
+		if (getSimilarVertexIndex(corners.vertices[j], corners.uvs[j], corners.normals[j], out, index))
+			out.indices.push_back(index);
+		else
+			addVertex(corners, j, out);
+	}
+	return out;
+}
+
+Result runHash(const Corners &corners)
+{
+	Result out;
+	VertexIndex vertexIndex(out.vertices, &out.uvs, out.normals);
+	for (unsigned int j = 0; j < corners.vertices.size(); j++) {
+		unsigned int index;
+		if (vertexIndex.find(corners.vertices[j], corners.uvs[j], corners.normals[j], index))
+			out.indices.push_back(index);
+		else {
+			addVertex(corners, j, out);
+			vertexIndex.addLast();
+		}
+	}
+	return out;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	long maxTriangles = (argc > 1) ? atol(argv[1]) : 2000000;
+	long maxLinear = (argc > 2) ? atol(argv[2]) : 50000;
+
+	printf("%10s %10s %12s %12s %12s %8s %8s\n", "triangles", "vertices", "linear ms", "hash ms", "reorder ms", "ACMR", "after");
+	for (int n = 16; 4L * n * n <= maxTriangles; n *= 2) {
+		srand(n);
+		Corners corners = makeSphere(n);
+		long nbTriangles = corners.vertices.size() / 3;
+
+		auto start = std::chrono::steady_clock::now();
+		Result hash = runHash(corners);
+		double hashTime = elapsedMs(start);
+
+		char linearTime[32] = "-";
+		if (nbTriangles <= maxLinear) {
+			start = std::chrono::steady_clock::now();
+			Result linear = runLinear(corners);
+			snprintf(linearTime, sizeof(linearTime), "%.1f", elapsedMs(start));
+			if (linear.indices != hash.indices || linear.vertices.size() != hash.vertices.size()) {
+				printf("hash and linear results differ for %ld triangles\n", nbTriangles);
+				return 1;
+			}
+		}
+
+		float acmr = computeACMR(hash.indices);
+		start = std::chrono::steady_clock::now();
+		optimizeVertexCache(hash.indices, hash.vertices.size());
+		double reorderTime = elapsedMs(start);
+
+		printf("%10ld %10zu %12s %12.1f %12.1f %8.3f %8.3f\n", nbTriangles, hash.vertices.size(), linearTime,
+		       hashTime, reorderTime, acmr, computeACMR(hash.indices));
+	}
+	return 0;
+}
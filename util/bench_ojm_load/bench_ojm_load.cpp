@@ -0,0 +1,164 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure le temps de lecture d'un modèle OJM par OjmFile, au format texte et au
+// format binaire v2, sur des sphères synthétiques converties par ObjToOjm.
+//
+// Chaque lecture est suivie d'un parcours de toutes les données de la shape, comme
+// le fait l'envoi au GPU par Ojm::initGLparam : au format binaire, c'est ce parcours
+// qui lit la projection du fichier. Les fichiers sont relus plusieurs fois, ils sont
+// donc dans le cache du système après la première lecture.
+//
+// usage : bench_ojm_load [nombre maximal de triangles] [répertoire des fichiers temporaires]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+#include "obj3D.hpp"
+#include "obj_to_ojm.hpp"
+#include "ojm_file.hpp"
+
+namespace {
+
+// sphère texturée de n x 2n quads au format OBJ, avec sa bibliothèque de matériaux
+void writeSphere(const std::string &fileName, const std::string &mtlName, int n)
+{
+	std::ofstream mtl(mtlName.c_str());
+	mtl << "newmtl sphere" << std::endl << "Kd 0.8 0.8 0.8" << std::endl << "map_Kd sphere.png" << std::endl;
+
+	std::ofstream obj(fileName.c_str());
+	obj << "mtllib " << mtlName << std::endl;
+	obj << "o sphere" << std::endl;
+	for (int i = 0; i <= n; i++) {
+		float theta = M_PI * i / n;
+		for (int j = 0; j <= 2 * n; j++) {
+			float phi = M_PI * j / n;
+			Vec3f p(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
+			obj << "v " << p[0] << " " << p[1] << " " << p[2] << std::endl;
+			obj << "vt " << (float)j / (2 * n) << " " << (float)i / n << std::endl;
+			obj << "vn " << p[0] << " " << p[1] << " " << p[2] << std::endl;
+		}
+	}
+	auto corner = [n](int i, int j) {
+		int k = i * (2 * n + 1) + j + 1;
+		return std::to_string(k) + "/" + std::to_string(k) + "/" + std::to_string(k);
+	};
+	obj << "usemtl sphere" << std::endl;
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < 2 * n; j++) {
+			obj << "f " << corner(i, j) << " " << corner(i + 1, j) << " " << corner(i + 1, j + 1) << std::endl;
+			obj << "f " << corner(i, j) << " " << corner(i + 1, j + 1) << " " << corner(i, j + 1) << std::endl;
+		}
+	}
+}
+
+bool convert(const std::string &objName, const std::string &ojmName, bool binary)
+{
+	// ObjToOjm est bavard
+	std::streambuf *coutBuf = std::cout.rdbuf(nullptr);
+	Obj3D obj3D(objName);
+	bool ok = obj3D.init();
+	ObjToOjm converter;
+	ok = ok && converter.importOBJ(&obj3D) && converter.exportOJM(ojmName, binary);
+	std::cout.rdbuf(coutBuf);
+	return ok;
+}
+
+long fileSize(const std::string &fileName)
+{
+	struct stat st;
+	return (stat(fileName.c_str(), &st) == 0) ? st.st_size : 0;
+}
+
+// temps moyen d'une lecture suivie d'un parcours des données, en ms
+double measureLoad(const std::string &fileName, int nbRuns, unsigned long &nbTriangles)
+{
+	double total = 0.0;
+	for (int run = 0; run < nbRuns; run++) {
+		auto start = std::chrono::steady_clock::now();
+		OjmFile file;
+		if (!file.load(fileName)) {
+			printf("%s: %s\n", fileName.c_str(), file.getError().c_str());
+			exit(1);
+		}
+		float sum = 0.0f;
+		unsigned long indexSum = 0;
+		nbTriangles = 0;
+		for (const OjmFile::ShapeData &shape : file.getShapes()) {
+			for (unsigned int i = 0; i < shape.nbVertices; i++)
+				sum += shape.vertices[i][0] + shape.normals[i][1] + shape.uvs[i][0];
+			for (unsigned int i = 0; i < shape.nbIndices; i++)
+				indexSum += shape.indices[i];
+			nbTriangles += shape.nbIndices / 3;
+		}
+		total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (sum == 1234.5f && indexSum == 42)
+			printf(" ");
+	}
+	return total / nbRuns;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long maxTriangles = (argc > 1) ? atol(argv[1]) : 2000000;
+	std::string dir = (argc > 2) ? argv[2] : "/tmp";
+
+	printf("%10s %12s %12s %12s %12s %8s\n", "triangles", "text (MB)", "binary (MB)", "text (ms)", "binary (ms)", "ratio");
+	for (int n = 32; 4UL * n * n <= maxTriangles; n *= 2) {
+		std::string objName = dir + "/bench_ojm_load.obj";
+		std::string mtlName = dir + "/bench_ojm_load.mtl";
+		std::string textName = dir + "/bench_ojm_load_text.ojm";
+		std::string binaryName = dir + "/bench_ojm_load_binary.ojm";
+		writeSphere(objName, mtlName, n);
+		if (!convert(objName, textName, false) || !convert(objName, binaryName, true)) {
+			printf("conversion failed\n");
+			return 1;
+		}
+
+		int nbRuns = std::max(1, (int)(2000000 / (4L * n * n)));
+		unsigned long textTriangles, binaryTriangles;
+		double text = measureLoad(textName, nbRuns, textTriangles);
+		double binary = measureLoad(binaryName, nbRuns, binaryTriangles);
+		if (textTriangles != binaryTriangles) {
+			printf("the two files differ\n");
+			return 1;
+		}
+		printf("%10lu %12.2f %12.2f %12.3f %12.3f %8.1f\n", binaryTriangles,
+		       fileSize(textName) / 1048576.0, fileSize(binaryName) / 1048576.0, text, binary, text / binary);
+
+		remove(objName.c_str());
+		remove(mtlName.c_str());
+		remove(textName.c_str());
+		remove(binaryName.c_str());
+	}
+	return 0;
+}
@@ -0,0 +1,276 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure le blocage du thread principal quand la date saute de plusieurs siècles
+// avec l'affichage des orbites de toutes les planètes et de tous les satellites.
+//
+// Les corps sont les vrais Body de data/default_ssystem.ini chargés par
+// SolarSystem::load. Chacun reçoit l'OrbitPlot que lui donne Body : Orbit3D pour
+// les satellites, Orbit2D pour les autres. À chaque frame le thread principal fait
+// ce que fait Body::compute_position : SolarSystem::computePositions puis
+// OrbitPlot::init et OrbitPlot::computeOrbit pour chaque orbite, jusqu'à ce que
+// toutes les orbites soient à jour pour la nouvelle date. Les frames sont espacées
+// de 16.7 ms, comme à 60 Hz.
+//
+// Pour comparer deux versions de OrbitPlot, compiler ce programme sur chacune.
+//
+// usage : bench_orbit [nombre de sauts]
+
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+#define __main__
+#include "log.hpp"
+#include "anchor_manager.hpp"
+#include "app_settings.hpp"
+#include "body.hpp"
+#include "navigator.hpp"
+#include "observer.hpp"
+#include "orbit_2d.hpp"
+#include "orbit_3d.hpp"
+#include "shader.hpp"
+#include "solarsystem.hpp"
+#include "time_mgr.hpp"
+
+namespace {
+
+// l'OrbitPlot de Body, qui dit en plus si ses points sont à jour pour une date
+template<class Plot>
+class BenchOrbitPlot : public Plot {
+public:
+	BenchOrbitPlot(Body* body) : Plot(body) {}
+
+	bool hasOrbit() const {
+		return this->delta_orbitJD > 0;
+	}
+	bool isUpToDate(double date) const {
+		return fabs(this->last_orbitJD - date) <= this->delta_orbitJD;
+	}
+};
+
+// sphère UV au format OJM texte, pour le modèle par défaut de SolarSystem
+void writeSphere(const std::string &fileName, int nbSlices)
+{
+	std::ofstream out(fileName);
+	const int nbStacks = nbSlices / 2;
+	for (int i = 0; i <= nbStacks; i++) {
+		double theta = M_PI * i / nbStacks;
+		for (int j = 0; j <= nbSlices; j++) {
+			double phi = 2.0 * M_PI * j / nbSlices;
+			double x = sin(theta) * cos(phi), y = sin(theta) * sin(phi), z = cos(theta);
+			out << "v " << x << " " << y << " " << z << "\n";
+			out << "u " << (double)j / nbSlices << " " << (double)i / nbStacks << "\n";
+			out << "n " << x << " " << y << " " << z << "\n";
+		}
+	}
+	for (int i = 0; i < nbStacks; i++) {
+		for (int j = 0; j < nbSlices; j++) {
+			int a = i * (nbSlices + 1) + j, b = a + nbSlices + 1;
+			out << "i " << a << " " << b << " " << a + 1 << "\n";
+			out << "i " << a + 1 << " " << b << " " << b + 1 << "\n";
+		}
+	}
+}
+
+// HOME temporaire avec le modèle Sphere attendu par ObjLMgr::insertDefault
+bool prepareUserDir()
+{
+	char tmpl[] = "/tmp/bench_orbitXXXXXX";
+	if (mkdtemp(tmpl) == nullptr)
+		return false;
+	std::string home = tmpl;
+	setenv("HOME", home.c_str(), 1);
+	std::string dir = AppSettings::Instance()->getModel3DDir() + "Sphere";
+	for (const std::string &d : {AppSettings::Instance()->getUserDir(), AppSettings::Instance()->getModel3DDir(), dir})
+		mkdir(d.c_str(), 0755);
+	writeSphere(dir + "/Sphere_1L.ojm", 16);
+	writeSphere(dir + "/Sphere_2M.ojm", 32);
+	writeSphere(dir + "/Sphere_3H.ojm", 64);
+	return true;
+}
+
+// noms des corps de data/default_ssystem.ini, dans l'ordre de SolarSystem::load
+std::vector<std::string> readBodyNames(const std::string &fileName)
+{
+	std::vector<std::string> names;
+	std::ifstream in(fileName);
+	std::string line;
+	while (getline(in, line)) {
+		if (line.compare(0, 7, "name = ") == 0)
+			names.push_back(line.substr(7));
+	}
+	return names;
+}
+
+struct Orbits {
+	std::vector<std::unique_ptr<BenchOrbitPlot<Orbit2D>>> orbits2d;
+	std::vector<std::unique_ptr<BenchOrbitPlot<Orbit3D>>> orbits3d;
+
+	template<class Plot>
+	static void add(std::vector<std::unique_ptr<BenchOrbitPlot<Plot>>> &orbits, Body *body) {
+		orbits.emplace_back(new BenchOrbitPlot<Plot>(body));
+		orbits.back()->init();
+		if (!orbits.back()->hasOrbit())
+			orbits.pop_back();
+	}
+
+	size_t size() const {
+		return orbits2d.size() + orbits3d.size();
+	}
+
+	// comme Body::compute_position, renvoie vrai si toutes les orbites sont à jour
+	template<class Plot>
+	static bool compute(std::vector<std::unique_ptr<BenchOrbitPlot<Plot>>> &orbits, double date) {
+		bool upToDate = true;
+		for (auto &orbit : orbits) {
+			orbit->init();
+			orbit->computeOrbit(date);
+			upToDate = orbit->isUpToDate(date) && upToDate;
+		}
+		return upToDate;
+	}
+	bool compute(double date) {
+		bool upToDate = compute(orbits2d, date);
+		return compute(orbits3d, date) && upToDate;
+	}
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Result {
+	double worstStall = 0.0;	// ms
+	double totalStall = 0.0;	// ms
+	int worstFrames = 0;		// frames avant que toutes les orbites soient à jour
+};
+
+Result run(SolarSystem &ssystem, Observer &observer, Orbits &orbits, int nbJumps)
+{
+	Result result;
+	for (int jump = 0; jump < nbJumps; jump++) {
+		double date = 2451545.0 + (jump % 2 ? -1.0 : 1.0) * 36525.0 * (1 + jump);
+		int frames = 0;
+		bool upToDate = false;
+		while (!upToDate) {
+			auto start = std::chrono::steady_clock::now();
+			ssystem.computePositions(date, &observer);
+			upToDate = orbits.compute(date);
+			double stall = elapsedMs(start);
+			result.worstStall = std::max(result.worstStall, stall);
+			result.totalStall += stall;
+			frames++;
+			// une frame à 60 Hz
+			if (!upToDate)
+				std::this_thread::sleep_for(std::chrono::microseconds(16667));
+		}
+		result.worstFrames = std::max(result.worstFrames, frames);
+	}
+	return result;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int nbJumps = (argc > 1) ? atoi(argv[1]) : 10;
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+		printf("SDL_Init: %s\n", SDL_GetError());
+		return 1;
+	}
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	SDL_Window* window = SDL_CreateWindow("bench_orbit", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+	if (context == nullptr) {
+		printf("OpenGL 4.2 context: %s\n", SDL_GetError());
+		return 1;
+	}
+	glewExperimental = GL_TRUE;
+	glewInit();
+
+	AppSettings::Init("", DATA_ROOT, "");
+	if (!prepareUserDir()) {
+		printf("can't create the user directory\n");
+		return 1;
+	}
+	shaderProgram::setShaderDir(AppSettings::Instance()->getShaderDir());
+
+	Result result;
+	size_t nbOrbits;
+	{
+		// même ordre que Core : l'observateur est posé sur la Terre
+		SolarSystem ssystem;
+		TimeMgr timeMgr;
+		Navigator nav;
+		Observer observer(ssystem);
+		AnchorManager anchorManager(&observer, &nav, &ssystem, &timeMgr, ssystem.getOrbitCreator());
+		ssystem.load(std::string(DATA_ROOT) + "data/default_ssystem.ini");
+		anchorManager.initFirstAnchor("Earth");
+		// fin du fondu d'apparition des corps : computeOrbit ignore les corps invisibles
+		ssystem.update(100000, &nav, &timeMgr);
+
+		Orbits orbits;
+		for (const std::string &name : readBodyNames(std::string(DATA_ROOT) + "data/default_ssystem.ini")) {
+			Body *body = ssystem.searchByEnglishName(name);
+			if (body == nullptr)
+				continue;
+			if (dynamic_cast<Moon*>(body))
+				Orbits::add(orbits.orbits3d, body);
+			else
+				Orbits::add(orbits.orbits2d, body);
+		}
+		nbOrbits = orbits.size();
+
+		// première date hors mesure
+		ssystem.computePositions(2451545.0, &observer);
+		while (!orbits.compute(2451545.0))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		result = run(ssystem, observer, orbits, nbJumps);
+	}
+
+	printf("%d jumps of several centuries, %zu orbits\n", nbJumps, nbOrbits);
+	printf("worst stall %8.3f ms, mean stall per jump %8.3f ms, orbits up to date after %d frames\n",
+	       result.worstStall, result.totalStall / nbJumps, result.worstFrames);
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Compare les recherches d'objets du ciel dans un champ de vue, pour des
+// catalogues de taille et des champs croissants.
+//
+// "brute" teste tous les objets, comme NebulaMgr::searchAround le faisait.
+// "grid" reprend NebulaMgr::draw avec littleGrid : les 492 zones proches du champ
+// puis un test par objet de ces zones. "index" passe par SkyIndex : seuls les
+// objets des cellules à cheval sur le bord du champ sont testés.
+// "polygon" cherche dans un champ carré, avec SkyIndex et en testant tous les objets.
+// Les résultats de SkyIndex doivent être ceux du test de tous les objets ;
+// "missed" compte les objets du champ que littleGrid ne renvoie pas.
+//
+// usage : bench_sky_index [niveau de SkyIndex, 4 comme NebulaMgr] [nombre de requêtes par mesure]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "grid.hpp"
+#include "sky_index.hpp"
+
+namespace {
+
+Vec3d randomDirection(std::mt19937 &gen)
+{
+	std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+	double z = uniform(gen);
+	double phi = M_PI * uniform(gen);
+	double r = sqrt(1.0 - z*z);
+	return Vec3d(r*cos(phi), r*sin(phi), z);
+}
+
+// champ carré de demi-côté halfAngle autour de dir
+StelGeom::ConvexS squareField(const Vec3d &dir, double halfAngle)
+{
+	Vec3d u = (fabs(dir[2]) < 0.9) ? Vec3d(0, 0, 1) : Vec3d(1, 0, 0);
+	u = u ^ dir;
+	u.normalize();
+	Vec3d w = dir ^ u;
+	const double t = tan(halfAngle);
+	Vec3d e0 = dir + (u + w) * t;
+	Vec3d e1 = dir + (w - u) * t;
+	Vec3d e2 = dir - (u + w) * t;
+	Vec3d e3 = dir + (u - w) * t;
+	e0.normalize();
+	e1.normalize();
+	e2.normalize();
+	e3.normalize();
+	return StelGeom::ConvexS(e0, e1, e2, e3);
+}
+
+bool inField(const StelGeom::ConvexS &field, const Vec3d &v)
+{
+	for (const StelGeom::HalfSpace &h : field) {
+		if (!h.contains(v))
+			return false;
+	}
+	return true;
+}
+
+double elapsedUs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int level = (argc > 1) ? atoi(argv[1]) : 4;	// NEB_INDEX_LEVEL de NebulaMgr
+	int nbQueries = (argc > 2) ? atoi(argv[2]) : 200;
+
+	const int catalogSizes[] = {1000, 10000, 100000, 500000};
+	const double fovs[] = {1.0, 5.0, 20.0, 60.0, 120.0, 180.0};	// degrés
+
+	std::mt19937 gen(42);
+	std::vector<Vec3d> queries(nbQueries);
+	for (Vec3d &q : queries)
+		q = randomDirection(gen);
+
+	printf("level %d, %u cells, %d queries per measure, times in us per query\n",
+	       level, GeodesicGrid::nrOfZones(level), nbQueries);
+	printf("%8s %6s %10s %10s %10s %10s %10s %12s %12s %8s\n", "objects", "fov", "found",
+	       "brute", "grid", "index", "polygon", "tested grid", "tested index", "missed");
+
+	bool ok = true;
+	for (int nbObjects : catalogSizes) {
+		std::vector<Vec3d> positions(nbObjects);
+		for (Vec3d &p : positions)
+			p = randomDirection(gen);
+
+		littleGrid grid;
+		std::vector<std::vector<int>> zones(grid.getNbPoints());
+		SkyIndex<int> index(level);
+		for (int i = 0; i < nbObjects; i++) {
+			Vec3f pf(positions[i][0], positions[i][1], positions[i][2]);
+			zones[grid.GetNearest(pf)].push_back(i);
+			index.insert(i, positions[i]);
+		}
+		index.build();
+
+		std::vector<SkyRange> ranges;
+		for (double fov : fovs) {
+			const double radius = fov * M_PI / 360.0;
+			const double cosRadius = cos(radius);
+			long bruteFound = 0, gridFound = 0, indexFound = 0, gridTested = 0, indexTested = 0;
+			long polygonFound = 0, polygonBruteFound = 0;
+
+			auto start = std::chrono::steady_clock::now();
+			for (const Vec3d &q : queries) {
+				for (const Vec3d &p : positions) {
+					if (p*q >= cosRadius)
+						bruteFound++;
+				}
+			}
+			double bruteTime = elapsedUs(start);
+
+			start = std::chrono::steady_clock::now();
+			for (const Vec3d &q : queries) {
+				int nbZones = grid.Intersect(Vec3f(q[0], q[1], q[2]), 2.f*radius);
+				const int *zoneList = grid.getResult();
+				for (int z = 0; z < nbZones; z++) {
+					for (int i : zones[zoneList[z]]) {
+						gridTested++;
+						if (positions[i]*q >= cosRadius)
+							gridFound++;
+					}
+				}
+			}
+			double gridTime = elapsedUs(start);
+
+			start = std::chrono::steady_clock::now();
+			for (const Vec3d &q : queries) {
+				index.searchCone(q, radius, ranges);
+				for (const SkyRange &r : ranges) {
+					if (r.inside) {
+						indexFound += r.last - r.first;
+						continue;
+					}
+					for (unsigned int i = r.first; i < r.last; i++) {
+						indexTested++;
+						if (positions[index[i]]*q >= cosRadius)
+							indexFound++;
+					}
+				}
+			}
+			double indexTime = elapsedUs(start);
+
+			start = std::chrono::steady_clock::now();
+			for (const Vec3d &q : queries) {
+				StelGeom::ConvexS field = squareField(q, std::min(radius, 0.49 * M_PI));
+				index.search(field, ranges);
+				for (const SkyRange &r : ranges) {
+					if (r.inside) {
+						polygonFound += r.last - r.first;
+						continue;
+					}
+					for (unsigned int i = r.first; i < r.last; i++) {
+						if (inField(field, positions[index[i]]))
+							polygonFound++;
+					}
+				}
+			}
+			double polygonTime = elapsedUs(start);
+
+			for (const Vec3d &q : queries) {
+				StelGeom::ConvexS field = squareField(q, std::min(radius, 0.49 * M_PI));
+				for (const Vec3d &p : positions) {
+					if (inField(field, p))
+						polygonBruteFound++;
+				}
+			}
+
+			if (indexFound != bruteFound || polygonFound != polygonBruteFound) {
+				printf("error: index %ld instead of %ld, polygon %ld instead of %ld\n",
+				       indexFound, bruteFound, polygonFound, polygonBruteFound);
+				ok = false;
+			}
+
+			printf("%8d %6.0f %10.1f %10.2f %10.2f %10.2f %10.2f %12.1f %12.1f %8ld\n", nbObjects, fov,
+			       (double)bruteFound / nbQueries, bruteTime / nbQueries, gridTime / nbQueries,
+			       indexTime / nbQueries, polygonTime / nbQueries,
+			       (double)gridTested / nbQueries, (double)indexTested / nbQueries, bruteFound - gridFound);
+		}
+	}
+	return ok ? 0 : 1;
+}
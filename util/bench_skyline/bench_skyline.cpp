@@ -0,0 +1,228 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure le temps CPU par frame de chaque ligne de SkyLineMgr quand elle est seule
+// affichée, comme la voit la boucle de Core : SkyLineMgr::draw avec les vrais
+// Projector, Navigator, TimeMgr et Observer, la Terre chargée depuis
+// data/default_ssystem.ini et le ciel qui tourne d'une minute par frame.
+//
+// Le temps compté est celui du thread appelant dans SkyLineMgr::draw, glFinish est
+// appelé hors de la mesure : le travail du GPU (ou de llvmpipe) n'est pas compté.
+// Les labels sont affichés avec la police donnée en argument, sans police seuls les
+// tracés sont mesurés.
+//
+// Pour comparer deux versions de skyline.cpp, compiler ce programme sur chacune.
+//
+// usage : bench_skyline [nombre de frames] [internalNav 0|1] [police ttf]
+
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#define __main__
+#include "log.hpp"
+#include "anchor_manager.hpp"
+#include "app_settings.hpp"
+#include "navigator.hpp"
+#include "observer.hpp"
+#include "projector.hpp"
+#include "shader.hpp"
+#include "skyline_mgr.hpp"
+#include "solarsystem.hpp"
+#include "time_mgr.hpp"
+#include "ubo_cam.hpp"
+
+namespace {
+
+// toutes les lignes créées par Core
+const char *lineTypes[] = {
+	"LINE_CIRCLE_POLAR", "LINE_ECLIPTIC_POLE", "LINE_GALACTIC_POLE", "LINE_ANALEMMA",
+	"LINE_ANALEMMALINE", "LINE_CIRCUMPOLAR", "LINE_GALACTIC_CENTER", "LINE_VERNAL",
+	"LINE_GREENWICH", "LINE_ARIES", "LINE_EQUATOR", "LINE_GALACTIC_EQUATOR",
+	"LINE_MERIDIAN", "LINE_TROPIC", "LINE_ECLIPTIC", "LINE_PRECESSION",
+	"LINE_VERTICAL", "LINE_ZODIAC", "LINE_ZENITH"
+};
+
+// sphère UV au format OJM texte, pour le modèle par défaut de SolarSystem
+void writeSphere(const std::string &fileName, int nbSlices)
+{
+	std::ofstream out(fileName);
+	const int nbStacks = nbSlices / 2;
+	for (int i = 0; i <= nbStacks; i++) {
+		double theta = M_PI * i / nbStacks;
+		for (int j = 0; j <= nbSlices; j++) {
+			double phi = 2.0 * M_PI * j / nbSlices;
+			double x = sin(theta) * cos(phi), y = sin(theta) * sin(phi), z = cos(theta);
+			out << "v " << x << " " << y << " " << z << "\n";
+			out << "u " << (double)j / nbSlices << " " << (double)i / nbStacks << "\n";
+			out << "n " << x << " " << y << " " << z << "\n";
+		}
+	}
+	for (int i = 0; i < nbStacks; i++) {
+		for (int j = 0; j < nbSlices; j++) {
+			int a = i * (nbSlices + 1) + j, b = a + nbSlices + 1;
+			out << "i " << a << " " << b << " " << a + 1 << "\n";
+			out << "i " << a + 1 << " " << b << " " << b + 1 << "\n";
+		}
+	}
+}
+
+// HOME temporaire avec le modèle Sphere attendu par ObjLMgr::insertDefault
+bool prepareUserDir()
+{
+	char tmpl[] = "/tmp/bench_skylineXXXXXX";
+	if (mkdtemp(tmpl) == nullptr)
+		return false;
+	std::string home = tmpl;
+	setenv("HOME", home.c_str(), 1);
+	std::string dir = AppSettings::Instance()->getModel3DDir() + "Sphere";
+	for (const std::string &d : {AppSettings::Instance()->getUserDir(), AppSettings::Instance()->getModel3DDir(), dir})
+		mkdir(d.c_str(), 0755);
+	writeSphere(dir + "/Sphere_1L.ojm", 16);
+	writeSphere(dir + "/Sphere_2M.ojm", 32);
+	writeSphere(dir + "/Sphere_3H.ojm", 64);
+	return true;
+}
+
+struct Scene {
+	SolarSystem *ssystem;
+	Observer *observer;
+	TimeMgr *timeMgr;
+	Navigator nav;
+	Projector prj {Vec4i(0, 0, 2048, 2048), 180.};
+	UBOCam ubo {"cam_block"};
+
+	// comme Core::updateInSolarSystem et Core::draw
+	void update(double date) {
+		timeMgr->setJDay(date);
+		ssystem->computePositions(date, observer);
+		ssystem->computeTransMatrices(date, observer);
+		nav.updateTransformMatrices(observer, date);
+		nav.updateViewMat(&prj, prj.getFov());
+		ubo.setViewport(prj.getViewport());
+		ubo.setClippingFov(prj.getClippingFov());
+		ubo.setViewportCenter(prj.getViewportFloatCenter());
+		ubo.setMVP2D(prj.getMatProjectionOrtho2D());
+		ubo.update();
+	}
+};
+
+// temps moyen en us du thread appelant dans SkyLineMgr::draw
+double measure(Scene &scene, SkyLineMgr &lines, int nbFrames)
+{
+	const double start = 2451545.0;
+	// première frame hors mesure : les VBO et les glyphes sont construits à la demande
+	scene.update(start);
+	lines.draw(&scene.prj, &scene.nav, scene.timeMgr, scene.observer);
+	glFinish();
+
+	double total = 0.0;
+	for (int frame = 1; frame <= nbFrames; frame++) {
+		scene.update(start + frame / 1440.0);
+		auto t = std::chrono::steady_clock::now();
+		lines.draw(&scene.prj, &scene.nav, scene.timeMgr, scene.observer);
+		total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t).count();
+		glFinish();
+	}
+	return total / nbFrames;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int nbFrames = (argc > 1) ? atoi(argv[1]) : 2000;
+	bool internalNav = (argc > 2) ? atoi(argv[2]) != 0 : false;
+	std::string fontName = (argc > 3) ? argv[3] : "";
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() < 0) {
+		printf("SDL_Init: %s\n", SDL_GetError());
+		return 1;
+	}
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	SDL_Window* window = SDL_CreateWindow("bench_skyline", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+	if (context == nullptr) {
+		printf("OpenGL 4.2 context: %s\n", SDL_GetError());
+		return 1;
+	}
+	glewExperimental = GL_TRUE;
+	glewInit();
+
+	AppSettings::Init("", DATA_ROOT, "");
+	if (!prepareUserDir()) {
+		printf("can't create the user directory\n");
+		return 1;
+	}
+	shaderProgram::setShaderDir(AppSettings::Instance()->getShaderDir());
+
+	{
+		Scene scene;
+		// même ordre que Core : l'observateur est posé sur la Terre
+		SolarSystem ssystem;
+		TimeMgr timeMgr;
+		Observer observer(ssystem);
+		AnchorManager anchorManager(&observer, &scene.nav, &ssystem, &timeMgr, ssystem.getOrbitCreator());
+		ssystem.load(std::string(DATA_ROOT) + "data/default_ssystem.ini");
+		anchorManager.initFirstAnchor("Earth");
+		observer.setLatitude(45.);	// les cercles circumpolaires ne sont pas dégénérés
+		scene.ssystem = &ssystem;
+		scene.observer = &observer;
+		scene.timeMgr = &timeMgr;
+
+		SkyLineMgr lines;
+		for (const char *type : lineTypes)
+			lines.Create(type);
+		if (!fontName.empty())
+			lines.setFont(12.f, fontName);
+		lines.setInternalNav(internalNav);
+
+		printf("%d frames, internalNav %d, labels %s, CPU time per frame\n", nbFrames, internalNav, fontName.empty() ? "off" : "on");
+		double total = 0.0;
+		for (const char *type : lineTypes) {
+			lines.setFlagShow(type, true);
+			lines.update(100000);
+			double t = measure(scene, lines, nbFrames);
+			total += t;
+			printf("%-22s %9.2f us\n", type, t);
+			lines.setFlagShow(type, false);
+			lines.update(100000);
+		}
+		printf("%-22s %9.2f us\n", "total", total);
+	}
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	TTF_Quit();
+	SDL_Quit();
+	return 0;
+}
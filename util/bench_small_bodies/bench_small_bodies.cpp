@@ -0,0 +1,356 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure la préparation et l'affichage du système solaire quand on y ajoute de
+// 10 à 100000 petits corps, comme ceux produits par generate-asteroid-sts.pl.
+//
+// Les corps sont de vrais Body : ceux de data/default_ssystem.ini chargés par
+// SolarSystem::load, puis des astéroïdes ajoutés par SolarSystem::addBody avec les
+// paramètres qu'écrit generate-asteroid-sts.pl (halo en plus). Le contexte OpenGL est
+// celui de SDL, la sphère par défaut est écrite dans un HOME temporaire.
+//
+// "full" refait l'ancien SolarSystem::computePreDraw puis SolarSystem::draw : pour
+// chaque corps compute_distance, computeMagnitude et computeDraw, un tri de tous les
+// corps, puis drawGL, qui dessine un halo par corps. "tiered" suit le chemin actuel :
+// Body::computeDrawPoint pour les petits corps, computeDraw et le tri pour les autres,
+// Body::addToBatch puis un seul HaloBatch::draw pour les halos des petits corps.
+// La colonne "draws" compte les appels de drawGL et de HaloBatch::draw par frame.
+//
+// Une passe de contrôle vérifie que computeDrawPoint donne la même visibilité et le
+// même halo que computeDraw pour tous les petits corps.
+//
+// usage : bench_small_bodies [nombre de frames]
+
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#define __main__
+#include "log.hpp"
+#include "anchor_manager.hpp"
+#include "app_settings.hpp"
+#include "body.hpp"
+#include "halo_batch.hpp"
+#include "navigator.hpp"
+#include "observer.hpp"
+#include "projector.hpp"
+#include "shader.hpp"
+#include "solarsystem.hpp"
+#include "time_mgr.hpp"
+#include "tone_reproductor.hpp"
+
+namespace {
+
+// sphère UV au format OJM texte, pour le modèle par défaut de SolarSystem
+void writeSphere(const std::string &fileName, int nbSlices)
+{
+	std::ofstream out(fileName);
+	const int nbStacks = nbSlices / 2;
+	for (int i = 0; i <= nbStacks; i++) {
+		double theta = M_PI * i / nbStacks;
+		for (int j = 0; j <= nbSlices; j++) {
+			double phi = 2.0 * M_PI * j / nbSlices;
+			double x = sin(theta) * cos(phi), y = sin(theta) * sin(phi), z = cos(theta);
+			out << "v " << x << " " << y << " " << z << "\n";
+			out << "u " << (double)j / nbSlices << " " << (double)i / nbStacks << "\n";
+			out << "n " << x << " " << y << " " << z << "\n";
+		}
+	}
+	for (int i = 0; i < nbStacks; i++) {
+		for (int j = 0; j < nbSlices; j++) {
+			int a = i * (nbSlices + 1) + j, b = a + nbSlices + 1;
+			out << "i " << a << " " << b << " " << a + 1 << "\n";
+			out << "i " << a + 1 << " " << b << " " << b + 1 << "\n";
+		}
+	}
+}
+
+// HOME temporaire avec le modèle Sphere attendu par ObjLMgr::insertDefault
+bool prepareUserDir()
+{
+	char tmpl[] = "/tmp/bench_small_bodiesXXXXXX";
+	if (mkdtemp(tmpl) == nullptr)
+		return false;
+	std::string home = tmpl;
+	setenv("HOME", home.c_str(), 1);
+	std::string dir = AppSettings::Instance()->getModel3DDir() + "Sphere";
+	for (const std::string &d : {AppSettings::Instance()->getUserDir(), AppSettings::Instance()->getModel3DDir(), dir})
+		mkdir(d.c_str(), 0755);
+	writeSphere(dir + "/Sphere_1L.ojm", 16);
+	writeSphere(dir + "/Sphere_2M.ojm", 32);
+	writeSphere(dir + "/Sphere_3H.ojm", 64);
+	return true;
+}
+
+// noms des corps de data/default_ssystem.ini, dans l'ordre de SolarSystem::load
+std::vector<std::string> readBodyNames(const std::string &fileName)
+{
+	std::vector<std::string> names;
+	std::ifstream in(fileName);
+	std::string line;
+	while (getline(in, line)) {
+		if (line.compare(0, 7, "name = ") == 0)
+			names.push_back(line.substr(7));
+	}
+	return names;
+}
+
+// mêmes paramètres que generate-asteroid-sts.pl, halo en plus
+void addAsteroids(SolarSystem &ssystem, std::vector<Body*> &smallBodies, int nb)
+{
+	for (int i = smallBodies.size(); i < nb; i++) {
+		double a = 2.1 + 1.2 * rand() / RAND_MAX;
+		stringHash_t params;
+		params["name"] = "bench_" + std::to_string(i);
+		params["parent"] = "Sun";
+		params["type"] = "Asteroid";
+		params["oblateness"] = "0.0";
+		params["color"] = "1.0,1.0,1.0";
+		params["coord_func"] = "comet_orbit";
+		params["halo"] = "true";
+		params["lighting"] = "false";
+		params["radius"] = std::to_string(1.0 + 100.0 * rand() / RAND_MAX);
+		params["albedo"] = std::to_string(0.1 + 0.3 * rand() / RAND_MAX);
+		params["orbit_epoch"] = "2451545.0";
+		params["orbit_semimajoraxis"] = std::to_string(a);
+		params["orbit_eccentricity"] = std::to_string(0.2 * rand() / RAND_MAX);
+		params["orbit_inclination"] = std::to_string(20.0 * rand() / RAND_MAX);
+		params["orbit_ascendingnode"] = std::to_string(360.0 * rand() / RAND_MAX);
+		params["orbit_argofpericenter"] = std::to_string(360.0 * rand() / RAND_MAX);
+		params["orbit_meananomaly"] = std::to_string(360.0 * rand() / RAND_MAX);
+		params["orbit_visualization_period"] = std::to_string(365.256363051 * pow(a, 1.5));
+		ssystem.addBody(params);
+		smallBodies.push_back(ssystem.searchByEnglishName(params["name"]));
+	}
+}
+
+struct Scene {
+	SolarSystem *ssystem;
+	Observer *observer;
+	Navigator nav;
+	Projector prj {Vec4i(0, 0, 2048, 2048), 120.};
+	ToneReproductor eye;
+	std::vector<Body*> bodies;
+
+	// comme Core::updateInSolarSystem
+	void update(double date) {
+		ssystem->computePositions(date, observer);
+		ssystem->computeTransMatrices(date, observer);
+		nav.updateTransformMatrices(observer, date);
+		nav.updateViewMat(&prj, prj.getFov());
+	}
+
+	void draw(Body *body) {
+		body->drawGL(&prj, &nav, observer, &eye, false, false, false);
+	}
+};
+
+bool biggerDistance(Body *i, Body *j)
+{
+	return i->getDistance() > j->getDistance();
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	glFinish();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ancien chemin : tout calculer, tout trier, un drawGL par corps
+double runFull(Scene &scene, int nbFrames, long &draws)
+{
+	std::vector<Body*> rendered = scene.bodies;
+	volatile float sink = 0.f;
+
+	double total = 0.0;
+	draws = 0;
+	for (int f = 0; f < nbFrames; f++) {
+		scene.update(2451545.0 + 2.0 * f);
+		auto start = std::chrono::steady_clock::now();
+		Vec3d obs = scene.nav.getObserverHelioPos();
+		for (Body *b : rendered) {
+			b->compute_distance(obs);
+			sink = sink + b->computeMagnitude(&scene.nav);
+			b->computeDraw(&scene.prj, &scene.nav);
+		}
+		std::sort(rendered.begin(), rendered.end(), biggerDistance);
+		for (Body *b : rendered) {
+			scene.draw(b);
+			draws++;
+		}
+		total += elapsedMs(start);
+	}
+	return total / nbFrames;
+}
+
+// chemin actuel de SolarSystem::computePreDraw et SolarSystem::draw
+double runTiered(Scene &scene, int nbFrames, long &draws)
+{
+	std::vector<Body*> drawn, points;
+	HaloBatch haloBatch;
+
+	double total = 0.0;
+	draws = 0;
+	for (int f = 0; f < nbFrames; f++) {
+		scene.update(2451545.0 + 2.0 * f);
+		auto start = std::chrono::steady_clock::now();
+		Vec3d obs = scene.nav.getObserverHelioPos();
+		drawn.clear();
+		points.clear();
+		for (Body *b : scene.bodies) {
+			b->compute_distance(obs);
+			if (b->canBeBatched() && b->computeDrawPoint(&scene.prj, &scene.nav)) {
+				points.push_back(b);
+				continue;
+			}
+			b->computeDraw(&scene.prj, &scene.nav);
+			drawn.push_back(b);
+		}
+		std::sort(drawn.begin(), drawn.end(), biggerDistance);
+
+		haloBatch.clear();
+		for (Body *b : points)
+			b->addToBatch(&scene.nav, &scene.prj, scene.observer, &scene.eye, false, haloBatch);
+		haloBatch.draw();
+		draws++;
+
+		for (Body *b : drawn) {
+			scene.draw(b);
+			draws++;
+		}
+		total += elapsedMs(start);
+	}
+	return total / nbFrames;
+}
+
+// contrôle : un petit corps donne-t-il le même halo après computeDrawPoint qu'après computeDraw ?
+int checkPoints(Scene &scene, const std::vector<Body*> &smallBodies, int &nbPoints)
+{
+	HaloBatch full, point;
+	int nbErrors = 0;
+	nbPoints = 0;
+	for (int f = 0; f < 5; f++) {
+		scene.update(2451545.0 + 37.0 * f);
+		Vec3d obs = scene.nav.getObserverHelioPos();
+		for (Body *b : smallBodies) {
+			b->compute_distance(obs);
+			full.clear();
+			point.clear();
+			b->computeDraw(&scene.prj, &scene.nav);
+			b->addToBatch(&scene.nav, &scene.prj, scene.observer, &scene.eye, false, full);
+			if (!b->computeDrawPoint(&scene.prj, &scene.nav))
+				continue;
+			b->addToBatch(&scene.nav, &scene.prj, scene.observer, &scene.eye, false, point);
+			nbPoints++;
+			if (full.size() != point.size())
+				nbErrors++;
+		}
+	}
+	return nbErrors;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int nbFrames = (argc > 1) ? atoi(argv[1]) : 20;
+	srand(1);
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+		printf("SDL_Init: %s\n", SDL_GetError());
+		return 1;
+	}
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	SDL_Window* window = SDL_CreateWindow("bench_small_bodies", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+	if (context == nullptr) {
+		printf("OpenGL 4.2 context: %s\n", SDL_GetError());
+		return 1;
+	}
+	glewExperimental = GL_TRUE;
+	glewInit();
+
+	AppSettings::Init("", DATA_ROOT, "");
+	if (!prepareUserDir()) {
+		printf("can't create the user directory\n");
+		return 1;
+	}
+	shaderProgram::setShaderDir(AppSettings::Instance()->getShaderDir());
+
+	Scene scene;
+	scene.eye.setWorldAdaptationLuminance(3.75f);	// ciel nocturne sans atmosphère, comme Core
+	// même ordre que Core : addBody déclare chaque corps à l'AnchorManager
+	SolarSystem ssystem;
+	TimeMgr timeMgr;
+	Observer observer(ssystem);
+	AnchorManager anchorManager(&observer, &scene.nav, &ssystem, &timeMgr, ssystem.getOrbitCreator());
+	ssystem.load(std::string(DATA_ROOT) + "data/default_ssystem.ini");
+	anchorManager.initFirstAnchor("Earth");
+	scene.ssystem = &ssystem;
+	scene.observer = &observer;
+	for (const std::string &name : readBodyNames(std::string(DATA_ROOT) + "data/default_ssystem.ini")) {
+		Body *body = ssystem.searchByEnglishName(name);
+		if (body != nullptr)
+			scene.bodies.push_back(body);
+	}
+	const size_t nbBigBodies = scene.bodies.size();
+
+	std::vector<Body*> smallBodies;
+	addAsteroids(ssystem, smallBodies, 20000);
+	int nbPoints;
+	int nbErrors = checkPoints(scene, smallBodies, nbPoints);
+
+	printf("%d frames, %zu bodies from default_ssystem.ini, %d small body checks\n", nbFrames, nbBigBodies, nbPoints);
+	printf("small bodies      full      draws      tiered      draws\n");
+	const int counts[] = {10, 100, 1000, 10000, 100000};
+	for (int nbSmall : counts) {
+		addAsteroids(ssystem, smallBodies, nbSmall);
+		scene.bodies.resize(nbBigBodies);
+		scene.bodies.insert(scene.bodies.end(), smallBodies.begin(), smallBodies.begin() + nbSmall);
+		long fullDraws, tieredDraws;
+		double full = runFull(scene, nbFrames, fullDraws);
+		double tiered = runTiered(scene, nbFrames, tieredDraws);
+		printf("%12d %9.3f ms %8ld %9.3f ms %8ld\n", nbSmall, full, fullDraws / nbFrames, tiered, tieredDraws / nbFrames);
+	}
+
+	if (nbErrors == 0)
+		printf("small bodies ok\n");
+	else
+		printf("small bodies errors (%d)\n", nbErrors);
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return nbErrors == 0 ? 0 : 1;
+}
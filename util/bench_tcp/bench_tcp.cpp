@@ -0,0 +1,192 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+
+// Mesure la latence des commandes reçues par le serveur TCP de contrôle quand
+// de nombreux clients locaux l'inondent de commandes.
+//
+// Chaque client envoie ses commandes en y inscrivant la date d'envoi ; une partie
+// est coupée en deux écritures pour vérifier que les lignes sont bien recomposées.
+// Le thread principal lit les commandes avec getInput() comme App::update, et la
+// latence est le temps entre l'envoi par le client et la lecture par le thread principal.
+//
+// usage : bench_tcp [nombre de clients] [commandes par client] [pause entre deux commandes en µs] [port]
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define __main__
+#include "log.hpp"
+#include "io.hpp"
+
+// io.cpp ne s'en sert que pour les requêtes HTTP, que ce test n'envoie pas
+AppSettings* AppSettings::Instance()
+{
+	return nullptr;
+}
+
+const std::string AppSettings::getWebDir() const
+{
+	return "";
+}
+
+namespace {
+
+long long nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void sendAll(int fd, const char* data, size_t size)
+{
+	while (size > 0) {
+		ssize_t count = send(fd, data, size, MSG_NOSIGNAL);
+		if (count <= 0)
+			return;
+		data += count;
+		size -= count;
+	}
+}
+
+void runClient(int id, int port, int nbCommands, int pauseUs, std::atomic<int> *ready, std::atomic<bool> *go)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+	if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+		printf("client %d: connect failed\n", id);
+		(*ready)++;
+		close(fd);
+		return;
+	}
+	(*ready)++;
+	while (!*go)
+		std::this_thread::yield();
+
+	char line[128];
+	for (int c = 0; c < nbCommands; c++) {
+		int size = snprintf(line, sizeof(line), "bench client %d command %d sent %lld\n", id, c, nowNs());
+		if (c % 4 == 0) {
+			// une ligne en deux morceaux, le serveur doit attendre la fin de ligne
+			sendAll(fd, line, size / 2);
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+			sendAll(fd, line + size / 2, size - size / 2);
+		} else
+			sendAll(fd, line, size);
+		if (pauseUs > 0)
+			std::this_thread::sleep_for(std::chrono::microseconds(pauseUs));
+	}
+	// laisse le serveur tout lire avant la fermeture
+	shutdown(fd, SHUT_WR);
+	char drain[256];
+	while (recv(fd, drain, sizeof(drain), 0) > 0) {}
+	close(fd);
+}
+
+double percentile(const std::vector<long long> &sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+	size_t index = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+	return sorted[index] / 1000.0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int nbClients = (argc > 1) ? atoi(argv[1]) : 16;
+	int nbCommands = (argc > 2) ? atoi(argv[2]) : 2000;
+	int pauseUs = (argc > 3) ? atoi(argv[3]) : 500;
+	int port = (argc > 4) ? atoi(argv[4]) : 7899;
+
+	ServerSocket server(port, nbClients, 65536, IO_DEBUG_WARN, IO_DEBUG_ALL);
+	if (server.open() != IO_NO_ERROR) {
+		printf("cannot open the server on port %d\n", port);
+		return 1;
+	}
+
+	std::atomic<int> ready(0);
+	std::atomic<bool> go(false);
+	std::vector<std::thread> clients;
+	for (int i = 0; i < nbClients; i++)
+		clients.emplace_back(runClient, i, port, nbCommands, pauseUs, &ready, &go);
+	while (ready < nbClients)
+		std::this_thread::yield();
+
+	const long total = (long)nbClients * nbCommands;
+	std::vector<long long> latencies;
+	latencies.reserve(total);
+	std::vector<int> nextCommand(nbClients, 0);
+	long outOfOrder = 0, malformed = 0;
+
+	long long start = nowNs();
+	go = true;
+	long long lastInput = nowNs();
+	while ((long)latencies.size() < total && nowNs() - lastInput < 2000000000LL) {
+		std::string input = server.getInput();
+		if (input.empty()) {
+			std::this_thread::yield();
+			continue;
+		}
+		long long received = nowNs();
+		lastInput = received;
+		int id, command;
+		long long sent;
+		if (sscanf(input.c_str(), "bench client %d command %d sent %lld", &id, &command, &sent) != 3 || id < 0 || id >= nbClients) {
+			malformed++;
+			continue;
+		}
+		if (command != nextCommand[id])
+			outOfOrder++;
+		nextCommand[id] = command + 1;
+		latencies.push_back(received - sent);
+	}
+	double elapsed = (nowNs() - start) / 1e9;
+
+	for (std::thread &client : clients)
+		client.join();
+	server.close();
+
+	std::sort(latencies.begin(), latencies.end());
+	printf("%d clients, %d commands each, %d µs between commands\n", nbClients, nbCommands, pauseUs);
+	printf("received %zu/%ld commands in %.2f s (%.0f commands/s), %ld malformed, %ld out of order\n",
+	       latencies.size(), total, elapsed, latencies.size() / elapsed, malformed, outOfOrder);
+	printf("latency p50 %8.1f µs, p99 %8.1f µs, max %8.1f µs\n",
+	       percentile(latencies, 0.50), percentile(latencies, 0.99), latencies.empty() ? 0.0 : latencies.back() / 1000.0);
+	return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure la lecture des images par TextureCache, comme au démarrage :
+//
+// "nocache" : sans cache, décodage de l'image seule, les mipmaps restent à faire par GL ;
+// "cold"    : premier démarrage, décodage, calcul des mipmaps et écriture dans le cache ;
+// "warm"    : démarrages suivants, projection de l'entrée du cache puis lecture de tous
+//             ses octets, comme le fait l'envoi à GL.
+//
+// Les données de "warm" doivent être identiques à celles de "cold". Pour finir, la date
+// de chaque image est changée : l'entrée du cache ne doit plus être utilisée. Les images
+// sont d'abord copiées dans un répertoire temporaire, les originaux ne sont pas touchés.
+//
+// usage : bench_texture_cache <image>...
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "texture_cache.hpp"
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long touch(const TextureCache::Image &image)
+{
+	unsigned long sum = 0;
+	for (size_t i = 0; i < image.getSize(); i += 64)
+		sum += image.getData()[i];
+	return sum;
+}
+
+bool copyFile(const std::string &from, const std::string &to)
+{
+	std::ifstream in(from.c_str(), std::ios::binary);
+	std::ofstream out(to.c_str(), std::ios::binary);
+	out << in.rdbuf();
+	return in.good() && out.good();
+}
+
+void removeEntries(const std::string &dir)
+{
+	DIR *d = opendir(dir.c_str());
+	if (d == nullptr)
+		return;
+	while (struct dirent *entry = readdir(d)) {
+		if (entry->d_name[0] != '.')
+			remove((dir + "/" + entry->d_name).c_str());
+	}
+	closedir(d);
+	rmdir(dir.c_str());
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		printf("usage: %s <image>...\n", argv[0]);
+		return 1;
+	}
+
+	char dirTemplate[] = "/tmp/bench_texture_cacheXXXXXX";
+	if (mkdtemp(dirTemplate) == nullptr) {
+		perror("mkdtemp");
+		return 1;
+	}
+	std::string cacheDir = dirTemplate;
+
+	std::vector<std::string> images;
+	for (int i = 1; i < argc; i++) {
+		std::string name = argv[i];
+		size_t dot = name.find_last_of('.');
+		std::string copy = cacheDir + "/image" + std::to_string(i) + (dot == std::string::npos ? "" : name.substr(dot));
+		if (!copyFile(name, copy)) {
+			printf("%s: can't copy\n", name.c_str());
+			removeEntries(cacheDir);
+			return 1;
+		}
+		images.push_back(copy);
+	}
+
+	double total[3] = {0.0, 0.0, 0.0};
+	bool ok = true;
+	unsigned long sum = 0;
+	printf("%-40s %12s %6s %10s %10s %10s\n", "image", "size", "levels", "nocache", "cold", "warm");
+	for (unsigned int i = 0; i < images.size(); i++) {
+		const std::string &name = images[i];
+		TextureCache::Image nocache, cold, warm;
+
+		TextureCache::setDirectory("", UINT64_MAX);
+		auto start = std::chrono::steady_clock::now();
+		if (!TextureCache::load(name, PNG_BLEND1, true, nocache)) {
+			printf("%s: can't read\n", argv[i + 1]);
+			ok = false;
+			continue;
+		}
+		sum += touch(nocache);
+		double nocacheTime = elapsedMs(start);
+
+		TextureCache::setDirectory(cacheDir, UINT64_MAX);
+		start = std::chrono::steady_clock::now();
+		TextureCache::load(name, PNG_BLEND1, true, cold);
+		sum += touch(cold);
+		double coldTime = elapsedMs(start);
+
+		start = std::chrono::steady_clock::now();
+		TextureCache::load(name, PNG_BLEND1, true, warm);
+		sum += touch(warm);
+		double warmTime = elapsedMs(start);
+
+		if (!warm.isCached() || warm.getSize() != cold.getSize() || memcmp(warm.getData(), cold.getData(), cold.getSize()) != 0 ||
+		        memcmp(nocache.getData(), cold.getData(), nocache.getSize()) != 0) {
+			printf("%s: cached data differs\n", argv[i + 1]);
+			ok = false;
+		}
+
+		char size[32];
+		snprintf(size, sizeof(size), "%dx%d", cold.getWidth(), cold.getHeight());
+		printf("%-40s %12s %6u %7.1f ms %7.1f ms %7.1f ms\n", argv[i + 1], size, cold.getNbLevels(), nocacheTime, coldTime, warmTime);
+		total[0] += nocacheTime;
+		total[1] += coldTime;
+		total[2] += warmTime;
+	}
+	printf("%-40s %12s %6s %7.1f ms %7.1f ms %7.1f ms\n", "total", "", "", total[0], total[1], total[2]);
+
+	// une image modifiée ne doit plus être lue depuis le cache
+	for (unsigned int i = 0; i < images.size(); i++) {
+		struct utimbuf times;
+		times.actime = times.modtime = time(nullptr) + 10;
+		if (utime(images[i].c_str(), &times) != 0)
+			continue;
+		TextureCache::Image image;
+		if (TextureCache::load(images[i], PNG_BLEND1, true, image) && image.isCached()) {
+			printf("%s: stale cache entry used\n", argv[i + 1]);
+			ok = false;
+		}
+	}
+	printf("%s (%lu)\n", ok ? "cache ok" : "cache errors", sum % 10);
+
+	removeEntries(cacheDir);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure la mise à jour et la préparation de l'affichage des traînées de tous les
+// corps quand le temps défile très vite.
+//
+// "list" reproduit l'ancien Trail : std::list de points, parcours de toute la liste à
+// chaque frame pour retirer les points trop anciens et copie de toute la traînée dans
+// des vecteurs avant l'envoi à la carte. "ring" passe par TrailBuffer : tampon circulaire,
+// expiration par dichotomie et copie des seuls vertices ajoutés depuis la frame précédente.
+// La copie vers un tableau remplace ici l'envoi par glBufferSubData.
+//
+// Une passe de contrôle fait tourner les deux versions côte à côte, avec des retours
+// en arrière du temps, et vérifie à chaque frame que les points et les vertices envoyés
+// sont les mêmes.
+//
+// usage : bench_trail [nombre de corps] [nombre de frames]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <vector>
+
+#include "trail_buffer.hpp"
+
+namespace {
+
+const int MAX_TRAIL = 1460;
+const double DELTA_TRAIL = 1.0;
+
+Vec3d bodyPosition(int body, double date)
+{
+	double period = 20.0 + 37.0 * body;
+	double a = 2.0 * M_PI * date / period;
+	double r = 1.0 + 0.1 * body;
+	return Vec3d(r * cos(a), r * sin(a), 0.01 * r * sin(3.0 * a));
+}
+
+// ancien Trail::updateTrail et Trail::drawTrail, sans GL
+struct ListTrail {
+	std::list<TrailPoint> trail;
+	std::vector<float> vecTrailPos;
+	std::vector<float> vecTrailColor;
+	double last_trailJD = 0;
+	bool first_point = true;
+
+	void update(int body, double date) {
+		int dt=0;
+		if (first_point || (dt=abs(int((date-last_trailJD)/DELTA_TRAIL))) > MAX_TRAIL) {
+			dt=1;
+			trail.clear();
+			first_point = false;
+		}
+		if (dt) {
+			last_trailJD = date;
+			TrailPoint tp;
+			tp.point = bodyPosition(body, date);
+			tp.date = date;
+			trail.push_front(tp);
+			if (trail.size() > (unsigned int)MAX_TRAIL)
+				trail.pop_back();
+		}
+		std::list<TrailPoint>::iterator end = trail.end();
+		for (std::list<TrailPoint>::iterator iter=trail.begin(); iter != end; iter++) {
+			if (fabs((*iter).date - date)/DELTA_TRAIL > MAX_TRAIL) {
+				trail.erase(iter, end);
+				break;
+			}
+		}
+	}
+
+	int draw(const Vec3d &current) {
+		float segment = 0;
+		vecTrailPos.push_back(current[0]);
+		vecTrailPos.push_back(current[1]);
+		vecTrailPos.push_back(current[2]);
+		vecTrailColor.push_back(1.0);
+		for (const TrailPoint &tp : trail) {
+			segment++;
+			vecTrailPos.push_back(tp.point[0]);
+			vecTrailPos.push_back(tp.point[1]);
+			vecTrailPos.push_back(tp.point[2]);
+			vecTrailColor.push_back(segment);
+		}
+		int nbPos = vecTrailPos.size()/3;
+		vecTrailPos.clear();
+		vecTrailColor.clear();
+		return nbPos;
+	}
+};
+
+// nouveau Trail::updateTrail et Trail::drawTrail, le vertex buffer étant un tableau
+struct RingTrail {
+	RingTrail() : trail(MAX_TRAIL), gpu((MAX_TRAIL + 3) * TrailBuffer::VERTEX_SIZE) {}
+
+	TrailBuffer trail;
+	std::vector<float> gpu;
+	double last_trailJD = 0;
+	bool first_point = true;
+
+	void update(int body, double date) {
+		int dt=0;
+		if (first_point || (dt=abs(int((date-last_trailJD)/DELTA_TRAIL))) > MAX_TRAIL) {
+			dt=1;
+			trail.clear();
+			first_point = false;
+		}
+		if (dt) {
+			last_trailJD = date;
+			trail.push(bodyPosition(body, date), date);
+		}
+		trail.expire(date, MAX_TRAIL * DELTA_TRAIL);
+	}
+
+	int draw(const Vec3d &current) {
+		const unsigned int size = TrailBuffer::VERTEX_SIZE;
+		const float *vertices = trail.getVertices().data();
+		unsigned int first[2], nb[2];
+		unsigned int nbRanges = trail.getDirty(first, nb);
+		for (unsigned int i = 0; i < nbRanges; i++)
+			memcpy(gpu.data() + size*first[i], vertices + size*first[i], sizeof(float)*size*nb[i]);
+		trail.markClean();
+
+		const float *newest = vertices + size*trail.getHead();
+		float link[2*TrailBuffer::VERTEX_SIZE] = {newest[0], newest[1], newest[2], newest[3],
+		                                          (float)current[0], (float)current[1], (float)current[2], newest[3]};
+		memcpy(gpu.data() + size*(trail.capacity()+1), link, sizeof(link));
+		return trail.size() + 1;
+	}
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class T>
+void run(std::vector<T> &trails, int nbFrames, double rate, double &updateMs, double &drawMs, long &nbVertices)
+{
+	double date = 2451545.0;
+	updateMs = drawMs = 0.0;
+	nbVertices = 0;
+	for (int f = 0; f < nbFrames; f++) {
+		date += rate;
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int b = 0; b < trails.size(); b++)
+			trails[b].update(b, date);
+		updateMs += elapsedMs(start);
+
+		start = std::chrono::steady_clock::now();
+		for (unsigned int b = 0; b < trails.size(); b++)
+			nbVertices += trails[b].draw(bodyPosition(b, date));
+		drawMs += elapsedMs(start);
+	}
+}
+
+// vérifie que les vertices envoyés, lus dans l'ordre des line strips, redonnent
+// les points de l'ancienne traînée et leur rang depuis le plus récent
+bool check(const ListTrail &old, const RingTrail &ring)
+{
+	if (old.trail.size() != ring.trail.size())
+		return false;
+
+	int first[2], nb[2];
+	unsigned int nbStrips = ring.trail.getStrips(first, nb);
+	std::vector<const float*> vertices;
+	for (unsigned int s = 0; s < nbStrips; s++) {
+		for (int i = 0; i < nb[s]; i++) {
+			// le premier vertex d'un strip qui suit un autre est le même point
+			if (s > 0 && i == 0)
+				continue;
+			vertices.push_back(ring.gpu.data() + TrailBuffer::VERTEX_SIZE*(first[s] + i));
+		}
+	}
+	if (vertices.size() != old.trail.size())
+		return false;
+
+	const int capacity = ring.trail.capacity();
+	const int head = ring.trail.getHead();
+	unsigned int i = 0;
+	for (const TrailPoint &tp : old.trail) {
+		const float *v = vertices[vertices.size() - 1 - i];
+		if (v[0] != (float)tp.point[0] || v[1] != (float)tp.point[1] || v[2] != (float)tp.point[2])
+			return false;
+		if (ring.trail[i].date != tp.date)
+			return false;
+		if ((head - (int)v[3] + capacity) % capacity + 1 != (int)i + 1)
+			return false;
+		i++;
+	}
+	return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int nbBodies = (argc > 1) ? atoi(argv[1]) : 300;
+	int nbFrames = (argc > 2) ? atoi(argv[2]) : 2000;
+
+	// contrôle : avance, recule, sauts au-delà de la traînée
+	int nbErrors = 0;
+	{
+		std::vector<ListTrail> old(20);
+		std::vector<RingTrail> ring(20);
+		double date = 2451545.0;
+		srand(1);
+		for (int f = 0; f < 20000; f++) {
+			int r = rand() % 1000;
+			if (r == 0)
+				date += 5000.0;
+			else if (f % 3000 < 2000)
+				date += (r % 40) * 0.1;
+			else
+				date -= (r % 300) * 0.1;
+			for (unsigned int b = 0; b < old.size(); b++) {
+				old[b].update(b, date);
+				ring[b].update(b, date);
+				old[b].draw(bodyPosition(b, date));
+				ring[b].draw(bodyPosition(b, date));
+				if (!check(old[b], ring[b]))
+					nbErrors++;
+			}
+		}
+	}
+
+	printf("%d bodies, %d frames, MaxTrail %d\n", nbBodies, nbFrames, MAX_TRAIL);
+	printf("days/frame    list update   list draw    ring update   ring draw    vertices/frame\n");
+	const double rates[] = {1.0, 5.0, 100.0, 1000.0};
+	for (double rate : rates) {
+		double listUpdate, listDraw, ringUpdate, ringDraw;
+		long listVertices, ringVertices;
+		{
+			std::vector<ListTrail> trails(nbBodies);
+			run(trails, nbFrames, rate, listUpdate, listDraw, listVertices);
+		}
+		{
+			std::vector<RingTrail> trails(nbBodies);
+			run(trails, nbFrames, rate, ringUpdate, ringDraw, ringVertices);
+		}
+		if (listVertices != ringVertices)
+			nbErrors++;
+		printf("%10.0f %10.3f ms %9.3f ms %11.3f ms %9.3f ms %14ld\n", rate,
+		       listUpdate / nbFrames, listDraw / nbFrames, ringUpdate / nbFrames, ringDraw / nbFrames,
+		       ringVertices / nbFrames);
+	}
+
+	if (nbErrors == 0)
+		printf("trails ok\n");
+	else
+		printf("trails errors (%d)\n", nbErrors);
+	return nbErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/*
+ * Spacecrafter astronomy simulation and visualization
+ *
+ * Copyright (C) 2018 of Association Sirius
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * Spacecrafter is a free open project of of LSS team
+ * See the TRADEMARKS file for free open project usage requirements.
+ *
+ */
+
+// Mesure le coût des uniforms envoyés pour chaque objet, comme le font les halos
+// des corps et les textures des nébuleuses : une matrice commune à tous les objets
+// de la frame et quelques valeurs propres à chaque objet.
+//
+// "old" reproduit l'ancien setUniform(const char*, ...) : recherche dans une map puis glUniform.
+// "string" passe par le setUniform(const char*, ...) actuel, "handle" par setUniform(UniformHandle, ...) :
+// la matrice, identique pour tous les objets, n'est alors envoyée à GL qu'une fois par frame.
+//
+// usage : bench_uniform [nombre d'objets par frame] [nombre de frames]
+
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "shader.hpp"
+
+namespace {
+
+struct BenchObject {
+	Vec3f color;
+	float cmag;
+	float fader;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+	glFinish();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int nbObjects = (argc > 1) ? atoi(argv[1]) : 2000;
+	int nbFrames = (argc > 2) ? atoi(argv[2]) : 200;
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+		printf("SDL_Init: %s\n", SDL_GetError());
+		return 1;
+	}
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	SDL_Window* window = SDL_CreateWindow("bench_uniform", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+	if (context == nullptr) {
+		printf("OpenGL 4.2 context: %s\n", SDL_GetError());
+		return 1;
+	}
+	glewExperimental = GL_TRUE;
+	glewInit();
+
+	shaderProgram::setShaderDir(SHADER_DIR);
+
+	shaderProgram halo;
+	halo.init("body_halo.vert", "body_halo.frag");
+	UniformHandle haloColor = halo.setUniformLocation("Color");
+	UniformHandle haloCmag = halo.setUniformLocation("cmag");
+
+	shaderProgram nebula;
+	nebula.init("nebulaTex.vert", "nebulaTex.geom", "nebulaTex.frag");
+	UniformHandle nebulaMat = nebula.setUniformLocation("Mat");
+	UniformHandle nebulaFader = nebula.setUniformLocation("fader");
+
+	std::vector<BenchObject> objects(nbObjects);
+	for (BenchObject &o : objects) {
+		o.color = Vec3f(rand()/(float)RAND_MAX, rand()/(float)RAND_MAX, rand()/(float)RAND_MAX);
+		o.cmag = rand()/(float)RAND_MAX;
+		o.fader = rand()/(float)RAND_MAX;
+	}
+
+	// the same matrix for all the objects of a frame, a new one each frame
+	auto frameMatrix = [](int frame) {
+		return Mat4f::zrotation(0.001f * frame);
+	};
+
+	// previous implementation of setUniform(const char*, ...) : two searches in a map
+	// of std::string built from the name, then a glUniform call on the program in use
+	GLint haloProgram, nebulaProgram;
+	halo.use();
+	glGetIntegerv(GL_CURRENT_PROGRAM, &haloProgram);
+	nebula.use();
+	glGetIntegerv(GL_CURRENT_PROGRAM, &nebulaProgram);
+	std::map<std::string, GLuint> oldHaloLocations, oldNebulaLocations;
+	oldHaloLocations["Color"] = glGetUniformLocation(haloProgram, "Color");
+	oldHaloLocations["cmag"] = glGetUniformLocation(haloProgram, "cmag");
+	oldNebulaLocations["Mat"] = glGetUniformLocation(nebulaProgram, "Mat");
+	oldNebulaLocations["fader"] = glGetUniformLocation(nebulaProgram, "fader");
+	auto oldLocation = [](std::map<std::string, GLuint> &locations, const char* name) -> GLint {
+		std::map<std::string, GLuint>::iterator pos = locations.find(name);
+		if (pos == locations.end())
+			return 0;
+		return locations[name];
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	for (int f = 0; f < nbFrames; f++) {
+		Mat4f mat = frameMatrix(f);
+		halo.use();
+		for (const BenchObject &o : objects) {
+			glUniform3fv(oldLocation(oldHaloLocations, "Color"), 1, o.color);
+			glUniform1f(oldLocation(oldHaloLocations, "cmag"), o.cmag);
+		}
+		nebula.use();
+		for (const BenchObject &o : objects) {
+			glUniformMatrix4fv(oldLocation(oldNebulaLocations, "Mat"), 1, GL_FALSE, mat);
+			glUniform1f(oldLocation(oldNebulaLocations, "fader"), o.fader);
+		}
+	}
+	double oldTime = elapsedMs(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int f = 0; f < nbFrames; f++) {
+		Mat4f mat = frameMatrix(f);
+		halo.use();
+		for (const BenchObject &o : objects) {
+			halo.setUniform("Color", o.color);
+			halo.setUniform("cmag", o.cmag);
+		}
+		nebula.use();
+		for (const BenchObject &o : objects) {
+			nebula.setUniform("Mat", mat);
+			nebula.setUniform("fader", o.fader);
+		}
+	}
+	double stringTime = elapsedMs(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int f = 0; f < nbFrames; f++) {
+		Mat4f mat = frameMatrix(f);
+		halo.use();
+		for (const BenchObject &o : objects) {
+			halo.setUniform(haloColor, o.color);
+			halo.setUniform(haloCmag, o.cmag);
+		}
+		nebula.use();
+		for (const BenchObject &o : objects) {
+			nebula.setUniform(nebulaMat, mat);
+			nebula.setUniform(nebulaFader, o.fader);
+		}
+	}
+	double handleTime = elapsedMs(start);
+
+	long nbCalls = 4L * nbObjects * nbFrames;
+	printf("%d objects, %d frames, %ld uniforms\n", nbObjects, nbFrames, nbCalls);
+	printf("old    : %8.2f ms, %6.1f ns per uniform\n", oldTime, 1e6 * oldTime / nbCalls);
+	printf("string : %8.2f ms, %6.1f ns per uniform\n", stringTime, 1e6 * stringTime / nbCalls);
+	printf("handle : %8.2f ms, %6.1f ns per uniform\n", handleTime, 1e6 * handleTime / nbCalls);
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
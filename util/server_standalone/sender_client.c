@@ -114,6 +114,9 @@ int main(int argc, char *argv[])
 	
 	unsigned int nb_write;
 	
+	// le serveur exécute les commandes ligne par ligne
+	if (sendBuff[strlen(sendBuff)-1] != '\n')
+		strcat(sendBuff, "\n");
 	nb_write = write(sockfd, sendBuff, strlen(sendBuff));
 	
 	if (nb_write == strlen(sendBuff))
@@ -57,6 +57,7 @@ static void cout_help(char *argv)
 	std::cout << "   -c   display copyright" << std::endl;
 	std::cout << "   -h   display this help" << std::endl;
 	std::cout << "   -n   don't fusion the obj materials" << std::endl;
+	std::cout << "   -t   write the old text format instead of the binary one" << std::endl;
 	std::cout << std::endl;
 }
 
@@ -71,6 +72,7 @@ int main(int argc, char **argv)
 {
 	// variables globales
 	bool toOptimize = true;
+	bool toBinary = true;
 	bool displayCopyright = false;
 	bool displayHelp = false;
 	std::string name;
@@ -79,7 +81,7 @@ int main(int argc, char **argv)
 
 	// Traitement des données
 	int c;
-	while ((c = getopt (argc, argv, "hcn")) != -1) {
+	while ((c = getopt (argc, argv, "hcnt")) != -1) {
 		switch (c) {
 
 			case 'c':
@@ -94,6 +96,10 @@ int main(int argc, char **argv)
 				toOptimize = false;
 				break;
 
+			case 't':
+				toBinary = false;
+				break;
+
 			default:
 				break;
 		}
@@ -136,7 +142,8 @@ int main(int argc, char **argv)
 	if (toOptimize)
 		converter.fusionMaterials();
 
-	converter.exportOJM(name + ".ojm");
+	if (!converter.exportOJM(name + ".ojm", toBinary))
+		return -3;
 	std::cout << argv[0] << ":  export converter without errors" << std::endl;
 	return 0;
 }
@@ -0,0 +1,253 @@
+#include "mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// *****************************************************************************
+//
+// FONCTIONS UTILITAIRES
+//
+// *****************************************************************************
+
+static const unsigned int NONE = 0xFFFFFFFF;
+
+// côté des cellules : le voisinage d'un vertex couvre au plus deux cellules par axe
+static const float CELL_SIZE = 2.0f * VERTEX_TOLERANCE;
+
+static bool is_near(float v1, float v2)
+{
+	return fabs( v1-v2 ) < VERTEX_TOLERANCE;
+}
+
+// score d'un vertex selon sa position dans le cache et le nombre de triangles
+// qui l'utilisent encore, valeurs de Tom Forsyth
+static float vertexScore(int cachePosition, unsigned int remaining)
+{
+	if (remaining == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		if (cachePosition < 3)
+			score = 0.75f; // vertex du dernier triangle
+		else
+			score = powf(1.0f - (cachePosition - 3) / float(VERTEX_CACHE_SIZE - 3), 1.5f);
+	}
+	// favorise les vertex qui n'ont plus que quelques triangles, pour ne pas les laisser isolés
+	return score + 2.0f * powf((float)remaining, -0.5f);
+}
+
+// *****************************************************************************
+//
+// VERTEXINDEX
+//
+// *****************************************************************************
+
+VertexIndex::VertexIndex(const std::vector<Vec3f> &_vertices, const std::vector<Vec2f> *_uvs, const std::vector<Vec3f> &_normals) :
+	vertices(_vertices), uvs(_uvs), normals(_normals)
+{
+}
+
+bool VertexIndex::getCell(const Vec3f &vertex, Cell &cell)
+{
+	for (int i = 0; i < 3; i++) {
+		// NaN ou coordonnée hors de portée des cellules : le vertex ne sera jamais fusionné
+		if (!(fabs(vertex[i] / CELL_SIZE) < 1e15f))
+			return false;
+	}
+	cell.x = (int64_t)floor(vertex[0] / CELL_SIZE);
+	cell.y = (int64_t)floor(vertex[1] / CELL_SIZE);
+	cell.z = (int64_t)floor(vertex[2] / CELL_SIZE);
+	return true;
+}
+
+bool VertexIndex::find(const Vec3f &vertex, const Vec2f &uv, const Vec3f &normal, unsigned int &result) const
+{
+	// cellules qui touchent le cube de côté 2*VERTEX_TOLERANCE autour du vertex,
+	// avec une marge pour les arrondis : une ou deux par axe
+	const Vec3f margin(1.01f * VERTEX_TOLERANCE, 1.01f * VERTEX_TOLERANCE, 1.01f * VERTEX_TOLERANCE);
+	Cell low, high;
+	if (!getCell(vertex - margin, low) || !getCell(vertex + margin, high))
+		return false;
+
+	unsigned int best = NONE;
+	for (int64_t x = low.x; x <= high.x; x++) {
+		for (int64_t y = low.y; y <= high.y; y++) {
+			for (int64_t z = low.z; z <= high.z; z++) {
+				auto it = lastInCell.find(Cell{x, y, z});
+				if (it == lastInCell.end())
+					continue;
+				for (unsigned int i = it->second; i != NONE; i = previousInCell[i]) {
+					if (i < best &&
+					    is_near( vertex[0], vertices[i][0] ) &&
+					    is_near( vertex[1], vertices[i][1] ) &&
+					    is_near( vertex[2], vertices[i][2] ) &&
+					    (uvs == nullptr || (is_near( uv[0], (*uvs)[i][0] ) && is_near( uv[1], (*uvs)[i][1] ))) &&
+					    is_near( normal[0], normals[i][0] ) &&
+					    is_near( normal[1], normals[i][1] ) &&
+					    is_near( normal[2], normals[i][2] ))
+						best = i;
+				}
+			}
+		}
+	}
+
+	if (best == NONE)
+		return false;
+	result = best;
+	return true;
+}
+
+void VertexIndex::addLast()
+{
+	unsigned int index = vertices.size() - 1;
+	previousInCell.push_back(NONE);
+
+	Cell cell;
+	if (!getCell(vertices[index], cell))
+		return;
+
+	auto it = lastInCell.find(cell);
+	if (it == lastInCell.end())
+		lastInCell.emplace(cell, index);
+	else {
+		previousInCell[index] = it->second;
+		it->second = index;
+	}
+}
+
+// *****************************************************************************
+//
+// ORDRE DES TRIANGLES
+//
+// *****************************************************************************
+
+void optimizeVertexCache(std::vector<unsigned int> &indices, unsigned int nbVertices)
+{
+	const unsigned int nbTriangles = indices.size() / 3;
+	if (nbTriangles == 0 || indices.size() % 3 != 0)
+		return;
+
+	// triangles pas encore émis de chaque vertex
+	std::vector<unsigned int> remaining(nbVertices, 0);
+	for (unsigned int v : indices)
+		remaining[v]++;
+
+	std::vector<unsigned int> triStart(nbVertices + 1, 0);
+	for (unsigned int v = 0; v < nbVertices; v++)
+		triStart[v + 1] = triStart[v] + remaining[v];
+
+	std::vector<unsigned int> triList(indices.size());
+	std::vector<unsigned int> fill(triStart.begin(), triStart.end() - 1);
+	for (unsigned int t = 0; t < nbTriangles; t++) {
+		for (int k = 0; k < 3; k++)
+			triList[fill[indices[3 * t + k]]++] = t;
+	}
+
+	std::vector<int> cachePosition(nbVertices, -1);
+	std::vector<float> vScore(nbVertices);
+	for (unsigned int v = 0; v < nbVertices; v++)
+		vScore[v] = vertexScore(-1, remaining[v]);
+
+	std::vector<float> tScore(nbTriangles);
+	std::vector<bool> emitted(nbTriangles, false);
+	unsigned int best = 0;
+	for (unsigned int t = 0; t < nbTriangles; t++) {
+		tScore[t] = vScore[indices[3 * t]] + vScore[indices[3 * t + 1]] + vScore[indices[3 * t + 2]];
+		if (tScore[t] > tScore[best])
+			best = t;
+	}
+
+	std::vector<unsigned int> cache, newCache;
+	cache.reserve(VERTEX_CACHE_SIZE + 3);
+	newCache.reserve(VERTEX_CACHE_SIZE + 3);
+	std::vector<unsigned int> output;
+	output.reserve(indices.size());
+	unsigned int cursor = 0;
+
+	for (unsigned int n = 0; n < nbTriangles; n++) {
+		// aucun triangle en cache : on repart du premier triangle restant
+		if (best == NONE) {
+			while (emitted[cursor])
+				cursor++;
+			best = cursor;
+		}
+
+		const unsigned int *tri = &indices[3 * best];
+		emitted[best] = true;
+		output.insert(output.end(), tri, tri + 3);
+
+		// retire le triangle des listes de ses vertex
+		for (int k = 0; k < 3; k++) {
+			unsigned int v = tri[k];
+			unsigned int *list = &triList[triStart[v]];
+			for (unsigned int i = 0; i < remaining[v]; i++) {
+				if (list[i] == best) {
+					list[i] = list[remaining[v] - 1];
+					break;
+				}
+			}
+			remaining[v]--;
+		}
+
+		// les vertex du triangle passent en tête du cache
+		newCache.clear();
+		for (int k = 0; k < 3; k++) {
+			if (std::find(newCache.begin(), newCache.end(), tri[k]) == newCache.end())
+				newCache.push_back(tri[k]);
+		}
+		for (unsigned int v : cache) {
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache.push_back(v);
+		}
+
+		// mise à jour des scores des vertex du cache et de ceux qui en sortent
+		for (unsigned int i = 0; i < newCache.size(); i++) {
+			unsigned int v = newCache[i];
+			cachePosition[v] = (i < VERTEX_CACHE_SIZE) ? i : -1;
+			float score = vertexScore(cachePosition[v], remaining[v]);
+			float diff = score - vScore[v];
+			vScore[v] = score;
+			for (unsigned int j = 0; j < remaining[v]; j++)
+				tScore[triList[triStart[v] + j]] += diff;
+		}
+
+		// le prochain triangle est le meilleur de ceux qui touchent le cache
+		best = NONE;
+		float bestScore = -1.0f;
+		if (newCache.size() > VERTEX_CACHE_SIZE)
+			newCache.resize(VERTEX_CACHE_SIZE);
+		for (unsigned int v : newCache) {
+			for (unsigned int j = 0; j < remaining[v]; j++) {
+				unsigned int t = triList[triStart[v] + j];
+				if (tScore[t] > bestScore) {
+					bestScore = tScore[t];
+					best = t;
+				}
+			}
+		}
+		std::swap(cache, newCache);
+	}
+
+	indices.swap(output);
+}
+
+float computeACMR(const std::vector<unsigned int> &indices, unsigned int cacheSize)
+{
+	if (indices.size() < 3)
+		return 0.0f;
+
+	std::vector<unsigned int> cache;
+	unsigned int misses = 0;
+	for (unsigned int v : indices) {
+		auto it = std::find(cache.begin(), cache.end(), v);
+		if (it == cache.end()) {
+			misses++;
+			if (cache.size() == cacheSize)
+				cache.pop_back();
+		} else
+			cache.erase(it);
+		cache.insert(cache.begin(), v);
+	}
+	return float(misses) / (indices.size() / 3);
+}
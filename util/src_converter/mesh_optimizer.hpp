@@ -0,0 +1,69 @@
+#ifndef MESH_OPTIMIZER_HPP_INCLUDED
+#define MESH_OPTIMIZER_HPP_INCLUDED
+
+#include "../../src/vecmath.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+//! écart en dessous duquel deux composantes de vertex sont considérées égales
+#define VERTEX_TOLERANCE 0.005f
+
+//! taille du cache de vertex simulé par optimizeVertexCache
+#define VERTEX_CACHE_SIZE 32
+
+/**
+ * \class VertexIndex
+ * \brief Index spatial des vertex déjà émis d'une shape
+ *
+ * Remplace la recherche linéaire reprise de opengl-tutorial.org : les vertex sont
+ * rangés dans une table de hachage de cellules de 2*VERTEX_TOLERANCE de côté,
+ * et un vertex similaire ne peut se trouver que dans les 8 cellules au plus qui
+ * touchent son voisinage.
+ *
+ * find() renvoie le plus petit indice similaire, comme la recherche linéaire :
+ * la sortie est donc la même, vertex pour vertex.
+ */
+class VertexIndex {
+public:
+	//! uvs vaut nullptr pour une shape sans coordonnées de texture
+	VertexIndex(const std::vector<Vec3f> &_vertices, const std::vector<Vec2f> *_uvs, const std::vector<Vec3f> &_normals);
+
+	//! cherche un vertex similaire : même position, même uv (si la shape en a) et même normale
+	bool find(const Vec3f &vertex, const Vec2f &uv, const Vec3f &normal, unsigned int &result) const;
+
+	//! référence le dernier vertex ajouté aux tableaux
+	void addLast();
+
+private:
+	struct Cell {
+		int64_t x, y, z;
+		bool operator==(const Cell &c) const {
+			return x == c.x && y == c.y && z == c.z;
+		}
+	};
+	struct CellHash {
+		size_t operator()(const Cell &c) const {
+			return (size_t)(c.x * 73856093) ^ (size_t)(c.y * 19349663) ^ (size_t)(c.z * 83492791);
+		}
+	};
+
+	static bool getCell(const Vec3f &vertex, Cell &cell);
+
+	const std::vector<Vec3f> &vertices;
+	const std::vector<Vec2f> *uvs;
+	const std::vector<Vec3f> &normals;
+
+	std::unordered_map<Cell, unsigned int, CellHash> lastInCell;	// dernier vertex de chaque cellule
+	std::vector<unsigned int> previousInCell;	// vertex précédent de la même cellule
+};
+
+//! réordonne les triangles pour réutiliser au mieux le cache de vertex du GPU (algorithme de Tom Forsyth)
+//! seuls les triangles changent d'ordre, les indices de vertex restent les mêmes
+void optimizeVertexCache(std::vector<unsigned int> &indices, unsigned int nbVertices);
+
+//! nombre moyen de vertex transformés par triangle avec un cache LRU de cacheSize vertex
+float computeACMR(const std::vector<unsigned int> &indices, unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+#endif // MESH_OPTIMIZER_HPP_INCLUDED
@@ -3,88 +3,23 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <future>
+#include <thread>
 
 using namespace std;
 
 #include "obj3D.hpp"
+#include "mesh_optimizer.hpp"
+#include "../../src/ThreadPool.hpp"
+#include "../../src/ojm_format.hpp"
 
 // *****************************************************************************
 //
 // FONCTIONS UTILITAIRES
 //
-// fonctions copiées de opengl-tutorial.org
-//
 // *****************************************************************************
 
-// Returns true if v1 can be considered equal to v2
-static bool is_near(float v1, float v2)
-{
-	return fabs( v1-v2 ) < 0.005f;
-}
-
-// Searches through all already-exported vertices for a similar one.
-// Similar = same position + same UVs + same normal
-static bool getSimilarVertexIndex(
-    Vec3f & in_vertex,
-    Vec2f & in_uv,
-    Vec3f & in_normal,
-    std::vector<Vec3f> & out_vertices,
-    std::vector<Vec2f> & out_uvs,
-    std::vector<Vec3f> & out_normals,
-    unsigned int & result
-)
-{
-	// Lame linear search
-	for ( unsigned int i=0; i<out_vertices.size(); i++ ) {
-		if (
-		    is_near( in_vertex[0], out_vertices[i][0] ) &&
-		    is_near( in_vertex[1], out_vertices[i][1] ) &&
-		    is_near( in_vertex[2], out_vertices[i][2] ) &&
-		    is_near( in_uv[0], out_uvs     [i][0] ) &&
-		    is_near( in_uv[1], out_uvs     [i][1] ) &&
-		    is_near( in_normal[0], out_normals [i][0] ) &&
-		    is_near( in_normal[1], out_normals [i][1] ) &&
-		    is_near( in_normal[2], out_normals [i][2] )
-		) {
-			result = i;
-			return true;
-		}
-	}
-	// No other vertex could be used instead.
-	// Looks like we'll have to add it to the VBO.
-	return false;
-}
-
-// Searches through all already-exported vertices for a similar one.
-// Similar = same position +  same normal
-static  bool getSimilarVertexNoUvIndex(
-    Vec3f & in_vertex,
-    Vec3f & in_normal,
-    std::vector<Vec3f> & out_vertices,
-    std::vector<Vec3f> & out_normals,
-    unsigned int & result
-)
-{
-	// Lame linear search
-	for ( unsigned int i=0; i<out_vertices.size(); i++ ) {
-		if (
-		    is_near( in_vertex[0], out_vertices[i][0] ) &&
-		    is_near( in_vertex[1], out_vertices[i][1] ) &&
-		    is_near( in_vertex[2], out_vertices[i][2] ) &&
-		    is_near( in_normal[0], out_normals [i][0] ) &&
-		    is_near( in_normal[1], out_normals [i][1] ) &&
-		    is_near( in_normal[2], out_normals [i][2] )
-		) {
-			result = i;
-			return true;
-		}
-	}
-	// No other vertex could be used instead.
-	// Looks like we'll have to add it to the VBO.
-	return false;
-}
-
-
 static std::string extractFileName(const std::string& str)
 {
 	if (str.empty())
@@ -108,80 +43,68 @@ bool ObjToOjm::importOBJ(Obj3D* _obj)
 	return true;
 }
 
-bool ObjToOjm::transform()
+void ObjToOjm::transformMesh(unsigned int i, Shape &shape) const
 {
-	cout << "Nombre total de shape "<< obj->meshes.size() << endl;
-	for(unsigned int  i=0; i < obj->meshes.size(); i++) {
-		//~ cout << "meshe "<< i << " sur "<< obj->meshes.size() << endl;
-		Mesh* mesh = obj->meshes[i];
-		Shape* pShape = new Shape();
-
-		int pourcent, oldPourcent=0;
-
-		pShape->name = mesh->material->name;
-		pShape->map_Ka = extractFileName(mesh->material->map_Ka);
-		pShape->map_Kd = extractFileName(mesh->material->map_Kd);
-		pShape->map_Ks = extractFileName(mesh->material->map_Ks);
-		pShape->T= mesh->material->T;
-
-		if (!pShape->map_Kd.empty() && pShape->map_Ka.empty())
-			pShape->map_Ka = pShape->map_Kd;
-
-		pShape->Ka = mesh->material->Ka;
-		pShape->Kd = mesh->material->Kd;
-		pShape->Ks = mesh->material->Ks;
-
-		pShape->Ns = mesh->material->Ns;
-		//~ cout << "test Ns = "<< pShape->Ns << endl;
-		//~ cout << "  " << endl;
-		
-		cout << "Shape ["<< i << "] nombre de vertex " << obj->meshes[i]->vertexIndices.size() << endl;
-		for (unsigned int j=0; j< obj->meshes[i]->vertexIndices.size(); j++) {
-			// Try to find a similar vertex in out_XXXX
-			//cout << "etape " << j << "/" << obj->meshes[i]->vertexIndices.size() << " name " << mesh->material->name << endl;
-
-			unsigned int index;
-			bool hasUV;
-			mesh->uvIndices.size()!=0 ? hasUV=true: hasUV = false;
-			bool found;
+	Mesh* mesh = obj->meshes[i];
 
-			if (hasUV)
-				found = getSimilarVertexIndex(obj->positionData.vertex[obj->meshes[i]->vertexIndices[j]-1],
-				                              obj->positionData.uvs[obj->meshes[i]->uvIndices[j]-1],
-				                              obj->positionData.normals[obj->meshes[i]->normalIndices[j]-1],
-				                              pShape->vertices,
-				                              pShape->uvs,
-				                              pShape->normals,
-				                              index);
-			else
-				found = getSimilarVertexNoUvIndex(obj->positionData.vertex[obj->meshes[i]->vertexIndices[j]-1],
-				                                  obj->positionData.normals[obj->meshes[i]->normalIndices[j]-1],
-				                                  pShape->vertices,
-				                                  pShape->normals,
-				                                  index);
-
-			if ( found ) { // A similar vertex is already in the VBO, use it instead !
-				pShape->indices.push_back( index );
-			}
-			else { // If not, it needs to be added in the output data.
+	shape.name = mesh->material->name;
+	shape.map_Ka = extractFileName(mesh->material->map_Ka);
+	shape.map_Kd = extractFileName(mesh->material->map_Kd);
+	shape.map_Ks = extractFileName(mesh->material->map_Ks);
+	shape.T= mesh->material->T;
 
-				pShape->vertices.push_back( obj->positionData.vertex[obj->meshes[i]->vertexIndices[j]-1]);
-				if (hasUV) {
-					pShape->uvs.push_back( obj->positionData.uvs[obj->meshes[i]->uvIndices[j]-1]);
-				}
-				pShape->normals.push_back( obj->positionData.normals[obj->meshes[i]->normalIndices[j]-1]);
-				pShape->indices.push_back( pShape->vertices.size() - 1 );
-			}
+	if (!shape.map_Kd.empty() && shape.map_Ka.empty())
+		shape.map_Ka = shape.map_Kd;
 
-			pourcent = std::floor(100*float(j)/obj->meshes[i]->vertexIndices.size()+0.5);
-			if ((pourcent-oldPourcent)>9) {
-				oldPourcent = pourcent;
-				cout << " " << pourcent << endl;
-			}
-			// else
-			// 	cout << "D " << pourcent-oldPourcent << endl;
+	shape.Ka = mesh->material->Ka;
+	shape.Kd = mesh->material->Kd;
+	shape.Ks = mesh->material->Ks;
+
+	shape.Ns = mesh->material->Ns;
+
+	bool hasUV = mesh->uvIndices.size()!=0;
+	VertexIndex vertexIndex(shape.vertices, hasUV ? &shape.uvs : nullptr, shape.normals);
+	const Vec2f noUV;
+
+	for (unsigned int j=0; j< mesh->vertexIndices.size(); j++) {
+		// Try to find a similar vertex in the shape
+		const Vec3f &vertex = obj->positionData.vertex[mesh->vertexIndices[j]-1];
+		const Vec2f &uv = hasUV ? obj->positionData.uvs[mesh->uvIndices[j]-1] : noUV;
+		const Vec3f &normal = obj->positionData.normals[mesh->normalIndices[j]-1];
+
+		unsigned int index;
+		if ( vertexIndex.find(vertex, uv, normal, index) ) { // A similar vertex is already in the VBO, use it instead !
+			shape.indices.push_back( index );
+		}
+		else { // If not, it needs to be added in the output data.
+			shape.vertices.push_back(vertex);
+			if (hasUV)
+				shape.uvs.push_back(uv);
+			shape.normals.push_back(normal);
+			vertexIndex.addLast();
+			shape.indices.push_back( shape.vertices.size() - 1 );
 		}
-		shapes.push_back(*pShape);
+	}
+
+	// ordre des triangles adapté au cache de vertex du GPU
+	optimizeVertexCache(shape.indices, shape.vertices.size());
+}
+
+bool ObjToOjm::transform()
+{
+	cout << "Nombre total de shape "<< obj->meshes.size() << endl;
+
+	// les shapes sont indépendantes : une tâche par shape
+	shapes.clear();
+	shapes.resize(obj->meshes.size());
+	ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<std::future<void>> jobs;
+	for(unsigned int i=0; i < obj->meshes.size(); i++)
+		jobs.push_back(pool.enqueue(&ObjToOjm::transformMesh, this, i, std::ref(shapes[i])));
+
+	for(unsigned int i=0; i < jobs.size(); i++) {
+		jobs[i].get();
+		cout << "Shape ["<< i << "] nombre de vertex " << obj->meshes[i]->vertexIndices.size() << " -> " << shapes[i].vertices.size() << endl;
 	}
 	std::cout << std::endl;
 	return true;
@@ -226,7 +149,7 @@ bool ObjToOjm::fusionMaterials()
 }
 
 
-bool ObjToOjm::exportOJM(const std::string &filename)
+bool ObjToOjm::exportOJM(const std::string &filename, bool binary)
 {
 	std::cout << "ObjToOjm transform" << std::endl;
 	if (!this->transform()) {
@@ -234,11 +157,32 @@ bool ObjToOjm::exportOJM(const std::string &filename)
 		return false;
 	}
 
+	bool isWritten = binary ? writeBinary(filename) : writeText(filename);
+	if (!isWritten) {
+		std::cout << "error ObjToOjm can't write " << filename << std::endl;
+		return false;
+	}
+
+	for(unsigned int i=0; i<shapes.size(); i++) {
+		std::cout << "Shape [" << i << "]" << std::endl;
+		std::cout << "  Nombre de vertex " << shapes[i].vertices.size() << std::endl;
+		std::cout << "  Nombre d'uv " << shapes[i].uvs.size() << std::endl;
+		std::cout << "  Nombre de normal " << shapes[i].normals.size() << std::endl;
+		std::cout << "  Nombre d'indices " << shapes[i].indices.size() << std::endl << std::endl;
+
+		std::cout << "Ratio : " << float(shapes[i].vertices.size())/float(shapes[i].indices.size()) << std::endl;
+		std::cout << "ACMR : " << computeACMR(shapes[i].indices) << std::endl;
+	}
+	return true;
+}
+
+bool ObjToOjm::writeText(const std::string &filename) const
+{
 	std::ofstream stream;
 
 	stream.open(filename.c_str(),std::ios_base::out);
 	if(!stream.is_open())
-		return -1;
+		return false;
 
 	stream<<"# Spacecrafter personal file format"<<std::endl;
 	stream<<"# By Olivier Nivoix and Jérôme Lartillot"<< std::endl;
@@ -292,16 +236,87 @@ bool ObjToOjm::exportOJM(const std::string &filename)
 		}
 
 		stream<<std::endl;
+	}
+	return true;
+}
 
-		std::cout << "Shape [" << i << "]" << std::endl;
-		std::cout << "  Nombre de vertex " << shapes[i].vertices.size() << std::endl;
-		std::cout << "  Nombre d'uv " << shapes[i].uvs.size() << std::endl;
-		std::cout << "  Nombre de normal " << shapes[i].normals.size() << std::endl;
-		std::cout << "  Nombre d'indices " << shapes[i].indices.size() << std::endl << std::endl;
+bool ObjToOjm::writeBinary(const std::string &filename) const
+{
+	// chaînes à la suite de la table des shapes, puis les blocs alignés
+	std::string strings;
+	auto addString = [&strings](uint64_t base, const std::string &str) -> uint64_t {
+		uint64_t offset = base + strings.size();
+		strings.append(str);
+		strings.push_back('\0');
+		return offset;
+	};
+	const uint64_t stringBase = sizeof(OjmFileHeader) + shapes.size() * sizeof(OjmShapeEntry);
+
+	std::vector<OjmShapeEntry> entries(shapes.size());
+	for(unsigned int i=0; i<shapes.size(); i++) {
+		const Shape &shape = shapes[i];
+		OjmShapeEntry &entry = entries[i];
+		memset(&entry, 0, sizeof(entry));
+		entry.name = addString(stringBase, shape.name);
+		entry.mapKa = addString(stringBase, shape.map_Ka);
+		entry.mapKd = addString(stringBase, shape.map_Kd);
+		entry.mapKs = addString(stringBase, shape.map_Ks);
+		for (int k=0; k<3; k++) {
+			entry.Ka[k] = shape.Ka.v[k];
+			entry.Kd[k] = shape.Kd.v[k];
+			entry.Ks[k] = shape.Ks.v[k];
+		}
+		entry.Ns = shape.Ns;
+		entry.T = shape.T;
+		entry.nbVertices = shape.vertices.size();
+		entry.nbUvs = shape.uvs.size();
+		entry.nbNormals = shape.normals.size();
+		entry.nbIndices = shape.indices.size();
+	}
 
-		std::cout << "Ratio : " << float(shapes[i].vertices.size())/float(shapes[i].indices.size()) << std::endl;
+	uint64_t offset = ojmAlignBlock(stringBase + strings.size());
+	for(unsigned int i=0; i<shapes.size(); i++) {
+		OjmShapeEntry &entry = entries[i];
+		entry.vertices = offset;
+		offset = ojmAlignBlock(offset + sizeof(Vec3f) * entry.nbVertices);
+		entry.uvs = offset;
+		offset = ojmAlignBlock(offset + sizeof(Vec2f) * entry.nbUvs);
+		entry.normals = offset;
+		offset = ojmAlignBlock(offset + sizeof(Vec3f) * entry.nbNormals);
+		entry.indices = offset;
+		offset = ojmAlignBlock(offset + sizeof(uint32_t) * entry.nbIndices);
 	}
 
+	OjmFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = OJM_BINARY_MAGIC;
+	header.version = OJM_BINARY_VERSION;
+	header.nbShapes = shapes.size();
+	header.fileSize = offset;
 
-	return true;
+	std::ofstream stream(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+	if(!stream.is_open())
+		return false;
+
+	uint64_t position = 0;
+	auto writeBlock = [&stream, &position](uint64_t blockOffset, const void *data, uint64_t length) {
+		static const char padding[OJM_BLOCK_ALIGN] = {};
+		if (blockOffset > position)
+			stream.write(padding, blockOffset - position);
+		stream.write((const char*)data, length);
+		position = blockOffset + length;
+	};
+
+	writeBlock(0, &header, sizeof(header));
+	writeBlock(position, entries.data(), entries.size() * sizeof(OjmShapeEntry));
+	writeBlock(position, strings.data(), strings.size());
+	for(unsigned int i=0; i<shapes.size(); i++) {
+		writeBlock(entries[i].vertices, shapes[i].vertices.data(), sizeof(Vec3f) * entries[i].nbVertices);
+		writeBlock(entries[i].uvs, shapes[i].uvs.data(), sizeof(Vec2f) * entries[i].nbUvs);
+		writeBlock(entries[i].normals, shapes[i].normals.data(), sizeof(Vec3f) * entries[i].nbNormals);
+		writeBlock(entries[i].indices, shapes[i].indices.data(), sizeof(uint32_t) * entries[i].nbIndices);
+	}
+	writeBlock(header.fileSize, nullptr, 0);
+
+	return stream.good();
 }
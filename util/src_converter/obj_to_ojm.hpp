@@ -20,13 +20,19 @@ public:
 	//! mise en commun des shapes identiques cad ayant les mêmes paramètres
 	bool fusionMaterials();
 
-	//! le sauvegarde sur disque dur
-	bool exportOJM(const std::string &filename);
+	//! le sauvegarde sur disque dur, au format binaire OJM v2 ou au format texte
+	bool exportOJM(const std::string &filename, bool binary = true);
 
 private:
 	Obj3D* obj;
 
 	bool transform();
+	//! construit la shape i : vertex sans doublons et triangles dans l'ordre du cache
+	void transformMesh(unsigned int i, Shape &shape) const;
+
+	bool writeText(const std::string &filename) const;
+	//! format décrit dans src/ojm_format.hpp
+	bool writeBinary(const std::string &filename) const;
 
 	std::vector<Shape> shapes;
 };